@@ -42,6 +42,8 @@ check_function_exists( glob ERT_HAVE_GLOB )
 check_function_exists( getuid ERT_HAVE_GETUID )
 check_function_exists( regexec ERT_HAVE_REGEXP )
 check_function_exists( lockf ERT_HAVE_LOCKF )
+check_function_exists( mmap ERT_HAVE_MMAP )
+check_function_exists( getc_unlocked ERT_HAVE_GETC_UNLOCKED )
 
 
 check_type_size(time_t SIZE_OF_TIME_T)
@@ -64,6 +66,7 @@ endif()
 
 if (HAVE_PTHREAD)
    set( ERT_HAVE_THREAD_POOL ON )
+   set( ERT_HAVE_PTHREAD ON )
 endif()
 
 
@@ -0,0 +1,145 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'rsvd_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/timer.h>
+#include <ert/util/matrix.h>
+#include <ert/util/matrix_blas.h>
+#include <ert/util/matrix_lapack.h>
+
+#include <ert/analysis/enkf_linalg.h>
+
+
+/*
+  Small benchmark of the full and the randomized svd with truncation,
+  as used in the EnKF update, for an S matrix with many more
+  observations than realisations. The time used by each method is
+  printed along with the largest relative error in the retained
+  (inverted) singular values. The S matrix has random orthonormal
+  singular vectors and singular values decaying geometrically with
+  @decay.
+*/
+
+
+static void orthonormal_init( matrix_type * Q , rng_type * rng ) {
+  int ncolumns = matrix_get_columns( Q );
+  double * tau = util_calloc( ncolumns , sizeof * tau );
+
+  for (int j=0; j < ncolumns; j++)
+    for (int i=0; i < matrix_get_rows( Q ); i++)
+      matrix_iset( Q , i , j , rng_std_normal( rng ));
+
+  matrix_dgeqrf( Q , tau );
+  matrix_dorgqr( Q , tau , ncolumns );
+  free( tau );
+}
+
+
+static matrix_type * alloc_S( int nrobs , int ens_size , double decay ) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  int nrmin = util_int_min( nrobs , ens_size );
+  matrix_type * U = matrix_alloc( nrobs , nrmin );
+  matrix_type * V = matrix_alloc( ens_size , nrmin );
+  matrix_type * S = matrix_alloc( nrobs , ens_size );
+
+  orthonormal_init( U , rng );
+  orthonormal_init( V , rng );
+  for (int j=0; j < nrmin; j++)
+    matrix_scale_column( U , j , 100 * pow( decay , j ));
+
+  matrix_dgemm( S , U , V , false , true , 1.0 , 0.0 );
+
+  matrix_free( V );
+  matrix_free( U );
+  rng_free( rng );
+  return S;
+}
+
+
+static void rsvd_bench( int nrobs , int ens_size , double truncation , double decay ) {
+  int nrmin = util_int_min( nrobs , ens_size );
+  matrix_type * S = alloc_S( nrobs , ens_size , decay );
+  matrix_type * U0 = matrix_alloc( nrobs , nrmin );
+  double * sig_full = util_calloc( nrmin , sizeof * sig_full );
+  double * sig_rsvd = util_calloc( nrmin , sizeof * sig_rsvd );
+  timer_type * timer = timer_alloc( true );
+  double full_time , rsvd_time;
+  int num_full , num_rsvd;
+  double max_error = 0;
+
+  timer_start( timer );
+  num_full = enkf_linalg_svdS_method( S , truncation , -1 , DGESVD_NONE , sig_full , U0 , NULL , ENKF_SVD_FULL );
+  full_time = timer_stop( timer );
+
+  timer_start( timer );
+  num_rsvd = enkf_linalg_svdS_method( S , truncation , -1 , DGESVD_NONE , sig_rsvd , U0 , NULL , ENKF_SVD_RANDOMIZED );
+  rsvd_time = timer_stop( timer );
+
+  for (int i=0; i < util_int_min( num_full , num_rsvd ); i++)
+    max_error = util_double_max( max_error , fabs( sig_full[i] - sig_rsvd[i] ) / sig_full[i] );
+
+  printf("svd of %d x %d matrix with truncation %g\n" , nrobs , ens_size , truncation);
+  printf("   full:        %10.3f ms  %4d components\n" , 1000 * full_time , num_full);
+  printf("   randomized:  %10.3f ms  %4d components\n" , 1000 * rsvd_time , num_rsvd);
+  printf("   max relative error in the retained singular values: %g\n" , max_error);
+
+  timer_free( timer );
+  free( sig_rsvd );
+  free( sig_full );
+  matrix_free( U0 );
+  matrix_free( S );
+}
+
+
+static int usage( void ) {
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Usage:\n\n");
+  fprintf(stderr,"   bash%% rsvd_bench [nrobs ens_size [truncation [decay]]]\n\n");
+  fprintf(stderr,"Will time the full and randomized svd of an nrobs x ens_size matrix; the defaults are 20000 200 0.99 0.8.\n");
+  exit(1);
+}
+
+
+int main(int argc , char ** argv) {
+  int nrobs = 20000;
+  int ens_size = 200;
+  double truncation = 0.99;
+  double decay = 0.8;
+
+  if (argc == 2 || argc > 5)
+    usage();
+
+  if (argc >= 3) {
+    if (!(util_sscanf_int( argv[1] , &nrobs ) && util_sscanf_int( argv[2] , &ens_size )))
+      usage();
+  }
+
+  if (argc >= 4 && !util_sscanf_double( argv[3] , &truncation ))
+    usage();
+
+  if (argc >= 5 && !util_sscanf_double( argv[4] , &decay ))
+    usage();
+
+  rsvd_bench( nrobs , ens_size , truncation , decay );
+  exit(0);
+}
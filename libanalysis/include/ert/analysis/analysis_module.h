@@ -58,6 +58,14 @@ typedef enum {
                                        {.value = ANALYSIS_ITERABLE    , .name = "ANALYSIS_ITERABLE"}
 
 
+/*
+   Modules which can use several threads internally should support
+   this integer variable; it is set by the core ert code from the
+   ANALYSIS_THREADS configuration keyword.
+*/
+#define ANALYSIS_NUM_THREADS_VAR "NUM_THREADS"
+
+
 #define EXTERNAL_MODULE_NAME "analysis_table"
 #define EXTERNAL_MODULE_SYMBOL analysis_table
 
@@ -6,6 +6,12 @@
 #include <ert/util/double_vector.h>
 
 
+typedef enum {
+  ENKF_SVD_FULL       = 0,    /* Full svd with dgesvd. */
+  ENKF_SVD_RANDOMIZED = 1     /* Randomized svd; only the leading singular values and vectors are calculated. */
+} enkf_svd_method_enum;
+
+
 int enkf_linalg_get_PC( const matrix_type * S0, 
                          const matrix_type * dObs , 
                          double truncation,
@@ -45,6 +51,15 @@ int enkf_linalg_svd_truncation(const matrix_type * S ,
                      matrix_type * U0 , 
                      matrix_type * V0T);
 
+int enkf_linalg_svd_truncation_method(const matrix_type * S ,
+                                      double truncation ,
+                                      int ncomp ,
+                                      dgesvd_vector_enum store_V0T ,
+                                      double * sig0,
+                                      matrix_type * U0 ,
+                                      matrix_type * V0T ,
+                                      enkf_svd_method_enum svd_method);
+
 
 int enkf_linalg_svdS(const matrix_type * S , 
                      double truncation , 
@@ -54,6 +69,22 @@ int enkf_linalg_svdS(const matrix_type * S ,
                      matrix_type * U0 , 
                      matrix_type * V0T);
 
+int enkf_linalg_svdS_method(const matrix_type * S ,
+                            double truncation ,
+                            int ncomp ,
+                            dgesvd_vector_enum jobVT ,
+                            double * sig0,
+                            matrix_type * U0 ,
+                            matrix_type * V0T ,
+                            enkf_svd_method_enum svd_method);
+
+void enkf_linalg_rsvd(const matrix_type * S ,
+                      int ncomp ,
+                      dgesvd_vector_enum store_V0T ,
+                      double * sig0 ,
+                      matrix_type * U0 ,
+                      matrix_type * V0T);
+
 
 
 matrix_type * enkf_linalg_alloc_innov( const matrix_type * dObs , const matrix_type * S);
@@ -67,6 +98,16 @@ void enkf_linalg_lowrankCinv__(const matrix_type * S ,
                                double truncation, 
                                int ncomp);
 
+void enkf_linalg_lowrankCinv_method__(const matrix_type * S ,
+                                      const matrix_type * R ,
+                                      matrix_type * V0T ,
+                                      matrix_type * Z,
+                                      double * eig ,
+                                      matrix_type * U0,
+                                      double truncation,
+                                      int ncomp,
+                                      enkf_svd_method_enum svd_method);
+
 
 
 void enkf_linalg_lowrankCinv(const matrix_type * S , 
@@ -76,6 +117,14 @@ void enkf_linalg_lowrankCinv(const matrix_type * S ,
                              double truncation     ,
                              int    ncomp);
 
+void enkf_linalg_lowrankCinv_method(const matrix_type * S ,
+                                    const matrix_type * R ,
+                                    matrix_type * W       ,
+                                    double * eig          ,
+                                    double truncation     ,
+                                    int    ncomp          ,
+                                    enkf_svd_method_enum svd_method);
+
 void enkf_linalg_lowrankE(const matrix_type * S , /* (nrobs x nrens) */
                           const matrix_type * E , /* (nrobs x nrens) */
                           matrix_type * W       , /* (nrobs x nrmin) Corresponding to X1 from Eqs. 14.54-14.55 */
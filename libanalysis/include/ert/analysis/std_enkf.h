@@ -16,6 +16,7 @@ extern "C" {
 #define  USE_EE_KEY_               "USE_EE"
 #define  USE_GE_KEY_               "USE_GE"
 #define  ANALYSIS_SCALE_DATA_KEY_  "ANALYSIS_SCALE_DATA"
+#define  RANDOMIZED_SVD_KEY_       "RANDOMIZED_SVD"
 
   typedef struct std_enkf_data_struct std_enkf_data_type;
 
@@ -277,7 +277,7 @@ static void rml_enkf_init1__( rml_enkf_data_type * data) {
   }
 
   // Um Wm VmT = Dm; nsign1 = num of non-zero singular values.
-  int nsign1 = enkf_linalg_svd_truncation(Dm , rml_enkf_config_get_truncation( data->config ) , -1 , DGESVD_MIN_RETURN  , Wm , Um , VmT);
+  int nsign1 = enkf_linalg_svd_truncation_method(Dm , rml_enkf_config_get_truncation( data->config ) , -1 , DGESVD_MIN_RETURN  , Wm , Um , VmT , rml_enkf_config_get_svd_method( data->config ));
 
   // Am = Um*Wm^(-1). I.e. scale *columns* of Um
   enkf_linalg_rml_enkfAm(Um, Wm, nsign1);
@@ -331,7 +331,7 @@ static void rml_enkf_initA__(rml_enkf_data_type * data, matrix_type * A, matrix_
     matrix_matmul(tmp , Cd , S );                         //
     matrix_scale(tmp , nsc);                              //
 
-    nsign = enkf_linalg_svd_truncation(tmp , rml_enkf_config_get_truncation( data->config ) , -1 , DGESVD_MIN_RETURN  , Wdr , Udr , VdTr);
+    nsign = enkf_linalg_svd_truncation_method(tmp , rml_enkf_config_get_truncation( data->config ) , -1 , DGESVD_MIN_RETURN  , Wdr , Udr , VdTr , rml_enkf_config_get_svd_method( data->config ));
     matrix_free( tmp );
   }
 
@@ -663,6 +663,8 @@ bool rml_enkf_set_bool( void * arg , const char * var_name , bool value) {
       rml_enkf_log_set_clear_log( module_data->rml_log , value );
     else if (strcmp( var_name , LAMBDA_RECALCULATE_KEY) == 0)
       rml_enkf_config_set_lambda_recalculate( module_data->config , value );
+    else if (strcmp( var_name , RANDOMIZED_SVD_KEY_) == 0)
+      rml_enkf_config_set_svd_method( module_data->config , value ? ENKF_SVD_RANDOMIZED : ENKF_SVD_FULL );
     else
       name_recognized = false;
 
@@ -679,6 +681,8 @@ bool rml_enkf_get_bool( const void * arg, const char * var_name) {
       return rml_enkf_log_get_clear_log( module_data->rml_log );
     else if (strcmp(var_name , LAMBDA_RECALCULATE_KEY) == 0)
       return rml_enkf_config_get_lambda_recalculate( module_data->config );
+    else if (strcmp(var_name , RANDOMIZED_SVD_KEY_) == 0)
+      return (rml_enkf_config_get_svd_method( module_data->config ) == ENKF_SVD_RANDOMIZED);
     else
        return false;
   }
@@ -772,6 +776,8 @@ bool rml_enkf_has_var( const void * arg, const char * var_name) {
       return true;
     else if (strcmp(var_name , CLEAR_LOG_KEY) == 0)
       return true;
+    else if (strcmp(var_name , RANDOMIZED_SVD_KEY_) == 0)
+      return true;
     else
       return false;
   }
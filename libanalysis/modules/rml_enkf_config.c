@@ -37,6 +37,7 @@
 #define DEFAULT_LAMBDA0                -1
 #define DEFAULT_LAMBDA_MIN             0.01
 #define DEFAULT_LAMBDA_RECALCULATE     false
+#define DEFAULT_SVD_METHOD             ENKF_SVD_FULL
 
 
 
@@ -55,6 +56,7 @@ struct rml_enkf_config_struct {
   double    lambda_decrease_factor;
   double    lambda_increase_factor;
   bool      lambda_recalculate;
+  enkf_svd_method_enum svd_method; // Controlled by config key: RANDOMIZED_SVD_KEY
 };
 
 
@@ -77,6 +79,7 @@ rml_enkf_config_type * rml_enkf_config_alloc() {
   rml_enkf_config_set_lambda_decrease_factor( config , DEFAULT_LAMBDA_REDUCE_FACTOR );
   rml_enkf_config_set_lambda_increase_factor( config , DEFAULT_LAMBDA_INCREASE_FACTOR );
   rml_enkf_config_set_lambda_recalculate( config , DEFAULT_LAMBDA_RECALCULATE );
+  rml_enkf_config_set_svd_method( config , DEFAULT_SVD_METHOD );
 
   return config;
 }
@@ -163,6 +166,15 @@ void rml_enkf_config_set_lambda_recalculate( rml_enkf_config_type * config , boo
 }
 
 
+enkf_svd_method_enum rml_enkf_config_get_svd_method( const rml_enkf_config_type * config ) {
+  return config->svd_method;
+}
+
+void rml_enkf_config_set_svd_method( rml_enkf_config_type * config , enkf_svd_method_enum svd_method) {
+  config->svd_method = svd_method;
+}
+
+
 void rml_enkf_config_free(rml_enkf_config_type * config) {
   free( config );
 }
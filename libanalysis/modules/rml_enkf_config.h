@@ -19,6 +19,8 @@
 #ifndef RML_ENKF_CONFIG_H
 #define RML_ENKF_CONFIG_H
 
+#include <ert/analysis/enkf_linalg.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -57,6 +59,9 @@ typedef struct rml_enkf_config_struct rml_enkf_config_type;
   bool   rml_enkf_config_get_lambda_recalculate( const rml_enkf_config_type * config );
   void   rml_enkf_config_set_lambda_recalculate( rml_enkf_config_type * config , bool lambda_recalculate);
 
+  enkf_svd_method_enum rml_enkf_config_get_svd_method( const rml_enkf_config_type * config );
+  void                 rml_enkf_config_set_svd_method( rml_enkf_config_type * config , enkf_svd_method_enum svd_method);
+
 
 #ifdef __cplusplus
 }
@@ -21,11 +21,15 @@
 #include <stdio.h>
 #include <math.h>
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/int_vector.h>
 #include <ert/util/util.h>
 #include <ert/util/rng.h>
 #include <ert/util/matrix.h>
 #include <ert/util/matrix_blas.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
 
 #include <ert/analysis/std_enkf.h>
 #include <ert/analysis/cv_enkf.h>
@@ -41,6 +45,14 @@
 #define DEFAULT_TRUNCATION          0.95
 #define DEFAULT_NCOMP               INVALID_SUBSPACE_DIMENSION
 
+/*
+  Upper limit for the total memory of the CV workspaces of all the
+  threads; each CV thread holds a resampled copy of A, and cv_enkf
+  allocates up to two more matrices of the same size while it runs.
+*/
+#define  CV_MEMORY_BUDGET            ((size_t) 4 << 30)
+#define  CV_WORK_MATRICES            3
+
 #define  DEFAULT_DO_CV               false
 #define  DEFAULT_NFOLDS              10
 #define  NFOLDS_KEY                  "BOOTSTRAP_NFOLDS"
@@ -53,9 +65,50 @@ typedef struct {
   rng_type             * rng;
   long                   option_flags;
   bool                   doCV;
+  int                    num_threads;
+  double                 truncation;         /* Copies of the cv_enkf settings; used for the per thread cv_enkf instances. */
+  int                    subspace_dimension;
 } bootstrap_enkf_data_type;
 
 
+/*
+  The bootstrap update of the different ensemble members are
+  independent, and are distributed over several threads. Each thread
+  has a bootstrap_work instance with the workspace matrices which are
+  reused for all the members handled by the thread; thread number t
+  of T handles the members t, t + T, t + 2T, ...
+
+  The resampling of all the members, and for the CV variant the
+  state of an rng for each member, is drawn from the module rng
+  before the threads are started, i.e. the result does not depend on
+  the number of threads.
+*/
+
+typedef struct {
+  const bootstrap_enkf_data_type * bootstrap_data;
+  int                    thread_nr;
+  int                    num_threads;
+
+  matrix_type          * A;
+  const matrix_type    * A0;
+  matrix_type          * S;
+  matrix_type          * R;
+  matrix_type          * dObs;
+  matrix_type          * E;
+  matrix_type          * D;
+  int                 ** iens_resample;
+  const char           * rng_states;        /* rng state for each member; only for CV. */
+
+  matrix_type          * X;
+  matrix_type          * S_resampled;
+  matrix_type          * A_resampled;       /* Only for CV. */
+  double               * weight;
+  double               * A_column;
+  rng_type             * rng;               /* Only for CV. */
+  cv_enkf_data_type    * cv_enkf_data;      /* Only for CV. */
+} bootstrap_work_type;
+
+
 static UTIL_SAFE_CAST_FUNCTION( bootstrap_enkf_data , BOOTSTRAP_ENKF_TYPE_ID )
 static UTIL_SAFE_CAST_FUNCTION_CONST( bootstrap_enkf_data , BOOTSTRAP_ENKF_TYPE_ID )
 
@@ -69,12 +122,14 @@ void bootstrap_enkf_set_doCV( bootstrap_enkf_data_type * data , bool doCV) {
 void bootstrap_enkf_set_truncation( bootstrap_enkf_data_type * boot_data , double truncation ) {
   std_enkf_set_truncation( boot_data->std_enkf_data , truncation );
   cv_enkf_set_truncation( boot_data->cv_enkf_data , truncation );
+  boot_data->truncation = truncation;
 }
 
 
 void bootstrap_enkf_set_subspace_dimension( bootstrap_enkf_data_type * boot_data , int ncomp) {
   std_enkf_set_subspace_dimension( boot_data->std_enkf_data , ncomp );
   cv_enkf_set_subspace_dimension( boot_data->cv_enkf_data , ncomp );
+  boot_data->subspace_dimension = ncomp;
 }
 
 
@@ -89,6 +144,7 @@ void * bootstrap_enkf_data_alloc( rng_type * rng ) {
   bootstrap_enkf_set_truncation( boot_data , DEFAULT_TRUNCATION );
   bootstrap_enkf_set_subspace_dimension( boot_data , DEFAULT_NCOMP );
   bootstrap_enkf_set_doCV( boot_data , DEFAULT_DO_CV);
+  boot_data->num_threads = util_get_num_cpu( );
   boot_data->option_flags = ANALYSIS_NEED_ED + ANALYSIS_UPDATE_A + ANALYSIS_SCALE_DATA;
   return boot_data;
 }
@@ -133,6 +189,138 @@ static void free_iens_resample( int ** iens_resample, int ens_size ) {
 
 
 
+static void bootstrap_work_init( bootstrap_work_type * work , int ens_size , int nrobs , int state_size ) {
+  const bootstrap_enkf_data_type * bootstrap_data = work->bootstrap_data;
+
+  work->X           = matrix_alloc( ens_size , ens_size );
+  work->S_resampled = matrix_alloc( nrobs , ens_size );
+  work->weight      = util_calloc( ens_size , sizeof * work->weight );
+  work->A_column    = util_calloc( state_size , sizeof * work->A_column );
+
+  if (bootstrap_data->doCV) {
+    work->A_resampled  = matrix_alloc( state_size , ens_size );
+    work->rng          = rng_alloc( rng_get_type( bootstrap_data->rng ) , INIT_DEFAULT );
+    work->cv_enkf_data = cv_enkf_data_alloc( work->rng );
+    cv_enkf_set_truncation( work->cv_enkf_data , bootstrap_data->truncation );
+    cv_enkf_set_subspace_dimension( work->cv_enkf_data , bootstrap_data->subspace_dimension );
+  } else {
+    work->A_resampled  = NULL;
+    work->rng          = NULL;
+    work->cv_enkf_data = NULL;
+  }
+}
+
+
+static void bootstrap_work_free( bootstrap_work_type * work ) {
+  matrix_free( work->X );
+  matrix_free( work->S_resampled );
+  matrix_safe_free( work->A_resampled );
+  free( work->weight );
+  free( work->A_column );
+  if (work->cv_enkf_data) {
+    cv_enkf_data_free( work->cv_enkf_data );
+    rng_free( work->rng );
+  }
+}
+
+
+/*
+  Updates column iens of A. The update of the resampled ensemble
+  is
+
+     A_resampled + A_resampled * X
+
+  and of this only column iens is kept. Since column k of
+  A_resampled is column iens_resample[iens][k] of A0, column iens of
+  A_resampled * X equals A0 * w, where w[m] is the sum of X[k,iens]
+  over all the k resampled from member m. This way only a
+  matrix-vector product with A0 is needed for each member; the full
+  A_resampled is only assembled when cv_enkf needs it.
+*/
+
+static void bootstrap_enkf_update_member( bootstrap_work_type * work , int iens ) {
+  const bootstrap_enkf_data_type * bootstrap_data = work->bootstrap_data;
+  const int * iens_resample = work->iens_resample[iens];
+  int ens_size   = matrix_get_columns( work->A0 );
+  int state_size = matrix_get_rows( work->A0 );
+
+  /* Resample A and meas_data. Here we are careful to resample the working copy.*/
+  for (int ensemble_counter = 0; ensemble_counter < ens_size; ensemble_counter++) {
+    int random_column = iens_resample[ensemble_counter];
+    matrix_copy_column( work->S_resampled , work->S , ensemble_counter , random_column );
+    if (work->A_resampled)
+      matrix_copy_column( work->A_resampled , work->A0 , ensemble_counter , random_column );
+  }
+
+  if (bootstrap_data->doCV) {
+    const bool_vector_type * ens_mask = NULL;
+    rng_set_state( work->rng , &work->rng_states[ iens * rng_state_size( work->rng ) ]);
+    cv_enkf_init_update( work->cv_enkf_data , ens_mask , work->S_resampled , work->R , work->dObs , work->E , work->D);
+    cv_enkf_initX( work->cv_enkf_data , work->X , work->A_resampled , work->S_resampled , work->R , work->dObs , work->E , work->D);
+  } else
+    std_enkf_initX(bootstrap_data->std_enkf_data , work->X , NULL , work->S_resampled , work->R , work->dObs , work->E , work->D );
+
+  for (int m = 0; m < ens_size; m++)
+    work->weight[m] = 0;
+  for (int k = 0; k < ens_size; k++)
+    work->weight[ iens_resample[k] ] += matrix_iget( work->X , k , iens );
+
+  matrix_dgemv( work->A0 , work->weight , work->A_column , false , 1.0 , 0.0 );
+  for (int i = 0; i < state_size; i++)
+    work->A_column[i] += matrix_iget( work->A0 , i , iens );
+  matrix_set_column( work->A , work->A_column , iens );
+}
+
+
+/*
+  The number of threads used for the CV variant is limited so that
+  the CV workspaces stay within CV_MEMORY_BUDGET; at least one thread
+  is always used.
+*/
+
+static int bootstrap_enkf_get_cv_threads( int num_threads , int state_size , int ens_size ) {
+  size_t thread_memory = (size_t) CV_WORK_MATRICES * state_size * ens_size * sizeof(double);
+  if (thread_memory > 0) {
+    size_t max_threads = CV_MEMORY_BUDGET / thread_memory;
+    if (max_threads < (size_t) num_threads)
+      num_threads = util_int_max( 1 , max_threads );
+  }
+  return num_threads;
+}
+
+
+static void * bootstrap_enkf_update_members_mt( void * arg ) {
+  bootstrap_work_type * work = arg;
+  int ens_size = matrix_get_columns( work->A0 );
+
+  for (int iens = work->thread_nr; iens < ens_size; iens += work->num_threads)
+    bootstrap_enkf_update_member( work , iens );
+
+  return NULL;
+}
+
+
+/*
+  Allocates the state of an rng for each ensemble member, drawn in
+  sequence from the module rng; used by the CV variant.
+*/
+
+static char * alloc_rng_states( rng_type * rng , int ens_size ) {
+  rng_type * member_rng = rng_alloc( rng_get_type( rng ) , INIT_DEFAULT );
+  int state_size = rng_state_size( member_rng );
+  char * rng_states = util_calloc( ens_size * state_size , sizeof * rng_states );
+
+  for (int iens = 0; iens < ens_size; iens++) {
+    rng_rng_init( member_rng , rng );
+    rng_get_state( member_rng , &rng_states[ iens * state_size ]);
+  }
+
+  rng_free( member_rng );
+  return rng_states;
+}
+
+
+
 void bootstrap_enkf_updateA(void * module_data ,
                             matrix_type * A ,
                             matrix_type * S ,
@@ -144,54 +332,54 @@ void bootstrap_enkf_updateA(void * module_data ,
 
   bootstrap_enkf_data_type * bootstrap_data = bootstrap_enkf_data_safe_cast( module_data );
   {
-    const int num_cpu_threads = 4;
     int ens_size              = matrix_get_columns( A );
-    matrix_type * X           = matrix_alloc( ens_size , ens_size );
+    int num_threads           = util_int_max( 1 , util_int_min( bootstrap_data->num_threads , ens_size ));
     matrix_type * A0          = matrix_alloc_copy( A );
-    matrix_type * S_resampled = matrix_alloc_copy( S );
-    matrix_type * A_resampled = matrix_alloc( matrix_get_rows(A0) , matrix_get_columns( A0 ));
     int ** iens_resample      = alloc_iens_resample( bootstrap_data->rng , ens_size );
-    {
-      int ensemble_members_loop;
-      for ( ensemble_members_loop = 0; ensemble_members_loop < ens_size; ensemble_members_loop++) {
-        int unique_bootstrap_components;
-        int ensemble_counter;
-        /* Resample A and meas_data. Here we are careful to resample the working copy.*/
-        {
-          {
-            int_vector_type * bootstrap_components = int_vector_alloc( ens_size , 0);
-            for (ensemble_counter  = 0; ensemble_counter < ens_size; ensemble_counter++) {
-              int random_column = iens_resample[ ensemble_members_loop][ensemble_counter];
-              int_vector_iset( bootstrap_components , ensemble_counter , random_column );
-              matrix_copy_column( A_resampled , A0 , ensemble_counter , random_column );
-              matrix_copy_column( S_resampled , S  , ensemble_counter , random_column );
-            }
-            int_vector_select_unique( bootstrap_components );
-            unique_bootstrap_components = int_vector_size( bootstrap_components );
-            int_vector_free( bootstrap_components );
-          }
-
-          if (bootstrap_data->doCV) {
-            const bool_vector_type * ens_mask = NULL;
-            cv_enkf_init_update( bootstrap_data->cv_enkf_data , ens_mask , S_resampled , R , dObs , E , D);
-            cv_enkf_initX( bootstrap_data->cv_enkf_data , X , A_resampled , S_resampled , R , dObs , E , D);
-          } else
-            std_enkf_initX(bootstrap_data->std_enkf_data , X , NULL , S_resampled,R, dObs, E,D );
-
-
-          matrix_inplace_matmul_mt1( A_resampled , X , num_cpu_threads );
-          matrix_inplace_add( A_resampled , A0 );
-          matrix_copy_column( A , A_resampled, ensemble_members_loop, ensemble_members_loop);
-
-        }
-      }
+    char * rng_states         = bootstrap_data->doCV ? alloc_rng_states( bootstrap_data->rng , ens_size ) : NULL;
+    bootstrap_work_type * work_list;
+
+    if (bootstrap_data->doCV)
+      num_threads = bootstrap_enkf_get_cv_threads( num_threads , matrix_get_rows( A ) , ens_size );
+
+    work_list = util_calloc( num_threads , sizeof * work_list );
+
+    for (int thread_nr = 0; thread_nr < num_threads; thread_nr++) {
+      bootstrap_work_type * work = &work_list[thread_nr];
+      work->bootstrap_data = bootstrap_data;
+      work->thread_nr      = thread_nr;
+      work->num_threads    = num_threads;
+      work->A              = A;
+      work->A0             = A0;
+      work->S              = S;
+      work->R              = R;
+      work->dObs           = dObs;
+      work->E              = E;
+      work->D              = D;
+      work->iens_resample  = iens_resample;
+      work->rng_states     = rng_states;
+      bootstrap_work_init( work , ens_size , matrix_get_rows( S ) , matrix_get_rows( A0 ));
     }
 
+#ifdef ERT_HAVE_THREAD_POOL
+    if (num_threads > 1) {
+      thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+      for (int thread_nr = 0; thread_nr < num_threads; thread_nr++)
+        thread_pool_add_job( tp , bootstrap_enkf_update_members_mt , &work_list[thread_nr] );
+      thread_pool_join( tp );
+      thread_pool_free( tp );
+    } else
+#endif
+    {
+      for (int thread_nr = 0; thread_nr < num_threads; thread_nr++)
+        bootstrap_enkf_update_members_mt( &work_list[thread_nr] );
+    }
 
+    for (int thread_nr = 0; thread_nr < num_threads; thread_nr++)
+      bootstrap_work_free( &work_list[thread_nr] );
+    free( work_list );
+    free( rng_states );
     free_iens_resample( iens_resample , ens_size);
-    matrix_free( X );
-    matrix_free( S_resampled );
-    matrix_free( A_resampled );
     matrix_free( A0 );
   }
 }
@@ -224,7 +412,10 @@ bool bootstrap_enkf_set_double( void * arg , const char * var_name , double valu
 bool bootstrap_enkf_set_int( void * arg , const char * var_name , int value) {
   bootstrap_enkf_data_type * bootstrap_data = bootstrap_enkf_data_safe_cast( arg );
   {
-    if (std_enkf_set_int( bootstrap_data->std_enkf_data , var_name , value ))
+    if (strcmp( var_name , ANALYSIS_NUM_THREADS_VAR ) == 0) {
+      bootstrap_data->num_threads = util_int_max( value , 1 );
+      return true;
+    } else if (std_enkf_set_int( bootstrap_data->std_enkf_data , var_name , value ))
       return true;
     else {
       return false;
@@ -251,7 +442,10 @@ bool bootstrap_enkf_set_bool( void * arg , const char * var_name , bool value) {
 bool bootstrap_enkf_has_var( const void * arg, const char * var_name) {
     const bootstrap_enkf_data_type * module_data = bootstrap_enkf_data_safe_cast_const( arg );
     {
-      return std_enkf_has_var(module_data->std_enkf_data, var_name);
+      if (strcmp( var_name , ANALYSIS_NUM_THREADS_VAR ) == 0)
+        return true;
+      else
+        return std_enkf_has_var(module_data->std_enkf_data, var_name);
     }
 }
 
@@ -265,7 +459,10 @@ double bootstrap_enkf_get_double( const void * arg, const char * var_name) {
 int bootstrap_enkf_get_int( const void * arg, const char * var_name) {
     const bootstrap_enkf_data_type * module_data = bootstrap_enkf_data_safe_cast_const( arg );
     {
-      return std_enkf_get_int( module_data->std_enkf_data , var_name);
+      if (strcmp( var_name , ANALYSIS_NUM_THREADS_VAR ) == 0)
+        return module_data->num_threads;
+      else
+        return std_enkf_get_int( module_data->std_enkf_data , var_name);
     }
 }
 
@@ -6,6 +6,7 @@
 #include <ert/util/matrix_lapack.h>
 #include <ert/util/matrix_blas.h>
 #include <ert/util/util.h>
+#include <ert/util/rng.h>
 
 #include <ert/analysis/enkf_linalg.h>
 
@@ -44,6 +45,221 @@ void enkf_linalg_genX2(matrix_type * X2 , const matrix_type * S , const matrix_t
 
 
 
+/*
+  Randomized svd, following the range finder of Halko, Martinsson
+  and Tropp: "Finding structure with randomness: Probabilistic
+  algorithms for constructing approximate matrix decompositions",
+  SIAM Review 53 (2011).
+
+  The range of S is sampled with a gaussian test matrix of
+  ncomp + RSVD_OVERSAMPLING columns, sharpened with a few power
+  iterations, and the svd is then calculated for the small matrix
+  Q' * S, where Q is an orthonormal basis for the sampled range. For
+  a S matrix with many more observations than ensemble members, and
+  a truncation which keeps only a few components, this is much
+  cheaper than the full dgesvd.
+
+  The rng is seeded with the default seed for every call, i.e. the
+  result is reproducible.
+*/
+
+#define RSVD_OVERSAMPLING       10
+#define RSVD_POWER_ITERATIONS    2
+#define RSVD_MIN_COMPONENTS     16
+
+
+static void enkf_linalg_orthonormalize( matrix_type * Q ) {
+  int ncolumns = matrix_get_columns( Q );
+  double * tau = util_calloc( ncolumns , sizeof * tau );
+
+  matrix_dgeqrf( Q , tau );
+  matrix_dorgqr( Q , tau , ncolumns );
+  free( tau );
+}
+
+
+/*
+  Computes the @ncomp leading singular values and vectors of S. The
+  sig0, U0 and V0T arguments are as for the full svd, i.e. with room
+  for min(nrows , ncolumns) singular values; the singular values and
+  vectors beyond @ncomp are set to zero. If store_V0T == DGESVD_NONE
+  the V0T matrix is not accessed.
+*/
+
+void enkf_linalg_rsvd(const matrix_type * S ,
+                      int ncomp ,
+                      dgesvd_vector_enum store_V0T ,
+                      double * sig0 ,
+                      matrix_type * U0 ,
+                      matrix_type * V0T) {
+
+  const int nrows    = matrix_get_rows( S );
+  const int ncolumns = matrix_get_columns( S );
+  const int nrmin    = util_int_min( nrows , ncolumns );
+  const int nsample  = util_int_min( ncomp + RSVD_OVERSAMPLING , nrmin );
+  matrix_type * Q    = matrix_alloc( nrows , nsample );
+
+  if ((ncomp <= 0) || (ncomp > nrmin))
+    util_abort("%s: invalid number of components:%d \n",__func__ , ncomp);
+
+  /* Q = orth( S * Omega ) */
+  {
+    rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+    matrix_type * Omega = matrix_alloc( ncolumns , nsample );
+
+    for (int j=0; j < nsample; j++)
+      for (int i=0; i < ncolumns; i++)
+        matrix_iset( Omega , i , j , rng_std_normal( rng ));
+
+    matrix_matmul( Q , S , Omega );
+    enkf_linalg_orthonormalize( Q );
+
+    matrix_free( Omega );
+    rng_free( rng );
+  }
+
+  /* Power iterations: Q = orth( S * orth( S' * Q )) */
+  {
+    matrix_type * Z = matrix_alloc( ncolumns , nsample );
+    for (int iter = 0; iter < RSVD_POWER_ITERATIONS; iter++) {
+      matrix_dgemm( Z , S , Q , true , false , 1.0 , 0.0 );
+      enkf_linalg_orthonormalize( Z );
+      matrix_matmul( Q , S , Z );
+      enkf_linalg_orthonormalize( Q );
+    }
+    matrix_free( Z );
+  }
+
+  /* svd( Q' * S ) = UB * sig * VT  =>  S ~ (Q * UB) * sig * VT */
+  {
+    matrix_type * B   = matrix_alloc( nsample , ncolumns );
+    matrix_type * UB  = matrix_alloc( nsample , nsample );
+    matrix_type * VT  = NULL;
+    double * sig      = util_calloc( nsample , sizeof * sig );
+
+    if (store_V0T != DGESVD_NONE)
+      VT = matrix_alloc( nsample , ncolumns );
+
+    matrix_dgemm( B , Q , S , true , false , 1.0 , 0.0 );
+    matrix_dgesvd( DGESVD_MIN_RETURN , (VT == NULL) ? DGESVD_NONE : DGESVD_MIN_RETURN , B , sig , UB , VT );
+    {
+      matrix_type * U = matrix_alloc_matmul( Q , UB );
+
+      matrix_set( U0 , 0 );
+      for (int j=0; j < ncomp; j++)
+        matrix_copy_column( U0 , U , j , j );
+
+      if (VT != NULL) {
+        matrix_set( V0T , 0 );
+        for (int i=0; i < ncomp; i++)
+          matrix_copy_row( V0T , VT , i , i );
+      }
+
+      for (int i=0; i < nrmin; i++)
+        sig0[i] = (i < ncomp) ? sig[i] : 0;
+
+      matrix_free( U );
+    }
+
+    free( sig );
+    matrix_safe_free( VT );
+    matrix_free( UB );
+    matrix_free( B );
+  }
+  matrix_free( Q );
+}
+
+
+/*
+  The total of the singular value spectrum used when determining the
+  number of significant singular values with a truncation; when
+  @variance is true this is the sum of the squared singular values,
+  i.e. the squared Frobenius norm of S, otherwise it is the sum of the
+  singular values, which is calculated from the eigenvalues of the
+  smallest gram matrix of S.
+*/
+
+static double enkf_linalg_svd_total( const matrix_type * S , bool variance ) {
+  double total = 0;
+  if (variance) {
+    for (int j=0; j < matrix_get_columns( S ); j++)
+      for (int i=0; i < matrix_get_rows( S ); i++)
+        total += matrix_iget( S , i , j ) * matrix_iget( S , i , j );
+  } else {
+    bool col = (matrix_get_rows( S ) >= matrix_get_columns( S ));
+    matrix_type * G = matrix_alloc_gram( S , col );
+    int nrmin = matrix_get_rows( G );
+    double * eig = util_calloc( nrmin , sizeof * eig );
+    int num_eig = matrix_dsyevx( false , DSYEVX_ALL , DSYEVX_AUPPER , G , 0 , 0 , 0 , 0 , eig , NULL );
+
+    for (int i=0; i < num_eig; i++)
+      total += sqrt( util_double_max( eig[i] , 0 ));
+
+    free( eig );
+    matrix_free( G );
+  }
+  return total;
+}
+
+
+/*
+  The truncation part of enkf_linalg_svdS() and
+  enkf_linalg_svd_truncation() with the randomized svd. When the
+  number of components is given with ncomp only these are
+  calculated; otherwise the number of calculated components is
+  doubled until the truncation is satisfied, falling back to the
+  full svd when the randomized svd would calculate (almost) all the
+  components anyway. Returns the number of significant singular
+  values.
+*/
+
+static int enkf_linalg_rsvd_truncation__(const matrix_type * S ,
+                                         double truncation ,
+                                         int ncomp ,
+                                         dgesvd_vector_enum store_V0T ,
+                                         double * sig0 ,
+                                         matrix_type * U0 ,
+                                         matrix_type * V0T ,
+                                         bool variance) {
+
+  const int nrmin = util_int_min( matrix_get_rows( S ) , matrix_get_columns( S ));
+  if (ncomp > 0) {
+    enkf_linalg_rsvd( S , util_int_min( ncomp , nrmin ) , store_V0T , sig0 , U0 , V0T );
+    return ncomp;
+  } else {
+    double total = enkf_linalg_svd_total( S , variance );
+    int num_components = util_int_min( RSVD_MIN_COMPONENTS , nrmin );
+
+    while (true) {
+      int num_significant = 0;
+      double running_sigma = 0;
+
+      if (num_components + RSVD_OVERSAMPLING >= nrmin) {
+        matrix_type * workS = matrix_alloc_copy( S );
+        matrix_dgesvd(DGESVD_MIN_RETURN , store_V0T , workS , sig0 , U0 , V0T);
+        matrix_free( workS );
+        num_components = nrmin;
+      } else
+        enkf_linalg_rsvd( S , num_components , store_V0T , sig0 , U0 , V0T );
+
+      for (int i=0; i < num_components; i++) {
+        if (running_sigma / total < truncation) {  /* Include one more singular value ? */
+          num_significant++;
+          running_sigma += variance ? sig0[i] * sig0[i] : sig0[i];
+        } else
+          break;
+      }
+
+      if ((running_sigma / total >= truncation) || (num_components == nrmin))
+        return num_significant;
+
+      num_components = util_int_min( 2 * num_components , nrmin );
+    }
+  }
+}
+
+
+
 /**
    This function calculates the svd of the input matrix S. The number
    of significant singular values to retain can either be forced to a
@@ -67,6 +283,10 @@ void enkf_linalg_genX2(matrix_type * X2 , const matrix_type * S , const matrix_t
 
    The input S matrix should have been shifted to zero mean prior to
    calling this function.
+
+   With svd_method == ENKF_SVD_RANDOMIZED only the leading singular
+   values and vectors are calculated, see enkf_linalg_rsvd(); the
+   remaining singular values and vectors are set to zero.
 */
 
 
@@ -74,13 +294,14 @@ void enkf_linalg_genX2(matrix_type * X2 , const matrix_type * S , const matrix_t
 /*This function is similar to enkf_linalg_svdS but it returns the eigen values without its inverse and also give the matrices truncated U VT and Sig0*/
 
 // Trunc.SVD(S)  = U0 * Sig0 * V0T
-int enkf_linalg_svd_truncation(const matrix_type * S ,
-                               double truncation ,
-                               int ncomp ,
-                               dgesvd_vector_enum store_V0T ,
-                               double * sig0,
-                               matrix_type * U0 ,
-                               matrix_type * V0T) {
+int enkf_linalg_svd_truncation_method(const matrix_type * S ,
+                                      double truncation ,
+                                      int ncomp ,
+                                      dgesvd_vector_enum store_V0T ,
+                                      double * sig0,
+                                      matrix_type * U0 ,
+                                      matrix_type * V0T ,
+                                      enkf_svd_method_enum svd_method) {
 
   int num_significant = -1;
   int nrows = matrix_get_rows(S);
@@ -90,37 +311,43 @@ int enkf_linalg_svd_truncation(const matrix_type * S ,
       ((truncation < 0) && (ncomp > 0))) {
 
       int num_singular_values = util_int_min( matrix_get_rows( S ) , matrix_get_columns( S ));
-      {
-        matrix_type * workS = matrix_alloc_copy( S );
-        matrix_dgesvd(DGESVD_MIN_RETURN , store_V0T , workS , sig0 , U0 , V0T);
-        matrix_free( workS );
-      }
       int i;
 
-      if (ncomp > 0)
-        num_significant = ncomp;
+      if (svd_method == ENKF_SVD_RANDOMIZED)
+        num_significant = enkf_linalg_rsvd_truncation__( S , truncation , ncomp , store_V0T , sig0 , U0 , V0T , false );
       else {
-        double total_sigma2    = 0;
-        for (i=0; i < num_singular_values; i++)
-          total_sigma2 += sig0[i];
-
-        /*
-           Determine the number of singular values by enforcing that
-           less than a fraction @truncation of the total variance be
-           accounted for.
-        */
-        num_significant = 0;
         {
-          double running_sigma2  = 0;
-          for (i=0; i < num_singular_values; i++) {
-            if (running_sigma2 / total_sigma2 < truncation) {  /* Include one more singular value ? */
-              num_significant++;
-              running_sigma2 += sig0[i];
-            } else
-              break;
+          matrix_type * workS = matrix_alloc_copy( S );
+          matrix_dgesvd(DGESVD_MIN_RETURN , store_V0T , workS , sig0 , U0 , V0T);
+          matrix_free( workS );
+        }
+
+        if (ncomp > 0)
+          num_significant = ncomp;
+        else {
+          double total_sigma2    = 0;
+          for (i=0; i < num_singular_values; i++)
+            total_sigma2 += sig0[i];
+
+          /*
+             Determine the number of singular values by enforcing that
+             less than a fraction @truncation of the total variance be
+             accounted for.
+          */
+          num_significant = 0;
+          {
+            double running_sigma2  = 0;
+            for (i=0; i < num_singular_values; i++) {
+              if (running_sigma2 / total_sigma2 < truncation) {  /* Include one more singular value ? */
+                num_significant++;
+                running_sigma2 += sig0[i];
+              } else
+                break;
+            }
           }
         }
       }
+
       if (num_significant > 0) {
         matrix_resize(U0 , nrows , num_significant , true);
         matrix_resize(V0T , num_significant , ncolumns , true);
@@ -134,6 +361,17 @@ int enkf_linalg_svd_truncation(const matrix_type * S ,
 }
 
 
+int enkf_linalg_svd_truncation(const matrix_type * S ,
+                               double truncation ,
+                               int ncomp ,
+                               dgesvd_vector_enum store_V0T ,
+                               double * sig0,
+                               matrix_type * U0 ,
+                               matrix_type * V0T) {
+  return enkf_linalg_svd_truncation_method( S , truncation , ncomp , store_V0T , sig0 , U0 , V0T , ENKF_SVD_FULL );
+}
+
+
 static int enkf_linalg_num_significant(int num_singular_values , const double * sig0 , double truncation ) {
   int num_significant  = 0;
   double total_sigma2  = 0;
@@ -160,13 +398,14 @@ static int enkf_linalg_num_significant(int num_singular_values , const double *
 }
 
 
-int enkf_linalg_svdS(const matrix_type * S ,
-		     double truncation ,
-		     int ncomp ,
-		     dgesvd_vector_enum store_V0T ,
-		     double * inv_sig0,
-		     matrix_type * U0 ,
-		     matrix_type * V0T) {
+int enkf_linalg_svdS_method(const matrix_type * S ,
+                            double truncation ,
+                            int ncomp ,
+                            dgesvd_vector_enum store_V0T ,
+                            double * inv_sig0,
+                            matrix_type * U0 ,
+                            matrix_type * V0T ,
+                            enkf_svd_method_enum svd_method) {
 
   double * sig0 = inv_sig0;
   int    num_significant = 0;
@@ -175,16 +414,20 @@ int enkf_linalg_svdS(const matrix_type * S ,
   if (((truncation > 0) && (ncomp < 0)) ||
       ((truncation < 0) && (ncomp > 0))) {
       int num_singular_values = util_int_min( matrix_get_rows( S ) , matrix_get_columns( S ));
-      {
-        matrix_type * workS = matrix_alloc_copy( S );
-        matrix_dgesvd(DGESVD_MIN_RETURN , store_V0T , workS , sig0 , U0 , V0T);
-        matrix_free( workS );
-      }
+      if (svd_method == ENKF_SVD_RANDOMIZED)
+        num_significant = enkf_linalg_rsvd_truncation__( S , truncation , ncomp , store_V0T , sig0 , U0 , V0T , true );
+      else {
+        {
+          matrix_type * workS = matrix_alloc_copy( S );
+          matrix_dgesvd(DGESVD_MIN_RETURN , store_V0T , workS , sig0 , U0 , V0T);
+          matrix_free( workS );
+        }
 
-      if (ncomp > 0)
-        num_significant = ncomp;
-      else
-        num_significant = enkf_linalg_num_significant( num_singular_values , sig0 , truncation );
+        if (ncomp > 0)
+          num_significant = ncomp;
+        else
+          num_significant = enkf_linalg_num_significant( num_singular_values , sig0 , truncation );
+      }
 
       {
 	int i;
@@ -204,6 +447,17 @@ int enkf_linalg_svdS(const matrix_type * S ,
 }
 
 
+int enkf_linalg_svdS(const matrix_type * S ,
+		     double truncation ,
+		     int ncomp ,
+		     dgesvd_vector_enum store_V0T ,
+		     double * inv_sig0,
+		     matrix_type * U0 ,
+		     matrix_type * V0T) {
+  return enkf_linalg_svdS_method( S , truncation , ncomp , store_V0T , inv_sig0 , U0 , V0T , ENKF_SVD_FULL );
+}
+
+
 int enkf_linalg_num_PC(const matrix_type * S , double truncation ) {
   int num_singular_values = util_int_min( matrix_get_rows( S ) , matrix_get_columns( S ));
   int num_significant;
@@ -324,14 +578,15 @@ void enkf_linalg_Cee(matrix_type * B, int nrens , const matrix_type * R , const
 
 
 
-void enkf_linalg_lowrankCinv__(const matrix_type * S ,
-                               const matrix_type * R ,
-                               matrix_type * V0T ,
-                               matrix_type * Z,
-                               double * eig ,
-                               matrix_type * U0,
-                               double truncation,
-                               int ncomp) {
+void enkf_linalg_lowrankCinv_method__(const matrix_type * S ,
+                                      const matrix_type * R ,
+                                      matrix_type * V0T ,
+                                      matrix_type * Z,
+                                      double * eig ,
+                                      matrix_type * U0,
+                                      double truncation,
+                                      int ncomp,
+                                      enkf_svd_method_enum svd_method) {
 
   const int nrobs = matrix_get_rows( S );
   const int nrens = matrix_get_columns( S );
@@ -340,9 +595,9 @@ void enkf_linalg_lowrankCinv__(const matrix_type * S ,
   double * inv_sig0      = util_calloc( nrmin , sizeof * inv_sig0);
 
   if (V0T != NULL)
-    enkf_linalg_svdS(S , truncation , ncomp , DGESVD_MIN_RETURN , inv_sig0 , U0 , V0T );
+    enkf_linalg_svdS_method(S , truncation , ncomp , DGESVD_MIN_RETURN , inv_sig0 , U0 , V0T , svd_method);
   else
-    enkf_linalg_svdS(S , truncation , ncomp , DGESVD_NONE , inv_sig0, U0 , NULL);
+    enkf_linalg_svdS_method(S , truncation , ncomp , DGESVD_NONE , inv_sig0, U0 , NULL , svd_method);
 
   {
     matrix_type * B    = matrix_alloc( nrmin , nrmin );
@@ -366,12 +621,25 @@ void enkf_linalg_lowrankCinv__(const matrix_type * S ,
 }
 
 
-void enkf_linalg_lowrankCinv(const matrix_type * S ,
-                             const matrix_type * R ,
-                             matrix_type * W       , /* Corresponding to X1 from Eq. 14.29 */
-                             double * eig          , /* Corresponding to 1 / (1 + Lambda_1) (14.29) */
-                             double truncation     ,
-                             int    ncomp) {
+void enkf_linalg_lowrankCinv__(const matrix_type * S ,
+                               const matrix_type * R ,
+                               matrix_type * V0T ,
+                               matrix_type * Z,
+                               double * eig ,
+                               matrix_type * U0,
+                               double truncation,
+                               int ncomp) {
+  enkf_linalg_lowrankCinv_method__( S , R , V0T , Z , eig , U0 , truncation , ncomp , ENKF_SVD_FULL );
+}
+
+
+void enkf_linalg_lowrankCinv_method(const matrix_type * S ,
+                                    const matrix_type * R ,
+                                    matrix_type * W       , /* Corresponding to X1 from Eq. 14.29 */
+                                    double * eig          , /* Corresponding to 1 / (1 + Lambda_1) (14.29) */
+                                    double truncation     ,
+                                    int    ncomp          ,
+                                    enkf_svd_method_enum svd_method) {
 
   const int nrobs = matrix_get_rows( S );
   const int nrens = matrix_get_columns( S );
@@ -380,7 +648,7 @@ void enkf_linalg_lowrankCinv(const matrix_type * S ,
   matrix_type * U0   = matrix_alloc( nrobs , nrmin );
   matrix_type * Z    = matrix_alloc( nrmin , nrmin );
 
-  enkf_linalg_lowrankCinv__( S , R , NULL , Z , eig , U0 , truncation , ncomp);
+  enkf_linalg_lowrankCinv_method__( S , R , NULL , Z , eig , U0 , truncation , ncomp , svd_method);
   matrix_matmul(W , U0 , Z); /* X1 = W = U0 * Z2 = U0 * Sigma0^(+') * Z    */
 
   matrix_free( U0 );
@@ -388,6 +656,16 @@ void enkf_linalg_lowrankCinv(const matrix_type * S ,
 }
 
 
+void enkf_linalg_lowrankCinv(const matrix_type * S ,
+                             const matrix_type * R ,
+                             matrix_type * W       , /* Corresponding to X1 from Eq. 14.29 */
+                             double * eig          , /* Corresponding to 1 / (1 + Lambda_1) (14.29) */
+                             double truncation     ,
+                             int    ncomp) {
+  enkf_linalg_lowrankCinv_method( S , R , W , eig , truncation , ncomp , ENKF_SVD_FULL );
+}
+
+
 void enkf_linalg_meanX5(const matrix_type * S ,
                         const matrix_type * W ,
                         const double * eig    ,
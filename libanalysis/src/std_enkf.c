@@ -54,6 +54,7 @@
 #define DEFAULT_USE_EE              false
 #define DEFAULT_USE_GE              false
 #define DEFAULT_ANALYSIS_SCALE_DATA true
+#define DEFAULT_SVD_METHOD          ENKF_SVD_FULL
 
 
 
@@ -89,6 +90,7 @@ struct std_enkf_data_struct {
   bool      use_EE;
   bool      use_GE;
   bool      analysis_scale_data;
+  enkf_svd_method_enum svd_method;  // Controlled by config key: RANDOMIZED_SVD_KEY
 };
 
 static UTIL_SAFE_CAST_FUNCTION_CONST( std_enkf_data , STD_ENKF_TYPE_ID )
@@ -137,6 +139,7 @@ void * std_enkf_data_alloc( rng_type * rng) {
   data->use_EE = DEFAULT_USE_EE;
   data->use_GE = DEFAULT_USE_GE;
   data->analysis_scale_data = DEFAULT_ANALYSIS_SCALE_DATA;
+  data->svd_method = DEFAULT_SVD_METHOD;
   return data;
 }
 
@@ -157,7 +160,8 @@ static void std_enkf_initX__( matrix_type * X ,
                               int    ncomp,
                               bool   bootstrap ,
                               bool   use_EE ,
-                              bool   use_GE) {
+                              bool   use_GE ,
+                              enkf_svd_method_enum svd_method) {
 
   int nrobs         = matrix_get_rows( S );
   int ens_size      = matrix_get_columns( S );
@@ -177,7 +181,7 @@ static void std_enkf_initX__( matrix_type * X ,
        matrix_type * Cee = matrix_alloc_matmul( E , Et );
        matrix_scale( Cee , 1.0 / (ens_size - 1));
 
-       enkf_linalg_lowrankCinv( S , Cee , W , eig , truncation , ncomp);
+       enkf_linalg_lowrankCinv_method( S , Cee , W , eig , truncation , ncomp , svd_method);
 
        matrix_free( Et );
        matrix_free( Cee );
@@ -185,7 +189,7 @@ static void std_enkf_initX__( matrix_type * X ,
 
   }
   else {
-    enkf_linalg_lowrankCinv( S , R , W , eig , truncation , ncomp);
+    enkf_linalg_lowrankCinv_method( S , R , W , eig , truncation , ncomp , svd_method);
   }
 
   enkf_linalg_init_stdX( X , S , D , W , eig , bootstrap);
@@ -214,7 +218,7 @@ void std_enkf_initX(void * module_data ,
     int ncomp         = data->subspace_dimension;
     double truncation = data->truncation;
 
-    std_enkf_initX__(X,S,R,E,D,truncation,ncomp,false,data->use_EE,data->use_GE);
+    std_enkf_initX__(X,S,R,E,D,truncation,ncomp,false,data->use_EE,data->use_GE,data->svd_method);
   }
 }
 
@@ -265,6 +269,8 @@ bool std_enkf_set_bool( void * arg , const char * var_name , bool value) {
       module_data->use_GE = value;
     else if (strcmp( var_name , ANALYSIS_SCALE_DATA_KEY_) == 0)
       module_data->analysis_scale_data = value;
+    else if (strcmp( var_name , RANDOMIZED_SVD_KEY_) == 0)
+      module_data->svd_method = value ? ENKF_SVD_RANDOMIZED : ENKF_SVD_FULL;
     else
       name_recognized = false;
 
@@ -292,6 +298,8 @@ bool std_enkf_has_var( const void * arg, const char * var_name) {
       return true;
     else if (strcmp(var_name , ANALYSIS_SCALE_DATA_KEY_) == 0)
       return true;
+    else if (strcmp(var_name , RANDOMIZED_SVD_KEY_) == 0)
+      return true;
     else
       return false;
   }
@@ -327,6 +335,8 @@ bool std_enkf_get_bool( const void * arg, const char * var_name) {
       return module_data->use_GE;
     else if (strcmp(var_name , ANALYSIS_SCALE_DATA_KEY_) == 0)
       return module_data->analysis_scale_data;
+    else if (strcmp(var_name , RANDOMIZED_SVD_KEY_) == 0)
+      return (module_data->svd_method == ENKF_SVD_RANDOMIZED);
     else
       return false;
   }
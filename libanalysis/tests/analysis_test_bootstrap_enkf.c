@@ -0,0 +1,171 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'analysis_test_bootstrap_enkf.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/matrix.h>
+
+#include <ert/analysis/analysis_module.h>
+#include <ert/analysis/std_enkf.h>
+
+#define ENS_SIZE    20
+#define NROBS       10
+#define STATE_SIZE  50
+
+
+typedef struct {
+  matrix_type * A;
+  matrix_type * S;
+  matrix_type * R;
+  matrix_type * dObs;
+  matrix_type * E;
+  matrix_type * D;
+} update_data_type;
+
+
+static void init_data( update_data_type * data ) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+
+  data->A    = matrix_alloc( STATE_SIZE , ENS_SIZE );
+  data->S    = matrix_alloc( NROBS , ENS_SIZE );
+  data->R    = matrix_alloc( NROBS , NROBS );
+  data->dObs = matrix_alloc( NROBS , 2 );
+  data->E    = matrix_alloc( NROBS , ENS_SIZE );
+  data->D    = matrix_alloc( NROBS , ENS_SIZE );
+
+  matrix_random_init( data->A , rng );
+  matrix_shift( data->A , 10 );
+  matrix_random_init( data->S , rng );
+  matrix_random_init( data->E , rng );
+  matrix_random_init( data->D , rng );
+  matrix_random_init( data->dObs , rng );
+  matrix_diag_set_scalar( data->R , 1.0 );
+
+  rng_free( rng );
+}
+
+
+static void free_data( update_data_type * data ) {
+  matrix_free( data->A );
+  matrix_free( data->S );
+  matrix_free( data->R );
+  matrix_free( data->dObs );
+  matrix_free( data->E );
+  matrix_free( data->D );
+}
+
+
+static matrix_type * alloc_update( const update_data_type * data , int num_threads , bool cv) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  analysis_module_type * module = analysis_module_alloc_internal( rng , "BOOTSTRAP_ENKF" );
+  matrix_type * A = matrix_alloc_copy( data->A );
+  matrix_type * S = matrix_alloc_copy( data->S );
+  char * num_threads_string = util_alloc_sprintf( "%d" , num_threads );
+
+  test_assert_true( analysis_module_set_var( module , ANALYSIS_NUM_THREADS_VAR , num_threads_string ));
+  test_assert_true( analysis_module_set_var( module , "CV" , cv ? "True" : "False" ));
+  analysis_module_updateA( module , A , S , data->R , data->dObs , data->E , data->D , NULL );
+
+  free( num_threads_string );
+  matrix_free( S );
+  analysis_module_free( module );
+  rng_free( rng );
+  return A;
+}
+
+
+/*
+  The original implementation: the full resampled ensemble is
+  updated for each member, and one column is kept.
+*/
+
+static matrix_type * alloc_reference_update( const update_data_type * data ) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  void * std_data = std_enkf_data_alloc( NULL );
+  matrix_type * A = matrix_alloc_copy( data->A );
+  matrix_type * X = matrix_alloc( ENS_SIZE , ENS_SIZE );
+  matrix_type * S_resampled = matrix_alloc_copy( data->S );
+  matrix_type * A_resampled = matrix_alloc_copy( data->A );
+  int iens_resample[ENS_SIZE][ENS_SIZE];
+
+  for (int i = 0; i < ENS_SIZE; i++)
+    for (int j = 0; j < ENS_SIZE; j++)
+      iens_resample[i][j] = rng_get_int( rng , ENS_SIZE );
+
+  std_enkf_set_truncation( std_data , 0.95 );
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    for (int k = 0; k < ENS_SIZE; k++) {
+      matrix_copy_column( A_resampled , data->A , k , iens_resample[iens][k] );
+      matrix_copy_column( S_resampled , data->S , k , iens_resample[iens][k] );
+    }
+    std_enkf_initX( std_data , X , NULL , S_resampled , data->R , data->dObs , data->E , data->D );
+    matrix_inplace_matmul( A_resampled , X );
+    matrix_inplace_add( A_resampled , data->A );
+    matrix_copy_column( A , A_resampled , iens , iens );
+  }
+
+  matrix_free( A_resampled );
+  matrix_free( S_resampled );
+  matrix_free( X );
+  std_enkf_data_free( std_data );
+  rng_free( rng );
+  return A;
+}
+
+
+static void test_equal( const matrix_type * A1 , const matrix_type * A2 ) {
+  for (int i = 0; i < STATE_SIZE; i++)
+    for (int j = 0; j < ENS_SIZE; j++)
+      test_assert_double_equal( matrix_iget( A1 , i , j ) , matrix_iget( A2 , i , j ));
+}
+
+
+int main(int argc , char ** argv) {
+  update_data_type data;
+  init_data( &data );
+
+  {
+    matrix_type * A_ref = alloc_reference_update( &data );
+    matrix_type * A1 = alloc_update( &data , 1 , false );
+    matrix_type * A4 = alloc_update( &data , 4 , false );
+
+    test_assert_false( matrix_equal( A1 , data.A ));
+    test_equal( A_ref , A1 );
+    test_assert_true( matrix_equal( A1 , A4 ));
+
+    matrix_free( A_ref );
+    matrix_free( A1 );
+    matrix_free( A4 );
+  }
+
+  {
+    matrix_type * A1 = alloc_update( &data , 1 , true );
+    matrix_type * A3 = alloc_update( &data , 3 , true );
+
+    test_assert_true( matrix_equal( A1 , A3 ));
+
+    matrix_free( A1 );
+    matrix_free( A3 );
+  }
+
+  free_data( &data );
+  exit(0);
+}
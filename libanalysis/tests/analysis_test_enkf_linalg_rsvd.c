@@ -0,0 +1,263 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'analysis_test_enkf_linalg_rsvd.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/matrix.h>
+#include <ert/util/matrix_blas.h>
+#include <ert/util/matrix_lapack.h>
+
+#include <ert/analysis/enkf_linalg.h>
+
+
+static void orthonormal_init( matrix_type * Q , rng_type * rng ) {
+  int ncolumns = matrix_get_columns( Q );
+  double * tau = util_calloc( ncolumns , sizeof * tau );
+
+  for (int j=0; j < ncolumns; j++)
+    for (int i=0; i < matrix_get_rows( Q ); i++)
+      matrix_iset( Q , i , j , rng_std_normal( rng ));
+
+  matrix_dgeqrf( Q , tau );
+  matrix_dorgqr( Q , tau , ncolumns );
+  free( tau );
+}
+
+
+/*
+  S = U * diag(sig) * V' with random orthonormal U and V, and
+  singular values decaying geometrically with @decay.
+*/
+
+static matrix_type * alloc_S( int nrobs , int ens_size , double decay ) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  int nrmin = util_int_min( nrobs , ens_size );
+  matrix_type * U = matrix_alloc( nrobs , nrmin );
+  matrix_type * V = matrix_alloc( ens_size , nrmin );
+  matrix_type * S = matrix_alloc( nrobs , ens_size );
+
+  orthonormal_init( U , rng );
+  orthonormal_init( V , rng );
+  for (int j=0; j < nrmin; j++)
+    matrix_scale_column( U , j , 100 * pow( decay , j ));
+
+  matrix_dgemm( S , U , V , false , true , 1.0 , 0.0 );
+
+  matrix_free( V );
+  matrix_free( U );
+  rng_free( rng );
+  return S;
+}
+
+
+static void full_svd( const matrix_type * S , double * sig , matrix_type * U ) {
+  matrix_type * workS = matrix_alloc_copy( S );
+  matrix_dgesvd( DGESVD_MIN_RETURN , DGESVD_NONE , workS , sig , U , NULL );
+  matrix_free( workS );
+}
+
+
+static double column_dot( const matrix_type * U1 , const matrix_type * U2 , int col ) {
+  double dot = 0;
+  for (int i=0; i < matrix_get_rows( U1 ); i++)
+    dot += matrix_iget( U1 , i , col ) * matrix_iget( U2 , i , col );
+  return dot;
+}
+
+
+/*
+  The leading singular values and (up to sign) singular vectors from
+  the randomized svd should agree with the full svd.
+*/
+
+static void test_rsvd( ) {
+  const int nrobs = 300;
+  const int ens_size = 60;
+  const int ncomp = 20;
+  matrix_type * S = alloc_S( nrobs , ens_size , 0.7 );
+  matrix_type * U_full = matrix_alloc( nrobs , ens_size );
+  matrix_type * U_rsvd = matrix_alloc( nrobs , ens_size );
+  matrix_type * VT_rsvd = matrix_alloc( ens_size , ens_size );
+  double * sig_full = util_calloc( ens_size , sizeof * sig_full );
+  double * sig_rsvd = util_calloc( ens_size , sizeof * sig_rsvd );
+
+  full_svd( S , sig_full , U_full );
+  enkf_linalg_rsvd( S , ncomp , DGESVD_MIN_RETURN , sig_rsvd , U_rsvd , VT_rsvd );
+
+  for (int i=0; i < ncomp; i++) {
+    test_assert_true( fabs( sig_rsvd[i] - sig_full[i] ) <= 1e-8 * sig_full[0] );
+    test_assert_true( fabs( fabs( column_dot( U_full , U_rsvd , i )) - 1 ) < 1e-6 );
+  }
+  for (int i=ncomp; i < ens_size; i++) {
+    test_assert_double_equal( sig_rsvd[i] , 0 );
+    test_assert_double_equal( matrix_iget( U_rsvd , 0 , i ) , 0 );
+  }
+
+  /* U * sig * VT reproduces S to the accuracy of the truncation. */
+  {
+    matrix_type * US = matrix_alloc_copy( U_rsvd );
+    matrix_type * S2 = matrix_alloc( nrobs , ens_size );
+    double max_diff = 0;
+
+    for (int j=0; j < ens_size; j++)
+      matrix_scale_column( US , j , sig_rsvd[j] );
+    matrix_matmul( S2 , US , VT_rsvd );
+    for (int j=0; j < ens_size; j++)
+      for (int i=0; i < nrobs; i++)
+        max_diff = util_double_max( max_diff , fabs( matrix_iget( S , i , j ) - matrix_iget( S2 , i , j )));
+
+    test_assert_true( max_diff < 2 * sig_full[ncomp] );
+    matrix_free( S2 );
+    matrix_free( US );
+  }
+
+  free( sig_rsvd );
+  free( sig_full );
+  matrix_free( VT_rsvd );
+  matrix_free( U_rsvd );
+  matrix_free( U_full );
+  matrix_free( S );
+}
+
+
+/*
+  With a truncation the randomized svdS() and svd_truncation() should
+  retain the same number of singular values as the full svd.
+*/
+
+static void test_truncation( int nrobs , int ens_size , double truncation ) {
+  matrix_type * S = alloc_S( nrobs , ens_size , 0.8 );
+  int nrmin = util_int_min( nrobs , ens_size );
+  matrix_type * U_full = matrix_alloc( nrobs , nrmin );
+  matrix_type * U_rsvd = matrix_alloc( nrobs , nrmin );
+  double * sig_full = util_calloc( nrmin , sizeof * sig_full );
+  double * sig_rsvd = util_calloc( nrmin , sizeof * sig_rsvd );
+
+  {
+    int num_full = enkf_linalg_svdS_method( S , truncation , -1 , DGESVD_NONE , sig_full , U_full , NULL , ENKF_SVD_FULL );
+    int num_rsvd = enkf_linalg_svdS_method( S , truncation , -1 , DGESVD_NONE , sig_rsvd , U_rsvd , NULL , ENKF_SVD_RANDOMIZED );
+
+    test_assert_int_equal( num_full , num_rsvd );
+    for (int i=0; i < nrmin; i++) {
+      test_assert_true( fabs( sig_full[i] - sig_rsvd[i] ) <= 1e-8 * sig_full[i] );
+      if (i < num_full)
+        test_assert_true( fabs( fabs( column_dot( U_full , U_rsvd , i )) - 1 ) < 1e-6 );
+    }
+  }
+
+  /* The plain enkf_linalg_svdS() is the full svd. */
+  {
+    int num_plain = enkf_linalg_svdS( S , truncation , -1 , DGESVD_NONE , sig_rsvd , U_rsvd , NULL );
+    int num_full = enkf_linalg_svdS_method( S , truncation , -1 , DGESVD_NONE , sig_full , U_full , NULL , ENKF_SVD_FULL );
+
+    test_assert_int_equal( num_full , num_plain );
+    for (int i=0; i < nrmin; i++)
+      test_assert_double_equal( sig_full[i] , sig_rsvd[i] );
+  }
+
+  /* svd_truncation() resizes U0 and V0T to the retained components. */
+  {
+    matrix_type * VT_full = matrix_alloc( nrmin , ens_size );
+    matrix_type * VT_rsvd = matrix_alloc( nrmin , ens_size );
+    int num_full = enkf_linalg_svd_truncation_method( S , truncation , -1 , DGESVD_MIN_RETURN , sig_full , U_full , VT_full , ENKF_SVD_FULL );
+    int num_rsvd = enkf_linalg_svd_truncation_method( S , truncation , -1 , DGESVD_MIN_RETURN , sig_rsvd , U_rsvd , VT_rsvd , ENKF_SVD_RANDOMIZED );
+
+    test_assert_int_equal( num_full , num_rsvd );
+    test_assert_int_equal( matrix_get_columns( U_rsvd ) , num_full );
+    test_assert_int_equal( matrix_get_rows( VT_rsvd ) , num_full );
+    for (int i=0; i < num_full; i++)
+      test_assert_true( fabs( sig_full[i] - sig_rsvd[i] ) <= 1e-8 * sig_full[0] );
+
+    matrix_free( VT_rsvd );
+    matrix_free( VT_full );
+  }
+
+  free( sig_rsvd );
+  free( sig_full );
+  matrix_free( U_rsvd );
+  matrix_free( U_full );
+  matrix_free( S );
+}
+
+
+/*
+  The low rank inverse used by std_enkf; W * diag(eig) * W' does not
+  depend on the sign of the singular vectors.
+*/
+
+static matrix_type * alloc_Cinv( const matrix_type * S , const matrix_type * R , double truncation , enkf_svd_method_enum svd_method ) {
+  int nrobs = matrix_get_rows( S );
+  int nrmin = util_int_min( nrobs , matrix_get_columns( S ));
+  matrix_type * W = matrix_alloc( nrobs , nrmin );
+  matrix_type * WE = matrix_alloc( nrobs , nrmin );
+  matrix_type * Cinv = matrix_alloc( nrobs , nrobs );
+  double * eig = util_calloc( nrmin , sizeof * eig );
+
+  enkf_linalg_lowrankCinv_method( S , R , W , eig , truncation , -1 , svd_method );
+  matrix_assign( WE , W );
+  for (int j=0; j < nrmin; j++)
+    matrix_scale_column( WE , j , eig[j] );
+  matrix_dgemm( Cinv , WE , W , false , true , 1.0 , 0.0 );
+
+  free( eig );
+  matrix_free( WE );
+  matrix_free( W );
+  return Cinv;
+}
+
+
+static void test_lowrankCinv( ) {
+  const int nrobs = 200;
+  const int ens_size = 60;
+  matrix_type * S = alloc_S( nrobs , ens_size , 0.8 );
+  matrix_type * R = matrix_alloc( nrobs , nrobs );
+  matrix_diag_set_scalar( R , 0.01 );
+  {
+    matrix_type * Cinv_full = alloc_Cinv( S , R , 0.99 , ENKF_SVD_FULL );
+    matrix_type * Cinv_rsvd = alloc_Cinv( S , R , 0.99 , ENKF_SVD_RANDOMIZED );
+    double max_value = 0;
+    double max_diff = 0;
+
+    for (int j=0; j < nrobs; j++)
+      for (int i=0; i < nrobs; i++) {
+        max_value = util_double_max( max_value , fabs( matrix_iget( Cinv_full , i , j )));
+        max_diff = util_double_max( max_diff , fabs( matrix_iget( Cinv_full , i , j ) - matrix_iget( Cinv_rsvd , i , j )));
+      }
+    test_assert_true( max_diff < 1e-6 * max_value );
+
+    matrix_free( Cinv_full );
+    matrix_free( Cinv_rsvd );
+  }
+  matrix_free( R );
+  matrix_free( S );
+}
+
+
+int main(int argc , char ** argv) {
+  test_rsvd( );
+  test_truncation( 300 , 60 , 0.99 );
+  test_truncation( 300 , 60 , 0.999999 );
+  test_truncation( 50 , 100 , 0.99 );
+  test_lowrankCinv( );
+  exit(0);
+}
@@ -0,0 +1,174 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'grid_xyz_index_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/timer.h>
+#include <ert/util/rng.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+/*
+  Microbenchmark comparing ecl_grid_get_global_index_from_xyz_batch()
+  with a linear scan over all cells for random points in and around
+  a nx x ny x nz grid. The time to build the index is included in the
+  index timing.
+*/
+
+
+static ecl_grid_type * alloc_grid( int nx , int ny , int nz ) {
+  const int size = nx*ny*nz;
+  double * dx = util_calloc( size , sizeof * dx );
+  double * dy = util_calloc( size , sizeof * dy );
+  double * dz = util_calloc( size , sizeof * dz );
+  double * tops = util_calloc( size , sizeof * tops );
+
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny; j++) {
+      for (int i = 0; i < nx; i++) {
+        int g = i + j*nx + k*nx*ny;
+        dx[g] = 50 + 10 * (i % 3);
+        dy[g] = 40 + 5 * (j % 4);
+        dz[g] = 2 + 0.5 * (k % 2) + 0.1 * (i % 20);
+
+        if (k == 0)
+          tops[g] = 1000 + 10 * sin( 0.3 * i ) + 5 * (j % 5);
+        else
+          tops[g] = tops[g - nx*ny] + dz[g - nx*ny];
+      }
+    }
+  }
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_dx_dy_dz_tops( nx , ny , nz , dx , dy , dz , tops , NULL );
+    free( dx );
+    free( dy );
+    free( dz );
+    free( tops );
+    return grid;
+  }
+}
+
+
+static int linear_scan( const ecl_grid_type * grid , double x , double y , double z) {
+  for (int g = 0; g < ecl_grid_get_global_size( grid ); g++) {
+    if (ecl_grid_cell_contains_xyz1( grid , g , x , y , z ))
+      return g;
+  }
+  return -1;
+}
+
+
+static void bench_grid( const ecl_grid_type * grid , int num_points ) {
+  int nx = ecl_grid_get_nx( grid );
+  int ny = ecl_grid_get_ny( grid );
+  int nz = ecl_grid_get_nz( grid );
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  double * x = util_calloc( num_points , sizeof * x );
+  double * y = util_calloc( num_points , sizeof * y );
+  double * z = util_calloc( num_points , sizeof * z );
+  int * scan_index = util_calloc( num_points , sizeof * scan_index );
+  int * batch_index = util_calloc( num_points , sizeof * batch_index );
+  timer_type * scan_timer = timer_alloc( true );
+  timer_type * index_timer = timer_alloc( true );
+  int found = 0;
+
+  {
+    double xmin , ymin , zmin , xmax , ymax , zmax;
+    ecl_grid_get_cell_corner_xyz3( grid , 0 , 0 , 0 , 0 , &xmin , &ymin , &zmin );
+    ecl_grid_get_cell_corner_xyz3( grid , nx - 1 , ny - 1 , nz - 1 , 7 , &xmax , &ymax , &zmax );
+    xmin -= 10; ymin -= 10; zmin = 980;
+    xmax += 10; ymax += 10; zmax += 30;
+
+    for (int ip = 0; ip < num_points; ip++) {
+      x[ip] = xmin + (xmax - xmin) * rng_get_double( rng );
+      y[ip] = ymin + (ymax - ymin) * rng_get_double( rng );
+      z[ip] = zmin + (zmax - zmin) * rng_get_double( rng );
+    }
+  }
+
+  timer_start( scan_timer );
+  for (int ip = 0; ip < num_points; ip++)
+    scan_index[ip] = linear_scan( grid , x[ip] , y[ip] , z[ip] );
+  timer_stop( scan_timer );
+
+  timer_start( index_timer );
+  ecl_grid_get_global_index_from_xyz_batch( grid , num_points , x , y , z , batch_index );
+  timer_stop( index_timer );
+
+  for (int ip = 0; ip < num_points; ip++) {
+    if (scan_index[ip] != batch_index[ip])
+      util_abort("%s: point %d: linear scan found cell %d, index found cell %d \n",__func__ , ip , scan_index[ip] , batch_index[ip]);
+    if (scan_index[ip] >= 0)
+      found++;
+  }
+
+  printf("Grid %dx%dx%d, %d points (%d inside): linear scan:%10.3f ms  index:%10.3f ms\n",
+         nx , ny , nz , num_points , found ,
+         1000 * timer_get_total_time( scan_timer ) ,
+         1000 * timer_get_total_time( index_timer ));
+
+  timer_free( scan_timer );
+  timer_free( index_timer );
+  free( batch_index );
+  free( scan_index );
+  free( x );
+  free( y );
+  free( z );
+  rng_free( rng );
+}
+
+
+static int usage( void ) {
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Usage:\n\n");
+  fprintf(stderr,"   bash%% grid_xyz_index_bench [num_points [nx ny nz]]\n\n");
+  fprintf(stderr,"Will time looking up num_points random points, default 2000, in a nx x ny x nz grid, default 40 x 30 x 20.\n");
+  exit(1);
+}
+
+
+int main(int argc , char ** argv) {
+  int num_points = 2000;
+  int nx = 40;
+  int ny = 30;
+  int nz = 20;
+
+  if (argc != 1 && argc != 2 && argc != 5)
+    usage();
+
+  if (argc >= 2 && !(util_sscanf_int( argv[1] , &num_points ) && num_points > 0))
+    usage();
+
+  if (argc == 5) {
+    if (!(util_sscanf_int( argv[2] , &nx ) && util_sscanf_int( argv[3] , &ny ) && util_sscanf_int( argv[4] , &nz )))
+      usage();
+    if (nx <= 0 || ny <= 0 || nz <= 0)
+      usage();
+  }
+
+  {
+    ecl_grid_type * grid = alloc_grid( nx , ny , nz );
+    bench_grid( grid , num_points );
+    ecl_grid_free( grid );
+  }
+  exit(0);
+}
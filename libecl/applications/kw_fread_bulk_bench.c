@@ -0,0 +1,142 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'kw_fread_bulk_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/util.h>
+#include <ert/util/timer.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+/*
+  Microbenchmark comparing ecl_kw_fread_data_bulk() with
+  ecl_kw_fread_data(), with plain and memory mapped fortio
+  instances. The best of NUM_REPEAT reads is reported. Observe that
+  the bulk reader only unpacks the records in parallel when libecl has
+  been built with OpenMP.
+*/
+
+#define NUM_REPEAT 5
+
+
+static void write_kw( const char * filename , const ecl_kw_type * ecl_kw ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  ecl_kw_fwrite( ecl_kw , fortio );
+  fortio_fclose( fortio );
+}
+
+
+static fortio_type * open_reader( const char * filename , bool use_mmap ) {
+  if (use_mmap)
+    return fortio_open_reader_mmap( filename , false , ECL_ENDIAN_FLIP );
+  else
+    return fortio_open_reader( filename , false , ECL_ENDIAN_FLIP );
+}
+
+
+static double read_kw( const char * filename , const ecl_kw_type * src_kw , bool use_mmap , bool bulk) {
+  timer_type * timer = timer_alloc( true );
+  int i;
+
+  for (i=0; i < NUM_REPEAT; i++) {
+    fortio_type * fortio = open_reader( filename , use_mmap );
+    ecl_kw_type * ecl_kw = ecl_kw_alloc_empty( );
+    bool read_ok;
+
+    timer_start( timer );
+    read_ok = (ecl_kw_fread_header( ecl_kw , fortio ) == ECL_KW_READ_OK);
+    if (read_ok) {
+      ecl_kw_alloc_data( ecl_kw );
+      if (bulk)
+        read_ok = ecl_kw_fread_data_bulk( ecl_kw , fortio );
+      else
+        read_ok = ecl_kw_fread_data( ecl_kw , fortio );
+    }
+    timer_stop( timer );
+
+    if (!(read_ok && ecl_kw_equal( ecl_kw , src_kw )))
+      util_abort("%s: reading %s back from:%s failed \n",__func__ , ecl_kw_get_header( src_kw ) , filename);
+
+    ecl_kw_free( ecl_kw );
+    fortio_fclose( fortio );
+  }
+
+  {
+    double min_time = timer_get_min_time( timer );
+    timer_free( timer );
+    return min_time;
+  }
+}
+
+
+static void bench_kw( const ecl_kw_type * src_kw ) {
+  const char * filename = "BENCH_BULK.UNRST";
+  write_kw( filename , src_kw );
+  {
+    double t_plain      = read_kw( filename , src_kw , false , false );
+    double t_bulk       = read_kw( filename , src_kw , false , true );
+    double t_mmap_plain = read_kw( filename , src_kw , true  , false );
+    double t_mmap_bulk  = read_kw( filename , src_kw , true  , true );
+
+    printf("%-8s %9d elements: fread_data:%8.4f s  bulk:%8.4f s  mmap+fread_data:%8.4f s  mmap+bulk:%8.4f s\n",
+           ecl_kw_get_header( src_kw ) , ecl_kw_get_size( src_kw ) ,
+           t_plain , t_bulk , t_mmap_plain , t_mmap_bulk);
+  }
+  util_unlink_existing( filename );
+}
+
+
+static int usage( void ) {
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Usage:\n\n");
+  fprintf(stderr,"   bash%% kw_fread_bulk_bench [size]\n\n");
+  fprintf(stderr,"Will time reading float and double keywords with size elements, default 2000001, from a file in the current directory.\n");
+  exit(1);
+}
+
+
+int main(int argc , char ** argv) {
+  int size = 2000001;
+
+  if (argc > 2)
+    usage();
+
+  if (argc == 2 && !(util_sscanf_int( argv[1] , &size ) && size > 0))
+    usage();
+
+  {
+    ecl_kw_type * float_kw = ecl_kw_alloc( "PRESSURE" , size , ECL_FLOAT_TYPE );
+    ecl_kw_type * double_kw = ecl_kw_alloc( "DBLKW" , size , ECL_DOUBLE_TYPE );
+    int i;
+
+    for (i=0; i < size; i++) {
+      ecl_kw_iset_float( float_kw , i , i * 0.25 );
+      ecl_kw_iset_double( double_kw , i , i * 0.125 );
+    }
+
+    bench_kw( float_kw );
+    bench_kw( double_kw );
+
+    ecl_kw_free( float_kw );
+    ecl_kw_free( double_kw );
+  }
+  exit(0);
+}
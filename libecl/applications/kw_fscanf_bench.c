@@ -0,0 +1,298 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'kw_fscanf_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/timer.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_grdecl.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/fortio.h>
+
+/*
+  Throughput benchmark for reading formatted ECLIPSE files and GRDECL
+  files. The token based parser in libecl is compared with the
+  one-fscanf()-per-element loops which were used before; the files are
+  written to the current directory and removed afterwards.
+*/
+
+
+/*****************************************************************/
+/* Formatted ECLIPSE files */
+
+static ecl_kw_type * fscanf_alloc_fmt_kw( const char * filename ) {
+  fortio_type * fortio = fortio_open_reader( filename , true , false );
+  FILE * stream = fortio_get_FILE( fortio );
+  ecl_kw_type * ecl_kw = ecl_kw_alloc_empty( );
+  bool OK = true;
+  int i;
+
+  if (ecl_kw_fread_header( ecl_kw , fortio ) != ECL_KW_READ_OK)
+    util_abort("%s: failed to read header from:%s \n",__func__ , filename);
+
+  ecl_kw_alloc_data( ecl_kw );
+  for (i=0; i < ecl_kw_get_size( ecl_kw ); i++) {
+    switch (ecl_kw_get_type( ecl_kw )) {
+    case(ECL_INT_TYPE):
+      {
+        int value;
+        OK = OK && (fscanf( stream , "%d" , &value ) == 1);
+        ecl_kw_iset_int( ecl_kw , i , value );
+      }
+      break;
+    case(ECL_FLOAT_TYPE):
+      {
+        float value;
+        OK = OK && (fscanf( stream , "%gE" , &value ) == 1);
+        ecl_kw_iset_float( ecl_kw , i , value );
+      }
+      break;
+    case(ECL_DOUBLE_TYPE):
+      {
+        double arg;
+        int power;
+        OK = OK && (fscanf( stream , "%lgD%d" , &arg , &power ) == 2);
+        ecl_kw_iset_double( ecl_kw , i , arg * pow( 10 , power ));
+      }
+      break;
+    default:
+      util_abort("%s: type not handled \n",__func__);
+    }
+  }
+  if (!OK)
+    util_abort("%s: failed to read data from:%s \n",__func__ , filename);
+
+  fortio_fclose( fortio );
+  return ecl_kw;
+}
+
+
+static ecl_kw_type * fread_alloc_fmt_kw( const char * filename ) {
+  fortio_type * fortio = fortio_open_reader( filename , true , false );
+  ecl_kw_type * ecl_kw = ecl_kw_fread_alloc( fortio );
+  fortio_fclose( fortio );
+  return ecl_kw;
+}
+
+
+static void print_throughput( const char * format , const char * kw , const char * filename , double t_fscanf , double t_token) {
+  double file_mb = util_file_size( filename ) / (1024.0 * 1024.0);
+
+  printf("%-9s %-8s %8.1f MB: fscanf:%8.3f s (%6.1f MB/s)  token:%8.3f s (%6.1f MB/s)\n",
+         format , kw , file_mb ,
+         t_fscanf , file_mb / t_fscanf ,
+         t_token , file_mb / t_token);
+}
+
+
+static void bench_fmt( const ecl_kw_type * src_kw ) {
+  const char * filename = "BENCH.FUNRST";
+  timer_type * timer = timer_alloc( true );
+  ecl_kw_type * fscanf_kw;
+  ecl_kw_type * token_kw;
+  double t_fscanf , t_token;
+  {
+    fortio_type * fortio = fortio_open_writer( filename , true , false );
+    ecl_kw_fwrite( src_kw , fortio );
+    fortio_fclose( fortio );
+  }
+
+  timer_start( timer );
+  fscanf_kw = fscanf_alloc_fmt_kw( filename );
+  t_fscanf = timer_stop( timer );
+
+  timer_start( timer );
+  token_kw = fread_alloc_fmt_kw( filename );
+  t_token = timer_stop( timer );
+
+  if (!ecl_kw_numeric_equal( fscanf_kw , token_kw , 0 , 1e-14 ))
+    util_abort("%s: the fscanf and token parsers differ for:%s \n",__func__ , ecl_kw_get_header( src_kw ));
+
+  print_throughput( "Formatted" , ecl_kw_get_header( src_kw ) , filename , t_fscanf , t_token );
+  util_unlink_existing( filename );
+
+  ecl_kw_free( fscanf_kw );
+  ecl_kw_free( token_kw );
+  timer_free( timer );
+}
+
+
+/*****************************************************************/
+/* GRDECL files */
+
+static ecl_kw_type * fscanf_alloc_grdecl_kw( const char * filename , const char * kw , int size ) {
+  FILE * stream = util_fopen( filename , "r");
+  ecl_kw_type * ecl_kw = ecl_kw_alloc( kw , size , ECL_FLOAT_TYPE );
+  char buffer[65];
+  int index = 0;
+
+  if (!ecl_kw_grdecl_fseek_kw( kw , true , stream ))
+    util_abort("%s: could not locate:%s in:%s \n",__func__ , kw , filename);
+
+  if (fscanf( stream , "%s" , buffer ) != 1)
+    util_abort("%s: failed to read header from:%s \n",__func__ , filename);
+
+  while (fscanf( stream , "%32s" , buffer ) == 1) {
+    int multiplier;
+    float value;
+
+    if (strcmp( buffer , ECL_DATA_TERMINATION ) == 0)
+      break;
+
+    if (strcmp( buffer , ECL_COMMENT_STRING ) == 0) {
+      util_fskip_lines( stream , 1 );
+      continue;
+    }
+
+    if (sscanf( buffer , "%d*%g" , &multiplier , &value) != 2) {
+      if (sscanf( buffer , "%g" , &value ) != 1)
+        util_abort("%s: could not parse:%s \n",__func__ , buffer);
+      multiplier = 1;
+    }
+
+    while (multiplier > 0 && index < size) {
+      ecl_kw_iset_float( ecl_kw , index , value );
+      index++;
+      multiplier--;
+    }
+  }
+  fclose( stream );
+  return ecl_kw;
+}
+
+
+static void bench_grdecl( const char * filename , const char * kw , int size ) {
+  timer_type * timer = timer_alloc( true );
+  ecl_kw_type * fscanf_kw;
+  ecl_kw_type * token_kw;
+  double t_fscanf , t_token;
+
+  timer_start( timer );
+  fscanf_kw = fscanf_alloc_grdecl_kw( filename , kw , size );
+  t_fscanf = timer_stop( timer );
+
+  timer_start( timer );
+  {
+    FILE * stream = util_fopen( filename , "r");
+    token_kw = ecl_kw_fscanf_alloc_grdecl( stream , kw , size , ECL_FLOAT_TYPE );
+    fclose( stream );
+  }
+  t_token = timer_stop( timer );
+
+  if (!ecl_kw_numeric_equal( fscanf_kw , token_kw , 0 , 1e-6 ))
+    util_abort("%s: the fscanf and token parsers differ for:%s \n",__func__ , kw);
+
+  print_throughput( "GRDECL" , kw , filename , t_fscanf , t_token );
+  util_unlink_existing( filename );
+
+  ecl_kw_free( fscanf_kw );
+  ecl_kw_free( token_kw );
+  timer_free( timer );
+}
+
+
+static void bench_grdecl_plain( const ecl_kw_type * src_kw ) {
+  FILE * stream = util_fopen( "BENCH_PORO.grdecl" , "w");
+  ecl_kw_fprintf_grdecl( src_kw , stream );
+  fclose( stream );
+
+  bench_grdecl( "BENCH_PORO.grdecl" , ecl_kw_get_header( src_kw ) , ecl_kw_get_size( src_kw ));
+}
+
+
+/*
+  PERMX with blocks of repeated values, interleaved with comments.
+*/
+
+static void bench_grdecl_repeat( int size ) {
+  FILE * stream = util_fopen( "BENCH_PERMX.grdecl" , "w");
+  int index = 0;
+  int line = 0;
+
+  fprintf(stream , "-- Generated file\nPERMX\n");
+  while (index < size) {
+    int repeat = util_int_min( 1 + (line % 50) , size - index );
+    if ((line % 1000) == 0)
+      fprintf(stream , "-- Line: %d\n" , line);
+
+    if (repeat > 1)
+      fprintf(stream , " %d*%g" , repeat , 100 + 0.5 * line);
+    else
+      fprintf(stream , " %g" , 100 + 0.5 * line);
+
+    if ((line % 5) == 4)
+      fprintf(stream , "\n");
+
+    index += repeat;
+    line++;
+  }
+  fprintf(stream , "\n/\n");
+  fclose( stream );
+
+  bench_grdecl( "BENCH_PERMX.grdecl" , "PERMX" , size );
+}
+
+
+static int usage( void ) {
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Usage:\n\n");
+  fprintf(stderr,"   bash%% kw_fscanf_bench [size]\n\n");
+  fprintf(stderr,"Will time reading formatted keywords with size elements, default 500000, from files in the current directory.\n");
+  exit(1);
+}
+
+
+int main(int argc , char ** argv) {
+  int size = 500000;
+
+  if (argc > 2)
+    usage();
+
+  if (argc == 2 && !(util_sscanf_int( argv[1] , &size ) && size > 0))
+    usage();
+
+  {
+    ecl_kw_type * int_kw = ecl_kw_alloc( "INTKW" , size , ECL_INT_TYPE );
+    ecl_kw_type * float_kw = ecl_kw_alloc( "PORO" , size , ECL_FLOAT_TYPE );
+    ecl_kw_type * double_kw = ecl_kw_alloc( "DBLKW" , size , ECL_DOUBLE_TYPE );
+    int i;
+
+    srand( 10 );
+    for (i=0; i < size; i++) {
+      ecl_kw_iset_int( int_kw , i , rand() - RAND_MAX / 2 );
+      ecl_kw_iset_float( float_kw , i , 0.35 * rand() / RAND_MAX );
+      ecl_kw_iset_double( double_kw , i , (rand() - RAND_MAX / 2) * 1e-3 );
+    }
+
+    bench_fmt( int_kw );
+    bench_fmt( float_kw );
+    bench_fmt( double_kw );
+    bench_grdecl_plain( float_kw );
+    bench_grdecl_repeat( 5 * size );
+
+    ecl_kw_free( int_kw );
+    ecl_kw_free( float_kw );
+    ecl_kw_free( double_kw );
+  }
+  exit(0);
+}
@@ -37,8 +37,10 @@ extern "C" {
 
 #define ECL_FILE_FLAGS_ENUM_DEFS \
   {.value =   1 , .name="ECL_FILE_CLOSE_STREAM"}, \
-  {.value =   2 , .name="ECL_FILE_WRITABLE"}
-#define ECL_FILE_FLAGS_ENUM_SIZE 2
+  {.value =   2 , .name="ECL_FILE_WRITABLE"}, \
+  {.value =   4 , .name="ECL_FILE_MMAP"}, \
+  {.value =   8 , .name="ECL_FILE_INDEX"}
+#define ECL_FILE_FLAGS_ENUM_SIZE 4
 
 
 
@@ -24,8 +24,10 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <ert/util/util.h>
+#include <ert/util/buffer.h>
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/fortio.h>
@@ -51,6 +53,9 @@ typedef struct inv_map_struct inv_map_type;
   void               ecl_file_kw_replace_kw( ecl_file_kw_type * file_kw , fortio_type * target , ecl_kw_type * new_kw );
   bool               ecl_file_kw_fskip_data( const ecl_file_kw_type * file_kw , fortio_type * fortio);
   void               ecl_file_kw_inplace_fwrite( ecl_file_kw_type * file_kw , fortio_type * fortio);
+  void               ecl_file_kw_buffer_store( const ecl_file_kw_type * file_kw , buffer_type * buffer , bool store_kw);
+  ecl_file_kw_type * ecl_file_kw_buffer_alloc( buffer_type * buffer , inv_map_type * inv_map );
+  bool               ecl_file_kw_buffer_check( buffer_type * buffer , int64_t file_size );
  
 #ifdef __cplusplus
 }
@@ -37,12 +37,25 @@ typedef enum {
                                     mainly to save filedescriptors in cases where many ecl_file instances are open at
                                     the same time. */
   //
-  ECL_FILE_WRITABLE      =  2    /*
+  ECL_FILE_WRITABLE      =  2 ,  /*
                                     This flag opens the file in a mode where it can be updated and modified, but it
                                     must still exist and be readable. I.e. this should not compared with the normal:
                                     fopen(filename , "w") where an existing file is truncated to zero upon successfull
                                     open.
                                  */
+  //
+  ECL_FILE_MMAP          =  4 ,  /*
+                                    This flag will memory map the file, keyword data is then read directly from the
+                                    mapped pages, and numeric keywords which do not need endian conversion will
+                                    reference the mapping without copying. The flag is ignored for formatted files
+                                    and when combined with ECL_FILE_WRITABLE.
+                                 */
+  //
+  ECL_FILE_INDEX         =  8    /*
+                                    This flag will use a keyword index sidecar file, 'FILENAME.index', to avoid
+                                    scanning through the whole file when opening it. If the sidecar is missing or
+                                    stale it is (re)created after the scan.
+                                 */
 } ecl_file_flag_type;
 
 
@@ -86,9 +86,13 @@ extern "C" {
   double          ecl_grid_get_cell_volume1_tskille( const ecl_grid_type * ecl_grid, int global_index );
   double          ecl_grid_get_cell_volume3( const ecl_grid_type * ecl_grid, int i , int j , int k);
   double          ecl_grid_get_cell_volume1A( const ecl_grid_type * ecl_grid, int active_index );
+  double        * ecl_grid_alloc_volume_data( const ecl_grid_type * grid , bool active_size );
+  ecl_kw_type   * ecl_grid_alloc_volume_kw( const ecl_grid_type * grid , bool active_size );
+  void            ecl_grid_alloc_center_arrays( const ecl_grid_type * grid , bool active_size , double ** x , double ** y , double ** z);
   bool            ecl_grid_cell_contains1(const ecl_grid_type * grid , int global_index , double x , double y , double z);
   bool            ecl_grid_cell_contains3(const ecl_grid_type * grid , int i , int j ,int k , double x , double y , double z);
   int             ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index);
+  void            ecl_grid_get_global_index_from_xyz_batch(ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , int * global_index);
   bool            ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k );
   bool            ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j);
   const  char   * ecl_grid_get_name( const ecl_grid_type * );
@@ -112,6 +116,8 @@ extern "C" {
   ecl_grid_type * ecl_grid_alloc_GRDECL_data(int , int , int , const float *  , const float *  , const int * , bool apply_mapaxes , const float * mapaxes);
   ecl_grid_type * ecl_grid_alloc_GRID_data(int num_coords , int nx, int ny , int nz , int coords_size , int ** coords , float ** corners , bool apply_mapaxes, const float * mapaxes);
   ecl_grid_type * ecl_grid_alloc(const char * );
+  ecl_grid_type * ecl_grid_alloc_compact(const char * grid_file );
+  bool            ecl_grid_is_compact( const ecl_grid_type * grid );
   ecl_grid_type * ecl_grid_load_case( const char * case_input );
   ecl_grid_type * ecl_grid_load_case__( const char * case_input , bool apply_mapaxes);
   ecl_grid_type * ecl_grid_alloc_rectangular( int nx , int ny , int nz , double dx , double dy , double dz , const int * actnum);
@@ -77,6 +77,8 @@ extern "C" {
   bool           ecl_kw_fread_realloc(ecl_kw_type *, fortio_type *);
   void           ecl_kw_fread(ecl_kw_type * , fortio_type * );
   ecl_kw_type *  ecl_kw_fread_alloc(fortio_type *);
+  ecl_kw_type *  ecl_kw_fread_alloc_shared(fortio_type * fortio);
+  void           ecl_kw_unshare_data(ecl_kw_type * ecl_kw);
   void           ecl_kw_free_data(ecl_kw_type *);
   void           ecl_kw_fread_indexed_data(fortio_type * fortio, offset_type data_offset, ecl_type_enum ecl_type, int element_count, const int_vector_type* index_map, char* buffer);
   void           ecl_kw_free(ecl_kw_type *);
@@ -126,6 +128,7 @@ extern "C" {
   bool           ecl_kw_fskip_data__( ecl_type_enum ecl_type , int size , fortio_type * fortio);
   bool           ecl_kw_fskip_data(ecl_kw_type *ecl_kw, fortio_type *fortio);
   bool           ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio);
+  bool           ecl_kw_fread_data_bulk(ecl_kw_type *ecl_kw, fortio_type *fortio);
   void           ecl_kw_fskip_header( fortio_type * fortio);
 
 
@@ -94,6 +94,8 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   ecl_sum_type   * ecl_sum_fread_alloc(const char * , const stringlist_type * data_files, const char * key_join_string);
   ecl_sum_type   * ecl_sum_fread_alloc_case(const char *  , const char * key_join_string);
   ecl_sum_type   * ecl_sum_fread_alloc_case__(const char *  , const char * key_join_string , bool include_restart);
+  ecl_sum_type   * ecl_sum_fread_alloc_restricted(const char * header_file , const stringlist_type * data_files , const char * key_join_string , const stringlist_type * keys);
+  ecl_sum_type   * ecl_sum_fread_alloc_case_restricted(const char * input_file , const char * key_join_string , const stringlist_type * keys);
   bool             ecl_sum_case_exists( const char * input_file );
 
   /* Accessor functions : */
@@ -156,6 +158,7 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   double ecl_sum_iget_general_var(const ecl_sum_type * ecl_sum , int internal_index , const char * lookup_kw);
 
 
+  const float        * ecl_sum_get_column( const ecl_sum_type * ecl_sum , int data_index );
   void                 ecl_sum_init_data_vector( const ecl_sum_type * ecl_sum , double_vector_type * data_vector , int data_index , bool report_only );
   double_vector_type * ecl_sum_alloc_data_vector( const ecl_sum_type * ecl_sum  , int data_index , bool report_only);
   time_t_vector_type * ecl_sum_alloc_time_vector( const ecl_sum_type * ecl_sum  , bool report_only);
@@ -40,6 +40,8 @@ typedef struct ecl_sum_tstep_struct ecl_sum_tstep_type;
                                                      const char * src_file ,
                                                      const ecl_smspec_type * smspec);
 
+  ecl_sum_tstep_type * ecl_sum_tstep_alloc_from_data( int report_step , int ministep_nr , const float * data , const ecl_smspec_type * smspec);
+
   ecl_sum_tstep_type * ecl_sum_tstep_alloc_new( int report_step , int ministep , float sim_seconds , const ecl_smspec_type * smspec );
 
   double ecl_sum_tstep_iget(const ecl_sum_tstep_type * ministep , int index);
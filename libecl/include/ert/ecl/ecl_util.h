@@ -22,6 +22,7 @@
 extern "C" {
 #endif
 #include <stdbool.h>
+#include <stdio.h>
 #include <time.h>
 
 #include <ert/util/stringlist.h>
@@ -211,6 +212,10 @@ void            ecl_util_append_month_range( time_t_vector_type * date_list , ti
 void            ecl_util_init_month_range( time_t_vector_type * date_list , time_t start_date , time_t end_date);
 void            ecl_util_set_date_values(time_t t , int * mday , int * month , int * year);
 
+int             ecl_util_fscanf_token( FILE * stream , char * token , int max_length);
+int             ecl_util_parse_fmt_int( const char * s , int * value);
+int             ecl_util_parse_fmt_double( const char * s , double * value);
+
 #ifdef __cplusplus
 }
 #endif
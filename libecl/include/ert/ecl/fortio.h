@@ -46,6 +46,7 @@ typedef struct fortio_struct fortio_type;
   bool               fortio_looks_like_fortran_file(const char *  , bool );
   void               fortio_copy_record(fortio_type * , fortio_type * , int , void * , bool *);
   fortio_type *      fortio_open_reader(const char *, bool fmt_file , bool endian_flip_header);
+  fortio_type *      fortio_open_reader_mmap(const char *, bool fmt_file , bool endian_flip_header);
   fortio_type *      fortio_open_writer(const char *, bool fmt_file , bool endian_flip_header);
   fortio_type *      fortio_open_readwrite(const char *, bool fmt_file , bool endian_flip_header);
   fortio_type *      fortio_open_append(const char *filename , bool fmt_file , bool endian_flip_header);
@@ -59,6 +60,11 @@ typedef struct fortio_struct fortio_type;
   void               fortio_fskip_buffer(fortio_type *, int );
   int                fortio_fskip_record(fortio_type *);
   bool               fortio_fread_buffer(fortio_type * , char * buffer, int buffer_size);
+  char        *      fortio_mmap_record_data( fortio_type * fortio , int buffer_size );
+  char        *      fortio_mmap_record_data_flip( fortio_type * fortio , int buffer_size , int elm_size );
+  bool               fortio_is_mmapped( const fortio_type * fortio );
+  const char  *      fortio_mmap_fread_ptr( fortio_type * fortio , size_t size );
+  bool               fortio_buffer_has_record( const fortio_type * fortio , const char * buffer , size_t offset , int record_size);
   void               fortio_fwrite_record(fortio_type * , const char * buffer, int buffer_size);
   FILE        *      fortio_get_FILE(const fortio_type *);
   void               fortio_fflush(fortio_type * ) ;
@@ -21,12 +21,19 @@
 #include <math.h>
 #include <errno.h>
 #include <time.h>
+#include <stdint.h>
+
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_UNISTD
+#include <unistd.h>
+#endif
 
 #include <ert/util/hash.h>
 #include <ert/util/util.h>
 #include <ert/util/vector.h>
 #include <ert/util/int_vector.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/buffer.h>
 
 #include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_kw.h>
@@ -557,6 +564,148 @@ static bool ecl_file_scan( ecl_file_type * ecl_file ) {
 }
 
 
+/*
+  Keyword index sidecar files. When opened with the ECL_FILE_INDEX
+  flag the index created by ecl_file_scan() is stored in the file
+  'FILENAME.index'; the next time the file is opened the index is
+  loaded from the sidecar file with one read instead of seeking
+  through the whole file. The index file contains the size and mtime
+  of the indexed file, and is ignored if these do not match.
+
+  The small restart header keywords SEQNUM, INTEHEAD and DOUBHEAD are
+  stored in full in the index file, so that selecting a restart block
+  by report step, time or days does not need to read anything from
+  the main file.
+
+  Layout: ID, VERSION, file size, mtime, number of keywords, the
+  ecl_file_kw records and finally the ID again.
+*/
+
+#define ECL_FILE_INDEX_ID       881307
+#define ECL_FILE_INDEX_VERSION  1
+
+
+static char * ecl_file_alloc_index_filename( const char * filename ) {
+  return util_alloc_sprintf("%s.index" , filename );
+}
+
+
+static bool ecl_file_index_store_kw( const char * header ) {
+  return (strcmp( header , SEQNUM_KW ) == 0) ||
+         (strcmp( header , INTEHEAD_KW ) == 0) ||
+         (strcmp( header , DOUBHEAD_KW ) == 0);
+}
+
+
+static bool ecl_file_load_index( ecl_file_type * ecl_file , const char * filename ) {
+  bool index_ok = false;
+  char * index_file = ecl_file_alloc_index_filename( filename );
+
+  if (util_file_exists( index_file )) {
+    buffer_type * buffer = buffer_fread_alloc( index_file );
+    size_t buffer_size = buffer_get_size( buffer );
+    size_t header_size = 3 * sizeof(int) + sizeof(int64_t) + sizeof(time_t);
+
+    if (buffer_size >= header_size + sizeof(int)) {
+      int trailer_id;
+      memcpy( &trailer_id , buffer_iget_data( buffer , buffer_size - sizeof trailer_id ) , sizeof trailer_id );
+
+      if ((trailer_id == ECL_FILE_INDEX_ID) &&
+          (buffer_fread_int( buffer ) == ECL_FILE_INDEX_ID) &&
+          (buffer_fread_int( buffer ) == ECL_FILE_INDEX_VERSION)) {
+        int64_t file_size;
+        time_t  mtime;
+
+        buffer_fread( buffer , &file_size , sizeof file_size , 1 );
+        mtime = buffer_fread_time_t( buffer );
+
+        if ((file_size == util_file_size( filename )) && (mtime == util_file_mtime( filename ))) {
+          int num_kw = buffer_fread_int( buffer );
+          size_t kw_offset = buffer_get_offset( buffer );
+          bool valid = (num_kw >= 0);
+          int ikw;
+
+          /*
+            The records are checked against the size of the indexed
+            file before anything is loaded; a corrupt index is then
+            ignored and the file is scanned instead.
+          */
+          for (ikw = 0; valid && (ikw < num_kw); ikw++)
+            valid = ecl_file_kw_buffer_check( buffer , file_size );
+
+          if (valid && (buffer_get_remaining_size( buffer ) == sizeof trailer_id)) {
+            buffer_fseek( buffer , kw_offset , SEEK_SET );
+            for (ikw = 0; ikw < num_kw; ikw++)
+              ecl_file_view_add_kw( ecl_file->global_view , ecl_file_kw_buffer_alloc( buffer , ecl_file->inv_view ));
+
+            ecl_file_view_make_index( ecl_file->global_view );
+            index_ok = true;
+          }
+        }
+      }
+    }
+    buffer_free( buffer );
+  }
+
+  free( index_file );
+  return index_ok;
+}
+
+
+/*
+  The index file is written to a temporary file which is then renamed,
+  so that concurrent readers never see a partially written index.
+  Failure to write the index, e.g. because the directory is read-only,
+  is silently ignored.
+*/
+
+static void ecl_file_store_index( ecl_file_type * ecl_file , const char * filename ) {
+  char * index_file = ecl_file_alloc_index_filename( filename );
+#ifdef ERT_HAVE_UNISTD
+  char * tmp_file = util_alloc_sprintf("%s.%d" , index_file , (int) getpid());
+#else
+  char * tmp_file = util_alloc_sprintf("%s.%d" , index_file , rand());
+#endif
+  FILE * stream = fopen( tmp_file , "w");
+
+  if (stream) {
+    buffer_type * buffer = buffer_alloc( 1024 );
+    int64_t file_size = util_file_size( filename );
+    int num_kw = ecl_file_view_get_size( ecl_file->global_view );
+    int ikw;
+    bool write_ok;
+
+    buffer_fwrite_int( buffer , ECL_FILE_INDEX_ID );
+    buffer_fwrite_int( buffer , ECL_FILE_INDEX_VERSION );
+    buffer_fwrite( buffer , &file_size , sizeof file_size , 1 );
+    buffer_fwrite_time_t( buffer , util_file_mtime( filename ));
+    buffer_fwrite_int( buffer , num_kw );
+
+    for (ikw = 0; ikw < num_kw; ikw++) {
+      ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file->global_view , ikw );
+      bool store_kw = ecl_file_index_store_kw( ecl_file_kw_get_header( file_kw ));
+
+      if (store_kw)
+        ecl_file_view_iget_kw( ecl_file->global_view , ikw );
+
+      ecl_file_kw_buffer_store( file_kw , buffer , store_kw );
+    }
+    buffer_fwrite_int( buffer , ECL_FILE_INDEX_ID );
+
+    write_ok = (fwrite( buffer_get_data( buffer ) , 1 , buffer_get_size( buffer ) , stream ) == buffer_get_size( buffer ));
+    write_ok = (fclose( stream ) == 0) && write_ok;
+
+    if (!write_ok || (rename( tmp_file , index_file ) != 0))
+      remove( tmp_file );
+
+    buffer_free( buffer );
+  }
+
+  free( tmp_file );
+  free( index_file );
+}
+
+
 void ecl_file_select_global( ecl_file_type * ecl_file ) {
   ecl_file->active_view = ecl_file->global_view;
 }
@@ -570,6 +719,10 @@ void ecl_file_select_global( ecl_file_type * ecl_file ) {
    create the map/index stored in the global_view field of the ecl_file
    structure. No keyword data will be loaded from the file.
 
+   If the ECL_FILE_INDEX flag is set the index is loaded from the
+   sidecar file 'FILENAME.index' when that is up to date; otherwise
+   the sidecar file is written after the scan.
+
    The ecl_file instance will retain an open fortio reference to the
    file until ecl_file_close() is called.
 */
@@ -583,15 +736,27 @@ ecl_file_type * ecl_file_open( const char * filename , int flags) {
 
   if (ecl_file_view_check_flags(flags , ECL_FILE_WRITABLE))
     fortio = fortio_open_readwrite( filename , fmt_file , ECL_ENDIAN_FLIP);
+  else if (ecl_file_view_check_flags(flags , ECL_FILE_MMAP))
+    fortio = fortio_open_reader_mmap( filename , fmt_file , ECL_ENDIAN_FLIP);
   else
     fortio = fortio_open_reader( filename , fmt_file , ECL_ENDIAN_FLIP);
 
   if (fortio) {
     ecl_file_type * ecl_file = ecl_file_alloc_empty( flags );
+    bool open_ok;
+
     ecl_file->fortio = fortio;
     ecl_file->global_view = ecl_file_view_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , true );
 
-    if (ecl_file_scan( ecl_file )) {
+    if (ecl_file_view_check_flags( flags , ECL_FILE_INDEX ) && ecl_file_load_index( ecl_file , filename ))
+      open_ok = true;
+    else {
+      open_ok = ecl_file_scan( ecl_file );
+      if (open_ok && ecl_file_view_check_flags( flags , ECL_FILE_INDEX ))
+        ecl_file_store_index( ecl_file , filename );
+    }
+
+    if (open_ok) {
       ecl_file_select_global( ecl_file );
 
       if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_CLOSE_STREAM))
@@ -667,6 +832,20 @@ void ecl_file_close_fortio_stream(ecl_file_type * ecl_file) {
 
 
 void ecl_file_fortio_detach( ecl_file_type * ecl_file ) {
+  if (fortio_is_mmapped( ecl_file->fortio )) {
+    /*
+      Keywords loaded from a memory mapped file might reference the
+      mapping directly; they must get private copies of the data
+      before the mapping goes away.
+    */
+    int index;
+    for (index = 0; index < ecl_file_view_get_size( ecl_file->global_view ); index++) {
+      ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file->global_view , index );
+      ecl_kw_type * ecl_kw = ecl_file_kw_get_kw_ptr( file_kw , ecl_file->fortio , ecl_file->inv_view );
+      if (ecl_kw)
+        ecl_kw_unshare_data( ecl_kw );
+    }
+  }
   fortio_fclose( ecl_file->fortio );
   ecl_file->fortio = NULL;
 }
@@ -20,9 +20,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
 
 #include <ert/util/size_t_vector.h>
 #include <ert/util/util.h>
+#include <ert/util/buffer.h>
 
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_kw.h>
@@ -39,7 +42,10 @@
   If and when the keyword is actually queried for at a later stage the
   ecl_file_kw_get_kw() method will seek to the keyword position in an
   open fortio instance and call ecl_kw_fread_alloc() to instantiate
-  the keyword itself.
+  the keyword itself. If the fortio instance is memory mapped the
+  keyword is instead instantiated with ecl_kw_fread_alloc_shared(),
+  and will then reference the mapped file content directly when
+  possible.
 
   The ecl_file_kw datatype is mainly used by the ecl_file datatype;
   whose index tables consists of ecl_file_kw instances.
@@ -204,6 +210,144 @@ static void ecl_file_kw_assert_kw( const ecl_file_kw_type * file_kw ) {
 }
 
 
+/**
+   Stores the header information of the file_kw instance in the
+   buffer; this is used for the keyword index files written by
+   ecl_file. If @store_kw is true and the keyword has been loaded the
+   keyword itself is also stored, and will be instantiated directly
+   when the file_kw is recreated with ecl_file_kw_buffer_alloc().
+*/
+
+void ecl_file_kw_buffer_store( const ecl_file_kw_type * file_kw , buffer_type * buffer , bool store_kw) {
+  int64_t file_offset = file_kw->file_offset;
+
+  buffer_fwrite_string( buffer , file_kw->header );
+  buffer_fwrite_int( buffer , file_kw->ecl_type );
+  buffer_fwrite_int( buffer , file_kw->kw_size );
+  buffer_fwrite( buffer , &file_offset , sizeof file_offset , 1 );
+
+  store_kw = store_kw && (file_kw->kw != NULL);
+  buffer_fwrite_bool( buffer , store_kw );
+  if (store_kw)
+    ecl_kw_buffer_store( file_kw->kw , buffer );
+}
+
+
+ecl_file_kw_type * ecl_file_kw_buffer_alloc( buffer_type * buffer , inv_map_type * inv_map ) {
+  const char *  header   = buffer_fread_string( buffer );
+  ecl_type_enum ecl_type = buffer_fread_int( buffer );
+  int           kw_size  = buffer_fread_int( buffer );
+  int64_t       file_offset;
+  ecl_file_kw_type * file_kw;
+
+  buffer_fread( buffer , &file_offset , sizeof file_offset , 1 );
+  file_kw = ecl_file_kw_alloc__( header , ecl_type , kw_size , file_offset );
+  if (buffer_fread_bool( buffer )) {
+    file_kw->kw = ecl_kw_buffer_alloc( buffer );
+    ecl_file_kw_assert_kw( file_kw );
+    inv_map_add_kw( inv_map , file_kw , file_kw->kw );
+  }
+
+  return file_kw;
+}
+
+
+/*
+  Checks a string written with buffer_fwrite_string() and moves the
+  buffer past it; the string must be at most @max_length characters.
+*/
+
+static const char * ecl_file_kw_buffer_check_string( buffer_type * buffer , int max_length ) {
+  const char * data = buffer_get_data( buffer );
+  size_t offset = buffer_get_offset( buffer );
+  int length;
+
+  if (buffer_get_remaining_size( buffer ) < sizeof length)
+    return NULL;
+
+  length = buffer_fread_int( buffer );
+  offset += sizeof length;
+  if ((length < 0) || (length > max_length) || (buffer_get_remaining_size( buffer ) < (size_t) length + 1))
+    return NULL;
+
+  if ((data[offset + length] != '\0') || (strlen( &data[offset] ) != (size_t) length))
+    return NULL;
+
+  buffer_fskip( buffer , length + 1 );
+  return &data[offset];
+}
+
+
+static bool ecl_file_kw_buffer_check_type( int ecl_type ) {
+  return (ecl_type >= ECL_CHAR_TYPE) && (ecl_type <= ECL_C010_TYPE);
+}
+
+
+/**
+   Checks that the buffer holds a valid record as written by
+   ecl_file_kw_buffer_store(), for a keyword in a file of @file_size
+   bytes, and moves the buffer past the record. Returns false if the
+   record is truncated or inconsistent; then the buffer position is
+   undefined. The keyword index files are checked with this function
+   before they are loaded with ecl_file_kw_buffer_alloc(), which will
+   abort on invalid input.
+*/
+
+bool ecl_file_kw_buffer_check( buffer_type * buffer , int64_t file_size ) {
+  const char * header = ecl_file_kw_buffer_check_string( buffer , ECL_STRING8_LENGTH );
+  int ecl_type;
+  int kw_size;
+  int64_t file_offset;
+  bool store_kw;
+
+  if (header == NULL)
+    return false;
+
+  if (buffer_get_remaining_size( buffer ) < 2 * sizeof(int) + sizeof file_offset + sizeof store_kw)
+    return false;
+
+  ecl_type = buffer_fread_int( buffer );
+  kw_size  = buffer_fread_int( buffer );
+  buffer_fread( buffer , &file_offset , sizeof file_offset , 1 );
+  store_kw = buffer_fread_bool( buffer );
+
+  if (!ecl_file_kw_buffer_check_type( ecl_type ) || (kw_size < 0))
+    return false;
+
+  if ((file_offset < 0) || (file_offset >= file_size))
+    return false;
+
+  if (store_kw) {
+    const char * kw_header = ecl_file_kw_buffer_check_string( buffer , ECL_STRING8_LENGTH );
+    bool header_equal;
+
+    if (kw_header == NULL)
+      return false;
+
+    {
+      char * strip_header = util_alloc_strip_copy( kw_header );
+      header_equal = (strcmp( strip_header , header ) == 0);
+      free( strip_header );
+    }
+
+    if (!header_equal || (buffer_get_remaining_size( buffer ) < 2 * sizeof(int)))
+      return false;
+
+    if ((buffer_fread_int( buffer ) != kw_size) || (buffer_fread_int( buffer ) != ecl_type))
+      return false;
+
+    {
+      size_t data_size = (size_t) kw_size * ecl_util_get_sizeof_ctype( ecl_type );
+      if (buffer_get_remaining_size( buffer ) < data_size)
+        return false;
+      buffer_fskip( buffer , data_size );
+    }
+  }
+
+  return true;
+}
+
+
 static void ecl_file_kw_drop_kw( ecl_file_kw_type * file_kw , inv_map_type * inv_map ) {
   if (file_kw->kw != NULL) {
     inv_map_drop_kw( inv_map , file_kw->kw );
@@ -222,7 +366,10 @@ static void ecl_file_kw_load_kw( ecl_file_kw_type * file_kw , fortio_type * fort
 
   {
     fortio_fseek( fortio , file_kw->file_offset , SEEK_SET );
-    file_kw->kw = ecl_kw_fread_alloc( fortio );
+    if (fortio_is_mmapped( fortio ))
+      file_kw->kw = ecl_kw_fread_alloc_shared( fortio );
+    else
+      file_kw->kw = ecl_kw_fread_alloc( fortio );
     ecl_file_kw_assert_kw( file_kw );
     inv_map_add_kw( inv_map , file_kw , file_kw->kw );
   }
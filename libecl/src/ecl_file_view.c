@@ -17,6 +17,8 @@
 */
 
 
+#include <string.h>
+
 #include <ert/util/vector.h>
 #include <ert/util/hash.h>
 #include <ert/util/stringlist.h>
@@ -161,6 +163,35 @@ ecl_kw_type * ecl_file_view_iget_kw( const ecl_file_view_type * ecl_file_view ,
   return ecl_kw;
 }
 
+/*
+  Formatted files can not be read at element offsets; the whole
+  keyword is read and the elements in @index_map are copied out of
+  it.
+*/
+
+static void ecl_file_view_index_fload_fmt_kw(fortio_type * fortio, offset_type offset, const int_vector_type * index_map, char* buffer) {
+    ecl_kw_type * ecl_kw;
+    int element_size;
+
+    fortio_fseek( fortio , offset , SEEK_SET );
+    ecl_kw = ecl_kw_fread_alloc( fortio );
+    if (ecl_kw == NULL)
+        util_abort("%s: failed to read keyword from:%s \n",__func__ , fortio_filename_ref( fortio ));
+
+    element_size = ecl_util_get_sizeof_ctype( ecl_kw_get_type( ecl_kw ));
+    if (ecl_kw_get_type( ecl_kw ) == ECL_CHAR_TYPE || ecl_kw_get_type( ecl_kw ) == ECL_MESS_TYPE)
+        element_size = ECL_STRING8_LENGTH;
+
+    for (int i = 0; i < int_vector_size( index_map ); i++) {
+        int element = int_vector_iget( index_map , i );
+        if (element < 0 || element >= ecl_kw_get_size( ecl_kw ))
+            util_abort("%s: Element index is out of range 0 <= %d < %d\n", __func__, element, ecl_kw_get_size( ecl_kw ));
+        memcpy( &buffer[ i * element_size ] , ecl_kw_iget_ptr( ecl_kw , element ) , element_size );
+    }
+    ecl_kw_free( ecl_kw );
+}
+
+
 void ecl_file_view_index_fload_kw(const ecl_file_view_type * ecl_file_view, const char* kw, int index, const int_vector_type * index_map, char* buffer) {
     ecl_file_kw_type * file_kw = ecl_file_view_iget_named_file_kw( ecl_file_view , kw , index);
 
@@ -169,7 +200,10 @@ void ecl_file_view_index_fload_kw(const ecl_file_view_type * ecl_file_view, cons
         ecl_type_enum ecl_type = ecl_file_kw_get_type(file_kw);
         int element_count = ecl_file_kw_get_size(file_kw);
 
-        ecl_kw_fread_indexed_data(ecl_file_view->fortio, offset + ECL_KW_HEADER_FORTIO_SIZE, ecl_type, element_count, index_map, buffer);
+        if (fortio_fmt_file( ecl_file_view->fortio ))
+            ecl_file_view_index_fload_fmt_kw(ecl_file_view->fortio, offset, index_map, buffer);
+        else
+            ecl_kw_fread_indexed_data(ecl_file_view->fortio, offset + ECL_KW_HEADER_FORTIO_SIZE, ecl_type, element_count, index_map, buffer);
     }
 }
 
@@ -21,6 +21,12 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <math.h>
+#include <float.h>
+
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 #include <ert/util/util.h>
 #include <ert/util/double_vector.h>
@@ -685,11 +691,9 @@ static void point_copy_values(point_type * p , const point_type * src) {
 #define HOST_CELL_NONE     -1
 
 #define CELL_FLAG_VALID    1     /* In the case of GRID files not necessarily all cells geometry values set - in that case this will be left as false. */
-#define CELL_FLAG_CENTER   2     /* Has the center value been calculated - this is by default not done to speed up loading a tiny bit. */
 #define CELL_FLAG_TAINTED  4     /* lazy fucking stupid reservoir engineers make invalid grid
                                     cells - for kicks??  must try to keep those cells out of
                                     real-world calculations with some hysteric heuristics.*/
-#define CELL_FLAG_VOLUME 8
 
 typedef struct ecl_cell_struct           ecl_cell_type;
 
@@ -698,11 +702,15 @@ typedef struct ecl_cell_struct           ecl_cell_type;
 #define METER_TO_FEET_SCALE_FACTOR   3.28084
 #define METER_TO_CM_SCALE_FACTOR   100.0
 
-struct ecl_cell_struct {
-  point_type center;
-  point_type corner_list[8];
+/*
+  The geometry of the cells - i.e. the corners - is not stored in the
+  ecl_cell structure, but in contiguous arrays in the grid; the center
+  and volume are calculated from the corners on demand. See the
+  ecl_grid_get_cell_corners(), ecl_grid_get_cell_center() and
+  ecl_grid_get_cell_signed_volume() functions.
+*/
 
-  double                 volume;             /* Cache volume - whether it is initialized or not is handled by a cell_flags. */
+struct ecl_cell_struct {
   int                    active;
   int                    active_index[2];    /* [0]: The active matrix index; [1]: the active fracture index */
   const ecl_grid_type   *lgr;                /* if this cell is part of an lgr; this will point to a grid instance for that lgr; NULL if not part of lgr. */
@@ -720,6 +728,28 @@ static const float * ecl_grid_get_mapaxes( const ecl_grid_type * grid );
 
 #define ECL_GRID_ID       991010
 
+
+/*
+  Spatial index used when looking up cells from world coordinates,
+  see the ecl_grid_index_xxx() functions further down.
+*/
+
+typedef struct {
+  double min[3];
+  double max[3];
+  int    first;     /* Leaf node: offset into the items array; interior node: index of the left child - the right child is first + 1. */
+  int    count;     /* The number of items in a leaf node; 0 for interior nodes. */
+} ecl_grid_index_node_type;
+
+
+typedef struct {
+  int                        dim;
+  int                        num_nodes;
+  ecl_grid_index_node_type * nodes;
+  int                      * items;
+} ecl_grid_index_type;
+
+
 struct ecl_grid_struct {
   UTIL_TYPE_ID_DECLARATION;
   int                   lgr_nr;        /* EGRID files: corresponds to item 4 in gridhead - 0 for the main grid.
@@ -729,7 +759,6 @@ struct ecl_grid_struct {
   int                   size;          /* == nx*ny*nz */
   int                   total_active;
   int                   total_active_fracture;
-  bool                * visited;                /* internal helper struct used when searching for index - can be NULL. */
   int                 * index_map;              /* this a list of nx*ny*nz elements, where value -1 means inactive cell .*/
   int                 * inv_index_map;          /* this is list of total_active elements - which point back to the index_map. */
 
@@ -737,6 +766,8 @@ struct ecl_grid_struct {
   int                 * inv_fracture_index_map; /* For fractures: this is list of total_active elements - which point back to the index_map. */
 
   ecl_cell_type      *  cells;
+  point_type         *  corners;                /* The eight corners of all the cells - NULL for compact grids. */
+  float              *  zcorn;                  /* Compact grids: the ZCORN data; the corners are calculated from zcorn and coord_kw on demand. */
 
   char                * parent_name;   /* the name of the parent for a nested lgr - for the main grid, and also a
                                           lgr descending directly from the main grid this will be NULL. */
@@ -776,9 +807,16 @@ struct ecl_grid_struct {
 
   ert_ecl_unit_enum     unit_system;
   int                   eclipse_version;
+
+  /*------------------------------:       lazily built spatial index; use ecl_grid_get_cell_index() and ecl_grid_get_column_index(). */
+  ecl_grid_index_type  * cell_index;     /* BVH over the bounding boxes of all cells - for xyz lookup. */
+  ecl_grid_index_type  * column_index;   /* BVH over the (x,y) bounding boxes of the i,j columns - for xy lookup. */
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_t        index_lock;
+#endif
 };
 
-static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2,  bool include_nnc , bool * equal) {
+static void ecl_cell_compare(const ecl_cell_type * c1 , const point_type * corners1 , const ecl_cell_type * c2, const point_type * corners2 , bool include_nnc , bool * equal) {
   int i;
 
   if (c1->active != c2->active)
@@ -799,7 +837,7 @@ static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2
 
   if (*equal) {
     for (i=0; i < 8; i++)
-      point_compare( &c1->corner_list[i] , &c2->corner_list[i] , equal );
+      point_compare( &corners1[i] , &corners2[i] , equal );
 
   }
 
@@ -811,28 +849,25 @@ static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2
 }
 
 
-static void ecl_cell_dump( const ecl_cell_type * cell , FILE * stream) {
+static void ecl_cell_dump( const point_type * corner_list , FILE * stream) {
   int i;
   for (i=0; i < 8; i++)
-    point_dump( &cell->corner_list[i] , stream );
+    point_dump( &corner_list[i] , stream );
 }
 
 
-static void ecl_cell_assert_center( ecl_cell_type * cell);
-
-static void ecl_cell_dump_ascii( ecl_cell_type * cell , int i , int j , int k , FILE * stream , const double * offset) {
+static void ecl_cell_dump_ascii( const ecl_cell_type * cell , const point_type * center , const point_type * corner_list , int i , int j , int k , FILE * stream , const double * offset) {
   fprintf(stream , "Cell: i:%3d  j:%3d    k:%3d   host_cell:%d  CoarseGroup:%4d active_nr:%6d  active:%d \nCorners:\n",i,j,k,cell->host_cell, cell->coarse_group , cell->active_index[MATRIX_INDEX], cell->active);
 
-  ecl_cell_assert_center( cell );
   fprintf(stream , "Center   : ");
-  point_dump_ascii( &cell->center , stream , offset);
+  point_dump_ascii( center , stream , offset);
   fprintf(stream , "\n");
 
   {
     int l;
     for (l=0; l < 8; l++) {
       fprintf(stream , "Corner %d : ",l);
-      point_dump_ascii( &cell->corner_list[l] , stream , offset);
+      point_dump_ascii( &corner_list[l] , stream , offset);
       fprintf(stream , "\n");
     }
   }
@@ -840,7 +875,7 @@ static void ecl_cell_dump_ascii( ecl_cell_type * cell , int i , int j , int k ,
 }
 
 
-static void ecl_cell_fwrite_GRID( const ecl_grid_type * grid , const ecl_cell_type * cell , bool fracture_cell , int coords_size , int i, int j , int k , int global_index , ecl_kw_type * coords_kw , ecl_kw_type * corners_kw, fortio_type * fortio) {
+static void ecl_cell_fwrite_GRID( const ecl_grid_type * grid , const ecl_cell_type * cell , const point_type * corner_list , bool fracture_cell , int coords_size , int i, int j , int k , int global_index , ecl_kw_type * coords_kw , ecl_kw_type * corners_kw, fortio_type * fortio) {
   ecl_kw_iset_int( coords_kw , 0 , i + 1);
   ecl_kw_iset_int( coords_kw , 1 , j + 1);
   ecl_kw_iset_int( coords_kw , 2 , k + 1);
@@ -867,7 +902,7 @@ static void ecl_cell_fwrite_GRID( const ecl_grid_type * grid , const ecl_cell_ty
     int c;
 
     for (c = 0; c < 8; c++) {
-      point_copy_values( &point , &cell->corner_list[c] );
+      point_copy_values( &point , &corner_list[c] );
       if (grid->use_mapaxes)
         point_mapaxes_invtransform( &point , grid->origo , grid->unit_x , grid->unit_y );
 
@@ -880,7 +915,7 @@ static void ecl_cell_fwrite_GRID( const ecl_grid_type * grid , const ecl_cell_ty
 }
 
 //static const size_t cellMappingECLRi[8] = { 0, 1, 3, 2, 4, 5, 7, 6 };
-static void ecl_cell_ri_export( const ecl_cell_type * cell , double * ri_points) {
+static void ecl_cell_ri_export( const point_type * corner_list , double * ri_points) {
   int ecl_offset = 4;
   int ri_offset =  ecl_offset * 3;
   {
@@ -888,14 +923,14 @@ static void ecl_cell_ri_export( const ecl_cell_type * cell , double * ri_points)
     // Handling the points 0,1 & 4,5 which map directly between ECLIPSE and RI
     for (point_nr =0; point_nr < 2; point_nr++) {
       // Points 0 & 1
-      ri_points[ point_nr * 3     ] =  cell->corner_list[point_nr].x;
-      ri_points[ point_nr * 3 + 1 ] =  cell->corner_list[point_nr].y;
-      ri_points[ point_nr * 3 + 2 ] = -cell->corner_list[point_nr].z;
+      ri_points[ point_nr * 3     ] =  corner_list[point_nr].x;
+      ri_points[ point_nr * 3 + 1 ] =  corner_list[point_nr].y;
+      ri_points[ point_nr * 3 + 2 ] = -corner_list[point_nr].z;
 
       // Points 4 & 5
-      ri_points[ ri_offset + point_nr * 3     ] =  cell->corner_list[ecl_offset + point_nr].x;
-      ri_points[ ri_offset + point_nr * 3 + 1 ] =  cell->corner_list[ecl_offset + point_nr].y;
-      ri_points[ ri_offset + point_nr * 3 + 2 ] = -cell->corner_list[ecl_offset + point_nr].z;
+      ri_points[ ri_offset + point_nr * 3     ] =  corner_list[ecl_offset + point_nr].x;
+      ri_points[ ri_offset + point_nr * 3 + 1 ] =  corner_list[ecl_offset + point_nr].y;
+      ri_points[ ri_offset + point_nr * 3 + 2 ] = -corner_list[ecl_offset + point_nr].z;
     }
   }
 
@@ -908,15 +943,15 @@ static void ecl_cell_ri_export( const ecl_cell_type * cell , double * ri_points)
     for (ecl_point =2; ecl_point < 4; ecl_point++) {
       int ri_point = 5 - ecl_point;
       // Points 2 & 3
-      ri_points[ ri_point * 3     ] =  cell->corner_list[ecl_point].x;
-      ri_points[ ri_point * 3 + 1 ] =  cell->corner_list[ecl_point].y;
-      ri_points[ ri_point * 3 + 2 ] = -cell->corner_list[ecl_point].z;
+      ri_points[ ri_point * 3     ] =  corner_list[ecl_point].x;
+      ri_points[ ri_point * 3 + 1 ] =  corner_list[ecl_point].y;
+      ri_points[ ri_point * 3 + 2 ] = -corner_list[ecl_point].z;
 
 
       // Points 6 & 7
-      ri_points[ ri_offset + ri_point * 3     ] =  cell->corner_list[ecl_offset + ecl_point].x;
-      ri_points[ ri_offset + ri_point * 3 + 1 ] =  cell->corner_list[ecl_offset + ecl_point].y;
-      ri_points[ ri_offset + ri_point * 3 + 2 ] = -cell->corner_list[ecl_offset + ecl_point].z;
+      ri_points[ ri_offset + ri_point * 3     ] =  corner_list[ecl_offset + ecl_point].x;
+      ri_points[ ri_offset + ri_point * 3 + 1 ] =  corner_list[ecl_offset + ecl_point].y;
+      ri_points[ ri_offset + ri_point * 3 + 2 ] = -corner_list[ecl_offset + ecl_point].z;
     }
   }
 }
@@ -951,12 +986,12 @@ static  double min8( double x1 , double x2 , double x3, double x4 , double x5 ,
 
 /*****************************************************************/
 
-static double ecl_cell_min_z( const ecl_cell_type * cell) {
-  return min4( cell->corner_list[0].z , cell->corner_list[1].z , cell->corner_list[2].z , cell->corner_list[3].z);
+static double ecl_cell_min_z( const point_type * corner_list) {
+  return min4( corner_list[0].z , corner_list[1].z , corner_list[2].z , corner_list[3].z);
 }
 
-static double ecl_cell_max_z( const ecl_cell_type * cell ) {
-  return max4( cell->corner_list[4].z , cell->corner_list[5].z , cell->corner_list[6].z , cell->corner_list[7].z );
+static double ecl_cell_max_z( const point_type * corner_list ) {
+  return max4( corner_list[4].z , corner_list[5].z , corner_list[6].z , corner_list[7].z );
 }
 
 
@@ -965,26 +1000,26 @@ static double ecl_cell_max_z( const ecl_cell_type * cell ) {
    plane for the x/y min/max.
 */
 
-static double ecl_cell_min_x( const ecl_cell_type * cell) {
-  return min8( cell->corner_list[0].x , cell->corner_list[1].x , cell->corner_list[2].x , cell->corner_list[3].x,
-               cell->corner_list[4].x , cell->corner_list[5].x , cell->corner_list[6].x , cell->corner_list[7].x );
+static double ecl_cell_min_x( const point_type * corner_list) {
+  return min8( corner_list[0].x , corner_list[1].x , corner_list[2].x , corner_list[3].x,
+               corner_list[4].x , corner_list[5].x , corner_list[6].x , corner_list[7].x );
 }
 
 
-static double ecl_cell_max_x( const ecl_cell_type * cell ) {
-  return max8( cell->corner_list[0].x , cell->corner_list[1].x , cell->corner_list[2].x , cell->corner_list[3].x,
-               cell->corner_list[4].x , cell->corner_list[5].x , cell->corner_list[6].x , cell->corner_list[7].x );
+static double ecl_cell_max_x( const point_type * corner_list ) {
+  return max8( corner_list[0].x , corner_list[1].x , corner_list[2].x , corner_list[3].x,
+               corner_list[4].x , corner_list[5].x , corner_list[6].x , corner_list[7].x );
 }
 
-static double ecl_cell_min_y( const ecl_cell_type * cell) {
-  return min8( cell->corner_list[0].y , cell->corner_list[1].y , cell->corner_list[2].y , cell->corner_list[3].y,
-               cell->corner_list[4].y , cell->corner_list[5].y , cell->corner_list[6].y , cell->corner_list[7].y );
+static double ecl_cell_min_y( const point_type * corner_list) {
+  return min8( corner_list[0].y , corner_list[1].y , corner_list[2].y , corner_list[3].y,
+               corner_list[4].y , corner_list[5].y , corner_list[6].y , corner_list[7].y );
 }
 
 
-static double ecl_cell_max_y( const ecl_cell_type * cell ) {
-  return max8( cell->corner_list[0].y , cell->corner_list[1].y , cell->corner_list[2].y , cell->corner_list[3].y,
-               cell->corner_list[4].y , cell->corner_list[5].y , cell->corner_list[6].y , cell->corner_list[7].y );
+static double ecl_cell_max_y( const point_type * corner_list ) {
+  return max8( corner_list[0].y , corner_list[1].y , corner_list[2].y , corner_list[3].y,
+               corner_list[4].y , corner_list[5].y , corner_list[6].y , corner_list[7].y );
 }
 
 
@@ -1024,10 +1059,10 @@ static double ecl_cell_max_y( const ecl_cell_type * cell ) {
  */
 
 
-static void ecl_cell_taint_cell( ecl_cell_type * cell ) {
+static void ecl_cell_taint_cell( ecl_cell_type * cell , const point_type * corner_list ) {
   int c;
   for (c = 0; c < 8; c++) {
-    const point_type p = cell->corner_list[c];
+    const point_type p = corner_list[c];
     if ((p.x == 0) && (p.y == 0)) {
       SET_CELL_FLAG(cell , CELL_FLAG_TAINTED);
       break;
@@ -1039,10 +1074,10 @@ static void ecl_cell_taint_cell( ecl_cell_type * cell ) {
   */
   if (cell->active == CELL_NOT_ACTIVE) {
     if (!GET_CELL_FLAG(cell , CELL_FLAG_TAINTED)) {
-      const point_type p0 = cell->corner_list[0];
+      const point_type p0 = corner_list[0];
       int cell_index = 1;
       while (true) {
-        const point_type pi = cell->corner_list[cell_index];
+        const point_type pi = corner_list[cell_index];
         if (pi.z != p0.z)
           // There is a difference - the cell is certainly valid.
           break;
@@ -1062,12 +1097,12 @@ static void ecl_cell_taint_cell( ecl_cell_type * cell ) {
 
 
 
-static int ecl_cell_get_twist( const ecl_cell_type * cell ) {
+static int ecl_cell_get_twist( const point_type * corner_list ) {
   int twist_count = 0;
 
   for (int c = 0; c < 4; c++) {
-    const point_type * p1 = &cell->corner_list[c];
-    const point_type * p2 = &cell->corner_list[c + 4];
+    const point_type * p1 = &corner_list[c];
+    const point_type * p2 = &corner_list[c + 4];
     if ((p2->z - p1->z) < 0)
       twist_count += 1;
   }
@@ -1110,23 +1145,14 @@ static int ecl_cell_get_tetrahedron_method( int i , int j , int k) {
 #undef mod
 */
 
-static void ecl_cell_set_center( ecl_cell_type * cell) {
-  point_set(&cell->center , 0 , 0 , 0);
+static void ecl_cell_calc_center( const point_type * corner_list , point_type * center) {
+  point_set(center , 0 , 0 , 0);
   {
     int c;
     for (c = 0; c < 8; c++)
-      point_inplace_add(&cell->center , &cell->corner_list[c]);
+      point_inplace_add(center , &corner_list[c]);
   }
-  point_inplace_scale(&cell->center , 1.0 / 8.0);
-
-  SET_CELL_FLAG( cell , CELL_FLAG_CENTER );
-}
-
-
-
-static void ecl_cell_assert_center( ecl_cell_type * cell) {
-  if (!GET_CELL_FLAG(cell , CELL_FLAG_CENTER))
-    ecl_cell_set_center( cell );
+  point_inplace_scale(center , 1.0 / 8.0);
 }
 
 
@@ -1168,7 +1194,7 @@ static double C(double *r,int f1,int f2,int f3){
 }
 
 
-static double ecl_cell_get_volume_tskille( ecl_cell_type * cell ) {
+static double ecl_cell_get_volume_tskille( const point_type * corner_list ) {
   double volume = 0;
   int pb,pg,qa,qg,ra,rb;
   double X[8];
@@ -1177,9 +1203,9 @@ static double ecl_cell_get_volume_tskille( ecl_cell_type * cell ) {
   {
     int c;
     for (c = 0; c < 8; c++) {
-      X[c] = cell->corner_list[c].x;
-      Y[c] = cell->corner_list[c].y;
-      Z[c] = cell->corner_list[c].z;
+      X[c] = corner_list[c].x;
+      Y[c] = corner_list[c].y;
+      Z[c] = corner_list[c].z;
     }
   }
 
@@ -1249,19 +1275,15 @@ static inline double tetrahedron_volume6( tetrahedron_type tet ) {
  * when used in opm-parser and has been optimised significantly. This means
  * inlining several operations, e.g. vector operations, and other tricks.
  */
-static double ecl_cell_get_signed_volume( ecl_cell_type * cell) {
-  if (GET_CELL_FLAG(cell , CELL_FLAG_VOLUME))
-    return cell->volume;
-
-  ecl_cell_assert_center( cell );
+static double ecl_cell_calc_signed_volume( const point_type * corner_list , const point_type * cell_center) {
   {
     /*
      * We make an activation record local copy of the cell's corners for less
      * jumping in memory and better cache performance.
      */
-    point_type center = cell->center;
+    point_type center = *cell_center;
     point_type corners[ 8 ];
-    memcpy( corners, cell->corner_list, sizeof( point_type ) * 8 );
+    memcpy( corners, corner_list, sizeof( point_type ) * 8 );
 
     tetrahedron_type tet = { .p0 = center };
     double           volume = 0;
@@ -1305,15 +1327,8 @@ static double ecl_cell_get_signed_volume( ecl_cell_type * cell) {
      * reverted.
      */
 
-    cell->volume = volume * 0.5;
-    SET_CELL_FLAG( cell , CELL_FLAG_VOLUME );
+    return volume * 0.5;
   }
-  return cell->volume;
-}
-
-
-static double ecl_cell_get_volume( ecl_cell_type * cell ) {
-  return fabs( ecl_cell_get_signed_volume(cell));
 }
 
 
@@ -1368,7 +1383,7 @@ static bool triangle_contains(const point_type *p0 , const point_type * p1 , con
 */
 
 
-static bool ecl_cell_layer_contains_xy( const ecl_cell_type * cell , bool lower_layer , double x , double y) {
+static bool ecl_cell_layer_contains_xy( const ecl_cell_type * cell , const point_type * corner_list , bool lower_layer , double x , double y) {
   if (GET_CELL_FLAG(cell,CELL_FLAG_TAINTED))
     return false;
   {
@@ -1380,10 +1395,10 @@ static bool ecl_cell_layer_contains_xy( const ecl_cell_type * cell , bool lower_
       else
         corner_offset = 4;
 
-      p0 = &cell->corner_list[corner_offset + 0];
-      p1 = &cell->corner_list[corner_offset + 1];
-      p2 = &cell->corner_list[corner_offset + 2];
-      p3 = &cell->corner_list[corner_offset + 3];
+      p0 = &corner_list[corner_offset + 0];
+      p1 = &corner_list[corner_offset + 1];
+      p2 = &corner_list[corner_offset + 2];
+      p3 = &corner_list[corner_offset + 3];
     }
 
     if (triangle_contains(p0,p1,p2,x,y))
@@ -1402,23 +1417,23 @@ static bool ecl_cell_layer_contains_xy( const ecl_cell_type * cell , bool lower_
          |   |           |   |
          0---1           4---5
 */
-static void ecl_cell_init_regular( ecl_cell_type * cell , const double * offset , int i , int j , int k , int global_index , const double * ivec , const double * jvec , const double * kvec , const int * actnum ) {
-  point_set(&cell->corner_list[0] , offset[0] , offset[1] , offset[2] ); // Point 0
+static void ecl_cell_init_regular( ecl_cell_type * cell , point_type * corner_list , const double * offset , int i , int j , int k , int global_index , const double * ivec , const double * jvec , const double * kvec , const int * actnum ) {
+  point_set(&corner_list[0] , offset[0] , offset[1] , offset[2] ); // Point 0
 
-  cell->corner_list[1] = cell->corner_list[0];                       // Point 1
-  point_shift(&cell->corner_list[1] , ivec[0] , ivec[1] , ivec[2]);
+  corner_list[1] = corner_list[0];                       // Point 1
+  point_shift(&corner_list[1] , ivec[0] , ivec[1] , ivec[2]);
 
-  cell->corner_list[2] = cell->corner_list[0];                       // Point 2
-  point_shift(&cell->corner_list[2] , jvec[0] , jvec[1] , jvec[2]);
+  corner_list[2] = corner_list[0];                       // Point 2
+  point_shift(&corner_list[2] , jvec[0] , jvec[1] , jvec[2]);
 
-  cell->corner_list[3] = cell->corner_list[1];                       // Point 3
-  point_shift(&cell->corner_list[3] , jvec[0] , jvec[1] , jvec[2]);
+  corner_list[3] = corner_list[1];                       // Point 3
+  point_shift(&corner_list[3] , jvec[0] , jvec[1] , jvec[2]);
 
   {
     int i;
     for (i=0; i < 4; i++) {
-      cell->corner_list[i+4] = cell->corner_list[i];                      // Point 4-7
-      point_shift(&cell->corner_list[i+4] , kvec[0] , kvec[1] , kvec[2]);
+      corner_list[i+4] = corner_list[i];                      // Point 4-7
+      point_shift(&corner_list[i+4] , kvec[0] , kvec[1] , kvec[2]);
     }
   }
 
@@ -1446,6 +1461,70 @@ static ecl_cell_type * ecl_grid_get_cell(const ecl_grid_type * grid , int global
 }
 
 
+/*
+  The cell geometry. A normal grid stores the eight corners of all
+  the cells in the corners array, whereas a compact grid only keeps
+  the ZCORN and COORD data - i.e. 8 floats for each cell - and
+  calculates the corners on demand. The cell centers and volumes are
+  not stored, but calculated from the corners of the requested cell
+  when needed; that way a const grid can be queried concurrently.
+
+  The ecl_grid_get_cell_corners() function should be used to access
+  the corners; for a compact grid the corners are calculated into the
+  buffer argument which must have room for eight points. The
+  ecl_grid_get_cell_corners_rw() function can only be used when
+  constructing a normal grid.
+*/
+
+static void ecl_grid_calc_cell_corners_GRDECL( const ecl_grid_type * ecl_grid , const float * zcorn , const float * coord , int i , int j , int k , point_type * corner_list);
+
+
+static bool ecl_grid_is_compact__( const ecl_grid_type * grid ) {
+  return (grid->corners == NULL);
+}
+
+
+static point_type * ecl_grid_get_cell_corners_rw( const ecl_grid_type * grid , int global_index) {
+  return &grid->corners[ 8 * global_index ];
+}
+
+
+static const point_type * ecl_grid_get_cell_corners( const ecl_grid_type * grid , int global_index , point_type * buffer) {
+  if (!ecl_grid_is_compact__( grid ))
+    return &grid->corners[ 8 * global_index ];
+  {
+    const int nxy = grid->nx * grid->ny;
+    const int k = global_index / nxy;
+    const int j = (global_index - k * nxy) / grid->nx;
+    const int i = global_index - k * nxy - j * grid->nx;
+
+    ecl_grid_calc_cell_corners_GRDECL( grid , grid->zcorn , ecl_kw_get_float_ptr( grid->coord_kw ) , i , j , k , buffer );
+    return buffer;
+  }
+}
+
+
+static void ecl_grid_get_cell_center( const ecl_grid_type * grid , int global_index , point_type * center) {
+  point_type buffer[8];
+  ecl_cell_calc_center( ecl_grid_get_cell_corners( grid , global_index , buffer ) , center );
+}
+
+
+static double ecl_grid_get_cell_signed_volume( const ecl_grid_type * grid , int global_index ) {
+  point_type buffer[8];
+  point_type center;
+  const point_type * corner_list = ecl_grid_get_cell_corners( grid , global_index , buffer );
+
+  ecl_cell_calc_center( corner_list , &center );
+  return ecl_cell_calc_signed_volume( corner_list , &center );
+}
+
+
+static double ecl_grid_get_cell_volume__( const ecl_grid_type * grid , int global_index ) {
+  return fabs( ecl_grid_get_cell_signed_volume( grid , global_index ));
+}
+
+
 /**
    this function uses heuristics (ahhh - i hate it) in an attempt to
    mark cells with fucked geometry - see further comments in the
@@ -1456,7 +1535,8 @@ static void ecl_grid_taint_cells( ecl_grid_type * ecl_grid ) {
   int index;
   for (index = 0; index < ecl_grid->size; index++) {
     ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , index );
-    ecl_cell_taint_cell( cell );
+    point_type buffer[8];
+    ecl_cell_taint_cell( cell , ecl_grid_get_cell_corners( ecl_grid , index , buffer ));
   }
 }
 
@@ -1474,11 +1554,20 @@ static void ecl_grid_free_cells( ecl_grid_type * grid ) {
 
 }
 
-static bool ecl_grid_alloc_cells( ecl_grid_type * grid , bool init_valid) {
+static bool ecl_grid_alloc_cells( ecl_grid_type * grid , bool init_valid , bool compact) {
   grid->cells = malloc(grid->size * sizeof * grid->cells );
   if (!grid->cells)
     return false;
 
+  if (!compact) {
+    grid->corners = malloc( 8 * grid->size * sizeof * grid->corners );
+    if (!grid->corners) {
+      free( grid->cells );
+      grid->cells = NULL;
+      return false;
+    }
+  }
+
   {
     ecl_cell_type * cell0 = ecl_grid_get_cell( grid , 0 );
     ecl_cell_init( cell0 , init_valid );
@@ -1499,9 +1588,13 @@ static bool ecl_grid_alloc_cells( ecl_grid_type * grid , bool init_valid) {
    transformations; and set the global_grid pointer of the new grid
    instance. apart from that no further lgr-relationsip initialisation
    is performed.
+
+   if the compact argument is true the cell corners are not
+   allocated; the caller must then set the zcorn and coord_kw fields
+   before the corners can be calculated.
 */
 
-static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int dualp_flag , int nx , int ny , int nz, int lgr_nr, bool init_valid) {
+static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int dualp_flag , int nx , int ny , int nz, int lgr_nr, bool init_valid, bool compact) {
   ecl_grid_type * grid = util_malloc(sizeof * grid );
   UTIL_TYPE_ID_INIT(grid , ECL_GRID_ID);
   grid->total_active   = 0;
@@ -1517,7 +1610,14 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int du
 
   grid->dualp_flag            = dualp_flag;
   grid->coord_kw              = NULL;
-  grid->visited               = NULL;
+  grid->cells                 = NULL;
+  grid->corners               = NULL;
+  grid->zcorn                 = NULL;
+  grid->cell_index            = NULL;
+  grid->column_index          = NULL;
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_init( &grid->index_lock , NULL );
+#endif
   grid->inv_index_map         = NULL;
   grid->index_map             = NULL;
   grid->fracture_index_map    = NULL;
@@ -1568,7 +1668,7 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int du
   grid->eclipse_version = 0;
 
   /* This is the large allocation - which can potentially fail. */
-  if (!ecl_grid_alloc_cells( grid , init_valid )) {
+  if (!ecl_grid_alloc_cells( grid , init_valid , compact )) {
     ecl_grid_free( grid );
     grid = NULL;
   }
@@ -1584,25 +1684,10 @@ static  int ecl_grid_get_global_index__(const ecl_grid_type * ecl_grid , int i ,
 
 
 static void ecl_grid_set_cell_EGRID(ecl_grid_type * ecl_grid , int i, int j , int k ,
-                                    double x[4][2] , double y[4][2] , double z[4][2] ,
                                     const int * actnum, const int * corsnum) {
 
   const int global_index   = ecl_grid_get_global_index__(ecl_grid , i , j  , k );
   ecl_cell_type * cell     = ecl_grid_get_cell( ecl_grid , global_index );
-  int ip , iz;
-
-  for (iz = 0; iz < 2; iz++) {
-    for (ip = 0; ip < 4; ip++) {
-      int c = ip + iz * 4;
-      point_set(&cell->corner_list[c] , x[ip][iz] , y[ip][iz] , z[ip][iz]);
-
-      if (ecl_grid->use_mapaxes)
-        point_mapaxes_transform( &cell->corner_list[c] , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
-    }
-  }
-
-
-
 
   /*
     If actnum == NULL that is taken to mean active.
@@ -1700,11 +1785,12 @@ static void ecl_grid_set_cell_GRID(ecl_grid_type * ecl_grid , int coords_size ,
     }
 
     if (matrix_cell) {
+      point_type * corner_list = ecl_grid_get_cell_corners_rw( ecl_grid , global_index );
       for (c = 0; c < 8; c++) {
-        point_set(&cell->corner_list[c] , corners[3*c] , corners[3*c + 1] , corners[3*c + 2]);
+        point_set(&corner_list[c] , corners[3*c] , corners[3*c + 1] , corners[3*c + 2]);
 
         if (ecl_grid->use_mapaxes)
-          point_mapaxes_transform( &cell->corner_list[c] , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
+          point_mapaxes_transform( &corner_list[c] , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
 
       }
     }
@@ -2189,71 +2275,107 @@ int ecl_grid_zcorn_index(const ecl_grid_type * grid , int i, int j , int k , int
 }
 
 
-static void ecl_grid_init_GRDECL_data_jslice(ecl_grid_type * ecl_grid ,  const float * zcorn , const float * coord , const int * actnum, const int * corsnum , int j) {
+static void ecl_grid_init_pillars_GRDECL(const ecl_grid_type * ecl_grid , const float * coord , int i , int j ,
+                                        point_type pillars[4][2] , double ex[4] , double ey[4] , double ez[4]) {
+  const int nx = ecl_grid->nx;
+  int pillar_index[4];
+  int ip;
+
+  pillar_index[0] = 6 * ( j      * (nx + 1) + i    );
+  pillar_index[1] = 6 * ( j      * (nx + 1) + i + 1);
+  pillar_index[2] = 6 * ((j + 1) * (nx + 1) + i    );
+  pillar_index[3] = 6 * ((j + 1) * (nx + 1) + i + 1);
+
+  for (ip = 0; ip < 4; ip++) {
+    int index = pillar_index[ip];
+    point_set(&pillars[ip][0] , coord[index] , coord[index + 1] , coord[index + 2]);
+
+    index += 3;
+    point_set(&pillars[ip][1] , coord[index] , coord[index + 1] , coord[index + 2]);
+  }
+
+  for (ip = 0; ip <  4; ip++) {
+    ex[ip] = pillars[ip][1].x - pillars[ip][0].x;
+    ey[ip] = pillars[ip][1].y - pillars[ip][0].y;
+    ez[ip] = pillars[ip][1].z - pillars[ip][0].z;
+  }
+}
+
+
+static void ecl_grid_calc_pillar_corners_GRDECL(const ecl_grid_type * ecl_grid , const float * zcorn , int i , int j , int k ,
+                                                point_type pillars[4][2] , const double ex[4] , const double ey[4] , const double ez[4] ,
+                                                point_type * corner_list) {
   const int nx = ecl_grid->nx;
   const int ny = ecl_grid->ny;
-  const int nz = ecl_grid->nz;
-  int i;
+  double x[4][2];
+  double y[4][2];
+  double z[4][2];
+  int ip , iz;
 
+  for (iz = 0; iz < 2; iz++) {
+    z[0][iz] = zcorn[k*8*nx*ny + j*4*nx + 2*i            + iz*4*nx*ny];
+    z[1][iz] = zcorn[k*8*nx*ny + j*4*nx + 2*i  +  1      + iz*4*nx*ny];
+    z[2][iz] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i     + iz*4*nx*ny];
+    z[3][iz] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i + 1 + iz*4*nx*ny];
+  }
 
-  for (i=0; i < nx; i++) {
-    point_type pillars[4][2];
-    int pillar_index[4];
-    pillar_index[0] = 6 * ( j      * (nx + 1) + i    );
-    pillar_index[1] = 6 * ( j      * (nx + 1) + i + 1);
-    pillar_index[2] = 6 * ((j + 1) * (nx + 1) + i    );
-    pillar_index[3] = 6 * ((j + 1) * (nx + 1) + i + 1);
+  for (ip = 0; ip <  4; ip++)
+    ecl_grid_pillar_cross_planes(&pillars[ip][0] , ex[ip], ey[ip] , ez[ip] , z[ip] , x[ip] , y[ip]);
 
-    {
-      int ip;
-      for (ip = 0; ip < 4; ip++) {
-        int index = pillar_index[ip];
-        point_set(&pillars[ip][0] , coord[index] , coord[index + 1] , coord[index + 2]);
+  for (iz = 0; iz < 2; iz++) {
+    for (ip = 0; ip < 4; ip++) {
+      int c = ip + iz * 4;
+      point_set(&corner_list[c] , x[ip][iz] , y[ip][iz] , z[ip][iz]);
 
-        index += 3;
-        point_set(&pillars[ip][1] , coord[index] , coord[index + 1] , coord[index + 2]);
-      }
+      if (ecl_grid->use_mapaxes)
+        point_mapaxes_transform( &corner_list[c] , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
     }
+  }
+}
 
-    {
-      double ex[4];
-      double ey[4];
-      double ez[4];
-      int k;
 
-      {
-        int ip;
-        for (ip = 0; ip <  4; ip++) {
-          ex[ip] = pillars[ip][1].x - pillars[ip][0].x;
-          ey[ip] = pillars[ip][1].y - pillars[ip][0].y;
-          ez[ip] = pillars[ip][1].z - pillars[ip][0].z;
-        }
-      }
+/*
+  Calculates the corners of one cell from the ZCORN and COORD
+  data. This is used on demand for compact grids, the normal grids
+  calculate the corners of one column at a time in the jslice
+  function below.
+*/
 
+static void ecl_grid_calc_cell_corners_GRDECL( const ecl_grid_type * ecl_grid , const float * zcorn , const float * coord , int i , int j , int k , point_type * corner_list) {
+  point_type pillars[4][2];
+  double ex[4];
+  double ey[4];
+  double ez[4];
 
-      for (k=0; k < nz; k++) {
-        double x[4][2];
-        double y[4][2];
-        double z[4][2];
+  ecl_grid_init_pillars_GRDECL( ecl_grid , coord , i , j , pillars , ex , ey , ez );
+  ecl_grid_calc_pillar_corners_GRDECL( ecl_grid , zcorn , i , j , k , pillars , ex , ey , ez , corner_list );
+}
 
-        {
-          int c;
-          for (c = 0; c < 2; c++) {
-            z[0][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i            + c*4*nx*ny];
-            z[1][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i  +  1      + c*4*nx*ny];
-            z[2][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i     + c*4*nx*ny];
-            z[3][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i + 1 + c*4*nx*ny];
-          }
-        }
 
-        {
-          int ip;
-          for (ip = 0; ip <  4; ip++)
-            ecl_grid_pillar_cross_planes(&pillars[ip][0] , ex[ip], ey[ip] , ez[ip] , z[ip] , x[ip] , y[ip]);
-        }
+static void ecl_grid_init_GRDECL_data_jslice(ecl_grid_type * ecl_grid ,  const float * zcorn , const float * coord , const int * actnum, const int * corsnum , int j) {
+  const int nx = ecl_grid->nx;
+  const int nz = ecl_grid->nz;
+  const bool compact = ecl_grid_is_compact__( ecl_grid );
+  int i;
 
-        ecl_grid_set_cell_EGRID(ecl_grid , i , j , k , x , y , z , actnum , corsnum);
+
+  for (i=0; i < nx; i++) {
+    point_type pillars[4][2];
+    double ex[4];
+    double ey[4];
+    double ez[4];
+    int k;
+
+    if (!compact)
+      ecl_grid_init_pillars_GRDECL( ecl_grid , coord , i , j , pillars , ex , ey , ez );
+
+    for (k=0; k < nz; k++) {
+      if (!compact) {
+        int global_index = ecl_grid_get_global_index__( ecl_grid , i , j , k );
+        ecl_grid_calc_pillar_corners_GRDECL( ecl_grid , zcorn , i , j , k , pillars , ex , ey , ez ,
+                                             ecl_grid_get_cell_corners_rw( ecl_grid , global_index ));
       }
+      ecl_grid_set_cell_EGRID(ecl_grid , i , j , k , actnum , corsnum);
     }
   }
 }
@@ -2278,9 +2400,9 @@ void ecl_grid_init_GRDECL_data(ecl_grid_type * ecl_grid ,  const float * zcorn ,
 static ecl_grid_type * ecl_grid_alloc_GRDECL_data__(ecl_grid_type * global_grid ,
                                                     int dualp_flag , bool apply_mapaxes, int nx , int ny , int nz ,
                                                     const float * zcorn , const float * coord , const int * actnum, const float * mapaxes, const int * corsnum,
-                                                    int lgr_nr) {
+                                                    int lgr_nr, bool compact) {
 
-  ecl_grid_type * ecl_grid = ecl_grid_alloc_empty(global_grid , dualp_flag , nx,ny,nz,lgr_nr,true);
+  ecl_grid_type * ecl_grid = ecl_grid_alloc_empty(global_grid , dualp_flag , nx,ny,nz,lgr_nr,true,compact);
   if (ecl_grid) {
     if (mapaxes != NULL)
       ecl_grid_init_mapaxes( ecl_grid , apply_mapaxes, mapaxes );
@@ -2289,6 +2411,8 @@ static ecl_grid_type * ecl_grid_alloc_GRDECL_data__(ecl_grid_type * global_grid
       ecl_grid->coarsening_active = true;
 
     ecl_grid->coord_kw = ecl_kw_alloc_new("COORD" , 6*(nx + 1) * (ny + 1) , ECL_FLOAT_TYPE , coord );
+    if (compact)
+      ecl_grid->zcorn = util_alloc_copy( zcorn , 8 * ecl_grid->size * sizeof * zcorn );
     ecl_grid_init_GRDECL_data( ecl_grid , zcorn , coord , actnum , corsnum);
 
     ecl_grid_init_coarse_cells( ecl_grid );
@@ -2324,6 +2448,13 @@ static void ecl_grid_copy_content( ecl_grid_type * target_grid , const ecl_grid_
     if (src_cell->nnc_info)
       target_cell->nnc_info = nnc_info_alloc_copy( src_cell->nnc_info );
   }
+
+  if (ecl_grid_is_compact__( src_grid )) {
+    target_grid->zcorn = util_alloc_copy( src_grid->zcorn , 8 * src_grid->size * sizeof * src_grid->zcorn );
+    target_grid->coord_kw = ecl_kw_alloc_copy( src_grid->coord_kw );
+  } else
+    memcpy( target_grid->corners , src_grid->corners , 8 * src_grid->size * sizeof * src_grid->corners );
+
   ecl_grid_copy_mapaxes( target_grid , src_grid );
 
   target_grid->parent_name = util_alloc_string_copy( src_grid->parent_name );
@@ -2340,7 +2471,8 @@ static ecl_grid_type * ecl_grid_alloc_copy__( const ecl_grid_type * src_grid,  e
                                                     ecl_grid_get_ny( src_grid ) ,
                                                     ecl_grid_get_nz( src_grid ) ,
                                                     0 ,
-                                                    false );
+                                                    false ,
+                                                    ecl_grid_is_compact__( src_grid ));
   if (copy_grid) {
     ecl_grid_copy_content( copy_grid , src_grid );  // This will handle everything except LGR relationships which is established in the calling routine
     ecl_grid_update_index( copy_grid );
@@ -2432,7 +2564,7 @@ ecl_grid_type * ecl_grid_alloc_processed_copy( const ecl_grid_type * src_grid ,
 */
 
 ecl_grid_type * ecl_grid_alloc_GRDECL_data(int nx , int ny , int nz , const float * zcorn , const float * coord , const int * actnum, bool apply_mapaxes , const float * mapaxes) {
-  return ecl_grid_alloc_GRDECL_data__(NULL , FILEHEAD_SINGLE_POROSITY , apply_mapaxes , nx , ny , nz , zcorn , coord , actnum , mapaxes , NULL , 0);
+  return ecl_grid_alloc_GRDECL_data__(NULL , FILEHEAD_SINGLE_POROSITY , apply_mapaxes , nx , ny , nz , zcorn , coord , actnum , mapaxes , NULL , 0 , false);
 }
 
 
@@ -2461,7 +2593,8 @@ static ecl_grid_type * ecl_grid_alloc_GRDECL_kw__(ecl_grid_type * global_grid ,
                                                   const ecl_kw_type * coord_kw ,
                                                   const ecl_kw_type * actnum_kw ,    /* Can be NULL */
                                                   const ecl_kw_type * mapaxes_kw ,   /* Can be NULL */
-                                                  const ecl_kw_type * corsnum_kw) {   /* Can be NULL */
+                                                  const ecl_kw_type * corsnum_kw,     /* Can be NULL */
+                                                  bool compact) {
    int gtype, nx,ny,nz, lgr_nr;
 
   gtype   = ecl_kw_iget_int(gridhead_kw , GRIDHEAD_TYPE_INDEX);
@@ -2505,7 +2638,8 @@ static ecl_grid_type * ecl_grid_alloc_GRDECL_kw__(ecl_grid_type * global_grid ,
                                         actnum_data,
                                         mapaxes_data,
                                         corsnum_data,
-                                        lgr_nr);
+                                        lgr_nr,
+                                        compact);
   }
 }
 
@@ -2525,7 +2659,7 @@ ecl_grid_type * ecl_grid_alloc_GRDECL_kw( int nx, int ny , int nz ,
 
   bool apply_mapaxes = true;
   ecl_kw_type * gridhead_kw = ecl_grid_alloc_gridhead_kw( nx , ny , nz , 0);
-  ecl_grid_type * ecl_grid = ecl_grid_alloc_GRDECL_kw__(NULL , FILEHEAD_SINGLE_POROSITY , apply_mapaxes , gridhead_kw , zcorn_kw , coord_kw , actnum_kw , mapaxes_kw , NULL);
+  ecl_grid_type * ecl_grid = ecl_grid_alloc_GRDECL_kw__(NULL , FILEHEAD_SINGLE_POROSITY , apply_mapaxes , gridhead_kw , zcorn_kw , coord_kw , actnum_kw , mapaxes_kw , NULL , false);
   ecl_kw_free( gridhead_kw );
   return ecl_grid;
 
@@ -2741,7 +2875,7 @@ static void ecl_grid_init_nnc_amalgamated(ecl_grid_type * main_grid, ecl_file_ty
 */
 
 
-static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const ecl_file_type * ecl_file , int grid_nr, bool apply_mapaxes) {
+static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const ecl_file_type * ecl_file , int grid_nr, bool apply_mapaxes, bool compact) {
   ecl_kw_type * gridhead_kw  = ecl_file_iget_named_kw( ecl_file , GRIDHEAD_KW  , grid_nr);
   ecl_kw_type * zcorn_kw     = ecl_file_iget_named_kw( ecl_file , ZCORN_KW     , grid_nr);
   ecl_kw_type * coord_kw     = ecl_file_iget_named_kw( ecl_file , COORD_KW     , grid_nr);
@@ -2784,7 +2918,8 @@ static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const
                                                            coord_kw ,
                                                            actnum_kw ,
                                                            mapaxes_kw ,
-                                                           corsnum_kw );
+                                                           corsnum_kw ,
+                                                           compact );
 
     if (ECL_GRID_MAINGRID_LGR_NR != grid_nr) ecl_grid_set_lgr_name_EGRID(ecl_grid , ecl_file , grid_nr);
     ecl_grid->eclipse_version = eclipse_version;
@@ -2794,7 +2929,7 @@ static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const
 
 
 
-ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes) {
+static ecl_grid_type * ecl_grid_alloc_EGRID_file__(const char * grid_file, bool apply_mapaxes, bool compact) {
   ecl_file_enum   file_type;
   file_type = ecl_util_get_file_type(grid_file , NULL , NULL);
   if (file_type != ECL_EGRID_FILE)
@@ -2803,11 +2938,11 @@ ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes)
     ecl_file_type * ecl_file   = ecl_file_open( grid_file , 0);
     if (ecl_file) {
       int num_grid               = ecl_file_get_num_named_kw( ecl_file , GRIDHEAD_KW );
-      ecl_grid_type * main_grid  = ecl_grid_alloc_EGRID__( NULL , ecl_file , 0 , apply_mapaxes);
+      ecl_grid_type * main_grid  = ecl_grid_alloc_EGRID__( NULL , ecl_file , 0 , apply_mapaxes , compact);
       int grid_nr;
 
       for ( grid_nr = 1; grid_nr < num_grid; grid_nr++) {
-        ecl_grid_type * lgr_grid = ecl_grid_alloc_EGRID__( main_grid , ecl_file , grid_nr , false);  /* The apply_mapaxes argument is ignored for LGR - it inherits from parent anyway. */
+        ecl_grid_type * lgr_grid = ecl_grid_alloc_EGRID__( main_grid , ecl_file , grid_nr , false , compact);  /* The apply_mapaxes argument is ignored for LGR - it inherits from parent anyway. */
         ecl_grid_add_lgr( main_grid , lgr_grid );
         {
           ecl_grid_type * host_grid;
@@ -2832,6 +2967,11 @@ ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes)
 }
 
 
+ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes) {
+  return ecl_grid_alloc_EGRID_file__( grid_file , apply_mapaxes , false );
+}
+
+
 
 
 
@@ -2839,7 +2979,7 @@ static ecl_grid_type * ecl_grid_alloc_GRID_data__(ecl_grid_type * global_grid ,
   if (dualp_flag != FILEHEAD_SINGLE_POROSITY)
     nz = nz / 2;
   {
-    ecl_grid_type * grid = ecl_grid_alloc_empty( global_grid , dualp_flag , nx , ny , nz , grid_nr, false);
+    ecl_grid_type * grid = ecl_grid_alloc_empty( global_grid , dualp_flag , nx , ny , nz , grid_nr, false, false);
     if (grid) {
       if (mapaxes != NULL)
         ecl_grid_init_mapaxes( grid , apply_mapaxes , mapaxes);
@@ -3078,7 +3218,7 @@ ecl_grid_type * ecl_grid_alloc_GRID(const char * grid_file, bool apply_mapaxes)
    which case all cells will be active.
 */
 ecl_grid_type * ecl_grid_alloc_regular( int nx, int ny , int nz , const double * ivec, const double * jvec , const double * kvec , const int * actnum) {
-  ecl_grid_type * grid = ecl_grid_alloc_empty(NULL , FILEHEAD_SINGLE_POROSITY , nx , ny , nz , 0, true);
+  ecl_grid_type * grid = ecl_grid_alloc_empty(NULL , FILEHEAD_SINGLE_POROSITY , nx , ny , nz , 0, true, false);
   if (grid) {
     const double grid_offset[3] = {0,0,0};
 
@@ -3094,7 +3234,7 @@ ecl_grid_type * ecl_grid_alloc_regular( int nx, int ny , int nz , const double *
           };
 
           ecl_cell_type * cell = ecl_grid_get_cell(grid , global_index );
-          ecl_cell_init_regular( cell , offset , i,j,k,global_index , ivec , jvec , kvec , actnum );
+          ecl_cell_init_regular( cell , ecl_grid_get_cell_corners_rw( grid , global_index ) , offset , i,j,k,global_index , ivec , jvec , kvec , actnum );
         }
       }
     }
@@ -3138,7 +3278,8 @@ ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv( int nx, int ny , int nz , const doub
     ecl_grid_type* grid = ecl_grid_alloc_empty(NULL,
                                                FILEHEAD_SINGLE_POROSITY,
                                                nx, ny, nz,
-                                               /*lgr_nr=*/0, /*init_valid=*/true);
+                                               /*lgr_nr=*/0, /*init_valid=*/true,
+                                               /*compact=*/false);
     if (grid) {
       double ivec[3] = { 0, 0, 0 };
       double jvec[3] = { 0, 0, 0 };
@@ -3159,7 +3300,7 @@ ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv( int nx, int ny , int nz , const doub
             ecl_cell_type* cell = ecl_grid_get_cell(grid, global_index);
             ivec[0] = dxv[i];
 
-            ecl_cell_init_regular(cell, offset,
+            ecl_cell_init_regular(cell, ecl_grid_get_cell_corners_rw(grid, global_index), offset,
                                   i,j,k,global_index,
                                   ivec,jvec,kvec,
                                   actnum);
@@ -3181,7 +3322,8 @@ ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv_depthz( int nx, int ny , int nz , con
     ecl_grid_type* grid = ecl_grid_alloc_empty(NULL,
                                                FILEHEAD_SINGLE_POROSITY,
                                                nx, ny, nz,
-                                               /*lgr_nr=*/0, /*init_valid=*/true);
+                                               /*lgr_nr=*/0, /*init_valid=*/true,
+                                               /*compact=*/false);
 
 
     /* First layer - where the DEPTHZ keyword applies. */
@@ -3193,22 +3335,22 @@ ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv_depthz( int nx, int ny , int nz , con
         double x0 = 0;
         for (i = 0; i < nx; i++) {
           int global_index = i + j*nx + k*nx*ny;
-          ecl_cell_type* cell = ecl_grid_get_cell(grid, global_index);
+          point_type * corner_list = ecl_grid_get_cell_corners_rw(grid, global_index);
           double z0 = depthz[ i     + j*(nx + 1)];
           double z1 = depthz[ i + 1 + j*(nx + 1)];
           double z2 = depthz[ i +     (j + 1)*(nx + 1)];
           double z3 = depthz[ i + 1 + (j + 1)*(nx + 1)];
 
 
-          point_set(&cell->corner_list[0] , x0 , y0 , z0);
-          point_set(&cell->corner_list[1] , x0 + dxv[i] , y0 , z1);
-          point_set(&cell->corner_list[2] , x0          , y0 + dyv[j] , z2);
-          point_set(&cell->corner_list[3] , x0 + dxv[i] , y0 + dyv[j] , z3);
+          point_set(&corner_list[0] , x0 , y0 , z0);
+          point_set(&corner_list[1] , x0 + dxv[i] , y0 , z1);
+          point_set(&corner_list[2] , x0          , y0 + dyv[j] , z2);
+          point_set(&corner_list[3] , x0 + dxv[i] , y0 + dyv[j] , z3);
           {
             int c;
             for (c = 0; c < 4; c++) {
-              cell->corner_list[c + 4] = cell->corner_list[c];
-              point_shift(&cell->corner_list[c + 4] , 0 , 0 , dzv[0]);
+              corner_list[c + 4] = corner_list[c];
+              point_shift(&corner_list[c + 4] , 0 , 0 , dzv[0]);
             }
           }
           x0 += dxv[i];
@@ -3225,14 +3367,14 @@ ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv_depthz( int nx, int ny , int nz , con
           for (i=0; i < nx; i++) {
             int g2 = i + j*nx + k*nx*ny;
             int g1 = i + j*nx + (k - 1)*nx*ny;
-            ecl_cell_type* cell2 = ecl_grid_get_cell(grid, g2);
-            ecl_cell_type* cell1 = ecl_grid_get_cell(grid, g1);
+            point_type * corners2 = ecl_grid_get_cell_corners_rw(grid, g2);
+            const point_type * corners1 = ecl_grid_get_cell_corners_rw(grid, g1);
             int c;
 
             for (c = 0; c < 4; c++) {
-              cell2->corner_list[c] = cell1->corner_list[c + 4];
-              cell2->corner_list[c + 4] = cell1->corner_list[c + 4];
-              point_shift( &cell2->corner_list[c + 4] , 0 , 0 , dzv[k]);
+              corners2[c] = corners1[c + 4];
+              corners2[c + 4] = corners1[c + 4];
+              point_shift( &corners2[c + 4] , 0 , 0 , dzv[k]);
             }
           }
         }
@@ -3285,7 +3427,7 @@ ecl_grid_type * ecl_grid_alloc_dx_dy_dz_tops( int nx, int ny , int nz , const do
   ecl_grid_type* grid = ecl_grid_alloc_empty(NULL,
                                              FILEHEAD_SINGLE_POROSITY,
                                              nx, ny, nz,
-                                             0, true);
+                                             0, true, false);
   if (grid) {
     int i, j, k;
     double * y0 = util_calloc( nx, sizeof * y0 );
@@ -3299,17 +3441,18 @@ ecl_grid_type * ecl_grid_alloc_dx_dy_dz_tops( int nx, int ny , int nz , const do
         for (i=0; i < nx; i++) {
           int g = i + j*nx + k*nx*ny;
           ecl_cell_type* cell = ecl_grid_get_cell(grid, g);
+          point_type * corner_list = ecl_grid_get_cell_corners_rw(grid, g);
           double z0 = tops[ g ];
 
-          point_set(&cell->corner_list[0] , x0         , y0[i]         , z0);
-          point_set(&cell->corner_list[1] , x0 + dx[g] , y0[i]         , z0);
-          point_set(&cell->corner_list[2] , x0         , y0[i] + dy[g] , z0);
-          point_set(&cell->corner_list[3] , x0 + dx[g] , y0[i] + dy[g] , z0);
+          point_set(&corner_list[0] , x0         , y0[i]         , z0);
+          point_set(&corner_list[1] , x0 + dx[g] , y0[i]         , z0);
+          point_set(&corner_list[2] , x0         , y0[i] + dy[g] , z0);
+          point_set(&corner_list[3] , x0 + dx[g] , y0[i] + dy[g] , z0);
 
-          point_set(&cell->corner_list[4] , x0         , y0[i]         , z0 + dz[g]);
-          point_set(&cell->corner_list[5] , x0 + dx[g] , y0[i]         , z0 + dz[g]);
-          point_set(&cell->corner_list[6] , x0         , y0[i] + dy[g] , z0 + dz[g]);
-          point_set(&cell->corner_list[7] , x0 + dx[g] , y0[i] + dy[g] , z0 + dz[g]);
+          point_set(&corner_list[4] , x0         , y0[i]         , z0 + dz[g]);
+          point_set(&corner_list[5] , x0 + dx[g] , y0[i]         , z0 + dz[g]);
+          point_set(&corner_list[6] , x0         , y0[i] + dy[g] , z0 + dz[g]);
+          point_set(&corner_list[7] , x0 + dx[g] , y0[i] + dy[g] , z0 + dz[g]);
 
           x0    += dx[g];
           y0[i] += dy[g];
@@ -3362,6 +3505,35 @@ ecl_grid_type * ecl_grid_alloc(const char * grid_file ) {
 }
 
 
+/**
+   Will allocate a grid with the compact geometry representation;
+   i.e. the cell corners are not stored, instead the ZCORN and COORD
+   keywords are kept in float arrays and the corners are calculated
+   when needed. This reduces the memory usage of the geometry from 192
+   bytes per cell to roughly 32 bytes per cell, at the cost of slower
+   corner based accessors. The cell centers and volumes are cached
+   when first calculated.
+
+   The compact representation is only available for EGRID files; for
+   GRID files this function returns a normal grid.
+*/
+
+ecl_grid_type * ecl_grid_alloc_compact(const char * grid_file ) {
+  bool apply_mapaxes = true;
+  ecl_file_enum file_type = ecl_util_get_file_type(grid_file , NULL ,  NULL);
+
+  if (file_type == ECL_EGRID_FILE)
+    return ecl_grid_alloc_EGRID_file__( grid_file , apply_mapaxes , true );
+  else
+    return ecl_grid_alloc__( grid_file , apply_mapaxes );
+}
+
+
+bool ecl_grid_is_compact( const ecl_grid_type * grid ) {
+  return ecl_grid_is_compact__( grid );
+}
+
+
 static void ecl_grid_file_nactive_dims( fortio_type * data_fortio , int * dims) {
   if (data_fortio) {
     if (ecl_kw_fseek_kw( INTEHEAD_KW , false , false , data_fortio )) {
@@ -3604,18 +3776,26 @@ static bool ecl_grid_compare_cells(const ecl_grid_type * g1 , const ecl_grid_typ
     bool this_equal = true;
     ecl_cell_type *c1 = ecl_grid_get_cell( g1 , g );
     ecl_cell_type *c2 = ecl_grid_get_cell( g2 , g );
-    ecl_cell_compare(c1 , c2 ,  include_nnc , &this_equal);
+    point_type buffer1[8];
+    point_type buffer2[8];
+    const point_type * corners1 = ecl_grid_get_cell_corners( g1 , g , buffer1 );
+    const point_type * corners2 = ecl_grid_get_cell_corners( g2 , g , buffer2 );
+    ecl_cell_compare(c1 , corners1 , c2 , corners2 , include_nnc , &this_equal);
 
     if (!this_equal) {
       if (verbose) {
         int i,j,k;
         ecl_grid_get_ijk1( g1 , g , &i , &j , &k);
 
-        printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , nnc_info_equal( c1->nnc_info , c2->nnc_info) , ecl_cell_get_volume( c1 ));
+        printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , nnc_info_equal( c1->nnc_info , c2->nnc_info) , ecl_grid_get_cell_volume__( g1 , g ));
         printf("-----------------------------------------------------------------\n");
-        ecl_cell_dump_ascii( c1 , i , j , k , stdout , NULL);
+        point_type center1 , center2;
+
+        ecl_grid_get_cell_center( g1 , g , &center1 );
+        ecl_grid_get_cell_center( g2 , g , &center2 );
+        ecl_cell_dump_ascii( c1 , &center1 , corners1 , i , j , k , stdout , NULL);
         printf("-----------------------------------------------------------------\n");
-        ecl_cell_dump_ascii( c2 , i , j , k , stdout , NULL );
+        ecl_cell_dump_ascii( c2 , &center2 , corners2 , i , j , k , stdout , NULL );
         printf("-----------------------------------------------------------------\n");
 
       }
@@ -3782,7 +3962,10 @@ bool ecl_grid_compare(const ecl_grid_type * g1 , const ecl_grid_type * g2 , bool
 bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j , int k, double x , double y , double z) {
   const double min_volume = 1e-9;
   point_type p;
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , ecl_grid_get_global_index3( ecl_grid , i, j , k ));
+  const int global_index = ecl_grid_get_global_index3( ecl_grid , i, j , k );
+  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
+  point_type buffer[8];
+  const point_type * corner_list = ecl_grid_get_cell_corners( ecl_grid , global_index , buffer );
   point_set( &p , x , y , z);
   /*
     1. first check if the point z value is below the deepest point of
@@ -3797,46 +3980,46 @@ bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j
     return false;
   }
 
-  if (p.z < ecl_cell_min_z( cell ))
+  if (p.z < ecl_cell_min_z( corner_list ))
     return false;
 
-  if (p.z > ecl_cell_max_z( cell ))
+  if (p.z > ecl_cell_max_z( corner_list ))
     return false;
 
-  if (p.x < ecl_cell_min_x( cell ))
+  if (p.x < ecl_cell_min_x( corner_list ))
     return false;
 
-  if (p.x > ecl_cell_max_x( cell ))
+  if (p.x > ecl_cell_max_x( corner_list ))
     return false;
 
-  if (p.y < ecl_cell_min_y( cell ))
+  if (p.y < ecl_cell_min_y( corner_list ))
     return false;
 
-  if (p.y > ecl_cell_max_y( cell ))
+  if (p.y > ecl_cell_max_y( corner_list ))
     return false;
 
   {
     /*
       Special case checks for the corner points.
     */
-    if (point_equal( &p , &cell->corner_list[0]))
+    if (point_equal( &p , &corner_list[0]))
       return true;
 
-    if (point_equal( &p , &cell->corner_list[1] )) {
+    if (point_equal( &p , &corner_list[1] )) {
       if (i == (ecl_grid->nx - 1))
         return true;
       else
         return false;
     }
 
-    if (point_equal( &p , &cell->corner_list[2])) {
+    if (point_equal( &p , &corner_list[2])) {
       if (j == (ecl_grid->ny - 1))
         return true;
       else
         return false;
     }
 
-    if (point_equal( &p , &cell->corner_list[3])) {
+    if (point_equal( &p , &corner_list[3])) {
       if ((j == (ecl_grid->ny - 1)) &&
           (i == (ecl_grid->nx - 1)))
         return true;
@@ -3844,14 +4027,14 @@ bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j
         return false;
     }
 
-    if (point_equal( &p , &cell->corner_list[4])) {
+    if (point_equal( &p , &corner_list[4])) {
       if (k == (ecl_grid->nz - 1))
         return true;
       else
         return false;
     }
 
-    if (point_equal( &p , &cell->corner_list[5] )) {
+    if (point_equal( &p , &corner_list[5] )) {
       if ((i == (ecl_grid->nx - 1)) &&
           (k == (ecl_grid->nz - 1)))
         return true;
@@ -3859,7 +4042,7 @@ bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j
         return false;
     }
 
-    if (point_equal( &p , &cell->corner_list[6] )) {
+    if (point_equal( &p , &corner_list[6] )) {
       if ((j == (ecl_grid->ny - 1)) &&
           (k == (ecl_grid->nz - 1)))
         return true;
@@ -3867,7 +4050,7 @@ bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j
         return false;
     }
 
-    if (point_equal( &p , &cell->corner_list[7] )) {
+    if (point_equal( &p , &corner_list[7] )) {
       if ((i == (ecl_grid->nx - 1)) &&
           (j == (ecl_grid->ny - 1)) &&
           (k == (ecl_grid->nz - 1)))
@@ -3876,18 +4059,18 @@ bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j
         return false;
     }
 
-    if (ecl_cell_get_twist(cell) > 0) {
+    if (ecl_cell_get_twist( corner_list ) > 0) {
       fprintf(stderr, "** Warning: Point (%g,%g,%g) is in vicinity of twisted cell: (%d,%d,%d) - function:%s might be mistaken.\n", x,y,z,i,j,k, __func__);
       return false;
     }
 
     {
-      double signed_volume = ecl_cell_get_signed_volume( cell );
+      double signed_volume = ecl_grid_get_cell_signed_volume( ecl_grid , global_index );
       if (fabs( signed_volume) > min_volume) {
         double sign = 1.0;
-        point_type * p0;
-        point_type * p1;
-        point_type * p2;
+        const point_type * p0;
+        const point_type * p1;
+        const point_type * p2;
         int phase0 = 0;
         int method = (phase0 + i + j + k) % 2;
 
@@ -3896,9 +4079,9 @@ bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j
         {
           for (int plane_nr = 0; plane_nr < 12; plane_nr++) {
 
-            p0 = &cell->corner_list[ tetrahedron_permutations[ method ][plane_nr][0] ];
-            p1 = &cell->corner_list[ tetrahedron_permutations[ method ][plane_nr][1] ];
-            p2 = &cell->corner_list[ tetrahedron_permutations[ method ][plane_nr][2] ];
+            p0 = &corner_list[ tetrahedron_permutations[ method ][plane_nr][0] ];
+            p1 = &corner_list[ tetrahedron_permutations[ method ][plane_nr][1] ];
+            p2 = &corner_list[ tetrahedron_permutations[ method ][plane_nr][2] ];
 
             if (point_equal(p0, p1) || point_equal(p0,p2) || point_equal(p1,p2))
               continue;
@@ -3925,245 +4108,494 @@ bool ecl_grid_cell_contains_xyz1( const ecl_grid_type * ecl_grid , int global_in
   return ecl_grid_cell_contains_xyz3( ecl_grid , i,j,k,x ,y  , z);
 }
 
-/**
-   This function returns the global index for the cell (in layer 'k')
-   which contains the point x,y. Observe that if you are looking for
-   (i,j) you must call the function ecl_grid_get_ijk1() on the return value.
+/*****************************************************************/
+/*
+  Spatial index for the lookup of cells from world coordinates.
+
+  The index is a bounding volume hierarchy (BVH) stored in a flat
+  array: each node holds the axis aligned bounding box of all the
+  items below it; the tree is built top down by splitting the items
+  at the median of the bounding box centers along the longest axis,
+  until there are at most ECL_GRID_INDEX_LEAF_SIZE items left. The
+  items are just integers, and it is the callback passed to
+  ecl_grid_index_find() which interprets them. Two indices are built
+  for a grid:
+
+    cell_index: 3D index where the items are global indices of all
+       cells which are not tainted.
+
+    column_index: 2D index where the items are the columns i + j*nx;
+       the bounding box of a column covers all the cells in the
+       column, and also the corners used by ecl_grid_get_ij_from_xy().
+
+  The indices are built on first use, with a lock held, so the lookup
+  functions can be called concurrently from several threads. When
+  the cell index is built the volume of all the indexed cells is
+  calculated and cached in the cells; after that the
+  ecl_grid_cell_contains_xyz() functions do not modify the grid.
 */
 
-int ecl_grid_get_global_index_from_xy( const ecl_grid_type * ecl_grid , int k , bool lower_layer , double x , double y) {
+#define ECL_GRID_INDEX_LEAF_SIZE   8
+#define ECL_GRID_INDEX_MAX_DEPTH  64
 
-  int i,j;
-  for (j=0; j < ecl_grid->ny; j++)
-    for (i=0; i < ecl_grid->nx; i++) {
-      int global_index = ecl_grid_get_global_index3( ecl_grid , i , j , k );
-      if (ecl_cell_layer_contains_xy( ecl_grid_get_cell( ecl_grid , global_index ) , lower_layer , x , y))
-        return global_index;
-    }
-  return -1; /* Did not find x,y */
+typedef bool (ecl_grid_index_match_ftype) (const ecl_grid_type * grid , int item , const double * pos , void * arg);
+
+
+static void ecl_grid_index_free( ecl_grid_index_type * index ) {
+  if (index != NULL) {
+    free( index->nodes );
+    free( index->items );
+    free( index );
+  }
 }
 
 
+/*
+  Partial sort of the items such that the first nth items have center
+  coordinate along axis less than or equal to the remaining items.
+*/
 
-int ecl_grid_get_global_index_from_xy_top( const ecl_grid_type * ecl_grid , double x , double y) {
-  return ecl_grid_get_global_index_from_xy( ecl_grid , ecl_grid->nz - 1 , false , x , y );
+static void ecl_grid_index_select( int * items , int count , int nth , const double * center , int axis) {
+  int left = 0;
+  int right = count - 1;
+
+  while (right > left) {
+    double pivot = center[ 3*items[ (left + right) / 2 ] + axis ];
+    int i = left;
+    int j = right;
+
+    while (i <= j) {
+      while (center[ 3*items[i] + axis ] < pivot)
+        i++;
+
+      while (center[ 3*items[j] + axis ] > pivot)
+        j--;
+
+      if (i <= j) {
+        int tmp = items[i];
+        items[i] = items[j];
+        items[j] = tmp;
+        i++;
+        j--;
+      }
+    }
+
+    if (nth <= j)
+      right = j;
+    else if (nth >= i)
+      left = i;
+    else
+      break;
+  }
 }
 
-int ecl_grid_get_global_index_from_xy_bottom( const ecl_grid_type * ecl_grid , double x , double y) {
-  return ecl_grid_get_global_index_from_xy( ecl_grid , 0 , true , x , y );
+
+static void ecl_grid_index_build_node( ecl_grid_index_type * index , int node_nr , int first , int count , const double * bbox , const double * center) {
+  ecl_grid_index_node_type * node = &index->nodes[ node_nr ];
+  double center_min[3];
+  double center_max[3];
+
+  for (int d = 0; d < 3; d++) {
+    node->min[d] = center_min[d] = DBL_MAX;
+    node->max[d] = center_max[d] = -DBL_MAX;
+  }
+
+  for (int n = first; n < first + count; n++) {
+    int item = index->items[n];
+    for (int d = 0; d < index->dim; d++) {
+      node->min[d] = util_double_min( node->min[d] , bbox[ 6*item + d ] );
+      node->max[d] = util_double_max( node->max[d] , bbox[ 6*item + 3 + d ] );
+      center_min[d] = util_double_min( center_min[d] , center[ 3*item + d ]);
+      center_max[d] = util_double_max( center_max[d] , center[ 3*item + d ]);
+    }
+  }
+
+  node->first = first;
+  node->count = count;
+  if (count > ECL_GRID_INDEX_LEAF_SIZE) {
+    int axis = 0;
+    for (int d = 1; d < index->dim; d++)
+      if ((center_max[d] - center_min[d]) > (center_max[axis] - center_min[axis]))
+        axis = d;
+
+    /* If all the centers coincide the node is left as a (large) leaf. */
+    if (center_max[axis] > center_min[axis]) {
+      int left_count = count / 2;
+      int left_node = index->num_nodes;
+
+      ecl_grid_index_select( &index->items[ first ] , count , left_count , center , axis );
+      index->num_nodes += 2;
+      node->first = left_node;
+      node->count = 0;
+
+      ecl_grid_index_build_node( index , left_node     , first              , left_count         , bbox , center );
+      ecl_grid_index_build_node( index , left_node + 1 , first + left_count , count - left_count , bbox , center );
+    }
+  }
 }
 
 
-static void ecl_grid_clear_visited( ecl_grid_type * grid ) {
-  if (grid->visited == NULL)
-    grid->visited = util_calloc( grid->size , sizeof * grid->visited );
+/*
+  The bbox array should contain [xmin,ymin,zmin,xmax,ymax,zmax] for
+  each item, the items which should not be indexed at all are marked
+  with include[item] == false.
+*/
 
-  {
-    int i;
-    for (i=0; i < grid->size; i++)
-      grid->visited[i] = false;
+static ecl_grid_index_type * ecl_grid_index_alloc( int dim , int size , const double * bbox , const bool * include) {
+  ecl_grid_index_type * index = util_malloc( sizeof * index );
+  double * center = util_calloc( 3 * size , sizeof * center );
+  int num_items = 0;
+
+  index->dim = dim;
+  index->num_nodes = 0;
+  index->items = util_calloc( size , sizeof * index->items );
+  index->nodes = NULL;
+
+  for (int item = 0; item < size; item++) {
+    if (include[item]) {
+      for (int d = 0; d < 3; d++)
+        center[ 3*item + d ] = 0.5 * (bbox[ 6*item + d ] + bbox[ 6*item + 3 + d ]);
+      index->items[ num_items ] = item;
+      num_items++;
+    }
   }
+
+  if (num_items > 0) {
+    index->nodes = util_calloc( 2 * num_items , sizeof * index->nodes );
+    index->num_nodes = 1;
+    ecl_grid_index_build_node( index , 0 , 0 , num_items , bbox , center );
+  }
+
+  free( center );
+  return index;
 }
 
 
 /*
-   Box coordinates are not inclusive, i.e. [i1,i2)
+  Will return the smallest item which contains the point pos, as
+  determined by the match() callback, or -1 if no such item exists.
 */
-static int ecl_grid_box_contains_xyz( const ecl_grid_type * grid , int i1, int i2 , int j1 , int j2 , int k1 , int k2 , const point_type * p) {
 
-  int i,j,k;
-  int global_index = -1;
-  for (k=k1; k < k2; k++)
-    for (j=j1; j < j2; j++)
-      for (i=i1; i < i2; i++) {
-        global_index = ecl_grid_get_global_index3( grid , i , j , k);
-        if (!grid->visited[ global_index ]) {
-          grid->visited[ global_index ] = true;
-          if (ecl_grid_cell_contains_xyz1( grid , global_index , p->x , p->y , p->z )) {
-            return global_index;
-          }
+static int ecl_grid_index_find( const ecl_grid_index_type * index , const ecl_grid_type * grid , const double * pos , ecl_grid_index_match_ftype * match , void * arg) {
+  int stack[ ECL_GRID_INDEX_MAX_DEPTH ];
+  int stack_size = 0;
+  int result = -1;
+
+  if (index->num_nodes > 0)
+    stack[ stack_size++ ] = 0;
+
+  while (stack_size > 0) {
+    const ecl_grid_index_node_type * node = &index->nodes[ stack[ --stack_size ] ];
+    bool inside = true;
+
+    for (int d = 0; d < index->dim; d++) {
+      if ((pos[d] < node->min[d]) || (pos[d] > node->max[d]))
+        inside = false;
+    }
+
+    if (!inside)
+      continue;
+
+    if (node->count > 0) {
+      for (int n = node->first; n < node->first + node->count; n++) {
+        int item = index->items[n];
+        if ((result < 0) || (item < result)) {
+          if (match( grid , item , pos , arg ))
+            result = item;
         }
       }
-  return -1;  /* Returning -1; did not find xyz. */
+    } else {
+      stack[ stack_size++ ] = node->first + 1;
+      stack[ stack_size++ ] = node->first;
+    }
+  }
+
+  return result;
 }
 
 
-/**
- * Search for given xyz coordinate around global start_index in a box of size bx
- */
-static int ecl_grid_get_global_index_from_xyz_around_box(ecl_grid_type * grid , double x , double y , double z , int start_index, int bx, point_type * p) {
-  /* Try neighbours */
-    int i,j,k;
-    int i1,i2,j1,j2,k1,k2;
-    int nx,ny,nz;
-    ecl_grid_get_dims( grid , &nx , &ny , &nz , NULL);
-    ecl_grid_get_ijk1( grid , start_index , &i , &j , &k);
+static void ecl_grid_index_lock( const ecl_grid_type * grid ) {
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_lock( &((ecl_grid_type *) grid)->index_lock );
+#endif
+}
+
 
-    i1 = util_int_max( 0 , i - bx );
-    j1 = util_int_max( 0 , j - bx );
-    k1 = util_int_max( 0 , k - bx );
+static void ecl_grid_index_unlock( const ecl_grid_type * grid ) {
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_unlock( &((ecl_grid_type *) grid)->index_lock );
+#endif
+}
 
-    i2 = util_int_min( nx , i + bx );
-    j2 = util_int_min( ny , j + bx );
-    k2 = util_int_min( nz , k + bx );
 
-    int global_index = ecl_grid_box_contains_xyz( grid , i1 , i2 , j1 , j2 , k1 , k2 , p);
-    return global_index;
+static void ecl_grid_bbox_update( double * bbox , double x , double y , double z) {
+  bbox[0] = util_double_min( bbox[0] , x );
+  bbox[1] = util_double_min( bbox[1] , y );
+  bbox[2] = util_double_min( bbox[2] , z );
+  bbox[3] = util_double_max( bbox[3] , x );
+  bbox[4] = util_double_max( bbox[4] , y );
+  bbox[5] = util_double_max( bbox[5] , z );
 }
 
 
+static void ecl_grid_bbox_init( double * bbox ) {
+  bbox[0] = bbox[1] = bbox[2] = DBL_MAX;
+  bbox[3] = bbox[4] = bbox[5] = -DBL_MAX;
+}
 
-/**
-   This function will find the global index of the cell containing the
-   world coordinates (x,y,z), if no cell can be found the function
-   will return -1.
 
-   The function is basically based on scanning through the cells in
-   natural (i fastest) order and querying whether the cell[i,j,k]
-   contains the (x,y,z) point; not very elegant :-(
+static ecl_grid_index_type * ecl_grid_alloc_cell_index( const ecl_grid_type * grid ) {
+  double * bbox = util_calloc( 6 * grid->size , sizeof * bbox );
+  bool * include = util_calloc( grid->size , sizeof * include );
+  ecl_grid_index_type * index;
 
-   The last argument - 'start_index' - can be used to speed things up
-   a bit if you have reasonable guess of where the the (x,y,z) is
-   located. The start_index value is used as this:
+  for (int global_index = 0; global_index < grid->size; global_index++) {
+    ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
 
+    include[ global_index ] = !GET_CELL_FLAG( cell , CELL_FLAG_TAINTED );
+    if (include[ global_index ]) {
+      point_type buffer[8];
+      const point_type * corner_list = ecl_grid_get_cell_corners( grid , global_index , buffer );
+      ecl_grid_bbox_init( &bbox[ 6*global_index ] );
+      for (int c = 0; c < 8; c++)
+        ecl_grid_bbox_update( &bbox[ 6*global_index ] , corner_list[c].x , corner_list[c].y , corner_list[c].z );
+    }
+  }
 
-     start_index == 0: I do not have a clue, start from the beginning
-        and scan through the grid linearly.
+  index = ecl_grid_index_alloc( 3 , grid->size , bbox , include );
+  free( include );
+  free( bbox );
+  return index;
+}
 
 
-     start_index != 0:
-        1. Check the cell 'start_index'.
-        2. Check the neighbours (i +/- 1, j +/- 1, k +/- 1 ).
-        3. Give up and do a linear search starting from start_index.
+static ecl_grid_index_type * ecl_grid_alloc_column_index( const ecl_grid_type * grid ) {
+  const int num_columns = grid->nx * grid->ny;
+  double * bbox = util_calloc( 6 * num_columns , sizeof * bbox );
+  bool * include = util_calloc( num_columns , sizeof * include );
+  ecl_grid_index_type * index;
 
-*/
-int ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index) {
-  int global_index;
-  point_type p;
-  point_set( &p , x , y , z);
-  ecl_grid_clear_visited( grid );
+  for (int j = 0; j < grid->ny; j++) {
+    for (int i = 0; i < grid->nx; i++) {
+      const int column = i + j * grid->nx;
+      double * column_bbox = &bbox[ 6 * column ];
 
-  if (start_index >= 0) {
-    /* Try start index */
-    if (ecl_grid_cell_contains_xyz1( grid , start_index , x,y,z))
-      return start_index;
-    else {
-      /* Try boxes 2, 4, 8, ..., 64  */
-      for (int bx = 1; bx <= 6; bx++) {
-        global_index = ecl_grid_get_global_index_from_xyz_around_box(grid, x, y, z,
-                                                                     start_index,
-                                                                     1<<bx, &p);
-        if (global_index >= 0)
-          return global_index;
+      ecl_grid_bbox_init( column_bbox );
+      for (int k = 0; k <= grid->nz; k++) {
+        for (int dj = 0; dj < 2; dj++) {
+          for (int di = 0; di < 2; di++) {
+            double x,y,z;
+            ecl_grid_get_corner_xyz( grid , i + di , j + dj , k , &x , &y , &z );
+            ecl_grid_bbox_update( column_bbox , x , y , 0 );
+          }
+        }
+
+        if (k < grid->nz) {
+          point_type buffer[8];
+          const point_type * corner_list = ecl_grid_get_cell_corners( grid , ecl_grid_get_global_index3( grid , i , j , k ) , buffer );
+          for (int c = 0; c < 8; c++)
+            ecl_grid_bbox_update( column_bbox , corner_list[c].x , corner_list[c].y , 0 );
+        }
       }
+      include[ column ] = true;
     }
   }
 
-  /*
-    OK - the attempted shortcuts did not pay off. Perform full linear search.
-  */
+  index = ecl_grid_index_alloc( 2 , num_columns , bbox , include );
+  free( include );
+  free( bbox );
+  return index;
+}
 
-  global_index = -1;
 
-  for (int index = 0; index < grid->size; index++) {
-    if (ecl_grid_cell_contains_xyz1( grid , index , x , y , z))
-      return index;
-  }
-  return -1;
+static const ecl_grid_index_type * ecl_grid_get_cell_index( const ecl_grid_type * grid ) {
+  ecl_grid_index_type * index;
+
+  ecl_grid_index_lock( grid );
+  if (grid->cell_index == NULL)
+    ((ecl_grid_type *) grid)->cell_index = ecl_grid_alloc_cell_index( grid );
+  index = grid->cell_index;
+  ecl_grid_index_unlock( grid );
+
+  return index;
 }
 
-bool ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k ) {
-  int g = ecl_grid_get_global_index_from_xyz(grid, x, y, z, start_index);
-  if (g < 0)
-    return false;
 
-  ecl_grid_get_ijk1( grid , g , i,j,k);
-  return true;
+static const ecl_grid_index_type * ecl_grid_get_column_index( const ecl_grid_type * grid ) {
+  ecl_grid_index_type * index;
+
+  ecl_grid_index_lock( grid );
+  if (grid->column_index == NULL)
+    ((ecl_grid_type *) grid)->column_index = ecl_grid_alloc_column_index( grid );
+  index = grid->column_index;
+  ecl_grid_index_unlock( grid );
+
+  return index;
 }
 
+/*****************************************************************/
+
+
+typedef struct {
+  int                k;
+  bool               lower_layer;
+  geo_polygon_type * polygon;
+} ecl_grid_layer_arg_type;
+
+
+static bool ecl_grid_cell_contains_xyz__( const ecl_grid_type * grid , int global_index , const double * pos , void * arg) {
+  return ecl_grid_cell_contains_xyz1( grid , global_index , pos[0] , pos[1] , pos[2] );
+}
+
+
+static bool ecl_grid_layer_contains_xy__( const ecl_grid_type * grid , int column , const double * pos , void * arg) {
+  const ecl_grid_layer_arg_type * layer = arg;
+  const int global_index = column + layer->k * grid->nx * grid->ny;
+  point_type buffer[8];
+  return ecl_cell_layer_contains_xy( ecl_grid_get_cell( grid , global_index ) , ecl_grid_get_cell_corners( grid , global_index , buffer ) , layer->lower_layer , pos[0] , pos[1]);
+}
 
-static bool ecl_grid_sublayer_contanins_xy__(const ecl_grid_type * grid , double x , double y , int k , int i1 , int i2 , int j1 , int j2, geo_polygon_type * polygon) {
-  int i,j;
+
+static bool ecl_grid_column_contains_xy__( const ecl_grid_type * grid , int column , const double * pos , void * arg) {
+  const ecl_grid_layer_arg_type * layer = arg;
+  const int i = column % grid->nx;
+  const int j = column / grid->nx;
+  geo_polygon_type * polygon = layer->polygon;
 
   geo_polygon_reset( polygon );
+  {
+    double x,y,z;
+
+    ecl_grid_get_corner_xyz( grid , i     , j     , layer->k , &x , &y , &z );
+    geo_polygon_add_point( polygon , x , y );
 
-  /* Bottom edge */
-  for (i=i1; i < i2; i++) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i , j1 , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
+    ecl_grid_get_corner_xyz( grid , i + 1 , j     , layer->k , &x , &y , &z );
+    geo_polygon_add_point( polygon , x , y );
+
+    ecl_grid_get_corner_xyz( grid , i + 1 , j + 1 , layer->k , &x , &y , &z );
+    geo_polygon_add_point( polygon , x , y );
+
+    ecl_grid_get_corner_xyz( grid , i     , j + 1 , layer->k , &x , &y , &z );
+    geo_polygon_add_point( polygon , x , y );
   }
+  geo_polygon_close( polygon );
+  return geo_polygon_contains_point__( polygon , pos[0] , pos[1] , true );
+}
+
+
+/**
+   This function returns the global index for the cell (in layer 'k')
+   which contains the point x,y. Observe that if you are looking for
+   (i,j) you must call the function ecl_grid_get_ijk1() on the return
+   value. If several cells contain the point the one with the lowest
+   global index is returned.
+*/
+
+int ecl_grid_get_global_index_from_xy( const ecl_grid_type * ecl_grid , int k , bool lower_layer , double x , double y) {
+  const ecl_grid_index_type * index = ecl_grid_get_column_index( ecl_grid );
+  ecl_grid_layer_arg_type layer = { .k = k , .lower_layer = lower_layer , .polygon = NULL };
+  double pos[2] = { x , y };
+  int column = ecl_grid_index_find( index , ecl_grid , pos , ecl_grid_layer_contains_xy__ , &layer );
+
+  if (column < 0)
+    return -1; /* Did not find x,y */
+
+  return column + k * ecl_grid->nx * ecl_grid->ny;
+}
+
+
+
+int ecl_grid_get_global_index_from_xy_top( const ecl_grid_type * ecl_grid , double x , double y) {
+  return ecl_grid_get_global_index_from_xy( ecl_grid , ecl_grid->nz - 1 , false , x , y );
+}
+
+int ecl_grid_get_global_index_from_xy_bottom( const ecl_grid_type * ecl_grid , double x , double y) {
+  return ecl_grid_get_global_index_from_xy( ecl_grid , 0 , true , x , y );
+}
+
+
+
+/**
+   This function will find the global index of the cell containing the
+   world coordinates (x,y,z), if no cell can be found the function
+   will return -1.
+
+   The search goes through the spatial index of the grid, which is
+   built on the first call; only the cells whose bounding box contains
+   the point are checked with ecl_grid_cell_contains_xyz1(). If
+   several cells contain the point - e.g. a point on the face between
+   two cells - the cell with the lowest global index is returned.
 
-  /* Right edge */
-  for (j=j1; j < j2; j++) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i2 , j , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
+   The last argument - 'start_index' - can be used if you have a
+   reasonable guess of where the (x,y,z) point is located; if
+   start_index >= 0 and that cell contains the point it is returned
+   directly without consulting the index.
+*/
+
+int ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index) {
+  if (start_index >= 0) {
+    if (ecl_grid_cell_contains_xyz1( grid , start_index , x,y,z))
+      return start_index;
   }
 
-  /* Top edge */
-  for (i=i2; i > i1; i--) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i , j2 , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
+  {
+    const ecl_grid_index_type * index = ecl_grid_get_cell_index( grid );
+    double pos[3] = { x , y , z };
+    return ecl_grid_index_find( index , grid , pos , ecl_grid_cell_contains_xyz__ , NULL );
   }
+}
+
+
+/**
+   Batch version of ecl_grid_get_global_index_from_xyz(); will look up
+   the points (x[i],y[i],z[i]) for i in [0,num_points) and store the
+   global index - or -1 if the point is not found - in global_index[i].
+*/
 
-  /* Left edge */
-  for (j=j2; j > j1; j--) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i1 , j , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
+void ecl_grid_get_global_index_from_xyz_batch(ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , int * global_index) {
+  const ecl_grid_index_type * index = ecl_grid_get_cell_index( grid );
+  int ip;
+
+#pragma omp parallel for
+  for (ip = 0; ip < num_points; ip++) {
+    double pos[3] = { x[ip] , y[ip] , z[ip] };
+    global_index[ip] = ecl_grid_index_find( index , grid , pos , ecl_grid_cell_contains_xyz__ , NULL );
   }
-  geo_polygon_close( polygon );
-  return geo_polygon_contains_point__( polygon , x  , y , true );
 }
 
 
+bool ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k ) {
+  int g = ecl_grid_get_global_index_from_xyz(grid, x, y, z, start_index);
+  if (g < 0)
+    return false;
 
-bool ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j) {
-  geo_polygon_type * polygon = geo_polygon_alloc( NULL );
-  int nx = ecl_grid_get_nx( grid );
-  int ny = ecl_grid_get_ny( grid );
-  bool inside = ecl_grid_sublayer_contanins_xy__(grid , x , y , k , 0 , nx , 0 , ny , polygon);
-  if (inside) {
-    int i1 = 0;
-    int i2 = nx;
-    int j1 = 0;
-    int j2 = ny;
+  ecl_grid_get_ijk1( grid , g , i,j,k);
+  return true;
+}
 
-    while (true) {
-      if ((i2 - i1) > 1) {
-        int ic = (i1 + i2) / 2;
-        if (ecl_grid_sublayer_contanins_xy__(grid , x , y , k , i1 , ic , j1 , j2 , polygon))
-          i2 = ic;
-        else {
-          if (!ecl_grid_sublayer_contanins_xy__(grid , x , y , k , ic , i2 , j1 , j2 , polygon))
-            util_abort("%s: point nowhere to be found ... \n",__func__);
-          i1 = ic;
-        }
-      }
 
-      if ((j2 - j1) > 1) {
-        int jc = (j1 + j2) / 2;
-        if (ecl_grid_sublayer_contanins_xy__(grid , x , y , k , i1 , i2 , j1 , jc , polygon))
-          j2 = jc;
-        else {
-          if (!ecl_grid_sublayer_contanins_xy__(grid , x , y , k , i1 , i2 , jc , j2 , polygon))
-            util_abort("%s: point nowhere to be found ... \n",__func__);
-          j1 = jc;
-        }
-      }
+/**
+   Will find the column (i,j) such that the point (x,y) is inside the
+   quadrilateral spanned by the corners (i,j,k), (i+1,j,k),
+   (i+1,j+1,k) and (i,j+1,k); i.e. k is in the range [0,nz] and
+   refers to the corner layers and not the cells. Points on the edge
+   between two columns are assigned to the column with lowest
+   i + j*nx. Returns false if the point is not found.
+*/
 
-      if ((i2 - i1) == 1 && (j2 - j1) == 1) {
-        *i = i1;
-        *j = j1;
-        break;
-      }
-    }
-  }
+bool ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j) {
+  const ecl_grid_index_type * index = ecl_grid_get_column_index( grid );
+  ecl_grid_layer_arg_type layer = { .k = k , .lower_layer = true , .polygon = geo_polygon_alloc( NULL ) };
+  double pos[2] = { x , y };
+  int column = ecl_grid_index_find( index , grid , pos , ecl_grid_column_contains_xy__ , &layer );
+
+  geo_polygon_free( layer.polygon );
+  if (column < 0)
+    return false;
 
-  geo_polygon_free( polygon );
-  return inside;
+  *i = column % grid->nx;
+  *j = column / grid->nx;
+  return true;
 }
 
 
@@ -4228,6 +4660,8 @@ int ecl_grid_get_block_count3d(const ecl_grid_type * grid , int i , int j, int k
 
 void ecl_grid_free(ecl_grid_type * grid) {
   ecl_grid_free_cells( grid );
+  util_safe_free( grid->corners );
+  util_safe_free( grid->zcorn );
   util_safe_free(grid->index_map);
   util_safe_free(grid->inv_index_map);
 
@@ -4252,7 +4686,11 @@ void ecl_grid_free(ecl_grid_type * grid) {
   vector_free( grid->coarse_cells );
   hash_free( grid->children );
   util_safe_free( grid->parent_name );
-  util_safe_free( grid->visited );
+  ecl_grid_index_free( grid->cell_index );
+  ecl_grid_index_free( grid->column_index );
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_destroy( &grid->index_lock );
+#endif
   util_safe_free( grid->name );
   free( grid );
 }
@@ -4267,15 +4705,14 @@ void ecl_grid_free__( void * arg ) {
 
 
 void ecl_grid_get_distance(const ecl_grid_type * grid , int global_index1, int global_index2 , double *dx , double *dy , double *dz) {
-  ecl_cell_type * cell1 = ecl_grid_get_cell( grid , global_index1);
-  ecl_cell_type * cell2 = ecl_grid_get_cell( grid , global_index2);
+  point_type center1 , center2;
 
-  ecl_cell_assert_center( cell1 );
-  ecl_cell_assert_center( cell2 );
+  ecl_grid_get_cell_center( grid , global_index1 , &center1 );
+  ecl_grid_get_cell_center( grid , global_index2 , &center2 );
   {
-    *dx = cell1->center.x - cell2->center.x;
-    *dy = cell1->center.y - cell2->center.y;
-    *dz = cell1->center.z - cell2->center.z;
+    *dx = center1.x - center2.x;
+    *dy = center1.y - center2.y;
+    *dz = center1.z - center2.z;
   }
 }
 
@@ -4485,12 +4922,13 @@ void ecl_grid_get_ijk1A(const ecl_grid_type *ecl_grid , int active_index , int *
 
 
 void ecl_grid_get_xyz1(const ecl_grid_type * grid , int global_index , double *xpos , double *ypos , double *zpos) {
-  ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  ecl_cell_assert_center( cell );
+  point_type center;
+
+  ecl_grid_get_cell_center( grid , global_index , &center );
   {
-    *xpos = cell->center.x;
-    *ypos = cell->center.y;
-    *zpos = cell->center.z;
+    *xpos = center.x;
+    *ypos = center.y;
+    *zpos = center.z;
   }
 }
 
@@ -4513,8 +4951,8 @@ void ecl_grid_get_xyz3(const ecl_grid_type * grid , int i, int j , int k, double
 
 void ecl_grid_get_cell_corner_xyz1(const ecl_grid_type * grid , int global_index , int corner_nr , double * xpos , double * ypos , double * zpos ) {
   if ((corner_nr >= 0) &&  (corner_nr <= 7)) {
-    const ecl_cell_type * cell  = ecl_grid_get_cell( grid , global_index );
-    const point_type      point = cell->corner_list[ corner_nr ];
+    point_type buffer[8];
+    const point_type point = ecl_grid_get_cell_corners( grid , global_index , buffer )[ corner_nr ];
     *xpos = point.x;
     *ypos = point.y;
     *zpos = point.z;
@@ -4569,9 +5007,9 @@ void ecl_grid_get_xyz1A(const ecl_grid_type * grid , int active_index , double *
 
 
 double ecl_grid_get_cdepth1(const ecl_grid_type * grid , int global_index) {
-  ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  ecl_cell_assert_center( cell );
-  return cell->center.z;
+  point_type center;
+  ecl_grid_get_cell_center( grid , global_index , &center );
+  return center.z;
 }
 
 
@@ -4619,12 +5057,13 @@ int ecl_grid_locate_depth( const ecl_grid_type * grid , double depth , int i , i
 */
 
 double ecl_grid_get_top1(const ecl_grid_type * grid , int global_index) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+  point_type buffer[8];
+  const point_type * corner_list = ecl_grid_get_cell_corners( grid , global_index , buffer );
   double depth = 0;
   int ij;
 
   for (ij = 0; ij < 4; ij++)
-    depth += cell->corner_list[ij].z;
+    depth += corner_list[ij].z;
 
   return depth * 0.25;
 }
@@ -4661,12 +5100,13 @@ double ecl_grid_get_top1A(const ecl_grid_type * grid , int active_index) {
 */
 
 double ecl_grid_get_bottom1(const ecl_grid_type * grid , int global_index) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
+  point_type buffer[8];
+  const point_type * corner_list = ecl_grid_get_cell_corners( grid , global_index , buffer );
   double depth = 0;
   int ij;
 
   for (ij = 0; ij < 4; ij++)
-    depth += cell->corner_list[ij + 4].z;
+    depth += corner_list[ij + 4].z;
 
   return depth * 0.25;
 }
@@ -4687,12 +5127,13 @@ double ecl_grid_get_bottom1A(const ecl_grid_type * grid , int active_index) {
 
 
 double ecl_grid_get_cell_dz1( const ecl_grid_type * grid , int global_index ) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
+  point_type buffer[8];
+  const point_type * corner_list = ecl_grid_get_cell_corners( grid , global_index , buffer );
   double dz = 0;
   int ij;
 
   for (ij = 0; ij < 4; ij++)
-    dz += (cell->corner_list[ij + 4].z - cell->corner_list[ij].z);
+    dz += (corner_list[ij + 4].z - corner_list[ij].z);
 
   return dz * 0.25;
 }
@@ -4727,14 +5168,15 @@ double ecl_grid_get_cell_thickness1A( const ecl_grid_type * grid , int active_in
 
 
 double ecl_grid_get_cell_dx1( const ecl_grid_type * grid , int global_index ) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
+  point_type buffer[8];
+  const point_type * corner_list = ecl_grid_get_cell_corners( grid , global_index , buffer );
   double dx = 0;
   double dy = 0;
   int c;
 
   for (c = 1; c < 8; c += 2) {
-    dx += cell->corner_list[c].x - cell->corner_list[c - 1].x;
-    dy += cell->corner_list[c].y - cell->corner_list[c - 1].y;
+    dx += corner_list[c].x - corner_list[c - 1].x;
+    dy += corner_list[c].y - corner_list[c - 1].y;
   }
   dx *= 0.25;
   dy *= 0.25;
@@ -4765,7 +5207,8 @@ double ecl_grid_get_cell_dx1A( const ecl_grid_type * grid , int active_index) {
 */
 
 double ecl_grid_get_cell_dy1( const ecl_grid_type * grid , int global_index ) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
+  point_type buffer[8];
+  const point_type * corner_list = ecl_grid_get_cell_corners( grid , global_index , buffer );
   double dx = 0;
   double dy = 0;
 
@@ -4773,8 +5216,8 @@ double ecl_grid_get_cell_dy1( const ecl_grid_type * grid , int global_index ) {
     for (int i = 0; i < 2; i++) {
       int c1 = i + k*4;
       int c2 = c1 + 2;
-      dx += cell->corner_list[c2].x - cell->corner_list[c1].x;
-      dy += cell->corner_list[c2].y - cell->corner_list[c1].y;
+      dx += corner_list[c2].x - corner_list[c1].x;
+      dy += corner_list[c2].y - corner_list[c1].y;
     }
   }
   dx *= 0.25;
@@ -5107,8 +5550,8 @@ bool ecl_grid_cell_regular3( const ecl_grid_type * ecl_grid, int i,int j,int k)
 */
 
 int ecl_grid_get_cell_twist1( const ecl_grid_type * ecl_grid, int global_index ) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
-  return ecl_cell_get_twist( cell );
+  point_type buffer[8];
+  return ecl_cell_get_twist( ecl_grid_get_cell_corners( ecl_grid , global_index , buffer ));
 }
 
 
@@ -5119,10 +5562,7 @@ int ecl_grid_get_cell_twist3(const ecl_grid_type * ecl_grid, int i, int j , int
 
 
 double ecl_grid_get_cell_volume1( const ecl_grid_type * ecl_grid, int global_index ) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
-  int i,j,k;
-  ecl_grid_get_ijk1( ecl_grid , global_index, &i , &j , &k);
-  return ecl_cell_get_volume( cell );
+  return ecl_grid_get_cell_volume__( ecl_grid , global_index );
 }
 
 
@@ -5134,8 +5574,8 @@ double ecl_grid_get_cell_volume1A( const ecl_grid_type * ecl_grid, int active_in
 
 
 double ecl_grid_get_cell_volume1_tskille( const ecl_grid_type * ecl_grid, int global_index ) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
-  return ecl_cell_get_volume_tskille( cell );
+  point_type buffer[8];
+  return ecl_cell_get_volume_tskille( ecl_grid_get_cell_corners( ecl_grid , global_index , buffer ));
 }
 
 
@@ -5148,6 +5588,66 @@ double ecl_grid_get_cell_volume3( const ecl_grid_type * ecl_grid, int i , int j
 }
 
 
+/**
+   Bulk versions of ecl_grid_get_cell_volume1() and
+   ecl_grid_get_xyz1(). The geometry of all the cells is calculated in
+   one pass - using several threads when available - and cached in the
+   grid, so later calls, also of the per cell functions, are just
+   lookups. If @active_size is true the arrays are indexed with active
+   index, otherwise with global index.
+*/
+
+static void ecl_grid_init_volume_data( const ecl_grid_type * grid , bool active_size , double * volume ) {
+  int global_index;
+
+#pragma omp parallel for
+  for (global_index = 0; global_index < grid->size; global_index++) {
+    int index = active_size ? grid->index_map[ global_index ] : global_index;
+    if (index >= 0)
+      volume[ index ] = ecl_grid_get_cell_volume__( grid , global_index );
+  }
+}
+
+
+double * ecl_grid_alloc_volume_data( const ecl_grid_type * grid , bool active_size ) {
+  int size = active_size ? grid->total_active : grid->size;
+  double * volume = util_calloc( size , sizeof * volume );
+  ecl_grid_init_volume_data( grid , active_size , volume );
+  return volume;
+}
+
+
+/**
+   Will allocate three arrays with the x, y and z coordinates of the
+   cell centers; the z array is the cell depth as returned from
+   ecl_grid_get_cdepth1(). The calling scope must free the arrays.
+*/
+
+void ecl_grid_alloc_center_arrays( const ecl_grid_type * grid , bool active_size , double ** x , double ** y , double ** z) {
+  int size = active_size ? grid->total_active : grid->size;
+  double * xpos = util_calloc( size , sizeof * xpos );
+  double * ypos = util_calloc( size , sizeof * ypos );
+  double * zpos = util_calloc( size , sizeof * zpos );
+  int global_index;
+
+#pragma omp parallel for
+  for (global_index = 0; global_index < grid->size; global_index++) {
+    int index = active_size ? grid->index_map[ global_index ] : global_index;
+    if (index >= 0) {
+      point_type center;
+      ecl_grid_get_cell_center( grid , global_index , &center );
+      xpos[ index ] = center.x;
+      ypos[ index ] = center.y;
+      zpos[ index ] = center.z;
+    }
+  }
+
+  *x = xpos;
+  *y = ypos;
+  *z = zpos;
+}
+
+
 void ecl_grid_summarize(const ecl_grid_type * ecl_grid) {
   int             active_cells , nx,ny,nz;
   ecl_grid_get_dims(ecl_grid , &nx , &ny , &nz , &active_cells);
@@ -5516,8 +6016,8 @@ static void ecl_grid_dump__(const ecl_grid_type * grid , FILE * stream) {
   {
     int i;
     for (i=0; i < grid->size; i++) {
-      const ecl_cell_type * cell = ecl_grid_get_cell( grid , i );
-      ecl_cell_dump( cell , stream );
+      point_type buffer[8];
+      ecl_cell_dump( ecl_grid_get_cell_corners( grid , i , buffer ) , stream );
     }
   }
 }
@@ -5538,8 +6038,11 @@ static void ecl_grid_dump_ascii__(ecl_grid_type * grid , bool active_only , FILE
       ecl_cell_type * cell = ecl_grid_get_cell( grid , l );
       if (cell->active_index[MATRIX_INDEX] >= 0 || !active_only) {
         int i,j,k;
+        point_type buffer[8];
+        point_type center;
         ecl_grid_get_ijk1( grid , l , &i , &j , &k);
-        ecl_cell_dump_ascii( cell , i,j,k , stream , NULL);
+        ecl_grid_get_cell_center( grid , l , &center );
+        ecl_cell_dump_ascii( cell , &center , ecl_grid_get_cell_corners( grid , l , buffer ) , i,j,k , stream , NULL);
       }
     }
   }
@@ -5576,16 +6079,22 @@ void ecl_grid_dump_ascii(ecl_grid_type * grid , bool active_only , FILE * stream
 
 void ecl_grid_dump_ascii_cell1(ecl_grid_type * grid , int global_index , FILE * stream , const double * offset) {
   ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+  point_type buffer[8];
+  point_type center;
   int i,j,k;
   ecl_grid_get_ijk1( grid , global_index , &i , &j , &k);
-  ecl_cell_dump_ascii(cell , i,j,k, stream , offset);
+  ecl_grid_get_cell_center( grid , global_index , &center );
+  ecl_cell_dump_ascii(cell , &center , ecl_grid_get_cell_corners( grid , global_index , buffer ) , i,j,k, stream , offset);
 }
 
 
 void ecl_grid_dump_ascii_cell3(ecl_grid_type * grid , int i , int j , int k , FILE * stream , const double * offset) {
   int global_index  = ecl_grid_get_global_index3(grid , i,j,k);
   ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
-  ecl_cell_dump_ascii(cell , i,j,k, stream , offset);
+  point_type buffer[8];
+  point_type center;
+  ecl_grid_get_cell_center( grid , global_index , &center );
+  ecl_cell_dump_ascii(cell , &center , ecl_grid_get_cell_corners( grid , global_index , buffer ) , i,j,k, stream , offset);
 }
 
 /*****************************************************************/
@@ -5775,8 +6284,9 @@ static void ecl_grid_fwrite_GRID__( const ecl_grid_type * grid , int coords_size
         for (i=0; i < grid->nx; i++) {
           int global_index = ecl_grid_get_global_index__(grid , i , j , k );
           const ecl_cell_type * cell = ecl_grid_get_cell( grid ,  global_index );
+          point_type buffer[8];
 
-          ecl_cell_fwrite_GRID( grid , cell , false , coords_size , i,j,k,global_index,coords_kw , corners_kw , fortio );
+          ecl_cell_fwrite_GRID( grid , cell , ecl_grid_get_cell_corners( grid , global_index , buffer ) , false , coords_size , i,j,k,global_index,coords_kw , corners_kw , fortio );
         }
       }
     }
@@ -5787,8 +6297,9 @@ static void ecl_grid_fwrite_GRID__( const ecl_grid_type * grid , int coords_size
           for (i=0; i < grid->nx; i++) {
             int global_index = ecl_grid_get_global_index__(grid , i , j , k - grid->nz );
             const ecl_cell_type * cell = ecl_grid_get_cell( grid ,  global_index );
+            point_type buffer[8];
 
-            ecl_cell_fwrite_GRID( grid , cell , true , coords_size , i,j,k,global_index ,  coords_kw , corners_kw , fortio );
+            ecl_cell_fwrite_GRID( grid , cell , ecl_grid_get_cell_corners( grid , global_index , buffer ) , true , coords_size , i,j,k,global_index ,  coords_kw , corners_kw , fortio );
           }
         }
       }
@@ -5935,8 +6446,10 @@ static bool ecl_grid_init_coord_section__( const ecl_grid_type * grid , int i, i
     point_type top_point;
     point_type bottom_point;
 
-    const ecl_cell_type * bottom_cell = ecl_grid_get_cell( grid , bottom_index );
-    const ecl_cell_type * top_cell    = ecl_grid_get_cell( grid , top_index);
+    point_type bottom_buffer[8];
+    point_type top_buffer[8];
+    const point_type * bottom_corners = ecl_grid_get_cell_corners( grid , bottom_index , bottom_buffer );
+    const point_type * top_corners    = ecl_grid_get_cell_corners( grid , top_index , top_buffer );
 
     /*
       2---3
@@ -5946,8 +6459,8 @@ static bool ecl_grid_init_coord_section__( const ecl_grid_type * grid , int i, i
     int corner_index = j_corner*2 + i_corner;
     int coord_offset = 6 * ( (j + j_corner) * (grid->nx + 1) + (i + i_corner) );
     {
-      point_copy_values( &top_point    , &top_cell->corner_list[corner_index]);
-      point_copy_values( &bottom_point , &bottom_cell->corner_list[ corner_index + 4]);
+      point_copy_values( &top_point    , &top_corners[corner_index]);
+      point_copy_values( &bottom_point , &bottom_corners[ corner_index + 4]);
 
 
       if ((top_point.z == bottom_point.z) && (force_set == false)) {
@@ -6068,14 +6581,15 @@ static void ecl_grid_init_zcorn_data__( const ecl_grid_type * grid , float * zco
     for (i=0; i < nx; i++) {
       for (k=0; k < nz; k++) {
         const int cell_index   = ecl_grid_get_global_index3( grid , i,j,k);
-        const ecl_cell_type * cell = ecl_grid_get_cell( grid , cell_index );
+        point_type buffer[8];
+        const point_type * corner_list = ecl_grid_get_cell_corners( grid , cell_index , buffer );
         int l;
 
         for (l=0; l < 2; l++) {
-          point_type p0 = cell->corner_list[ 4*l];
-          point_type p1 = cell->corner_list[ 4*l + 1];
-          point_type p2 = cell->corner_list[ 4*l + 2];
-          point_type p3 = cell->corner_list[ 4*l + 3];
+          point_type p0 = corner_list[ 4*l];
+          point_type p1 = corner_list[ 4*l + 1];
+          point_type p2 = corner_list[ 4*l + 2];
+          point_type p3 = corner_list[ 4*l + 3];
 
           int z1 = k*8*nx*ny + j*4*nx + 2*i            + l*4*nx*ny;
           int z2 = k*8*nx*ny + j*4*nx + 2*i  +  1      + l*4*nx*ny;
@@ -6573,9 +7087,9 @@ void ecl_grid_fprintf_grdecl(ecl_grid_type * grid , FILE * stream ) {
 */
 
 void ecl_grid_cell_ri_export( const ecl_grid_type * ecl_grid , int global_index , double * ri_points) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
+  point_type buffer[8];
   int offset = global_index * 8 * 3;
-  ecl_cell_ri_export( cell , &ri_points[ offset ] );
+  ecl_cell_ri_export( ecl_grid_get_cell_corners( ecl_grid , global_index , buffer ) , &ri_points[ offset ] );
 }
 
 
@@ -6621,39 +7135,10 @@ int ecl_grid_get_num_nnc( const ecl_grid_type * grid ) {
 }
 
 
-static ecl_kw_type * ecl_grid_alloc_volume_kw_active( const ecl_grid_type * grid) {
-  ecl_kw_type * volume_kw = ecl_kw_alloc("VOLUME" , ecl_grid_get_active_size(grid) , ECL_DOUBLE_TYPE);
-  {
-    double * volume_data = ecl_kw_get_ptr( volume_kw );
-    int active_index;
-    for (active_index = 0; active_index < ecl_grid_get_active_size(grid); active_index++) {
-      double cell_volume = ecl_grid_get_cell_volume1A(grid , active_index);
-      volume_data[ active_index] = cell_volume;
-    }
-  }
-  return volume_kw;
-}
-
-
-static ecl_kw_type * ecl_grid_alloc_volume_kw_global( const ecl_grid_type * grid) {
-  ecl_kw_type * volume_kw = ecl_kw_alloc("VOLUME" , ecl_grid_get_global_size(grid) , ECL_DOUBLE_TYPE);
-  {
-    double * volume_data = ecl_kw_get_ptr( volume_kw );
-    int global_index;
-    for (global_index = 0; global_index < ecl_grid_get_global_size(grid); global_index++) {
-      double cell_volume = ecl_grid_get_cell_volume1(grid , global_index);
-      volume_data[ global_index] = cell_volume;
-    }
-  }
-  return volume_kw;
-}
-
-
-
 ecl_kw_type * ecl_grid_alloc_volume_kw( const ecl_grid_type * grid , bool active_size) {
-  if (active_size)
-    return ecl_grid_alloc_volume_kw_active( grid );
-  else
-    return ecl_grid_alloc_volume_kw_global( grid );
+  int size = active_size ? ecl_grid_get_active_size( grid ) : ecl_grid_get_global_size( grid );
+  ecl_kw_type * volume_kw = ecl_kw_alloc("VOLUME" , size , ECL_DOUBLE_TYPE);
+  ecl_grid_init_volume_data( grid , active_size , ecl_kw_get_ptr( volume_kw ));
+  return volume_kw;
 }
 //
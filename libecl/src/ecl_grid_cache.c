@@ -59,27 +59,15 @@ ecl_grid_cache_type * ecl_grid_cache_alloc( const ecl_grid_type * grid ) {
   grid_cache->grid          = grid;
   grid_cache->volume        = NULL;
   grid_cache->size          = ecl_grid_get_active_size( grid );
-  grid_cache->xpos          = util_calloc( grid_cache->size , sizeof * grid_cache->xpos );
-  grid_cache->ypos          = util_calloc( grid_cache->size , sizeof * grid_cache->ypos );
-  grid_cache->zpos          = util_calloc( grid_cache->size , sizeof * grid_cache->zpos );
   grid_cache->global_index  = util_calloc( grid_cache->size , sizeof * grid_cache->global_index );
   {
     int active_index;
-
-
-    /* Go trough all the active cells and extract the cell center
-       position and store it in xpos/ypos/zpos. */
-
-    for (active_index = 0; active_index < grid_cache->size; active_index++) {
-      int global_index = ecl_grid_get_global_index1A( grid , active_index );
-      grid_cache->global_index[ active_index ] = global_index;
-      ecl_grid_get_xyz1( grid , global_index ,
-                         &grid_cache->xpos[ active_index ] ,
-                         &grid_cache->ypos[ active_index ] ,
-                         &grid_cache->zpos[ active_index ]);
-    }
-
+    for (active_index = 0; active_index < grid_cache->size; active_index++)
+      grid_cache->global_index[ active_index ] = ecl_grid_get_global_index1A( grid , active_index );
   }
+
+  /* Extract the cell center position of all the active cells in one go. */
+  ecl_grid_alloc_center_arrays( grid , true , &grid_cache->xpos , &grid_cache->ypos , &grid_cache->zpos );
   return grid_cache;
 }
 
@@ -113,9 +101,7 @@ const double * ecl_grid_cache_get_volume( const ecl_grid_cache_type * grid_cache
   if (!grid_cache->volume) {
     // C++ style const cast.
     ecl_grid_cache_type * gc = (ecl_grid_cache_type *) grid_cache;
-    gc->volume = util_calloc( gc->size , sizeof * gc->volume );
-    for (int active_index = 0; active_index < grid_cache->size; active_index++)
-      gc->volume[active_index] = ecl_grid_get_cell_volume1A( gc->grid , active_index );
+    gc->volume = ecl_grid_alloc_volume_data( gc->grid , true );
   }
 
   return grid_cache->volume;
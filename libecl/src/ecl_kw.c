@@ -1074,19 +1074,62 @@ static bool ecl_kw_fscanf_qstring(char *s , const char *fmt , int len, FILE *str
 */
 /** Should be: NESTED */
 
-static double __fscanf_ECL_double( FILE * stream , const char * fmt) {
-  int    read_count , power;
-  double value , arg;
-  read_count = fscanf( stream , fmt , &arg , &power);
-  if (read_count == 2)
-    value = arg * pow(10 , power );
-  else {
-    util_abort("%s: read failed \n",__func__);
-    value = -1;
+static bool __sscanf_ECL_double( const char * token , const char * fmt , double * value) {
+  int    power;
+  double arg;
+  if (sscanf( token , fmt , &arg , &power) == 2) {
+    *value = arg * pow(10 , power );
+    return true;
+  } else
+    return false;
+}
+
+
+/*
+  Reads one int, float or double element from a formatted file. The
+  whitespace separated token is parsed with the fast and locale
+  independent parsers from ecl_util; tokens which are not recognized
+  there are passed on to sscanf() with the traditional read format.
+*/
+
+#define ECL_KW_FMT_TOKEN_LENGTH 64
+
+static bool ecl_kw_fscanf_fmt_number( FILE * stream , ecl_type_enum ecl_type , const char * read_fmt , char * data) {
+  char token[ECL_KW_FMT_TOKEN_LENGTH + 1];
+  int  length = ecl_util_fscanf_token( stream , token , ECL_KW_FMT_TOKEN_LENGTH );
+
+  if (length == 0)
+    return false;
+
+  if (ecl_type == ECL_INT_TYPE) {
+    int value;
+    if ((ecl_util_parse_fmt_int( token , &value ) == length) || (sscanf( token , read_fmt , &value) == 1)) {
+      memcpy( data , &value , sizeof value );
+      return true;
+    }
+  } else if (ecl_type == ECL_FLOAT_TYPE) {
+    double double_value;
+    float  value;
+    if (ecl_util_parse_fmt_double( token , &double_value ) == length)
+      value = double_value;
+    else if (sscanf( token , read_fmt , &value) != 1)
+      return false;
+
+    memcpy( data , &value , sizeof value );
+    return true;
+  } else if (ecl_type == ECL_DOUBLE_TYPE) {
+    double value;
+    if ((ecl_util_parse_fmt_double( token , &value ) == length) || __sscanf_ECL_double( token , read_fmt , &value)) {
+      memcpy( data , &value , sizeof value );
+      return true;
+    }
   }
-  return value;
+
+  return false;
 }
 
+#undef ECL_KW_FMT_TOKEN_LENGTH
+
 bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
   const char null_char         = '\0';
   bool fmt_file                = fortio_fmt_file( fortio );
@@ -1107,28 +1150,13 @@ bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
             ecl_kw_fscanf_qstring(&ecl_kw->data[offset] , read_fmt , 8, stream);
             break;
           case(ECL_INT_TYPE):
-            {
-              int iread = fscanf(stream , read_fmt , (int *) &ecl_kw->data[offset]);
-              if (iread != 1)
-                util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - aborting \n",__func__ , offset / ecl_kw->sizeof_ctype , ecl_kw->header8 , fortio_filename_ref(fortio));
-            }
-            break;
           case(ECL_FLOAT_TYPE):
-            {
-              int iread = fscanf(stream , read_fmt , (float *) &ecl_kw->data[offset]);
-              if (iread != 1) {
-                util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - aborting \n",__func__ ,
-                           offset / ecl_kw->sizeof_ctype ,
-                           ecl_kw->header8 ,
-                           fortio_filename_ref(fortio));
-              }
-            }
-            break;
           case(ECL_DOUBLE_TYPE):
-            {
-              double value = __fscanf_ECL_double( stream , read_fmt );
-              ecl_kw_iset(ecl_kw , index , &value);
-            }
+            if (!ecl_kw_fscanf_fmt_number( stream , ecl_kw->ecl_type , read_fmt , &ecl_kw->data[offset] ))
+              util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - aborting \n",__func__ ,
+                         offset / ecl_kw->sizeof_ctype ,
+                         ecl_kw->header8 ,
+                         fortio_filename_ref(fortio));
             break;
           case(ECL_BOOL_TYPE):
             {
@@ -1205,32 +1233,212 @@ bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
 }
 
 
+/*
+   Will copy and endian flip the blocks [block1, block2) from the raw
+   buffer - which starts at block1 - into the keyword storage. Returns
+   the number of blocks which did not have a valid record header.
+*/
+
+static int ecl_kw_unpack_blocks( ecl_kw_type * ecl_kw , const fortio_type * fortio , const char * raw , int block1 , int block2) {
+  const int    blocksize     = get_blocksize( ecl_kw->ecl_type );
+  const size_t record_stride = (size_t) blocksize * ecl_kw->sizeof_ctype + 2 * sizeof(int);
+  int read_error = 0;
+  int ib;
+
+#pragma omp parallel for schedule(static) reduction(+:read_error)
+  for (ib = block1; ib < block2; ib++) {
+    int    block_elm   = util_int_min((ib + 1) * blocksize , ecl_kw->size) - ib * blocksize;
+    int    record_size = block_elm * ecl_kw->sizeof_ctype;
+    size_t src_offset  = (ib - block1) * record_stride;
+
+    if (fortio_buffer_has_record( fortio , raw , src_offset , record_size )) {
+      char * target = &ecl_kw->data[ (size_t) ib * blocksize * ecl_kw->sizeof_ctype ];
+
+      memcpy( target , &raw[ src_offset + sizeof(int) ] , record_size );
+      if (ECL_ENDIAN_FLIP)
+        util_endian_flip_vector( target , ecl_kw->sizeof_ctype , block_elm );
+    } else
+      read_error += 1;
+  }
+
+  return read_error;
+}
+
+
+/**
+   Bulk reader for keyword data; this is an opt-in alternative to
+   ecl_kw_fread_data() for large unformatted numeric keywords. The data
+   section of the keyword - including the Fortran record headers - is
+   read in large chunks with one fread() per chunk, or taken directly
+   from the mapping if the fortio instance is memory mapped. The 1000
+   element records are then located in memory, and copied and endian
+   flipped into the keyword storage in parallel when libecl has been
+   built with OpenMP.
+
+   If the records on file are not laid out as expected the stream is
+   repositioned and the function falls back to ecl_kw_fread_data();
+   formatted files and string keywords are also handled by
+   ecl_kw_fread_data().
+*/
+
+#define ECL_KW_BULK_CHUNK_BLOCKS 256
+
+bool ecl_kw_fread_data_bulk(ecl_kw_type *ecl_kw, fortio_type *fortio) {
+  if (fortio_fmt_file( fortio ) || (ecl_kw->size == 0) || (ecl_kw->ecl_type == ECL_CHAR_TYPE) || (ecl_kw->ecl_type == ECL_MESS_TYPE))
+    return ecl_kw_fread_data( ecl_kw , fortio );
+
+  {
+    const offset_type init_pos  = fortio_ftell( fortio );
+    const int    blocksize      = get_blocksize( ecl_kw->ecl_type );
+    const int    num_blocks     = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+    const size_t record_stride  = (size_t) blocksize * ecl_kw->sizeof_ctype + 2 * sizeof(int);
+    const size_t raw_size       = (size_t) num_blocks * 2 * sizeof(int) + (size_t) ecl_kw->size * ecl_kw->sizeof_ctype;
+    const char * raw            = fortio_mmap_fread_ptr( fortio , raw_size );
+    int          read_error     = 0;
+
+    if (raw)
+      read_error = ecl_kw_unpack_blocks( ecl_kw , fortio , raw , 0 , num_blocks );
+    else {
+      /*
+        Reading through a bounded buffer; reading the whole data
+        section into one temporary allocation costs more in page
+        faults than is gained by the single fread().
+      */
+      FILE * stream     = fortio_get_FILE( fortio );
+      size_t chunk_size = util_size_t_min( raw_size , ECL_KW_BULK_CHUNK_BLOCKS * record_stride );
+      char * raw_buffer = util_malloc( chunk_size );
+      int block1 = 0;
+
+      while ((block1 < num_blocks) && (read_error == 0)) {
+        int    block2    = util_int_min( block1 + ECL_KW_BULK_CHUNK_BLOCKS , num_blocks );
+        size_t read_size = util_size_t_min( (block2 - block1) * record_stride , raw_size - block1 * record_stride );
+
+        if (fread( raw_buffer , 1 , read_size , stream ) == read_size)
+          read_error = ecl_kw_unpack_blocks( ecl_kw , fortio , raw_buffer , block1 , block2 );
+        else
+          read_error = 1;
+
+        block1 = block2;
+      }
+      free( raw_buffer );
+    }
+
+    if (read_error == 0)
+      return true;
+    else {
+      fortio_fseek( fortio , init_pos , SEEK_SET );
+      return ecl_kw_fread_data( ecl_kw , fortio );
+    }
+  }
+}
+
+#undef ECL_KW_BULK_CHUNK_BLOCKS
+
+
+/*
+   Offset of element @element in a keyword data section starting at
+   @data_offset, i.e. the data_offset used by fortio_data_fseek().
+*/
+
+static offset_type ecl_kw_element_offset( offset_type data_offset , int element , int element_size , int block_size) {
+  int block_index = element / block_size;
+  return data_offset + (offset_type) (2 * block_index + 1) * sizeof(int) + (offset_type) element * element_size;
+}
+
+
+/**
+   Reads the elements listed in @index_map from the keyword with data
+   section starting at @data_offset; element i of the index_map is
+   stored as element i in @buffer.
+
+   The requested elements are sorted, and elements which are close on
+   disk are grouped in runs which are read with one fread() each and
+   then scattered into the output buffer; i.e. there will be at most
+   one read per Fortran record touched.
+*/
+
+#define ECL_KW_INDEXED_READ_GAP       16384
+#define ECL_KW_INDEXED_READ_MAX_SIZE  4194304
+
 void ecl_kw_fread_indexed_data(fortio_type * fortio, offset_type data_offset, ecl_type_enum ecl_type, int element_count, const int_vector_type* index_map, char* buffer) {
     const int block_size = get_blocksize( ecl_type );
+    const int num_index  = int_vector_size( index_map );
     FILE *stream  = fortio_get_FILE( fortio );
-    int index;
     int element_size = ecl_util_get_sizeof_ctype(ecl_type);
 
     if(ecl_type == ECL_CHAR_TYPE || ecl_type == ECL_MESS_TYPE) {
         element_size = ECL_STRING8_LENGTH;
     }
 
+    if (num_index > 0) {
+        perm_vector_type * perm = int_vector_alloc_sort_perm( index_map );
+        char * read_buffer = NULL;
+        size_t read_buffer_size = 0;
+        int run_start = 0;
 
-    for(index = 0; index < int_vector_size(index_map); index++) {
-        int element_index = int_vector_iget(index_map, index);
+        {
+            int min_index = int_vector_iget( index_map , perm_vector_iget( perm , 0 ));
+            int max_index = int_vector_iget( index_map , perm_vector_iget( perm , num_index - 1 ));
 
-        if(element_index < 0 || element_index >= element_count) {
-            util_abort("%s: Element index is out of range 0 <= %d < %d\n", __func__, element_index, element_count);
+            if (min_index < 0)
+                util_abort("%s: Element index is out of range 0 <= %d < %d\n", __func__, min_index, element_count);
+
+            if (max_index >= element_count)
+                util_abort("%s: Element index is out of range 0 <= %d < %d\n", __func__, max_index, element_count);
         }
-        fortio_data_fseek(fortio, data_offset, element_index, element_size, element_count, block_size);
-        util_fread(&buffer[index * element_size], element_size, 1, stream, __func__);
+
+        while (run_start < num_index) {
+            int first_element = int_vector_iget( index_map , perm_vector_iget( perm , run_start ));
+            offset_type first_offset = ecl_kw_element_offset( data_offset , first_element , element_size , block_size );
+            offset_type last_offset = first_offset;
+            int run_end = run_start + 1;
+
+            while (run_end < num_index) {
+                int element = int_vector_iget( index_map , perm_vector_iget( perm , run_end ));
+                offset_type offset = ecl_kw_element_offset( data_offset , element , element_size , block_size );
+
+                if ((offset - last_offset > ECL_KW_INDEXED_READ_GAP) || (offset - first_offset > ECL_KW_INDEXED_READ_MAX_SIZE))
+                    break;
+
+                last_offset = offset;
+                run_end++;
+            }
+
+            {
+                size_t read_size = last_offset - first_offset + element_size;
+                int i;
+
+                if (read_size > read_buffer_size) {
+                    read_buffer = util_realloc( read_buffer , read_size );
+                    read_buffer_size = read_size;
+                }
+
+                fortio_fseek( fortio , first_offset , SEEK_SET );
+                util_fread( read_buffer , 1 , read_size , stream , __func__ );
+
+                for (i = run_start; i < run_end; i++) {
+                    int buffer_index = perm_vector_iget( perm , i );
+                    int element = int_vector_iget( index_map , buffer_index );
+                    offset_type offset = ecl_kw_element_offset( data_offset , element , element_size , block_size );
+
+                    memcpy( &buffer[buffer_index * element_size] , &read_buffer[ offset - first_offset ] , element_size );
+                }
+            }
+            run_start = run_end;
+        }
+
+        util_safe_free( read_buffer );
+        perm_vector_free( perm );
     }
 
     if (ECL_ENDIAN_FLIP) {
-        util_endian_flip_vector(buffer, element_size, int_vector_size(index_map));
+        util_endian_flip_vector(buffer, element_size, num_index);
     }
 }
 
+#undef ECL_KW_INDEXED_READ_GAP
+#undef ECL_KW_INDEXED_READ_MAX_SIZE
+
 /**
    Allocates storage and reads data.
 */
@@ -1519,6 +1727,74 @@ ecl_kw_type *ecl_kw_fread_alloc(fortio_type *fortio) {
 
 
 
+/**
+   Will load a keyword from @fortio like ecl_kw_fread_alloc(), but if
+   the fortio instance is memory mapped and the keyword holds numeric
+   data in one single record the keyword will reference the mapped
+   pages directly instead of copying the data. When the file byte
+   order differs from the host byte order, i.e. when ECL_ENDIAN_FLIP
+   is set, the record is byte swapped in place in a private
+   copy-on-write mapping, see fortio_mmap_record_data_flip(). In all
+   other cases the data is read into private storage with
+   ecl_kw_fread_data_bulk().
+
+   Observe that a keyword with shared data can not be resized, and
+   must not outlive the fortio instance; use ecl_kw_unshare_data() to
+   get a private copy of the data.
+*/
+
+ecl_kw_type * ecl_kw_fread_alloc_shared(fortio_type * fortio) {
+  ecl_kw_type * ecl_kw = ecl_kw_alloc_empty();
+  bool OK = false;
+
+  if (ecl_kw_fread_header(ecl_kw , fortio) == ECL_KW_READ_OK) {
+    char * data = NULL;
+
+    if ((ecl_kw->size > 0) && (ecl_kw->ecl_type != ECL_CHAR_TYPE) && (ecl_kw->ecl_type != ECL_MESS_TYPE)) {
+      int byte_size = ecl_kw->size * ecl_kw->sizeof_ctype;
+      if (ECL_ENDIAN_FLIP)
+        data = fortio_mmap_record_data_flip( fortio , byte_size , ecl_kw->sizeof_ctype );
+      else
+        data = fortio_mmap_record_data( fortio , byte_size );
+    }
+
+    if (data) {
+      ecl_kw_set_shared_ref( ecl_kw , data );
+      OK = true;
+    } else {
+      ecl_kw_alloc_data( ecl_kw );
+      OK = ecl_kw_fread_data_bulk( ecl_kw , fortio );
+    }
+  }
+
+  if (!OK) {
+    ecl_kw_free( ecl_kw );
+    ecl_kw = NULL;
+  }
+
+  return ecl_kw;
+}
+
+
+/**
+   If the keyword references shared storage the data is copied into
+   private storage owned by the keyword. The ecl_kw instance itself is
+   unchanged, so references held by the calling scope remain valid.
+*/
+
+void ecl_kw_unshare_data(ecl_kw_type * ecl_kw) {
+  if (ecl_kw->shared_data) {
+    char * shared_data = ecl_kw->data;
+
+    ecl_kw->shared_data = false;
+    ecl_kw->data = NULL;
+    if (shared_data != NULL)
+      ecl_kw->data = util_alloc_copy( shared_data , ecl_kw->size * ecl_kw->sizeof_ctype );
+  }
+}
+
+
+
 void ecl_kw_fskip(fortio_type *fortio) {
   ecl_kw_type *tmp_kw;
   tmp_kw = ecl_kw_fread_alloc(fortio );
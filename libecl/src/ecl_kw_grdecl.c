@@ -304,6 +304,81 @@ static void iset_range( char * data , int data_offset , int sizeof_ctype , void
 }
 
 
+/*
+   Fast path for one token of numerical GRDECL data, i.e. 'value' or
+   'N*value'. Returns false unless the complete token is recognized;
+   the caller should then fall back to sscanf_grdecl_value().
+*/
+
+static bool parse_grdecl_value( const char * token , int token_length , ecl_type_enum ecl_type , int * multiplier , void * value_ptr) {
+  const char * value_string = token;
+  int value_length = token_length;
+  int repeat;
+  int repeat_length = ecl_util_parse_fmt_int( token , &repeat );
+
+  if ((repeat_length > 0) && (token[repeat_length] == '*')) {
+    if (repeat <= 0)
+      return false;
+
+    value_string += repeat_length + 1;
+    value_length -= repeat_length + 1;
+    *multiplier = repeat;
+  } else
+    *multiplier = 1;
+
+  if (value_length == 0)
+    return false;
+
+  if (ecl_type == ECL_INT_TYPE)
+    return (ecl_util_parse_fmt_int( value_string , value_ptr ) == value_length);
+  else {
+    double value;
+    if (ecl_util_parse_fmt_double( value_string , &value ) == value_length) {
+      if (ecl_type == ECL_FLOAT_TYPE)
+        *((float *) value_ptr) = value;
+      else
+        *((double *) value_ptr) = value;
+      return true;
+    } else
+      return false;
+  }
+}
+
+
+/*
+   The original sscanf() based parsing of one token of numerical
+   GRDECL data; handles everything sscanf() can make sense of.
+*/
+
+static bool sscanf_grdecl_value( const char * token , ecl_type_enum ecl_type , int * multiplier , void * value_ptr) {
+  if (ecl_type == ECL_INT_TYPE) {
+    if (sscanf(token , "%d*%d" , multiplier , (int *) value_ptr) == 2)
+      return true;
+    else if (sscanf( token , "%d" , (int *) value_ptr) == 1) {
+      *multiplier = 1;
+      return true;
+    }
+  } else if (ecl_type == ECL_FLOAT_TYPE) {
+    if (sscanf(token , "%d*%g" , multiplier , (float *) value_ptr) == 2)
+      return true;
+    else if (sscanf( token , "%g" , (float *) value_ptr) == 1) {
+      *multiplier = 1;
+      return true;
+    }
+  } else if (ecl_type == ECL_DOUBLE_TYPE) {
+    if (sscanf(token , "%d*%lg" , multiplier , (double *) value_ptr) == 2)
+      return true;
+    else if (sscanf( token , "%lg" , (double *) value_ptr) == 1) {
+      *multiplier = 1;
+      return true;
+    }
+  } else
+    util_abort("%s: sorry type:%s not supported \n",__func__ , ecl_util_get_type_name(ecl_type));
+
+  return false;
+}
+
+
 /**
    The @strict flag is used to indicate whether the loader will accept
    character strings embedded into a numerical grdecl keyword; this
@@ -345,7 +420,8 @@ static char * fscanf_alloc_grdecl_data( const char * header , bool strict , ecl_
   char * data         = util_calloc( sizeof_ctype * data_size , sizeof * data );
 
   while (true) {
-    if (fscanf(stream , "%32s" , buffer) == 1) {
+    int buffer_length = ecl_util_fscanf_token( stream , buffer , 32 );
+    if (buffer_length > 0) {
       if (strcmp(buffer , ECL_COMMENT_STRING) == 0) {
         // We have read a comment marker - just read up to the end of line.
         char c;
@@ -365,55 +441,18 @@ static char * fscanf_alloc_grdecl_data( const char * header , bool strict , ecl_
         // The multiplier algorithm will fail hard if there are spaces on either side
         // of the '*'.
 
-        int multiplier;
-        void * value_ptr = NULL;
+        int    multiplier;
+        double value_buffer;   /* Large enough for int, float and double. */
+        void * value_ptr  = &value_buffer;
         bool   char_input = false;
 
-        if (ecl_type == ECL_INT_TYPE) {
-          int value;
-
-          if (sscanf(buffer , "%d*%d" , &multiplier , &value) == 2)
-            {}
-          else if (sscanf( buffer , "%d" , &value) == 1)
-            multiplier = 1;
-          else {
+        if (!parse_grdecl_value( buffer , buffer_length , ecl_type , &multiplier , value_ptr ))
+          if (!sscanf_grdecl_value( buffer , ecl_type , &multiplier , value_ptr )) {
             char_input = true;
             if (strict)
               util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
           }
 
-          value_ptr = &value;
-        } else if (ecl_type == ECL_FLOAT_TYPE) {
-          float value;
-
-          if (sscanf(buffer , "%d*%g" , &multiplier , &value) == 2)
-            {}
-          else if (sscanf( buffer , "%g" , &value) == 1)
-            multiplier = 1;
-          else {
-            char_input = true;
-            if (strict)
-              util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
-          }
-
-          value_ptr = &value;
-        } else if (ecl_type == ECL_DOUBLE_TYPE) {
-          double value;
-
-          if (sscanf(buffer , "%d*%lg" , &multiplier , &value) == 2)
-            {}
-          else if (sscanf( buffer , "%lg" , &value) == 1)
-            multiplier = 1;
-          else {
-            char_input = true;
-            if (strict)
-              util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
-          }
-
-          value_ptr = &value;
-        } else
-          util_abort("%s: sorry type:%s not supported \n",__func__ , ecl_util_get_type_name(ecl_type));
-
         /*
           Removing this warning on user request:
           if (char_input)
@@ -467,8 +506,8 @@ static char * fscanf_alloc_grdecl_data( const char * header , bool strict , ecl_
    ways; if the loading fails the function returns NULL.
 
    The main loop is extremely simple - it is just repeated calls to
-   fscanf() to read one-number-at-atime; when that reading fails that
-   is interpreted as the end of the keyword.
+   ecl_util_fscanf_token() to read one-number-at-atime; when that
+   reading fails that is interpreted as the end of the keyword.
 
    Currently ONLY integer and float types are supported in ecl_type -
    any other types will lead to a hard failure.
@@ -810,9 +810,11 @@ void ecl_region_deselect_k1k2( ecl_region_type * region , int k1 , int k2) {
 
 
 static void ecl_region_select_from_depth__( ecl_region_type * region , double depth_limit , bool select_deep  , bool select) {
+  double * x , * y , * depth;
   int global_index;
+  ecl_grid_alloc_center_arrays( region->parent_grid , false , &x , &y , &depth );
   for (global_index = 0; global_index < region->grid_vol; global_index++) {
-    double cell_depth = ecl_grid_get_cdepth1( region->parent_grid , global_index );
+    double cell_depth = depth[ global_index ];
     if (select_deep) {
       // The select/deselect mechanism should be applied to deep cells.
       if (cell_depth >= depth_limit)
@@ -823,6 +825,9 @@ static void ecl_region_select_from_depth__( ecl_region_type * region , double de
         region->active_mask[ global_index ] = select;
     }
   }
+  free( x );
+  free( y );
+  free( depth );
   ecl_region_invalidate_index_list( region );
 }
 
@@ -848,9 +853,10 @@ void ecl_region_deselect_deep_cells( ecl_region_type * region , double depth_lim
 /*****************************************************************/
 
 static void ecl_region_select_from_volume__( ecl_region_type * region , double volum_limit , bool select_small , bool select) {
+  double * volume = ecl_grid_alloc_volume_data( region->parent_grid , false );
   int global_index;
   for (global_index = 0; global_index < region->grid_vol; global_index++) {
-    double cell_size = ecl_grid_get_cell_volume1( region->parent_grid , global_index );
+    double cell_size = volume[ global_index ];
     if (select_small) {
       // The select/deselect mechanism should be applied to small cells.
       if (cell_size <= volum_limit)
@@ -861,6 +867,7 @@ static void ecl_region_select_from_volume__( ecl_region_type * region , double v
         region->active_mask[ global_index ] = select;
     }
   }
+  free( volume );
   ecl_region_invalidate_index_list( region );
 }
 
@@ -140,6 +140,8 @@ struct ecl_smspec_struct {
   float_vector_type * params_default;
 
   char              * restart_case;
+  int_vector_type   * params_map;                    /* When loaded with a key selection: params_index -> index in the PARAMS vector on file; NULL otherwise. */
+  int                 file_params_size;              /* The size of the PARAMS vector on file. */
 };
 
 
@@ -273,6 +275,8 @@ static ecl_smspec_type * ecl_smspec_alloc_empty(bool write_mode , const char * k
   ecl_smspec->params_default = float_vector_alloc(0 , PARAMS_GLOBAL_DEFAULT);
   ecl_smspec->write_mode = write_mode;
   ecl_smspec->need_nums = false;
+  ecl_smspec->params_map = NULL;
+  ecl_smspec->file_params_size = 0;
 
   return ecl_smspec;
 }
@@ -1073,7 +1077,42 @@ static bool ecl_smspec_check_header( ecl_file_type * header ) {
 }
 
 
-static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * header_file , bool include_restart) {
+/*
+  When the smspec is loaded with a key selection only the nodes
+  matching one of the patterns in @keys are retained; in addition the
+  nodes holding time information are always retained, because they
+  are needed to assign time to the individual tsteps.
+*/
+
+static bool ecl_smspec_select_node( const smspec_node_type * smspec_node , const stringlist_type * keys) {
+  if (smspec_node_get_var_type( smspec_node ) == ECL_SMSPEC_MISC_VAR) {
+    const char * keyword = smspec_node_get_keyword( smspec_node );
+    if (util_string_equal( keyword , "TIME") ||
+        util_string_equal( keyword , "DAY") ||
+        util_string_equal( keyword , "MONTH") ||
+        util_string_equal( keyword , "YEAR"))
+      return true;
+  }
+
+  {
+    const char * gen_key1 = smspec_node_get_gen_key1( smspec_node );
+    const char * gen_key2 = smspec_node_get_gen_key2( smspec_node );
+    int i;
+
+    for (i=0; i < stringlist_get_size( keys ); i++) {
+      const char * pattern = stringlist_iget( keys , i );
+      if (gen_key1 && (util_fnmatch( pattern , gen_key1 ) == 0))
+        return true;
+
+      if (gen_key2 && (util_fnmatch( pattern , gen_key2 ) == 0))
+        return true;
+    }
+  }
+  return false;
+}
+
+
+static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * header_file , bool include_restart , const stringlist_type * keys) {
   ecl_file_type * header = ecl_file_open( header_file , 0);
   if (header && ecl_smspec_check_header( header )) {
     ecl_kw_type *wells     = ecl_file_iget_named_kw(header, WGNAMES_KW  , 0);
@@ -1114,6 +1153,9 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
     ecl_smspec->grid_dims[1] = ecl_kw_iget_int(dimens , DIMENS_SMSPEC_NY_INDEX );
     ecl_smspec->grid_dims[2] = ecl_kw_iget_int(dimens , DIMENS_SMSPEC_NZ_INDEX );
     ecl_smspec_set_params_size( ecl_smspec , ecl_kw_get_size(keywords));
+    ecl_smspec->file_params_size = ecl_kw_get_size(keywords);
+    if (keys != NULL)
+      ecl_smspec->params_map = int_vector_alloc( 0 , 0 );
 
     ecl_util_get_file_type( header_file , &ecl_smspec->formatted , NULL );
 
@@ -1125,19 +1167,31 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
         char * kw                    = util_alloc_strip_copy(ecl_kw_iget_ptr(keywords , params_index));
         char * unit                  = util_alloc_strip_copy(ecl_kw_iget_ptr(units    , params_index));
         char * lgr_name              = NULL;
+        int node_params_index        = params_index;
 
         smspec_node_type * smspec_node;
         ecl_smspec_var_type var_type = ecl_smspec_identify_var_type( kw );
         if (nums != NULL) num        = ecl_kw_iget_int(nums , params_index);
+        if (ecl_smspec->params_map != NULL)
+          node_params_index = int_vector_size( ecl_smspec->params_map );
+
         if (ecl_smspec_lgr_var_type( var_type )) {
           int lgr_i = ecl_kw_iget_int( numlx , params_index );
           int lgr_j = ecl_kw_iget_int( numly , params_index );
           int lgr_k = ecl_kw_iget_int( numlz , params_index );
           lgr_name  = util_alloc_strip_copy(  ecl_kw_iget_ptr( lgrs , params_index ));
-          smspec_node = smspec_node_alloc_lgr( var_type , well , kw , unit , lgr_name , ecl_smspec->key_join_string , lgr_i , lgr_j , lgr_k , params_index, default_value);
+          smspec_node = smspec_node_alloc_lgr( var_type , well , kw , unit , lgr_name , ecl_smspec->key_join_string , lgr_i , lgr_j , lgr_k , node_params_index, default_value);
         } else
-          smspec_node = smspec_node_alloc( var_type , well , kw , unit , ecl_smspec->key_join_string , ecl_smspec->grid_dims , num , params_index , default_value);
-
+          smspec_node = smspec_node_alloc( var_type , well , kw , unit , ecl_smspec->key_join_string , ecl_smspec->grid_dims , num , node_params_index , default_value);
+
+        if ((smspec_node != NULL) && (ecl_smspec->params_map != NULL)) {
+          if (ecl_smspec_select_node( smspec_node , keys ))
+            int_vector_append( ecl_smspec->params_map , params_index );
+          else {
+            smspec_node_free( smspec_node );
+            smspec_node = NULL;
+          }
+        }
 
         if (smspec_node != NULL) {
           /** OK - we know this is valid shit. */
@@ -1151,6 +1205,11 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
       }
     }
 
+    if (ecl_smspec->params_map != NULL) {
+      ecl_smspec->params_size = int_vector_size( ecl_smspec->params_map );
+      float_vector_resize( ecl_smspec->params_default , ecl_smspec->params_size );
+    }
+
     ecl_smspec->header_file = util_alloc_realpath( header_file );
     if (include_restart)
       ecl_smspec_load_restart( ecl_smspec , header );
@@ -1164,7 +1223,18 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
 
 
 
-ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * key_join_string , bool include_restart) {
+/**
+   Will load the smspec header, but only retain the nodes matching one
+   of the (fnmatch) patterns in @keys, in addition to the time
+   variables. The retained nodes are assigned new params_index values
+   in the range [0,num_selected), and the mapping back to the full
+   PARAMS vector on file is available with ecl_smspec_get_params_map();
+   the ecl_sum_data layer uses this to only read the selected elements
+   from the PARAMS keywords. If @keys is NULL all nodes are loaded,
+   i.e. the same as ecl_smspec_fread_alloc().
+*/
+
+ecl_smspec_type * ecl_smspec_fread_alloc_restricted(const char *header_file, const char * key_join_string , bool include_restart , const stringlist_type * keys) {
   ecl_smspec_type *ecl_smspec;
 
   {
@@ -1174,7 +1244,7 @@ ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * k
     util_safe_free(path);
   }
 
-  if (ecl_smspec_fread_header(ecl_smspec , header_file , include_restart)) {
+  if (ecl_smspec_fread_header(ecl_smspec , header_file , include_restart , keys)) {
 
     if (hash_has_key( ecl_smspec->misc_var_index , "TIME")) {
       const smspec_node_type * time_node = hash_get(ecl_smspec->misc_var_index , "TIME");
@@ -1214,6 +1284,11 @@ ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * k
 }
 
 
+ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * key_join_string , bool include_restart) {
+  return ecl_smspec_fread_alloc_restricted( header_file , key_join_string , include_restart , NULL );
+}
+
+
 int ecl_smspec_get_num_groups(const ecl_smspec_type * ecl_smspec) {
   return hash_get_size(ecl_smspec->group_var_index);
 }
@@ -1614,6 +1689,8 @@ void ecl_smspec_free(ecl_smspec_type *ecl_smspec) {
   util_safe_free( ecl_smspec->header_file );
   int_vector_free( ecl_smspec->index_map );
   float_vector_free( ecl_smspec->params_default );
+  if (ecl_smspec->params_map)
+    int_vector_free( ecl_smspec->params_map );
   vector_free( ecl_smspec->smspec_nodes );
   free( ecl_smspec->restart_case );
   free( ecl_smspec );
@@ -1801,6 +1878,22 @@ stringlist_type * ecl_smspec_alloc_well_var_list( const ecl_smspec_type * smspec
 
 
 
+/**
+   Returns NULL unless the smspec instance has been loaded with
+   ecl_smspec_fread_alloc_restricted(); in that case the vector maps
+   from params_index to index in the PARAMS vector on file.
+*/
+
+const int_vector_type * ecl_smspec_get_params_map( const ecl_smspec_type * smspec ) {
+  return smspec->params_map;
+}
+
+
+int ecl_smspec_get_file_params_size( const ecl_smspec_type * smspec ) {
+  return smspec->file_params_size;
+}
+
+
 int ecl_smspec_get_params_size( const ecl_smspec_type * smspec ) {
   return smspec->params_size;
 }
@@ -182,8 +182,8 @@ static bool ecl_sum_fread_data( ecl_sum_type * ecl_sum , const stringlist_type *
 }
 
 
-static void ecl_sum_fread_history( ecl_sum_type * ecl_sum ) {
-  ecl_sum_type * history = ecl_sum_fread_alloc_case__( ecl_smspec_get_restart_case( ecl_sum->smspec ) , ":" , true);
+static void ecl_sum_fread_history( ecl_sum_type * ecl_sum , const stringlist_type * keys) {
+  ecl_sum_type * history = ecl_sum_fread_alloc_case_restricted( ecl_smspec_get_restart_case( ecl_sum->smspec ) , ":" , keys);
   if (history) {
     ecl_sum_data_add_case(ecl_sum->data , history->data );
     ecl_sum_free( history );
@@ -192,8 +192,8 @@ static void ecl_sum_fread_history( ecl_sum_type * ecl_sum ) {
 
 
 
-static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart) {
-  ecl_sum->smspec = ecl_smspec_fread_alloc( header_file , ecl_sum->key_join_string , include_restart);
+static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart , const stringlist_type * keys) {
+  ecl_sum->smspec = ecl_smspec_fread_alloc_restricted( header_file , ecl_sum->key_join_string , include_restart , keys);
   if (ecl_sum->smspec) {
     bool fmt_file;
     ecl_util_get_file_type( header_file , &fmt_file , NULL);
@@ -214,13 +214,13 @@ static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , con
     return false;
 
   if (include_restart && ecl_smspec_get_restart_case( ecl_sum->smspec ))
-    ecl_sum_fread_history( ecl_sum );
+    ecl_sum_fread_history( ecl_sum , keys );
 
   return true;
 }
 
 
-static bool ecl_sum_fread_case( ecl_sum_type * ecl_sum , bool include_restart) {
+static bool ecl_sum_fread_case( ecl_sum_type * ecl_sum , bool include_restart , const stringlist_type * keys) {
   char * header_file;
   stringlist_type * summary_file_list = stringlist_alloc_new();
 
@@ -228,7 +228,7 @@ static bool ecl_sum_fread_case( ecl_sum_type * ecl_sum , bool include_restart) {
 
   ecl_util_alloc_summary_files( ecl_sum->path , ecl_sum->base , ecl_sum->ext , &header_file , summary_file_list );
   if ((header_file != NULL) && (stringlist_get_size( summary_file_list ) > 0)) {
-    caseOK = ecl_sum_fread( ecl_sum , header_file , summary_file_list , include_restart );
+    caseOK = ecl_sum_fread( ecl_sum , header_file , summary_file_list , include_restart , keys );
   }
   util_safe_free( header_file );
   stringlist_free( summary_file_list );
@@ -249,8 +249,24 @@ static bool ecl_sum_fread_case( ecl_sum_type * ecl_sum , bool include_restart) {
 
 
 ecl_sum_type * ecl_sum_fread_alloc(const char *header_file , const stringlist_type *data_files , const char * key_join_string) {
+  return ecl_sum_fread_alloc_restricted( header_file , data_files , key_join_string , NULL );
+}
+
+
+/**
+   As ecl_sum_fread_alloc(), but only the summary vectors matching one
+   of the patterns in @keys (e.g. "WOPR:*" or "FOPT") are loaded; for
+   the remaining vectors neither the smspec nodes nor the data are
+   retained, and only the selected elements of the PARAMS keywords
+   are read from disk. The time vectors TIME, DAY, MONTH and YEAR are
+   always loaded. Observe that the params_index values of the loaded
+   vectors will differ from the params_index in the full SMSPEC file.
+   If @keys is NULL all the vectors are loaded.
+*/
+
+ecl_sum_type * ecl_sum_fread_alloc_restricted(const char *header_file , const stringlist_type *data_files , const char * key_join_string , const stringlist_type * keys) {
   ecl_sum_type * ecl_sum = ecl_sum_alloc__( header_file , key_join_string );
-  ecl_sum_fread( ecl_sum , header_file , data_files , false );
+  ecl_sum_fread( ecl_sum , header_file , data_files , false , keys );
   return ecl_sum;
 }
 
@@ -389,9 +405,9 @@ void ecl_sum_free__(void * __ecl_sum) {
 */
 
 
-ecl_sum_type * ecl_sum_fread_alloc_case__(const char * input_file , const char * key_join_string , bool include_restart){
+static ecl_sum_type * ecl_sum_fread_alloc_case_restricted__(const char * input_file , const char * key_join_string , bool include_restart , const stringlist_type * keys){
   ecl_sum_type * ecl_sum     = ecl_sum_alloc__(input_file , key_join_string);
-  if (ecl_sum_fread_case( ecl_sum , include_restart))
+  if (ecl_sum_fread_case( ecl_sum , include_restart , keys))
     return ecl_sum;
   else {
     /*
@@ -405,6 +421,23 @@ ecl_sum_type * ecl_sum_fread_alloc_case__(const char * input_file , const char *
 
 
 
+ecl_sum_type * ecl_sum_fread_alloc_case__(const char * input_file , const char * key_join_string , bool include_restart){
+  return ecl_sum_fread_alloc_case_restricted__( input_file , key_join_string , include_restart , NULL );
+}
+
+
+/**
+   Will load the case @input_file - including the cases it has been
+   restarted from - but only the vectors matching @keys; see
+   ecl_sum_fread_alloc_restricted().
+*/
+
+ecl_sum_type * ecl_sum_fread_alloc_case_restricted(const char * input_file , const char * key_join_string , const stringlist_type * keys){
+  bool include_restart = true;
+  return ecl_sum_fread_alloc_case_restricted__( input_file , key_join_string , include_restart , keys );
+}
+
+
 ecl_sum_type * ecl_sum_fread_alloc_case(const char * input_file , const char * key_join_string){
   bool include_restart = true;
   return ecl_sum_fread_alloc_case__( input_file , key_join_string , include_restart );
@@ -783,6 +816,17 @@ time_t_vector_type * ecl_sum_alloc_time_vector( const ecl_sum_type * ecl_sum  ,
   return ecl_sum_data_alloc_time_vector( ecl_sum->data , report_only );
 }
 
+/**
+   Returns a contiguous array with ecl_sum_get_data_length() elements
+   with all the values of the vector @data_index; the array is owned by
+   the ecl_sum instance. See ecl_sum_data_get_column().
+*/
+
+const float * ecl_sum_get_column( const ecl_sum_type * ecl_sum , int data_index ) {
+  return ecl_sum_data_get_column( ecl_sum->data , data_index );
+}
+
+
 void ecl_sum_init_data_vector( const ecl_sum_type * ecl_sum , double_vector_type * data_vector , int data_index , bool report_only ) {
   ecl_sum_data_init_data_vector( ecl_sum->data , data_vector , data_index , report_only );
 }
@@ -821,9 +865,10 @@ void ecl_sum_summarize( const ecl_sum_type * ecl_sum , FILE * stream ) {
 
 static int ecl_sum_get_limiting(const ecl_sum_type * ecl_sum , int smspec_index , double limit , bool gt) {
   const int length        = ecl_sum_data_get_length( ecl_sum->data );
+  const float * column    = ecl_sum_data_get_column( ecl_sum->data , smspec_index );
   int internal_index      = 0;
   do {
-    double value = ecl_sum_data_iget( ecl_sum->data , internal_index , smspec_index );
+    double value = column[internal_index];
     if (gt) {
       if (value > limit)
         break;
@@ -18,6 +18,11 @@
 
 #include <string.h>
 
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 #include <ert/util/util.h>
 #include <ert/util/vector.h>
 #include <ert/util/time_t_vector.h>
@@ -225,6 +230,12 @@ struct ecl_sum_data_struct {
   time_interval_type     * sim_time;               /* The time interval sim_time goes from the first time value where we have
                                                       data to the end of the simulation. In the case of restarts the start
                                                       value might disagree with the simulation start reported by the smspec file. */
+  bool                     writer;                 /* In write mode the tstep data can be updated behind our back with ecl_sum_tstep_iset(). */
+  int                      num_columns;
+  float                 ** columns;                /* Lazily built column major copies of the data, indexed by params_index; see ecl_sum_data_get_column(). */
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_t          column_lock;            /* Held when building a column. */
+#endif
 };
 
 
@@ -233,7 +244,49 @@ struct ecl_sum_data_struct {
 
 /*****************************************************************/
 
+static void ecl_sum_data_column_lock( const ecl_sum_data_type * data ) {
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_lock( &((ecl_sum_data_type *) data)->column_lock );
+#endif
+}
+
+
+static void ecl_sum_data_column_unlock( const ecl_sum_data_type * data ) {
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_unlock( &((ecl_sum_data_type *) data)->column_lock );
+#endif
+}
+
+
+/*
+  Will discard all the column major copies of the data; must be called
+  whenever tsteps are added, removed or reordered. Pointers returned
+  from ecl_sum_data_get_column() are invalid after this.
+*/
+
+static void ecl_sum_data_clear_columns( ecl_sum_data_type * data ) {
+  int i;
+  for (i=0; i < data->num_columns; i++) {
+    free( data->columns[i] );
+    data->columns[i] = NULL;
+  }
+}
+
+
+static void ecl_sum_data_clear_column( ecl_sum_data_type * data , int params_index ) {
+  if (params_index < data->num_columns) {
+    free( data->columns[params_index] );
+    data->columns[params_index] = NULL;
+  }
+}
+
+
  void ecl_sum_data_free( ecl_sum_data_type * data ) {
+  ecl_sum_data_clear_columns( data );
+  free( data->columns );
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_destroy( &data->column_lock );
+#endif
   vector_free( data->data );
   int_vector_free( data->report_first_index );
   int_vector_free( data->report_last_index  );
@@ -260,6 +313,7 @@ static void ecl_sum_data_clear_index( ecl_sum_data_type * data ) {
   data->last_ministep         = INVALID_MINISTEP_NR;
   data->index_valid           = false;
   time_interval_reopen( data->sim_time );
+  ecl_sum_data_clear_columns( data );
 }
 
 
@@ -268,6 +322,12 @@ ecl_sum_data_type * ecl_sum_data_alloc(ecl_smspec_type * smspec) {
   data->data        = vector_alloc_new();
   data->smspec      = smspec;
   data->__min_time  = 0;
+  data->writer       = false;
+  data->num_columns  = 0;
+  data->columns      = NULL;
+#ifdef ERT_HAVE_PTHREAD
+  pthread_mutex_init( &data->column_lock , NULL );
+#endif
 
   data->report_first_index    = int_vector_alloc( 0 , INVALID_MINISTEP_NR );
   data->report_last_index     = int_vector_alloc( 0 , INVALID_MINISTEP_NR );
@@ -318,6 +378,7 @@ void ecl_sum_data_report2internal_range(const ecl_sum_data_type * data , int rep
 
 ecl_sum_data_type * ecl_sum_data_alloc_writer( ecl_smspec_type * smspec ) {
   ecl_sum_data_type * data = ecl_sum_data_alloc( smspec );
+  data->writer = true;
   return data;
 }
 
@@ -750,6 +811,7 @@ static void ecl_sum_data_append_tstep__( ecl_sum_data_type * data , ecl_sum_tste
 
   vector_append_owned_ref( data->data , tstep , ecl_sum_tstep_free__);
   data->index_valid = false;
+  ecl_sum_data_clear_columns( data );
 }
 
 
@@ -921,20 +983,39 @@ static void ecl_sum_data_add_ecl_file(ecl_sum_data_type * data         ,
 
   int num_ministep  = ecl_file_view_get_num_named_kw( summary_view , PARAMS_KW);
   if (num_ministep > 0) {
+    const int_vector_type * params_map = ecl_smspec_get_params_map( smspec );
+    float * params_data = NULL;
     int ikw;
 
+    /*
+      When the smspec has been loaded with a key selection only the
+      selected elements of the PARAMS keywords are read from file.
+    */
+    if (params_map != NULL)
+      params_data = util_calloc( util_int_max( int_vector_size( params_map ) , 1 ) , sizeof * params_data );
+
     for (ikw = 0; ikw < num_ministep; ikw++) {
       ecl_kw_type * ministep_kw = ecl_file_view_iget_named_kw( summary_view , MINISTEP_KW , ikw);
-      ecl_kw_type * params_kw   = ecl_file_view_iget_named_kw( summary_view , PARAMS_KW   , ikw);
 
       {
-        ecl_sum_tstep_type * tstep;
+        ecl_sum_tstep_type * tstep = NULL;
         int ministep_nr = ecl_kw_iget_int( ministep_kw , 0 );
-        tstep = ecl_sum_tstep_alloc_from_file( report_step ,
-                                               ministep_nr ,
-                                               params_kw ,
-                                               ecl_file_view_get_src_file( summary_view ),
-                                               smspec );
+
+        if (params_map == NULL) {
+          ecl_kw_type * params_kw = ecl_file_view_iget_named_kw( summary_view , PARAMS_KW , ikw);
+          tstep = ecl_sum_tstep_alloc_from_file( report_step ,
+                                                 ministep_nr ,
+                                                 params_kw ,
+                                                 ecl_file_view_get_src_file( summary_view ),
+                                                 smspec );
+        } else {
+          if (ecl_file_view_iget_named_size( summary_view , PARAMS_KW , ikw ) == ecl_smspec_get_file_params_size( smspec )) {
+            ecl_file_view_index_fload_kw( summary_view , PARAMS_KW , ikw , params_map , (char *) params_data );
+            tstep = ecl_sum_tstep_alloc_from_data( report_step , ministep_nr , params_data , smspec );
+          } else
+            fprintf(stderr , "** Warning size mismatch between timestep loaded from:%s and header:%s - timestep discarded.\n" ,
+                    ecl_file_view_get_src_file( summary_view ) , ecl_smspec_get_header_file( smspec ));
+        }
 
         if (tstep != NULL) {
           if (load_end == 0 || (ecl_sum_tstep_get_sim_time( tstep ) < load_end))
@@ -946,6 +1027,7 @@ static void ecl_sum_data_add_ecl_file(ecl_sum_data_type * data         ,
         }
       }
     }
+    util_safe_free( params_data );
   }
 }
 
@@ -1456,22 +1538,83 @@ time_t_vector_type *  ecl_sum_data_alloc_time_vector( const ecl_sum_data_type *
 }
 
 
+static void ecl_sum_data_init_column__( const ecl_sum_data_type * data , int params_index , float * column ) {
+  const int length = vector_get_size( data->data );
+  int i;
+
+  for (i = 0; i < length; i++) {
+    const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , i );
+    column[i] = ecl_sum_tstep_iget( ministep , params_index );
+  }
+}
+
+
+/**
+   Will return a pointer to a contiguous array, with
+   ecl_sum_data_get_length() elements, of all the values of the vector
+   @params_index ordered by internal index. The tstep data is stored
+   row wise, i.e. one PARAMS vector for each ministep, so the column is
+   extracted with a strided pass through all the tsteps the first time
+   it is requested and then kept on the ecl_sum_data instance.
+
+   Only the requested vectors are stored in column major order, i.e.
+   the extra memory is at most one copy of the data. The returned
+   pointer is owned by the ecl_sum_data instance, and is valid until
+   tsteps are added to the instance or the vector is scaled or
+   shifted. Building a column is protected by a mutex, so the function
+   can be called concurrently on the same instance.
+
+   In write mode the data can be updated directly through the
+   ecl_sum_tstep instances, so then the column is re-read from the
+   tsteps on every call.
+*/
+
+const float * ecl_sum_data_get_column( const ecl_sum_data_type * data , int params_index ) {
+  ecl_sum_data_type * cache = (ecl_sum_data_type *) data;   /* Only the column cache is modified; under the column_lock. */
+  float * column;
+
+  if (params_index < 0 || params_index >= ecl_smspec_get_params_size( data->smspec ))
+    util_abort("%s: invalid params_index:%d \n",__func__ , params_index);
+
+  ecl_sum_data_column_lock( data );
+  {
+    if (params_index >= data->num_columns) {
+      int new_size = ecl_smspec_get_params_size( data->smspec );
+      int i;
+
+      cache->columns = util_realloc( data->columns , new_size * sizeof * data->columns );
+      for (i = data->num_columns; i < new_size; i++)
+        cache->columns[i] = NULL;
+      cache->num_columns = new_size;
+    }
+
+    column = data->columns[params_index];
+    if (column == NULL) {
+      column = util_calloc( util_int_max( vector_get_size( data->data ) , 1 ) , sizeof * column );
+      cache->columns[params_index] = column;
+      ecl_sum_data_init_column__( data , params_index , column );
+    } else if (data->writer)
+      ecl_sum_data_init_column__( data , params_index , column );
+  }
+  ecl_sum_data_column_unlock( data );
+  return column;
+}
+
+
 void ecl_sum_data_init_data_vector( const ecl_sum_data_type * data , double_vector_type * data_vector , int data_index , bool report_only) {
+  const float * column = ecl_sum_data_get_column( data , data_index );
   double_vector_reset( data_vector );
   double_vector_append( data_vector , ecl_smspec_get_start_time( data->smspec ));
   if (report_only) {
     int report_step;
     for (report_step = data->first_report_step; report_step <= data->last_report_step; report_step++) {
       int last_index = int_vector_iget(data->report_last_index , report_step);
-      const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , last_index );
-      double_vector_append( data_vector , ecl_sum_tstep_iget( ministep , data_index ));
+      double_vector_append( data_vector , column[ last_index ] );
     }
   } else {
     int i;
-    for (i = 0; i < vector_get_size(data->data); i++) {
-      const ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep( data , i  );
-      double_vector_append( data_vector , ecl_sum_tstep_iget( ministep , data_index ));
-    }
+    for (i = 0; i < vector_get_size(data->data); i++)
+      double_vector_append( data_vector , column[i] );
   }
 }
 
@@ -1500,6 +1643,7 @@ void ecl_sum_data_scale_vector(ecl_sum_data_type * data, int index, double scala
     ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep(data,i);
     ecl_sum_tstep_iscale(ministep, index, scalar);
   }
+  ecl_sum_data_clear_column( data , index );
 }
 
 void ecl_sum_data_shift_vector(ecl_sum_data_type * data, int index, double addend) {
@@ -1508,6 +1652,7 @@ void ecl_sum_data_shift_vector(ecl_sum_data_type * data, int index, double adden
     ecl_sum_tstep_type * ministep = ecl_sum_data_iget_ministep(data,i);
     ecl_sum_tstep_ishift(ministep, index, addend);
   }
+  ecl_sum_data_clear_column( data , index );
 }
 
 bool ecl_sum_data_report_step_equal( const ecl_sum_data_type * data1 , const ecl_sum_data_type * data2) {
@@ -16,6 +16,7 @@
    for more details.
 */
 
+#include <string.h>
 #include <time.h>
 #include <math.h>
 
@@ -216,6 +217,21 @@ ecl_sum_tstep_type * ecl_sum_tstep_alloc_from_file( int report_step    ,
 }
 
 
+/*
+  As ecl_sum_tstep_alloc_from_file(), but the data has already been
+  extracted from the PARAMS keyword by the calling scope; the @data
+  pointer must point to ecl_smspec_get_params_size() elements. Used
+  when only a subset of the PARAMS vector has been loaded.
+*/
+
+ecl_sum_tstep_type * ecl_sum_tstep_alloc_from_data( int report_step , int ministep_nr , const float * data , const ecl_smspec_type * smspec) {
+  ecl_sum_tstep_type * ministep = ecl_sum_tstep_alloc( report_step , ministep_nr , smspec);
+  memcpy( ministep->data , data , ministep->data_size * sizeof * ministep->data );
+  ecl_sum_tstep_set_time_info( ministep , smspec );
+  return ministep;
+}
+
+
 /*
   Should be called in write mode.
 */
@@ -21,6 +21,9 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <limits.h>
 
 #include <ert/util/ert_api_config.h>
 
@@ -1566,3 +1569,208 @@ void ecl_util_set_date_values(time_t t , int * mday , int * month , int * year)
 }
 
 
+
+/*****************************************************************/
+/*
+  Low level scanning of formatted ECLIPSE files and GRDECL files. The
+  input is split in whitespace separated tokens with
+  ecl_util_fscanf_token(), and numbers are parsed from the tokens by
+  hand. This is considerably faster than one fscanf() call per
+  element, and it is independent of the current locale; i.e. the
+  decimal separator is always '.'.
+*/
+
+#ifdef ERT_HAVE_GETC_UNLOCKED
+#define ECL_UTIL_GETC(stream)    getc_unlocked(stream)
+#define ECL_UTIL_LOCK(stream)    flockfile(stream)
+#define ECL_UTIL_UNLOCK(stream)  funlockfile(stream)
+#else
+#define ECL_UTIL_GETC(stream)    getc(stream)
+#define ECL_UTIL_LOCK(stream)
+#define ECL_UTIL_UNLOCK(stream)
+#endif
+
+#define ECL_UTIL_MAX_EXPONENT     100000
+#define ECL_UTIL_MAX_MANTISSA     100000000000000000ULL    /* 10^17 */
+#define ECL_UTIL_EXACT_MANTISSA   9007199254740992ULL      /* 2^53  */
+
+static bool ecl_util_isspace( int c ) {
+  return (c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f');
+}
+
+static bool ecl_util_isdigit( int c ) {
+  return (c >= '0' && c <= '9');
+}
+
+
+/**
+   Will skip whitespace and then read the next whitespace separated
+   token from the stream into @token, which must have room for
+   @max_length + 1 characters. Longer tokens are split, i.e. this
+   behaves like fscanf(stream , "%<max_length>s" , token). The stream
+   is left positioned at the character following the token. Returns
+   the length of the token; 0 means EOF.
+*/
+
+int ecl_util_fscanf_token( FILE * stream , char * token , int max_length) {
+  int length = 0;
+  int c;
+
+  ECL_UTIL_LOCK( stream );
+  do {
+    c = ECL_UTIL_GETC( stream );
+  } while (ecl_util_isspace( c ));
+
+  while ((c != EOF) && !ecl_util_isspace( c )) {
+    token[length] = c;
+    length++;
+    if (length == max_length)
+      break;
+    c = ECL_UTIL_GETC( stream );
+  }
+
+  if ((length < max_length) && (c != EOF))
+    ungetc( c , stream );
+  ECL_UTIL_UNLOCK( stream );
+
+  token[length] = '\0';
+  return length;
+}
+
+
+/**
+   Parses an integer from the start of @s. Returns the number of
+   characters consumed, or 0 if @s does not start with an integer
+   which fits in an int.
+*/
+
+int ecl_util_parse_fmt_int( const char * s , int * value) {
+  const char * p = s;
+  bool negative = false;
+  long long int_value = 0;
+
+  if (*p == '+' || *p == '-') {
+    negative = (*p == '-');
+    p++;
+  }
+
+  if (!ecl_util_isdigit( *p ))
+    return 0;
+
+  while (ecl_util_isdigit( *p )) {
+    int_value = 10 * int_value + (*p - '0');
+    if (int_value > (long long) INT_MAX + 1)
+      return 0;
+    p++;
+  }
+
+  if (negative)
+    int_value = -int_value;
+
+  if (int_value > INT_MAX)
+    return 0;
+
+  *value = (int) int_value;
+  return p - s;
+}
+
+
+/**
+   Parses a floating point number from the start of @s. Both the 'E'
+   exponent of C and float data, and the 'D' exponent which is used
+   for double precision data in formatted ECLIPSE files, are
+   recognized. Returns the number of characters consumed, or 0 if @s
+   does not start with a number.
+
+   When the significant digits fit in the 53 bit mantissa of a double
+   and the decimal exponent is small the value is computed directly,
+   otherwise strtod() is used for the final rounding. Digits beyond
+   the 18th significant digit are ignored.
+*/
+
+int ecl_util_parse_fmt_double( const char * s , double * value) {
+  static const double pow10[] = {1e0  , 1e1  , 1e2  , 1e3  , 1e4  , 1e5  , 1e6  , 1e7  ,
+                                 1e8  , 1e9  , 1e10 , 1e11 , 1e12 , 1e13 , 1e14 , 1e15 ,
+                                 1e16 , 1e17 , 1e18 , 1e19 , 1e20 , 1e21 , 1e22};
+  const char * p = s;
+  bool negative = false;
+  bool truncated = false;
+  bool has_digits = false;
+  uint64_t mantissa = 0;
+  int exp10 = 0;
+
+  if (*p == '+' || *p == '-') {
+    negative = (*p == '-');
+    p++;
+  }
+
+  while (ecl_util_isdigit( *p )) {
+    if (mantissa < ECL_UTIL_MAX_MANTISSA)
+      mantissa = 10 * mantissa + (*p - '0');
+    else {
+      exp10++;
+      truncated = true;
+    }
+    has_digits = true;
+    p++;
+  }
+
+  if (*p == '.') {
+    p++;
+    while (ecl_util_isdigit( *p )) {
+      if (mantissa < ECL_UTIL_MAX_MANTISSA) {
+        mantissa = 10 * mantissa + (*p - '0');
+        exp10--;
+      } else
+        truncated = true;
+      has_digits = true;
+      p++;
+    }
+  }
+
+  if (!has_digits)
+    return 0;
+
+  if (*p == 'E' || *p == 'e' || *p == 'D' || *p == 'd') {
+    const char * q = p + 1;
+    bool exp_negative = false;
+
+    if (*q == '+' || *q == '-') {
+      exp_negative = (*q == '-');
+      q++;
+    }
+
+    if (ecl_util_isdigit( *q )) {
+      int exponent = 0;
+      while (ecl_util_isdigit( *q )) {
+        if (exponent < ECL_UTIL_MAX_EXPONENT)
+          exponent = 10 * exponent + (*q - '0');
+        q++;
+      }
+      exp10 += exp_negative ? -exponent : exponent;
+      p = q;
+    }
+  }
+
+  {
+    double double_value = (double) mantissa;
+
+    if (!truncated && (mantissa <= ECL_UTIL_EXACT_MANTISSA) && (exp10 >= -22) && (exp10 <= 22)) {
+      if (exp10 < 0)
+        double_value /= pow10[-exp10];
+      else
+        double_value *= pow10[exp10];
+    } else if (mantissa > 0) {
+      /*
+        Slow path: let strtod() do the rounding. The canonical string
+        has no decimal point, so the locale does not matter.
+      */
+      char buffer[64];
+      snprintf( buffer , sizeof buffer , "%" PRIu64 "e%d" , mantissa , exp10 );
+      double_value = strtod( buffer , NULL );
+    }
+
+    *value = negative ? -double_value : double_value;
+  }
+  return p - s;
+}
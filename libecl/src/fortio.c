@@ -22,7 +22,13 @@
 #include <string.h>
 #include <errno.h>
 
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #include <ert/util/util.h>
+#include <ert/util/hash.h>
 #include <ert/util/type_macros.h>
 #include <ert/ecl/fortio.h>
 
@@ -90,6 +96,28 @@ struct fortio_struct {
   */
   bool               readable;
   offset_type        read_size;
+
+  /*
+    When the fortio instance is opened with fortio_open_reader_mmap()
+    the complete file is mapped into memory, and data reading
+    functions will copy directly from the mapped pages instead of
+    going through fread(). The mapping is private, i.e. modifications
+    through a pointer into the mapping will never reach the file.
+  */
+  char             * mmap_data;
+  size_t             mmap_size;
+
+  /*
+    Records which should be handed out with the byte order of the
+    host, when that differs from the byte order of the file, are
+    byte swapped in place in a second private mapping of the file;
+    that way mmap_data always holds the unmodified file content. The
+    second mapping is created on first use, and the offsets of the
+    swapped records are kept in mmap_flipped so that a record is
+    never swapped twice.
+  */
+  char             * mmap_flip_data;
+  hash_type        * mmap_flipped;
 };
 
 
@@ -105,6 +133,10 @@ static fortio_type * fortio_alloc__(const char *filename , bool fmt_file , bool
   fortio->stream_owner       = stream_owner;
   fortio->read_size          = 0;
   fortio->readable           = readable;
+  fortio->mmap_data          = NULL;
+  fortio->mmap_size          = 0;
+  fortio->mmap_flip_data     = NULL;
+  fortio->mmap_flipped       = NULL;
   return fortio;
 }
 
@@ -303,6 +335,32 @@ fortio_type * fortio_open_reader(const char *filename , bool fmt_file , bool end
 
 
 
+/**
+   Will open the file for reading exactly like fortio_open_reader(),
+   and in addition map the complete file into memory. If the mapping
+   fails, or the file is formatted, the fortio instance will silently
+   fall back to ordinary stdio based reading.
+
+   The file is assumed to be unmodified for the lifetime of the fortio
+   instance.
+*/
+
+fortio_type * fortio_open_reader_mmap(const char *filename , bool fmt_file , bool endian_flip_header) {
+  fortio_type * fortio = fortio_open_reader( filename , fmt_file , endian_flip_header );
+#ifdef ERT_HAVE_MMAP
+  if (fortio && !fmt_file && (fortio->read_size > 0)) {
+    void * data = mmap( NULL , fortio->read_size , PROT_READ | PROT_WRITE , MAP_PRIVATE , fortio_fileno( fortio ) , 0);
+    if (data != MAP_FAILED) {
+      fortio->mmap_data = data;
+      fortio->mmap_size = fortio->read_size;
+    }
+  }
+#endif
+  return fortio;
+}
+
+
+
 fortio_type * fortio_open_writer(const char *filename , bool fmt_file , bool endian_flip_header ) {
   FILE * stream = fortio_fopen_write( filename , fmt_file );
   if (stream) {
@@ -396,6 +454,14 @@ bool fortio_assert_stream_open( fortio_type * fortio ) {
 
 
 static void fortio_free__(fortio_type * fortio) {
+#ifdef ERT_HAVE_MMAP
+  if (fortio->mmap_data)
+    munmap( fortio->mmap_data , fortio->mmap_size );
+  if (fortio->mmap_flip_data)
+    munmap( fortio->mmap_flip_data , fortio->mmap_size );
+#endif
+  if (fortio->mmap_flipped)
+    hash_free( fortio->mmap_flipped );
   util_safe_free(fortio->filename);
   free(fortio);
 }
@@ -526,6 +592,188 @@ static int fortio_fread_record(fortio_type *fortio , char *buffer) {
 }
 
 
+/**
+   Reads the header of the record starting at @offset in the mapped
+   file. Will return -1 if the mapping does not contain a complete
+   and consistent record at @offset.
+*/
+
+static int fortio_mmap_record_size( const fortio_type * fortio , size_t offset ) {
+  int header , tail;
+
+  if (offset + 2 * sizeof header > fortio->mmap_size)
+    return -1;
+
+  memcpy( &header , &fortio->mmap_data[offset] , sizeof header );
+  if (fortio->endian_flip_header)
+    util_endian_flip_vector(&header , sizeof header , 1);
+
+  if ((header < 0) || (offset + 2 * sizeof header + header > fortio->mmap_size))
+    return -1;
+
+  memcpy( &tail , &fortio->mmap_data[offset + sizeof header + header] , sizeof tail );
+  if (fortio->endian_flip_header)
+    util_endian_flip_vector(&tail , sizeof tail , 1);
+
+  if (tail != header)
+    return -1;
+
+  return header;
+}
+
+
+/**
+   Memory mapped version of fortio_fread_buffer(); the records are
+   located and copied directly from the mapping, and the stream is
+   positioned after the last record which was read.
+*/
+
+static bool fortio_mmap_fread_buffer( fortio_type * fortio , char * buffer , int buffer_size) {
+  size_t offset = fortio_ftell( fortio );
+  int total_bytes_read = 0;
+
+  while (total_bytes_read < buffer_size) {
+    int record_size = fortio_mmap_record_size( fortio , offset );
+    if ((record_size < 0) || (total_bytes_read + record_size > buffer_size))
+      break;
+
+    memcpy( &buffer[total_bytes_read] , &fortio->mmap_data[offset + sizeof record_size] , record_size );
+    total_bytes_read += record_size;
+    offset += record_size + 2 * sizeof record_size;
+  }
+
+  fortio_fseek( fortio , offset , SEEK_SET );
+  return (total_bytes_read == buffer_size);
+}
+
+
+/**
+   If the fortio instance is memory mapped, and the data at the
+   current position is one single record of exactly @buffer_size
+   bytes, this function will return a pointer to the record data in
+   the mapping and position the stream after the record. In all other
+   cases the function will return NULL and leave the stream position
+   unchanged; the caller must then use fortio_fread_buffer().
+
+   The returned pointer is valid until the fortio instance is closed;
+   writes through it go to a private copy of the page and are never
+   seen by the file.
+*/
+
+char * fortio_mmap_record_data( fortio_type * fortio , int buffer_size ) {
+  if (fortio->mmap_data) {
+    size_t offset = fortio_ftell( fortio );
+    int record_size = fortio_mmap_record_size( fortio , offset );
+    if (record_size == buffer_size) {
+      fortio_fseek( fortio , offset + record_size + 2 * sizeof record_size , SEEK_SET );
+      return &fortio->mmap_data[offset + sizeof record_size];
+    }
+  }
+  return NULL;
+}
+
+
+/**
+   Like fortio_mmap_record_data(), but the record data is returned
+   with the byte order of every @elm_size element swapped. The
+   swapping is done in place in a second private copy-on-write
+   mapping of the file, i.e. the pages holding the record are copied
+   by the kernel when they are swapped, but no heap storage is
+   allocated and no read() calls are made. The original mapping is
+   left untouched, so the ordinary reading functions are not affected.
+
+   The record is swapped the first time it is requested; subsequent
+   calls for the same record return the same, already swapped, data.
+   The returned pointer is valid until the fortio instance is closed.
+*/
+
+char * fortio_mmap_record_data_flip( fortio_type * fortio , int buffer_size , int elm_size ) {
+#ifdef ERT_HAVE_MMAP
+  if (fortio->mmap_data && (elm_size > 0) && ((buffer_size % elm_size) == 0)) {
+    size_t offset = fortio_ftell( fortio );
+    int record_size = fortio_mmap_record_size( fortio , offset );
+
+    if (record_size != buffer_size)
+      return NULL;
+
+    if (!fortio->mmap_flip_data) {
+      void * data = mmap( NULL , fortio->mmap_size , PROT_READ | PROT_WRITE , MAP_PRIVATE , fortio_fileno( fortio ) , 0);
+      if (data == MAP_FAILED)
+        return NULL;
+
+      fortio->mmap_flip_data = data;
+      fortio->mmap_flipped = hash_alloc();
+    }
+
+    {
+      char * record_data = &fortio->mmap_flip_data[offset + sizeof record_size];
+      char * key = util_alloc_sprintf( "%zu" , offset );
+
+      if (!hash_has_key( fortio->mmap_flipped , key )) {
+        util_endian_flip_vector( record_data , elm_size , record_size / elm_size );
+        hash_insert_int( fortio->mmap_flipped , key , 1 );
+      }
+      free( key );
+
+      fortio_fseek( fortio , offset + record_size + 2 * sizeof record_size , SEEK_SET );
+      return record_data;
+    }
+  }
+#endif
+  return NULL;
+}
+
+
+/**
+   Will return a pointer to the next @size bytes of the memory mapped
+   file, and position the stream after them. If the fortio instance is
+   not memory mapped, or the file does not contain @size more bytes,
+   the function will return NULL and leave the stream position
+   unchanged.
+*/
+
+const char * fortio_mmap_fread_ptr( fortio_type * fortio , size_t size ) {
+  if (fortio->mmap_data) {
+    size_t offset = fortio_ftell( fortio );
+    if (offset + size <= fortio->mmap_size) {
+      fortio_fseek( fortio , offset + size , SEEK_SET );
+      return &fortio->mmap_data[offset];
+    }
+  }
+  return NULL;
+}
+
+
+/**
+   Checks whether the memory buffer @buffer - which should hold a copy
+   of file content read from this fortio instance - contains a
+   complete Fortran record with exactly @record_size bytes of data
+   starting at @offset. The caller must ensure that the buffer holds
+   at least @offset + @record_size + 8 bytes.
+*/
+
+bool fortio_buffer_has_record( const fortio_type * fortio , const char * buffer , size_t offset , int record_size) {
+  int header , tail;
+
+  memcpy( &header , &buffer[offset] , sizeof header );
+  memcpy( &tail , &buffer[offset + sizeof header + record_size] , sizeof tail );
+  if (fortio->endian_flip_header) {
+    util_endian_flip_vector(&header , sizeof header , 1);
+    util_endian_flip_vector(&tail , sizeof tail , 1);
+  }
+
+  return ((header == record_size) && (tail == record_size));
+}
+
+
+bool fortio_is_mmapped( const fortio_type * fortio ) {
+  if (fortio->mmap_data)
+    return true;
+  else
+    return false;
+}
+
+
 /**
    This function fills the buffer with 'buffer_size' bytes from the
    fortio stream. The function works by repeated calls to
@@ -538,6 +786,9 @@ static int fortio_fread_record(fortio_type *fortio , char *buffer) {
 bool fortio_fread_buffer(fortio_type * fortio, char * buffer , int buffer_size) {
   int total_bytes_read = 0;
 
+  if (fortio->mmap_data)
+    return fortio_mmap_fread_buffer( fortio , buffer , buffer_size );
+
   while (true) {
     char * buffer_ptr = &buffer[total_bytes_read];
     int bytes_read = fortio_fread_record(fortio , buffer_ptr);
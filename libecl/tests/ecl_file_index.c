@@ -0,0 +1,224 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/fortio.h>
+
+
+void write_restart( const char * filename , int num_steps ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int step;
+  for (step = 0; step < num_steps; step++) {
+    ecl_kw_type * seqnum = ecl_kw_alloc( SEQNUM_KW , 1 , ECL_INT_TYPE );
+    ecl_kw_type * intehead = ecl_kw_alloc( INTEHEAD_KW , INTEHEAD_RESTART_SIZE , ECL_INT_TYPE );
+    ecl_kw_type * doubhead = ecl_kw_alloc( DOUBHEAD_KW , 10 , ECL_DOUBLE_TYPE );
+    ecl_kw_type * pressure = ecl_kw_alloc( "PRESSURE" , 1000 , ECL_FLOAT_TYPE );
+
+    ecl_kw_iset_int( seqnum , 0 , 10 * step );
+    ecl_kw_scalar_set_int( intehead , 0 );
+    ecl_kw_iset_int( intehead , INTEHEAD_DAY_INDEX , 1 );
+    ecl_kw_iset_int( intehead , INTEHEAD_MONTH_INDEX , 1 + step );
+    ecl_kw_iset_int( intehead , INTEHEAD_YEAR_INDEX , 2010 );
+    ecl_kw_scalar_set_double( doubhead , 0 );
+    ecl_kw_iset_double( doubhead , DOUBHEAD_DAYS_INDEX , 31.0 * step );
+    ecl_kw_scalar_set_float( pressure , 100 + step );
+
+    ecl_kw_fwrite( seqnum , fortio );
+    ecl_kw_fwrite( intehead , fortio );
+    ecl_kw_fwrite( doubhead , fortio );
+    ecl_kw_fwrite( pressure , fortio );
+
+    ecl_kw_free( seqnum );
+    ecl_kw_free( intehead );
+    ecl_kw_free( doubhead );
+    ecl_kw_free( pressure );
+  }
+  fortio_fclose( fortio );
+}
+
+
+void assert_equal_files( ecl_file_type * file1 , ecl_file_type * file2 ) {
+  int i;
+  test_assert_int_equal( ecl_file_get_size( file1 ) , ecl_file_get_size( file2 ));
+  for (i=0; i < ecl_file_get_size( file1 ); i++) {
+    test_assert_string_equal( ecl_file_iget_header( file1 , i ) , ecl_file_iget_header( file2 , i ));
+    test_assert_int_equal( ecl_file_iget_size( file1 , i ) , ecl_file_iget_size( file2 , i ));
+    test_assert_int_equal( ecl_file_iget_type( file1 , i ) , ecl_file_iget_type( file2 , i ));
+    test_assert_true( ecl_kw_equal( ecl_file_iget_kw( file1 , i ) , ecl_file_iget_kw( file2 , i )));
+  }
+}
+
+
+/*
+  When the index is loaded the restart header keywords are already in
+  memory; selecting restart blocks should then work even without the
+  backing file.
+*/
+
+void test_restart_lookup( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_INDEX );
+  ecl_file_fortio_detach( ecl_file );
+
+  test_assert_true( ecl_file_has_report_step( ecl_file , 20 ));
+  test_assert_false( ecl_file_has_report_step( ecl_file , 25 ));
+  test_assert_true( ecl_file_has_sim_time( ecl_file , ecl_util_make_date( 1 , 3 , 2010 )));
+  {
+    ecl_file_view_type * view = ecl_file_get_restart_view( ecl_file , -1 , 30 , -1 , -1 );
+    test_assert_not_NULL( view );
+    test_assert_int_equal( ecl_file_view_get_size( view ) , 4 );
+  }
+  {
+    ecl_file_view_type * view = ecl_file_get_restart_view( ecl_file , -1 , -1 , ecl_util_make_date( 1 , 2 , 2010 ) , -1 );
+    test_assert_not_NULL( view );
+  }
+  {
+    ecl_file_view_type * view = ecl_file_get_restart_view( ecl_file , -1 , -1 , -1 , 62.0 );
+    test_assert_not_NULL( view );
+  }
+  ecl_file_close( ecl_file );
+}
+
+
+/*
+  Writes the index with @num_skip bytes removed at @offset, or if
+  @num_skip is zero with the int at @offset overwritten with @value
+  repeated, and checks that the index is ignored.
+*/
+
+void test_corrupt_index( const char * filename , const char * index_file , const char * index_data , size_t index_size , size_t offset , size_t num_skip , int value) {
+  FILE * stream = util_fopen( index_file , "w");
+
+  if (num_skip > 0) {
+    util_fwrite( index_data , 1 , offset , stream , __func__ );
+    util_fwrite( &index_data[ offset + num_skip ] , 1 , index_size - offset - num_skip , stream , __func__ );
+  } else {
+    util_fwrite( index_data , 1 , index_size , stream , __func__ );
+    if (value != 0) {
+      char bytes[sizeof(int)];
+      memset( bytes , value , sizeof bytes );
+      fseek( stream , offset , SEEK_SET );
+      util_fwrite( bytes , 1 , sizeof bytes , stream , __func__ );
+    }
+  }
+  fclose( stream );
+
+  {
+    ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_INDEX );
+    test_assert_int_equal( ecl_file_get_size( ecl_file ) , 28 );
+    ecl_file_close( ecl_file );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_index");
+  const char * filename = "CASE.UNRST";
+  const char * index_file = "CASE.UNRST.index";
+
+  write_restart( filename , 5 );
+  {
+    ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+    test_assert_false( util_file_exists( index_file ));
+    ecl_file_close( ecl_file );
+  }
+
+  {
+    ecl_file_type * scan_file = ecl_file_open( filename , 0 );
+    ecl_file_type * index_file1 = ecl_file_open( filename , ECL_FILE_INDEX );
+    ecl_file_type * index_file2;
+
+    test_assert_true( util_file_exists( index_file ));
+    index_file2 = ecl_file_open( filename , ECL_FILE_INDEX + ECL_FILE_CLOSE_STREAM );
+
+    assert_equal_files( scan_file , index_file1 );
+    assert_equal_files( scan_file , index_file2 );
+
+    ecl_file_close( scan_file );
+    ecl_file_close( index_file1 );
+    ecl_file_close( index_file2 );
+  }
+  test_restart_lookup( filename );
+
+  /* A stale index must be detected and replaced. */
+  write_restart( filename , 7 );
+  {
+    ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_INDEX );
+    test_assert_int_equal( ecl_file_get_size( ecl_file ) , 28 );
+    ecl_file_close( ecl_file );
+
+    ecl_file = ecl_file_open( filename , ECL_FILE_INDEX );
+    test_assert_int_equal( ecl_file_get_size( ecl_file ) , 28 );
+    ecl_file_close( ecl_file );
+  }
+
+  /* A truncated index file is ignored. */
+  {
+    FILE * stream = util_fopen( index_file , "w");
+    fprintf(stream , "Garbage");
+    fclose( stream );
+    {
+      ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_INDEX );
+      test_assert_int_equal( ecl_file_get_size( ecl_file ) , 28 );
+      ecl_file_close( ecl_file );
+    }
+  }
+
+  /*
+    An index with a valid header and trailer, but with a corrupt or
+    truncated middle section, is also ignored.
+  */
+  {
+    ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_INDEX );
+    ecl_file_close( ecl_file );
+  }
+  {
+    size_t index_size = util_file_size( index_file );
+    size_t num_kw_offset = 2 * sizeof(int) + sizeof(int64_t) + sizeof(time_t);
+    char * index_data = util_calloc( index_size , sizeof * index_data );
+    FILE * stream = util_fopen( index_file , "r");
+    util_fread( index_data , 1 , index_size , stream , __func__ );
+    fclose( stream );
+
+    test_corrupt_index( filename , index_file , index_data , index_size , num_kw_offset + sizeof(int) , 0 , 0xFF );
+    test_corrupt_index( filename , index_file , index_data , index_size , index_size / 2 , index_size / 4 , 0 );
+    test_corrupt_index( filename , index_file , index_data , index_size , index_size / 2 , 0 , 0x7F );
+    {
+      int num_kw = 100000;
+      memcpy( &index_data[ num_kw_offset ] , &num_kw , sizeof num_kw );
+      test_corrupt_index( filename , index_file , index_data , index_size , 0 , 0 , 0 );
+    }
+    free( index_data );
+  }
+
+  test_work_area_free( work_area );
+  exit(0);
+}
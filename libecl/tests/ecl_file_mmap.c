@@ -0,0 +1,172 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_mmap.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+
+void write_file(const char * filename , ecl_kw_type ** kw_list , int num_kw) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int i;
+  for (i=0; i < num_kw; i++)
+    ecl_kw_fwrite( kw_list[i] , fortio );
+  fortio_fclose( fortio );
+}
+
+
+void test_fortio_mmap( const char * filename , const ecl_kw_type * float_kw ) {
+  fortio_type * fortio = fortio_open_reader_mmap( filename , false , ECL_ENDIAN_FLIP );
+  test_assert_true( fortio_is_mmapped( fortio ));
+  {
+    int i;
+    for (i=0; i < 2; i++) {
+      ecl_kw_type * kw = ecl_kw_fread_alloc( fortio );
+      ecl_kw_free( kw );
+    }
+  }
+  {
+    ecl_kw_type * kw = ecl_kw_fread_alloc( fortio );
+    test_assert_true( ecl_kw_equal( kw , float_kw ));
+    ecl_kw_free( kw );
+  }
+  fortio_fclose( fortio );
+}
+
+
+/*
+  Numeric keywords stored in one single record should reference the
+  mapping instead of being copied; loading such a keyword twice gives
+  the same data pointer, and the data must only be byte swapped
+  once. The FLOATKW keyword spans several records and is copied.
+*/
+
+void test_shared( const char * filename , ecl_kw_type ** kw_list ) {
+  fortio_type * fortio = fortio_open_reader_mmap( filename , false , ECL_ENDIAN_FLIP );
+  ecl_kw_type * kw1[3];
+  ecl_kw_type * kw2[3];
+  int i;
+
+  for (i=0; i < 3; i++)
+    kw1[i] = ecl_kw_fread_alloc_shared( fortio );
+
+  fortio_fseek( fortio , 0 , SEEK_SET );
+  for (i=0; i < 3; i++)
+    kw2[i] = ecl_kw_fread_alloc_shared( fortio );
+
+  for (i=0; i < 3; i++) {
+    test_assert_true( ecl_kw_equal( kw1[i] , kw_list[i] ));
+    test_assert_true( ecl_kw_equal( kw2[i] , kw_list[i] ));
+  }
+
+  test_assert_ptr_equal( ecl_kw_get_void_ptr( kw1[0] ) , ecl_kw_get_void_ptr( kw2[0] ));
+  test_assert_ptr_equal( ecl_kw_get_void_ptr( kw1[1] ) , ecl_kw_get_void_ptr( kw2[1] ));
+  test_assert_ptr_not_equal( ecl_kw_get_void_ptr( kw1[2] ) , ecl_kw_get_void_ptr( kw2[2] ));
+
+  /* Unsharing gives a private copy with the same content. */
+  ecl_kw_unshare_data( kw2[0] );
+  test_assert_ptr_not_equal( ecl_kw_get_void_ptr( kw1[0] ) , ecl_kw_get_void_ptr( kw2[0] ));
+  test_assert_true( ecl_kw_equal( kw2[0] , kw_list[0] ));
+
+  for (i=0; i < 3; i++) {
+    ecl_kw_free( kw1[i] );
+    ecl_kw_free( kw2[i] );
+  }
+  fortio_fclose( fortio );
+}
+
+
+void test_open( const char * filename , ecl_kw_type ** kw_list , int num_kw) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_MMAP );
+  int i;
+
+  test_assert_int_equal( ecl_file_get_size( ecl_file ) , num_kw );
+  for (i=0; i < num_kw; i++)
+    test_assert_true( ecl_kw_equal( ecl_file_iget_kw( ecl_file , i ) , kw_list[i] ));
+
+  {
+    ecl_kw_type * int_kw = ecl_file_iget_kw( ecl_file , 0 );
+    const void * shared_ptr = ecl_kw_get_void_ptr( int_kw );
+
+    test_assert_ptr_equal( shared_ptr , ecl_kw_get_void_ptr( ecl_file_iget_kw( ecl_file , 0 )));
+    ecl_file_fortio_detach( ecl_file );
+    test_assert_ptr_equal( int_kw , ecl_file_iget_kw( ecl_file , 0 ));
+    test_assert_ptr_not_equal( shared_ptr , ecl_kw_get_void_ptr( int_kw ));
+  }
+
+  for (i=0; i < num_kw; i++)
+    test_assert_true( ecl_kw_equal( ecl_file_iget_kw( ecl_file , i ) , kw_list[i] ));
+
+  ecl_file_close( ecl_file );
+}
+
+
+void test_close_stream( const char * filename , ecl_kw_type ** kw_list , int num_kw) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_MMAP + ECL_FILE_CLOSE_STREAM );
+  int i;
+
+  for (i=num_kw - 1; i >= 0; i--)
+    test_assert_true( ecl_kw_equal( ecl_file_iget_kw( ecl_file , i ) , kw_list[i] ));
+
+  ecl_file_close( ecl_file );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_mmap");
+  const int num_kw = 5;
+  ecl_kw_type * kw_list[5];
+  int i;
+
+  kw_list[0] = ecl_kw_alloc( "INTKW"   , 100  , ECL_INT_TYPE );
+  kw_list[1] = ecl_kw_alloc( "DBLKW"   , 500  , ECL_DOUBLE_TYPE );
+  kw_list[2] = ecl_kw_alloc( "FLOATKW" , 2500 , ECL_FLOAT_TYPE );
+  kw_list[3] = ecl_kw_alloc( "CHARKW"  , 10   , ECL_CHAR_TYPE );
+  kw_list[4] = ecl_kw_alloc( "EMPTY"   , 0    , ECL_INT_TYPE );
+
+  for (i=0; i < 100; i++)
+    ecl_kw_iset_int( kw_list[0] , i , i );
+
+  for (i=0; i < 500; i++)
+    ecl_kw_iset_double( kw_list[1] , i , i * 0.25 );
+
+  for (i=0; i < 2500; i++)
+    ecl_kw_iset_float( kw_list[2] , i , i * 0.5 );
+
+  for (i=0; i < 10; i++)
+    ecl_kw_iset_string8( kw_list[3] , i , "STRING" );
+
+  write_file( "TEST.UNRST" , kw_list , num_kw );
+  test_fortio_mmap( "TEST.UNRST" , kw_list[2] );
+  test_shared( "TEST.UNRST" , kw_list );
+  test_open( "TEST.UNRST" , kw_list , num_kw );
+  test_close_stream( "TEST.UNRST" , kw_list , num_kw );
+
+  for (i=0; i < num_kw; i++)
+    ecl_kw_free( kw_list[i] );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
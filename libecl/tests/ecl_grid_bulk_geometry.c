@@ -0,0 +1,139 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_bulk_geometry.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+
+#define NX 80
+#define NY 60
+#define NZ 40
+
+
+ecl_grid_type * alloc_grid( ) {
+  const int size = NX*NY*NZ;
+  double * dx = util_calloc( size , sizeof * dx );
+  double * dy = util_calloc( size , sizeof * dy );
+  double * dz = util_calloc( size , sizeof * dz );
+  double * tops = util_calloc( size , sizeof * tops );
+  int * actnum = util_calloc( size , sizeof * actnum );
+
+  for (int k = 0; k < NZ; k++) {
+    for (int j = 0; j < NY; j++) {
+      for (int i = 0; i < NX; i++) {
+        int g = i + j*NX + k*NX*NY;
+        dx[g] = 50 + 10 * (i % 3);
+        dy[g] = 40 + 5 * (j % 4);
+        dz[g] = 2 + 0.5 * (k % 2) + 0.1 * i;
+        actnum[g] = (g % 5) ? 1 : 0;
+
+        if (k == 0)
+          tops[g] = 1000 + 10 * sin( 0.3 * i ) + 5 * (j % 5);
+        else
+          tops[g] = tops[g - NX*NY] + dz[g - NX*NY];
+      }
+    }
+  }
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_dx_dy_dz_tops( NX , NY , NZ , dx , dy , dz , tops , actnum );
+    free( dx );
+    free( dy );
+    free( dz );
+    free( tops );
+    free( actnum );
+    return grid;
+  }
+}
+
+
+void test_volume( const ecl_grid_type * grid ) {
+  double * volume = ecl_grid_alloc_volume_data( grid , false );
+  ecl_kw_type * volume_kw = ecl_grid_alloc_volume_kw( grid , true );
+
+  test_assert_int_equal( ecl_kw_get_size( volume_kw ) , ecl_grid_get_active_size( grid ));
+  for (int g = 0; g < ecl_grid_get_global_size( grid ); g++)
+    test_assert_double_equal( volume[g] , ecl_grid_get_cell_volume1( grid , g ));
+
+  for (int a = 0; a < ecl_grid_get_active_size( grid ); a++)
+    test_assert_double_equal( ecl_kw_iget_double( volume_kw , a ) , ecl_grid_get_cell_volume1A( grid , a ));
+
+  ecl_kw_free( volume_kw );
+  free( volume );
+}
+
+
+void test_center( const ecl_grid_type * grid ) {
+  double * x , * y , * z;
+
+  ecl_grid_alloc_center_arrays( grid , true , &x , &y , &z );
+  for (int a = 0; a < ecl_grid_get_active_size( grid ); a++) {
+    double xpos , ypos , zpos;
+    ecl_grid_get_xyz1A( grid , a , &xpos , &ypos , &zpos );
+    test_assert_double_equal( x[a] , xpos );
+    test_assert_double_equal( y[a] , ypos );
+    test_assert_double_equal( z[a] , zpos );
+    test_assert_double_equal( z[a] , ecl_grid_get_cdepth1A( grid , a ));
+  }
+  free( x );
+  free( y );
+  free( z );
+}
+
+
+/*
+  The bulk function on a fresh grid should give the same volumes as
+  the per cell function.
+*/
+
+void test_fresh_volume( ) {
+  ecl_grid_type * grid1 = alloc_grid( );
+  ecl_grid_type * grid2 = alloc_grid( );
+  const int size = ecl_grid_get_global_size( grid1 );
+  double * volume1 = util_calloc( size , sizeof * volume1 );
+  double * volume2;
+
+  for (int g = 0; g < size; g++)
+    volume1[g] = ecl_grid_get_cell_volume1( grid1 , g );
+
+  volume2 = ecl_grid_alloc_volume_data( grid2 , false );
+  for (int g = 0; g < size; g++)
+    test_assert_double_equal( volume1[g] , volume2[g] );
+
+  free( volume1 );
+  free( volume2 );
+  ecl_grid_free( grid1 );
+  ecl_grid_free( grid2 );
+}
+
+
+int main( int argc , char ** argv) {
+  ecl_grid_type * grid = alloc_grid( );
+  test_volume( grid );
+  test_center( grid );
+  ecl_grid_free( grid );
+
+  test_fresh_volume( );
+  exit(0);
+}
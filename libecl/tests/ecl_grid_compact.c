@@ -0,0 +1,149 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_compact.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+#define NX 60
+#define NY 50
+#define NZ 30
+
+
+/*
+  Corner point grid with slanted pillars, varying layer thickness and
+  a fault like jump in ZCORN halfway through the grid in the x
+  direction.
+*/
+
+ecl_grid_type * alloc_grid( ) {
+  const int size = NX*NY*NZ;
+  float * coord = util_calloc( 6 * (NX + 1) * (NY + 1) , sizeof * coord );
+  float * zcorn = util_calloc( 8 * size , sizeof * zcorn );
+  int * actnum = util_calloc( size , sizeof * actnum );
+
+  for (int j = 0; j <= NY; j++) {
+    for (int i = 0; i <= NX; i++) {
+      int index = 6 * (i + j * (NX + 1));
+      coord[index]     = 100 * i;
+      coord[index + 1] = 80 * j;
+      coord[index + 2] = 1000;
+      coord[index + 3] = 100 * i + 0.05 * j * 80;
+      coord[index + 4] = 80 * j + 0.02 * i * 100;
+      coord[index + 5] = 2000;
+    }
+  }
+
+  for (int k = 0; k < NZ; k++) {
+    for (int j = 0; j < NY; j++) {
+      for (int i = 0; i < NX; i++) {
+        for (int c = 0; c < 8; c++) {
+          int di = c % 2;
+          int dj = (c / 2) % 2;
+          int dk = c / 4;
+          double z = 1000 + 10 * sin( 0.1 * (i + di) ) + 2 * (j + dj) + (k + dk) * (3 + 0.01 * (i + di));
+          if (i >= NX/2)
+            z += 7;
+          zcorn[ ecl_grid_zcorn_index__( NX , NY , i , j , k , c ) ] = z;
+        }
+        actnum[ i + j*NX + k*NX*NY ] = ((i + j + k) % 7) ? 1 : 0;
+      }
+    }
+  }
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_GRDECL_data( NX , NY , NZ , zcorn , coord , actnum , false , NULL );
+    free( coord );
+    free( zcorn );
+    free( actnum );
+    return grid;
+  }
+}
+
+
+void test_equal( ecl_grid_type * grid , ecl_grid_type * compact ) {
+  test_assert_false( ecl_grid_is_compact( grid ));
+  test_assert_true( ecl_grid_is_compact( compact ));
+  test_assert_true( ecl_grid_compare( grid , compact , true , false , true ));
+  test_assert_int_equal( ecl_grid_get_active_size( grid ) , ecl_grid_get_active_size( compact ));
+
+  for (int g = 0; g < ecl_grid_get_global_size( grid ); g++) {
+    double x1,y1,z1,x2,y2,z2;
+
+    ecl_grid_get_xyz1( grid , g , &x1 , &y1 , &z1 );
+    ecl_grid_get_xyz1( compact , g , &x2 , &y2 , &z2 );
+    test_assert_double_equal( x1 , x2 );
+    test_assert_double_equal( y1 , y2 );
+    test_assert_double_equal( z1 , z2 );
+    test_assert_double_equal( ecl_grid_get_cell_volume1( grid , g ) , ecl_grid_get_cell_volume1( compact , g ));
+    test_assert_double_equal( ecl_grid_get_cell_dx1( grid , g ) , ecl_grid_get_cell_dx1( compact , g ));
+    test_assert_double_equal( ecl_grid_get_cell_dz1( grid , g ) , ecl_grid_get_cell_dz1( compact , g ));
+
+    for (int c = 0; c < 8; c++) {
+      ecl_grid_get_cell_corner_xyz1( grid , g , c , &x1 , &y1 , &z1 );
+      ecl_grid_get_cell_corner_xyz1( compact , g , c , &x2 , &y2 , &z2 );
+      test_assert_double_equal( x1 , x2 );
+      test_assert_double_equal( y1 , y2 );
+      test_assert_double_equal( z1 , z2 );
+    }
+
+    if ((g % 97) == 0) {
+      ecl_grid_get_xyz1( grid , g , &x1 , &y1 , &z1 );
+      test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , x1 , y1 , z1 , 0 ) ,
+                             ecl_grid_get_global_index_from_xyz( compact , x1 , y1 , z1 , 0 ));
+    }
+  }
+}
+
+
+void test_copy( const ecl_grid_type * compact ) {
+  ecl_grid_type * copy = ecl_grid_alloc_copy( compact );
+  test_assert_true( ecl_grid_is_compact( copy ));
+  test_assert_true( ecl_grid_compare( compact , copy , true , false , true ));
+  ecl_grid_free( copy );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_grid_compact");
+  {
+    ecl_grid_type * src = alloc_grid( );
+    ecl_grid_fwrite_EGRID2( src , "CASE.EGRID" , ECL_METRIC_UNITS );
+    ecl_grid_free( src );
+  }
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc( "CASE.EGRID" );
+    ecl_grid_type * compact = ecl_grid_alloc_compact( "CASE.EGRID" );
+
+    test_equal( grid , compact );
+    test_copy( compact );
+
+    ecl_grid_free( compact );
+    ecl_grid_free( grid );
+  }
+
+  test_work_area_free( work_area );
+  exit(0);
+}
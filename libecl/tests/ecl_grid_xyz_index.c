@@ -0,0 +1,229 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_xyz_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
+
+#include <ert/ecl/ecl_grid.h>
+
+#define NX 20
+#define NY 15
+#define NZ 10
+#define NUM_POINTS 300
+
+
+/*
+  Grid with varying cell sizes, and a fault like offset in the top
+  depth of the columns.
+*/
+
+ecl_grid_type * alloc_grid( ) {
+  const int size = NX*NY*NZ;
+  double * dx = util_calloc( size , sizeof * dx );
+  double * dy = util_calloc( size , sizeof * dy );
+  double * dz = util_calloc( size , sizeof * dz );
+  double * tops = util_calloc( size , sizeof * tops );
+
+  for (int k = 0; k < NZ; k++) {
+    for (int j = 0; j < NY; j++) {
+      for (int i = 0; i < NX; i++) {
+        int g = i + j*NX + k*NX*NY;
+        dx[g] = 50 + 10 * (i % 3);
+        dy[g] = 40 + 5 * (j % 4);
+        dz[g] = 2 + 0.5 * (k % 2) + 0.1 * i;
+
+        if (k == 0)
+          tops[g] = 1000 + 10 * sin( 0.3 * i ) + 5 * (j % 5);
+        else
+          tops[g] = tops[g - NX*NY] + dz[g - NX*NY];
+      }
+    }
+  }
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_dx_dy_dz_tops( NX , NY , NZ , dx , dy , dz , tops , NULL );
+    free( dx );
+    free( dy );
+    free( dz );
+    free( tops );
+    return grid;
+  }
+}
+
+
+int brute_force_find( const ecl_grid_type * grid , double x , double y , double z) {
+  for (int g = 0; g < ecl_grid_get_global_size( grid ); g++) {
+    if (ecl_grid_cell_contains_xyz1( grid , g , x , y , z ))
+      return g;
+  }
+  return -1;
+}
+
+
+void random_points( const ecl_grid_type * grid , rng_type * rng , double * x , double * y , double * z) {
+  double xmin , ymin , zmin , xmax , ymax , zmax;
+  ecl_grid_get_cell_corner_xyz3( grid , 0 , 0 , 0 , 0 , &xmin , &ymin , &zmin );
+  ecl_grid_get_cell_corner_xyz3( grid , NX - 1 , NY - 1 , NZ - 1 , 7 , &xmax , &ymax , &zmax );
+  xmin -= 10; ymin -= 10; zmin = 980;
+  xmax += 10; ymax += 10; zmax += 30;
+
+  for (int ip = 0; ip < NUM_POINTS; ip++) {
+    x[ip] = xmin + (xmax - xmin) * rng_get_double( rng );
+    y[ip] = ymin + (ymax - ymin) * rng_get_double( rng );
+    z[ip] = zmin + (zmax - zmin) * rng_get_double( rng );
+  }
+}
+
+
+void test_xyz( ecl_grid_type * grid , const double * x , const double * y , const double * z) {
+  int * batch_index = util_calloc( NUM_POINTS , sizeof * batch_index );
+  int * expected = util_calloc( NUM_POINTS , sizeof * expected );
+  int found = 0;
+
+  for (int ip = 0; ip < NUM_POINTS; ip++)
+    expected[ip] = brute_force_find( grid , x[ip] , y[ip] , z[ip] );
+
+  ecl_grid_get_global_index_from_xyz_batch( grid , NUM_POINTS , x , y , z , batch_index );
+
+  for (int ip = 0; ip < NUM_POINTS; ip++) {
+    test_assert_int_equal( expected[ip] , batch_index[ip] );
+    test_assert_int_equal( expected[ip] , ecl_grid_get_global_index_from_xyz( grid , x[ip] , y[ip] , z[ip] , 0 ));
+    if (expected[ip] >= 0) {
+      int i,j,k;
+      test_assert_true( ecl_grid_get_ijk_from_xyz( grid , x[ip] , y[ip] , z[ip] , expected[ip] , &i , &j , &k ));
+      test_assert_int_equal( expected[ip] , ecl_grid_get_global_index3( grid , i , j , k ));
+      found++;
+    }
+  }
+  test_assert_true( found > NUM_POINTS / 4 );
+
+  free( expected );
+  free( batch_index );
+}
+
+
+void test_xy( const ecl_grid_type * grid ) {
+  for (int k = 0; k < NZ; k += 7) {
+    for (int j = 0; j < NY; j++) {
+      for (int i = 0; i < NX; i++) {
+        int g = ecl_grid_get_global_index3( grid , i , j , k );
+        double x,y,z;
+        int i2,j2;
+
+        ecl_grid_get_xyz3( grid , i , j , k , &x , &y , &z );
+        test_assert_true( ecl_grid_get_ij_from_xy( grid , x , y , k , &i2 , &j2 ));
+        test_assert_int_equal( i , i2 );
+        test_assert_int_equal( j , j2 );
+
+        test_assert_int_equal( g , ecl_grid_get_global_index_from_xy( grid , k , true , x , y ));
+        test_assert_int_equal( g , ecl_grid_get_global_index_from_xy( grid , k , false , x , y ));
+      }
+    }
+  }
+
+  {
+    int i,j;
+    test_assert_false( ecl_grid_get_ij_from_xy( grid , -1 , -1 , 0 , &i , &j ));
+    test_assert_int_equal( -1 , ecl_grid_get_global_index_from_xy_top( grid , -1 , -1 ));
+  }
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+typedef struct {
+  ecl_grid_type * grid;
+  const double  * x;
+  const double  * y;
+  const double  * z;
+  int           * global_index;
+  int             offset;
+} lookup_arg_type;
+
+
+void * lookup_points( void * arg ) {
+  lookup_arg_type * lookup = arg;
+  for (int ip = lookup->offset; ip < NUM_POINTS; ip += 4)
+    lookup->global_index[ip] = ecl_grid_get_global_index_from_xyz( lookup->grid , lookup->x[ip] , lookup->y[ip] , lookup->z[ip] , -1 );
+  return NULL;
+}
+
+
+/*
+  Several threads doing the first lookup on a fresh grid, i.e. they
+  will race to build the index.
+*/
+
+void test_threads( const double * x , const double * y , const double * z) {
+  ecl_grid_type * grid = alloc_grid( );
+  int * global_index = util_calloc( NUM_POINTS , sizeof * global_index );
+  lookup_arg_type args[4];
+  thread_pool_type * tp = thread_pool_alloc( 4 , true );
+
+  for (int t = 0; t < 4; t++) {
+    args[t].grid = grid;
+    args[t].x = x;
+    args[t].y = y;
+    args[t].z = z;
+    args[t].global_index = global_index;
+    args[t].offset = t;
+    thread_pool_add_job( tp , lookup_points , &args[t] );
+  }
+  thread_pool_join( tp );
+  thread_pool_free( tp );
+
+  for (int ip = 0; ip < NUM_POINTS; ip++)
+    test_assert_int_equal( brute_force_find( grid , x[ip] , y[ip] , z[ip] ) , global_index[ip] );
+
+  free( global_index );
+  ecl_grid_free( grid );
+}
+
+#endif
+
+
+int main( int argc , char ** argv) {
+  ecl_grid_type * grid = alloc_grid( );
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  double * x = util_calloc( NUM_POINTS , sizeof * x );
+  double * y = util_calloc( NUM_POINTS , sizeof * y );
+  double * z = util_calloc( NUM_POINTS , sizeof * z );
+
+  random_points( grid , rng , x , y , z );
+  test_xy( grid );
+  test_xyz( grid , x , y , z );
+#ifdef ERT_HAVE_THREAD_POOL
+  test_threads( x , y , z );
+#endif
+
+  free( x );
+  free( y );
+  free( z );
+  rng_free( rng );
+  ecl_grid_free( grid );
+  exit(0);
+}
@@ -0,0 +1,129 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_kw_fread_bulk.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+/*
+  Correctness test for ecl_kw_fread_data_bulk(); the timing comparison
+  with ecl_kw_fread_data() is in the kw_fread_bulk_bench application.
+*/
+
+
+void write_kw( const char * filename , const ecl_kw_type * ecl_kw ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  ecl_kw_fwrite( ecl_kw , fortio );
+  fortio_fclose( fortio );
+}
+
+
+fortio_type * open_reader( const char * filename , bool use_mmap ) {
+  if (use_mmap)
+    return fortio_open_reader_mmap( filename , false , ECL_ENDIAN_FLIP );
+  else
+    return fortio_open_reader( filename , false , ECL_ENDIAN_FLIP );
+}
+
+
+void read_kw( const char * filename , const ecl_kw_type * src_kw , bool use_mmap , bool bulk) {
+  fortio_type * fortio = open_reader( filename , use_mmap );
+  ecl_kw_type * ecl_kw = ecl_kw_alloc_empty( );
+
+  test_assert_int_equal( ecl_kw_fread_header( ecl_kw , fortio ) , ECL_KW_READ_OK );
+  ecl_kw_alloc_data( ecl_kw );
+  if (bulk)
+    test_assert_true( ecl_kw_fread_data_bulk( ecl_kw , fortio ));
+  else
+    test_assert_true( ecl_kw_fread_data( ecl_kw , fortio ));
+
+  test_assert_true( ecl_kw_equal( ecl_kw , src_kw ));
+  ecl_kw_free( ecl_kw );
+  fortio_fclose( fortio );
+}
+
+
+void test_kw( const ecl_kw_type * src_kw ) {
+  const char * filename = "BULK.UNRST";
+  write_kw( filename , src_kw );
+
+  read_kw( filename , src_kw , false , false );
+  read_kw( filename , src_kw , false , true );
+  read_kw( filename , src_kw , true  , false );
+  read_kw( filename , src_kw , true  , true );
+}
+
+
+/*
+  The bulk reader must fall back gracefully for keywords it does not
+  handle itself.
+*/
+
+void test_fallback( ) {
+  ecl_kw_type * char_kw = ecl_kw_alloc( "CHARKW" , 250 , ECL_CHAR_TYPE );
+  ecl_kw_type * empty_kw = ecl_kw_alloc( "EMPTY" , 0 , ECL_FLOAT_TYPE );
+  int i;
+
+  for (i=0; i < 250; i++)
+    ecl_kw_iset_string8( char_kw , i , "CHAR" );
+
+  write_kw( "CHAR.UNRST" , char_kw );
+  read_kw( "CHAR.UNRST" , char_kw , false , true );
+
+  write_kw( "EMPTY.UNRST" , empty_kw );
+  read_kw( "EMPTY.UNRST" , empty_kw , false , true );
+
+  ecl_kw_free( char_kw );
+  ecl_kw_free( empty_kw );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_kw_fread_bulk");
+  const int size = 600001;     /* Several bulk read chunks and a partial last block. */
+  ecl_kw_type * float_kw = ecl_kw_alloc( "PRESSURE" , size , ECL_FLOAT_TYPE );
+  ecl_kw_type * double_kw = ecl_kw_alloc( "DBLKW" , size , ECL_DOUBLE_TYPE );
+  ecl_kw_type * int_kw = ecl_kw_alloc( "INTKW" , 1234 , ECL_INT_TYPE );
+  int i;
+
+  for (i=0; i < size; i++) {
+    ecl_kw_iset_float( float_kw , i , i * 0.25 );
+    ecl_kw_iset_double( double_kw , i , i * 0.125 );
+  }
+
+  for (i=0; i < 1234; i++)
+    ecl_kw_iset_int( int_kw , i , i );
+
+  test_kw( int_kw );
+  test_kw( float_kw );
+  test_kw( double_kw );
+  test_fallback( );
+
+  ecl_kw_free( int_kw );
+  ecl_kw_free( float_kw );
+  ecl_kw_free( double_kw );
+  test_work_area_free( work_area );
+  exit(0);
+}
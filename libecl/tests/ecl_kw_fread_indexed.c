@@ -0,0 +1,178 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_kw_fread_indexed.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+/*
+  Correctness test and benchmark for ecl_kw_fread_indexed_data(). The
+  reference implementation is the old one-seek-and-read-per-element
+  loop; the timings are printed, not asserted on.
+*/
+
+#define NX 200
+#define NY 100
+#define NZ 100
+#define NUM_STEPS 10
+
+
+void fread_indexed_reference( fortio_type * fortio , offset_type data_offset , int element_count , const int_vector_type * index_map , char * buffer) {
+  int element_size = sizeof(float);
+  int index;
+
+  for (index = 0; index < int_vector_size( index_map ); index++) {
+    int element_index = int_vector_iget( index_map , index );
+    fortio_data_fseek( fortio , data_offset , element_index , element_size , element_count , 1000 );
+    util_fread( &buffer[index * element_size] , element_size , 1 , fortio_get_FILE( fortio ) , __func__);
+  }
+
+  if (ECL_ENDIAN_FLIP)
+    util_endian_flip_vector( buffer , element_size , int_vector_size( index_map ));
+}
+
+
+/*
+  A set of well cells: vertical wells perforated through all layers,
+  and horizontal wells along the i direction; appended in well order,
+  i.e. not sorted.
+*/
+
+int_vector_type * alloc_well_cells( ) {
+  int_vector_type * index_map = int_vector_alloc( 0 , 0 );
+  int w , i , k;
+
+  for (w = 0; w < 25; w++) {
+    int wi = (37 * w) % NX;
+    int wj = (53 * w) % NY;
+    for (k = 0; k < NZ; k++)
+      int_vector_append( index_map , wi + wj * NX + k * NX * NY );
+  }
+
+  for (w = 0; w < 10; w++) {
+    int wj = (17 * w + 5) % NY;
+    int wk = (31 * w + 3) % NZ;
+    for (i = 20; i < 120; i++)
+      int_vector_append( index_map , i + wj * NX + wk * NX * NY );
+  }
+
+  return index_map;
+}
+
+
+void test_indexed_read( const char * filename , const int_vector_type * index_map ) {
+  const int size = NX * NY * NZ;
+  const int num_index = int_vector_size( index_map );
+  float * ref_buffer = util_calloc( num_index , sizeof * ref_buffer );
+  float * buffer = util_calloc( num_index , sizeof * buffer );
+  fortio_type * fortio = fortio_open_reader( filename , false , ECL_ENDIAN_FLIP );
+  int step , i;
+
+  for (step = 0; step < NUM_STEPS; step++) {
+    offset_type kw_offset = step * util_file_size( filename ) / NUM_STEPS;
+    offset_type data_offset = kw_offset + ECL_KW_HEADER_FORTIO_SIZE;
+
+    fread_indexed_reference( fortio , data_offset , size , index_map , (char *) ref_buffer );
+    ecl_kw_fread_indexed_data( fortio , data_offset , ECL_FLOAT_TYPE , size , index_map , (char *) buffer );
+
+    for (i=0; i < num_index; i++) {
+      test_assert_float_equal( buffer[i] , ref_buffer[i] );
+      test_assert_float_equal( buffer[i] , step + int_vector_iget( index_map , i ) * 0.001 );
+    }
+  }
+
+  fortio_fclose( fortio );
+  free( ref_buffer );
+  free( buffer );
+}
+
+
+void test_edge_cases( const char * filename ) {
+  const int size = NX * NY * NZ;
+  offset_type data_offset = ECL_KW_HEADER_FORTIO_SIZE;
+  fortio_type * fortio = fortio_open_reader( filename , false , ECL_ENDIAN_FLIP );
+  int_vector_type * index_map = int_vector_alloc( 0 , 0 );
+  float buffer[8];
+
+  /* Empty index_map. */
+  ecl_kw_fread_indexed_data( fortio , data_offset , ECL_FLOAT_TYPE , size , index_map , (char *) buffer );
+
+  /* Duplicates, block boundaries and the last element. */
+  int_vector_append( index_map , 1000 );
+  int_vector_append( index_map , 999 );
+  int_vector_append( index_map , size - 1 );
+  int_vector_append( index_map , 0 );
+  int_vector_append( index_map , 999 );
+  ecl_kw_fread_indexed_data( fortio , data_offset , ECL_FLOAT_TYPE , size , index_map , (char *) buffer );
+  test_assert_float_equal( buffer[0] , 1.0 );
+  test_assert_float_equal( buffer[1] , 0.999 );
+  test_assert_float_equal( buffer[2] , (size - 1) * 0.001 );
+  test_assert_float_equal( buffer[3] , 0 );
+  test_assert_float_equal( buffer[4] , 0.999 );
+
+  int_vector_free( index_map );
+  fortio_fclose( fortio );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_kw_fread_indexed");
+  const char * filename = "CASE.UNRST";
+  const int size = NX * NY * NZ;
+  {
+    fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+    ecl_kw_type * pressure = ecl_kw_alloc( "PRESSURE" , size , ECL_FLOAT_TYPE );
+    int step , i;
+
+    for (step = 0; step < NUM_STEPS; step++) {
+      for (i=0; i < size; i++)
+        ecl_kw_iset_float( pressure , i , step + i * 0.001 );
+      ecl_kw_fwrite( pressure , fortio );
+    }
+    ecl_kw_free( pressure );
+    fortio_fclose( fortio );
+  }
+
+  test_edge_cases( filename );
+  {
+    int_vector_type * well_cells = alloc_well_cells( );
+    int_vector_type * random_cells = int_vector_alloc( 0 , 0 );
+    int i;
+
+    srand( 17 );
+    for (i=0; i < 5000; i++)
+      int_vector_append( random_cells , rand() % size );
+
+    test_indexed_read( filename , well_cells );
+    test_indexed_read( filename , random_cells );
+
+    int_vector_free( well_cells );
+    int_vector_free( random_cells );
+  }
+
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,238 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_kw_fscanf_token.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_grdecl.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/fortio.h>
+
+/*
+  Correctness test for the token based parser used when reading
+  formatted ECLIPSE files and GRDECL files. The reference
+  implementations below are the one-fscanf()-per-element loops which
+  were used before the token based parser. The throughput is measured
+  by the kw_fscanf_bench application.
+*/
+
+
+/*****************************************************************/
+/* Formatted ECLIPSE files */
+
+ecl_kw_type * fscanf_alloc_fmt_kw( const char * filename ) {
+  fortio_type * fortio = fortio_open_reader( filename , true , false );
+  FILE * stream = fortio_get_FILE( fortio );
+  ecl_kw_type * ecl_kw = ecl_kw_alloc_empty( );
+  int i;
+
+  test_assert_int_equal( ecl_kw_fread_header( ecl_kw , fortio ) , ECL_KW_READ_OK );
+  ecl_kw_alloc_data( ecl_kw );
+  for (i=0; i < ecl_kw_get_size( ecl_kw ); i++) {
+    switch (ecl_kw_get_type( ecl_kw )) {
+    case(ECL_INT_TYPE):
+      {
+        int value;
+        test_assert_int_equal( fscanf( stream , "%d" , &value ) , 1 );
+        ecl_kw_iset_int( ecl_kw , i , value );
+      }
+      break;
+    case(ECL_FLOAT_TYPE):
+      {
+        float value;
+        test_assert_int_equal( fscanf( stream , "%gE" , &value ) , 1 );
+        ecl_kw_iset_float( ecl_kw , i , value );
+      }
+      break;
+    case(ECL_DOUBLE_TYPE):
+      {
+        double arg;
+        int power;
+        test_assert_int_equal( fscanf( stream , "%lgD%d" , &arg , &power ) , 2 );
+        ecl_kw_iset_double( ecl_kw , i , arg * pow( 10 , power ));
+      }
+      break;
+    default:
+      util_abort("%s: type not handled \n",__func__);
+    }
+  }
+  fortio_fclose( fortio );
+  return ecl_kw;
+}
+
+
+ecl_kw_type * fread_alloc_fmt_kw( const char * filename ) {
+  fortio_type * fortio = fortio_open_reader( filename , true , false );
+  ecl_kw_type * ecl_kw = ecl_kw_fread_alloc( fortio );
+  fortio_fclose( fortio );
+  return ecl_kw;
+}
+
+
+void test_fmt( const ecl_kw_type * src_kw ) {
+  const char * filename = "TEST.FUNRST";
+  ecl_kw_type * fscanf_kw;
+  ecl_kw_type * token_kw;
+  {
+    fortio_type * fortio = fortio_open_writer( filename , true , false );
+    ecl_kw_fwrite( src_kw , fortio );
+    fortio_fclose( fortio );
+  }
+
+  fscanf_kw = fscanf_alloc_fmt_kw( filename );
+  token_kw = fread_alloc_fmt_kw( filename );
+
+  test_assert_true( ecl_kw_numeric_equal( fscanf_kw , token_kw , 0 , 1e-14 ));
+  test_assert_true( ecl_kw_numeric_equal( src_kw , token_kw , 0 , 1e-7 ));
+
+  ecl_kw_free( fscanf_kw );
+  ecl_kw_free( token_kw );
+}
+
+
+/*****************************************************************/
+/* GRDECL files */
+
+ecl_kw_type * fscanf_alloc_grdecl_kw( const char * filename , const char * kw , int size ) {
+  FILE * stream = util_fopen( filename , "r");
+  ecl_kw_type * ecl_kw = ecl_kw_alloc( kw , size , ECL_FLOAT_TYPE );
+  char buffer[65];
+  int index = 0;
+
+  test_assert_true( ecl_kw_grdecl_fseek_kw( kw , true , stream ));
+  test_assert_int_equal( fscanf( stream , "%s" , buffer ) , 1);
+  while (fscanf( stream , "%32s" , buffer ) == 1) {
+    int multiplier;
+    float value;
+
+    if (strcmp( buffer , ECL_DATA_TERMINATION ) == 0)
+      break;
+
+    if (strcmp( buffer , ECL_COMMENT_STRING ) == 0) {
+      util_fskip_lines( stream , 1 );
+      continue;
+    }
+
+    if (sscanf( buffer , "%d*%g" , &multiplier , &value) != 2) {
+      test_assert_int_equal( sscanf( buffer , "%g" , &value ) , 1 );
+      multiplier = 1;
+    }
+
+    while (multiplier > 0) {
+      ecl_kw_iset_float( ecl_kw , index , value );
+      index++;
+      multiplier--;
+    }
+  }
+  test_assert_int_equal( index , size );
+  fclose( stream );
+  return ecl_kw;
+}
+
+
+void test_grdecl( const char * filename , const char * kw , int size ) {
+  ecl_kw_type * fscanf_kw = fscanf_alloc_grdecl_kw( filename , kw , size );
+  ecl_kw_type * token_kw;
+  {
+    FILE * stream = util_fopen( filename , "r");
+    token_kw = ecl_kw_fscanf_alloc_grdecl( stream , kw , size , ECL_FLOAT_TYPE );
+    fclose( stream );
+  }
+
+  test_assert_true( ecl_kw_numeric_equal( fscanf_kw , token_kw , 0 , 1e-6 ));
+  ecl_kw_free( fscanf_kw );
+  ecl_kw_free( token_kw );
+}
+
+
+void test_grdecl_plain( const ecl_kw_type * src_kw ) {
+  FILE * stream = util_fopen( "PORO.grdecl" , "w");
+  ecl_kw_fprintf_grdecl( src_kw , stream );
+  fclose( stream );
+
+  test_grdecl( "PORO.grdecl" , ecl_kw_get_header( src_kw ) , ecl_kw_get_size( src_kw ));
+}
+
+
+/*
+  PERMX with blocks of repeated values, interleaved with comments.
+*/
+
+void test_grdecl_repeat( int size ) {
+  FILE * stream = util_fopen( "PERMX.grdecl" , "w");
+  int index = 0;
+  int line = 0;
+
+  fprintf(stream , "-- Generated file\nPERMX\n");
+  while (index < size) {
+    int repeat = util_int_min( 1 + (line % 50) , size - index );
+    if ((line % 1000) == 0)
+      fprintf(stream , "-- Line: %d\n" , line);
+
+    if (repeat > 1)
+      fprintf(stream , " %d*%g" , repeat , 100 + 0.5 * line);
+    else
+      fprintf(stream , " %g" , 100 + 0.5 * line);
+
+    if ((line % 5) == 4)
+      fprintf(stream , "\n");
+
+    index += repeat;
+    line++;
+  }
+  fprintf(stream , "\n/\n");
+  fclose( stream );
+
+  test_grdecl( "PERMX.grdecl" , "PERMX" , size );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_kw_fscanf_token");
+  const int size = 10000;
+  ecl_kw_type * int_kw = ecl_kw_alloc( "INTKW" , size , ECL_INT_TYPE );
+  ecl_kw_type * float_kw = ecl_kw_alloc( "PORO" , size , ECL_FLOAT_TYPE );
+  ecl_kw_type * double_kw = ecl_kw_alloc( "DBLKW" , size , ECL_DOUBLE_TYPE );
+  int i;
+
+  srand( 10 );
+  for (i=0; i < size; i++) {
+    ecl_kw_iset_int( int_kw , i , rand() - RAND_MAX / 2 );
+    ecl_kw_iset_float( float_kw , i , 0.35 * rand() / RAND_MAX );
+    ecl_kw_iset_double( double_kw , i , (rand() - RAND_MAX / 2) * 1e-3 );
+  }
+
+  test_fmt( int_kw );
+  test_fmt( float_kw );
+  test_fmt( double_kw );
+  test_grdecl_plain( float_kw );
+  test_grdecl_repeat( 5 * size );
+
+  ecl_kw_free( int_kw );
+  ecl_kw_free( float_kw );
+  ecl_kw_free( double_kw );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,196 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_sum_column.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <ert/util/test_util.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_sum.h>
+
+#define NUM_WELLS     500
+#define NUM_DATES     50
+#define NUM_MINISTEP  20
+
+
+static float well_value( int well , int step ) {
+  return well * 1000 + step;
+}
+
+
+void write_summary( const char * name , time_t start_time ) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  smspec_node_type * nodes[NUM_WELLS];
+  double sim_seconds = 0;
+  int step = 0;
+
+  for (int well = 0; well < NUM_WELLS; well++) {
+    char * well_name = util_alloc_sprintf( "W%d" , well );
+    nodes[well] = ecl_sum_add_var( ecl_sum , "WOPR" , well_name , 0 , "SM3/DAY" , 0 );
+    free( well_name );
+  }
+
+  for (int report_step = 0; report_step < NUM_DATES; report_step++) {
+    for (int ministep = 0; ministep < NUM_MINISTEP; ministep++) {
+      ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , report_step + 1 , sim_seconds );
+      for (int well = 0; well < NUM_WELLS; well++)
+        ecl_sum_tstep_set_from_node( tstep , nodes[well] , well_value( well , step ));
+
+      /* In write mode the column must see the values just set in the tstep. */
+      {
+        int params_index = smspec_node_get_params_index( nodes[7] );
+        const float * column = ecl_sum_get_column( ecl_sum , params_index );
+        test_assert_float_equal( column[step] , well_value( 7 , step ));
+      }
+      sim_seconds += 3600;
+      step++;
+    }
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+void test_column( const ecl_sum_type * ecl_sum ) {
+  const int length = ecl_sum_get_data_length( ecl_sum );
+  test_assert_int_equal( length , NUM_DATES * NUM_MINISTEP );
+
+  for (int well = 0; well < NUM_WELLS; well++) {
+    char * key = util_alloc_sprintf( "WOPR:W%d" , well );
+    int params_index = ecl_sum_get_general_var_params_index( ecl_sum , key );
+    const float * column = ecl_sum_get_column( ecl_sum , params_index );
+
+    for (int step = 0; step < length; step++) {
+      test_assert_float_equal( column[step] , well_value( well , step ));
+      test_assert_double_equal( column[step] , ecl_sum_iget( ecl_sum , step , params_index ));
+    }
+
+    /* The second lookup is served from the column cache. */
+    test_assert_ptr_equal( column , ecl_sum_get_column( ecl_sum , params_index ));
+    free( key );
+  }
+}
+
+
+void test_limiting( const ecl_sum_type * ecl_sum ) {
+  int params_index = ecl_sum_get_general_var_params_index( ecl_sum , "WOPR:W5" );
+
+  test_assert_int_equal( ecl_sum_get_first_gt( ecl_sum , params_index , well_value( 5 , 17 )) , 18 );
+  test_assert_int_equal( ecl_sum_get_first_gt( ecl_sum , params_index , well_value( 6 , 0 )) , -1 );
+  test_assert_int_equal( ecl_sum_get_first_lt( ecl_sum , params_index , well_value( 5 , 0 )) , -1 );
+  test_assert_int_equal( ecl_sum_get_first_lt( ecl_sum , params_index , well_value( 5 , 1 )) , 0 );
+}
+
+
+/*
+  Several threads building the same columns concurrently from one
+  ecl_sum instance.
+*/
+
+#ifdef ERT_HAVE_PTHREAD
+#define NUM_THREADS 4
+
+static void * column_thread( void * arg ) {
+  const ecl_sum_type * ecl_sum = arg;
+  const int length = ecl_sum_get_data_length( ecl_sum );
+
+  for (int well = 0; well < NUM_WELLS; well++) {
+    const float * column = ecl_sum_get_column( ecl_sum , well + 1 );
+    for (int step = 0; step < length; step++)
+      test_assert_float_equal( column[step] , well_value( well , step ));
+  }
+  return NULL;
+}
+
+
+void test_column_threads( const ecl_sum_type * ecl_sum ) {
+  pthread_t threads[NUM_THREADS];
+
+  for (int i = 0; i < NUM_THREADS; i++)
+    pthread_create( &threads[i] , NULL , column_thread , (void *) ecl_sum );
+
+  for (int i = 0; i < NUM_THREADS; i++)
+    pthread_join( threads[i] , NULL );
+}
+#endif
+
+
+void test_data_vector( const ecl_sum_type * ecl_sum ) {
+  const int length = ecl_sum_get_data_length( ecl_sum );
+  int params_index = ecl_sum_get_general_var_params_index( ecl_sum , "WOPR:W13" );
+  double_vector_type * all_steps = ecl_sum_alloc_data_vector( ecl_sum , params_index , false );
+  double_vector_type * report_steps = ecl_sum_alloc_data_vector( ecl_sum , params_index , true );
+
+  test_assert_int_equal( double_vector_size( all_steps ) , length + 1 );
+  for (int step = 0; step < length; step++)
+    test_assert_double_equal( double_vector_iget( all_steps , step + 1 ) , well_value( 13 , step ));
+
+  test_assert_int_equal( double_vector_size( report_steps ) , NUM_DATES + 1 );
+  for (int report_step = 0; report_step < NUM_DATES; report_step++)
+    test_assert_double_equal( double_vector_iget( report_steps , report_step + 1 ) ,
+                              well_value( 13 , (report_step + 1) * NUM_MINISTEP - 1 ));
+
+  double_vector_free( all_steps );
+  double_vector_free( report_steps );
+}
+
+
+void test_scale( ecl_sum_type * ecl_sum ) {
+  const int length = ecl_sum_get_data_length( ecl_sum );
+  int params_index = ecl_sum_get_general_var_params_index( ecl_sum , "WOPR:W3" );
+  const float * column;
+
+  ecl_sum_get_column( ecl_sum , params_index );
+  ecl_sum_scale_vector( ecl_sum , params_index , 2 );
+  ecl_sum_shift_vector( ecl_sum , params_index , 1 );
+
+  column = ecl_sum_get_column( ecl_sum , params_index );
+  for (int step = 0; step < length; step++)
+    test_assert_float_equal( column[step] , 2 * well_value( 3 , step ) + 1 );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_sum_column");
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+
+  write_summary( "CASE" , start_time );
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case( "CASE" , ":" );
+
+    test_column( ecl_sum );
+    test_limiting( ecl_sum );
+    test_data_vector( ecl_sum );
+#ifdef ERT_HAVE_PTHREAD
+    test_column_threads( ecl_sum );
+#endif
+    test_scale( ecl_sum );
+
+    ecl_sum_free( ecl_sum );
+  }
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,135 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_sum_restricted.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_smspec.h>
+
+#define NUM_WELLS     100
+#define NUM_DATES     10
+#define NUM_MINISTEP  5
+
+
+void write_summary( const char * name , time_t start_time , bool fmt_output , bool unified) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , fmt_output , unified , ":" , start_time , true , 10 , 10 , 10 );
+  smspec_node_type * wopr[NUM_WELLS];
+  smspec_node_type * wwct[NUM_WELLS];
+  smspec_node_type * fopt = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0 );
+  double sim_seconds = 0;
+
+  for (int well = 0; well < NUM_WELLS; well++) {
+    char * well_name = util_alloc_sprintf( "W%d" , well );
+    wopr[well] = ecl_sum_add_var( ecl_sum , "WOPR" , well_name , 0 , "SM3/DAY" , 0 );
+    wwct[well] = ecl_sum_add_var( ecl_sum , "WWCT" , well_name , 0 , "" , 0 );
+    free( well_name );
+  }
+
+  for (int report_step = 0; report_step < NUM_DATES; report_step++) {
+    for (int ministep = 0; ministep < NUM_MINISTEP; ministep++) {
+      ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , report_step + 1 , sim_seconds );
+      ecl_sum_tstep_set_from_node( tstep , fopt , sim_seconds );
+      for (int well = 0; well < NUM_WELLS; well++) {
+        ecl_sum_tstep_set_from_node( tstep , wopr[well] , well + sim_seconds / 3600 );
+        ecl_sum_tstep_set_from_node( tstep , wwct[well] , 1.0 / (well + 1));
+      }
+      sim_seconds += 3600 * 24;
+    }
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+void test_restricted( const char * name ) {
+  ecl_sum_type * full = ecl_sum_fread_alloc_case( name , ":" );
+  stringlist_type * keys = stringlist_alloc_new();
+  stringlist_append_ref( keys , "FOPT" );
+  stringlist_append_ref( keys , "WOPR:W1*" );
+  stringlist_append_ref( keys , "WWCT:W77" );
+  {
+    ecl_sum_type * restricted = ecl_sum_fread_alloc_case_restricted( name , ":" , keys );
+    const ecl_smspec_type * smspec = ecl_sum_get_smspec( restricted );
+    stringlist_type * loaded_keys = ecl_sum_alloc_matching_general_var_list( restricted , NULL );
+
+    /* TIME + FOPT + WOPR:W1 + WOPR:W10 ... WOPR:W19 + WWCT:W77 */
+    test_assert_int_equal( ecl_smspec_get_params_size( smspec ) , 1 + 1 + 11 + 1 );
+    test_assert_int_equal( ecl_smspec_get_file_params_size( smspec ) , ecl_smspec_get_params_size( ecl_sum_get_smspec( full )));
+    test_assert_int_equal( stringlist_get_size( loaded_keys ) , 13 );
+
+    test_assert_true( ecl_sum_has_key( restricted , "WOPR:W15" ));
+    test_assert_true( ecl_sum_has_key( restricted , "WWCT:W77" ));
+    test_assert_false( ecl_sum_has_key( restricted , "WOPR:W2" ));
+    test_assert_false( ecl_sum_has_key( restricted , "WWCT:W15" ));
+
+    test_assert_int_equal( ecl_sum_get_data_length( restricted ) , ecl_sum_get_data_length( full ));
+    test_assert_time_t_equal( ecl_sum_get_end_time( restricted ) , ecl_sum_get_end_time( full ));
+
+    for (int ikey = 0; ikey < stringlist_get_size( loaded_keys ); ikey++) {
+      const char * key = stringlist_iget( loaded_keys , ikey );
+      int full_index = ecl_sum_get_general_var_params_index( full , key );
+      int restricted_index = ecl_sum_get_general_var_params_index( restricted , key );
+
+      for (int step = 0; step < ecl_sum_get_data_length( full ); step++) {
+        test_assert_time_t_equal( ecl_sum_iget_sim_time( restricted , step ) , ecl_sum_iget_sim_time( full , step ));
+        test_assert_double_equal( ecl_sum_iget( restricted , step , restricted_index ) ,
+                                  ecl_sum_iget( full , step , full_index ));
+      }
+    }
+
+    stringlist_free( loaded_keys );
+    ecl_sum_free( restricted );
+  }
+
+  {
+    ecl_sum_type * all = ecl_sum_fread_alloc_case_restricted( name , ":" , NULL );
+    test_assert_int_equal( ecl_smspec_get_params_size( ecl_sum_get_smspec( all )) , ecl_smspec_get_params_size( ecl_sum_get_smspec( full )));
+    test_assert_NULL( ecl_smspec_get_params_map( ecl_sum_get_smspec( all )));
+    ecl_sum_free( all );
+  }
+
+  stringlist_free( keys );
+  ecl_sum_free( full );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_sum_restricted");
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+
+  write_summary( "UNIFIED" , start_time , false , true );
+  test_restricted( "UNIFIED" );
+
+  write_summary( "MULTIPLE" , start_time , false , false );
+  test_restricted( "MULTIPLE" );
+
+  write_summary( "FMT_UNIFIED" , start_time , true , true );
+  test_assert_true( util_file_exists( "FMT_UNIFIED.FSMSPEC" ));
+  test_restricted( "FMT_UNIFIED" );
+
+  write_summary( "FMT_MULTIPLE" , start_time , true , false );
+  test_restricted( "FMT_MULTIPLE" );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
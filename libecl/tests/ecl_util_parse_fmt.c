@@ -0,0 +1,131 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_util_parse_fmt.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_util.h>
+
+
+void test_int( const char * s , int expected_length , int expected_value) {
+  int value;
+  int length = ecl_util_parse_fmt_int( s , &value );
+  test_assert_int_equal( length , expected_length );
+  if (length > 0)
+    test_assert_int_equal( value , expected_value );
+}
+
+
+void test_double( const char * s , int expected_length , double expected_value) {
+  double value;
+  int length = ecl_util_parse_fmt_double( s , &value );
+  test_assert_int_equal( length , expected_length );
+  if (length > 0)
+    test_assert_double_equal( value , expected_value );
+}
+
+
+/*
+  For numbers with up to 15 significant digits the parser should give
+  exactly the same result as strtod().
+*/
+
+void test_strtod( ) {
+  char buffer[64];
+  int i;
+  srand( 100 );
+  for (i=0; i < 10000; i++) {
+    double value = 10.0 * rand() / RAND_MAX - 5.0;
+    double parsed;
+    int exp = rand() % 40 - 20;
+
+    sprintf( buffer , "%.14e" , value );
+    test_assert_int_equal( ecl_util_parse_fmt_double( buffer , &parsed ) , strlen( buffer ));
+    test_assert_true( parsed == strtod( buffer , NULL ));
+
+    sprintf( buffer , "%.8fE%+03d" , value , exp );
+    test_assert_int_equal( ecl_util_parse_fmt_double( buffer , &parsed ) , strlen( buffer ));
+    test_assert_true( parsed == strtod( buffer , NULL ));
+  }
+}
+
+
+void test_token( ) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_util_parse_fmt");
+  char token[9];
+  FILE * stream = util_fopen( "TOKENS" , "w");
+  fprintf(stream , "  ABC\n\t 10*0.25 0123456789ABCDEF -- \n/");
+  fclose( stream );
+
+  stream = util_fopen( "TOKENS" , "r");
+  test_assert_int_equal( ecl_util_fscanf_token( stream , token , 8 ) , 3 );
+  test_assert_string_equal( token , "ABC" );
+  test_assert_int_equal( fgetc( stream ) , '\n' );
+
+  test_assert_int_equal( ecl_util_fscanf_token( stream , token , 8 ) , 7 );
+  test_assert_string_equal( token , "10*0.25" );
+
+  test_assert_int_equal( ecl_util_fscanf_token( stream , token , 8 ) , 8 );
+  test_assert_string_equal( token , "01234567" );
+  test_assert_int_equal( ecl_util_fscanf_token( stream , token , 8 ) , 8 );
+  test_assert_string_equal( token , "89ABCDEF" );
+
+  test_assert_int_equal( ecl_util_fscanf_token( stream , token , 8 ) , 2 );
+  test_assert_string_equal( token , "--" );
+  test_assert_int_equal( ecl_util_fscanf_token( stream , token , 8 ) , 1 );
+  test_assert_string_equal( token , "/" );
+  test_assert_int_equal( ecl_util_fscanf_token( stream , token , 8 ) , 0 );
+  fclose( stream );
+  test_work_area_free( work_area );
+}
+
+
+int main(int argc , char ** argv) {
+  test_int( "0" , 1 , 0 );
+  test_int( "-17" , 3 , -17 );
+  test_int( "+17" , 3 , 17 );
+  test_int( "10*5" , 2 , 10 );
+  test_int( "2147483647" , 10 , 2147483647 );
+  test_int( "-2147483648" , 11 , -2147483647 - 1 );
+  test_int( "2147483648" , 0 , 0 );
+  test_int( "99999999999999999999" , 0 , 0 );
+  test_int( "-" , 0 , 0 );
+  test_int( "ABC" , 0 , 0 );
+
+  test_double( "0.25" , 4 , 0.25 );
+  test_double( "-.5" , 3 , -0.5 );
+  test_double( "5." , 2 , 5.0 );
+  test_double( "1e3" , 3 , 1000 );
+  test_double( "1E" , 1 , 1 );
+  test_double( "0.12345678E+01" , 14 , 1.2345678 );
+  test_double( "-0.12345678901234D+03" , 21 , -123.45678901234 );
+  test_double( "0.10000000000000D-99" , 20 , 1e-100 );
+  test_double( "0.25*" , 4 , 0.25 );
+  test_double( "." , 0 , 0 );
+  test_double( "F" , 0 , 0 );
+  test_double( "123456789012345678901234567890" , 30 , 123456789012345678901234567890.0 );
+
+  test_strtod( );
+  test_token( );
+  exit(0);
+}
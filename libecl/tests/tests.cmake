@@ -26,6 +26,22 @@ add_executable( ecl_kw_fread ecl_kw_fread.c )
 target_link_libraries( ecl_kw_fread ecl  )
 add_test( ecl_kw_fread ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_fread  )
 
+add_executable( ecl_file_mmap ecl_file_mmap.c )
+target_link_libraries( ecl_file_mmap ecl  )
+add_test( ecl_file_mmap ${EXECUTABLE_OUTPUT_PATH}/ecl_file_mmap  )
+
+add_executable( ecl_file_index ecl_file_index.c )
+target_link_libraries( ecl_file_index ecl  )
+add_test( ecl_file_index ${EXECUTABLE_OUTPUT_PATH}/ecl_file_index  )
+
+add_executable( ecl_kw_fread_bulk ecl_kw_fread_bulk.c )
+target_link_libraries( ecl_kw_fread_bulk ecl  )
+add_test( ecl_kw_fread_bulk ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_fread_bulk  )
+
+add_executable( ecl_kw_fread_indexed ecl_kw_fread_indexed.c )
+target_link_libraries( ecl_kw_fread_indexed ecl  )
+add_test( ecl_kw_fread_indexed ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_fread_indexed  )
+
 add_executable( ecl_valid_basename ecl_valid_basename.c )
 target_link_libraries( ecl_valid_basename ecl  )
 add_test( ecl_valid_basename ${EXECUTABLE_OUTPUT_PATH}/ecl_valid_basename)
@@ -38,6 +54,14 @@ add_executable( ecl_sum_writer ecl_sum_writer.c )
 target_link_libraries( ecl_sum_writer ecl  )
 add_test( ecl_sum_writer ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_writer )
 
+add_executable( ecl_sum_column ecl_sum_column.c )
+target_link_libraries( ecl_sum_column ecl  )
+add_test( ecl_sum_column ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_column )
+
+add_executable( ecl_sum_restricted ecl_sum_restricted.c )
+target_link_libraries( ecl_sum_restricted ecl  )
+add_test( ecl_sum_restricted ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_restricted )
+
 add_executable( ecl_grid_add_nnc ecl_grid_add_nnc.c )
 target_link_libraries( ecl_grid_add_nnc ecl  )
 add_test( ecl_grid_add_nnc ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_add_nnc )
@@ -66,6 +90,10 @@ add_executable( ecl_kw_grdecl ecl_kw_grdecl.c )
 target_link_libraries( ecl_kw_grdecl ecl  )
 add_test( ecl_kw_grdecl ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_grdecl )
 
+add_executable( ecl_kw_fscanf_token ecl_kw_fscanf_token.c )
+target_link_libraries( ecl_kw_fscanf_token ecl  )
+add_test( ecl_kw_fscanf_token ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_fscanf_token )
+
 add_executable( ecl_kw_equal ecl_kw_equal.c )
 target_link_libraries( ecl_kw_equal ecl  )
 add_test( ecl_kw_equal ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_equal )
@@ -78,6 +106,10 @@ add_executable( ecl_util_month_range ecl_util_month_range.c )
 target_link_libraries( ecl_util_month_range ecl  )
 add_test( ecl_util_month_range ${EXECUTABLE_OUTPUT_PATH}/ecl_util_month_range  )
 
+add_executable( ecl_util_parse_fmt ecl_util_parse_fmt.c )
+target_link_libraries( ecl_util_parse_fmt ecl  )
+add_test( ecl_util_parse_fmt ${EXECUTABLE_OUTPUT_PATH}/ecl_util_parse_fmt  )
+
 if (HAVE_UTIL_ABORT_INTERCEPT)
    add_executable( ecl_grid_corner ecl_grid_corner.c )
    target_link_libraries( ecl_grid_corner ecl  )
@@ -96,6 +128,18 @@ add_executable( ecl_grid_copy ecl_grid_copy.c )
 target_link_libraries( ecl_grid_copy ecl  )
 add_test( ecl_grid_copy ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_copy )
 
+add_executable( ecl_grid_xyz_index ecl_grid_xyz_index.c )
+target_link_libraries( ecl_grid_xyz_index ecl ert_util )
+add_test( ecl_grid_xyz_index ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_xyz_index )
+
+add_executable( ecl_grid_compact ecl_grid_compact.c )
+target_link_libraries( ecl_grid_compact ecl ert_util )
+add_test( ecl_grid_compact ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_compact )
+
+add_executable( ecl_grid_bulk_geometry ecl_grid_bulk_geometry.c )
+target_link_libraries( ecl_grid_bulk_geometry ecl ert_util )
+add_test( ecl_grid_bulk_geometry ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_bulk_geometry )
+
 add_executable( ecl_get_num_cpu ecl_get_num_cpu_test.c )
 target_link_libraries( ecl_get_num_cpu ecl  )
 add_test( ecl_get_num_cpu ${EXECUTABLE_OUTPUT_PATH}/ecl_get_num_cpu 
@@ -40,6 +40,7 @@ typedef struct active_list_struct active_list_type;
   active_mode_type   active_list_get_mode(const active_list_type * );
   void               active_list_free__( void * arg );
   active_list_type * active_list_alloc_copy( const active_list_type * src);
+  active_list_type * active_list_alloc_subset( const active_list_type * src , int offset , int length);
   void               active_list_fprintf( const active_list_type * active_list , const char * dataset_key , const char * key , FILE * stream );
   void               active_list_summary_fprintf( const active_list_type * active_list , const char * dataset_key , const char * key , FILE * stream);
   bool               active_list_iget( const active_list_type * active_list , int index );
@@ -51,6 +51,9 @@ extern "C" {
 #define  ADD_FIXED_LENGTH_SCHEDULE_KW_KEY  "ADD_FIXED_LENGTH_SCHEDULE_KW"
 #define  ANALYSIS_COPY_KEY                 "ANALYSIS_COPY"
 #define  ANALYSIS_LOAD_KEY                 "ANALYSIS_LOAD"
+#define  ANALYSIS_MEMORY_LIMIT_KEY         "ANALYSIS_MEMORY_LIMIT"
+#define  ANALYSIS_THREADS_KEY              "ANALYSIS_THREADS"
+#define  ANALYSIS_SINGLE_PRECISION_KEY     "ANALYSIS_SINGLE_PRECISION"
 #define  ANALYSIS_SET_VAR_KEY              "ANALYSIS_SET_VAR"
 #define  ANALYSIS_SELECT_KEY               "ANALYSIS_SELECT"
 #define  CASE_TABLE_KEY                    "CASE_TABLE"
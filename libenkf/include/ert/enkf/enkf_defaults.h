@@ -128,6 +128,9 @@
 #define DEFAULT_ANALYSIS_MIN_REALISATIONS  0   // 0: No lower limit
 #define DEFAULT_ANALYSIS_STOP_LONG_RUNNING false 
 #define DEFAULT_MAX_RUNTIME                0
+#define DEFAULT_ANALYSIS_MEMORY_LIMIT      0       /* Memory limit for the A matrix; 0: No limit */
+#define DEFAULT_ANALYSIS_THREADS           0       /* 0: Use all available cpus */
+#define DEFAULT_ANALYSIS_SINGLE_PRECISION  false   /* Store the A matrix in single precision in the update. */
 #define DEFAULT_ITER_RETRY_COUNT           4
 
 
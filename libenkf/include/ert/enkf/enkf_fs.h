@@ -30,6 +30,7 @@ extern "C" {
 #include <ert/util/stringlist.h>
 
 #include <ert/enkf/fs_driver.h>
+#include <ert/enkf/field_block_driver.h>
 #include <ert/enkf/enkf_types.h>
 #include <ert/enkf/fs_types.h>
 #include <ert/enkf/enkf_fs_type.h>
@@ -63,6 +64,21 @@ extern "C" {
                                           const char * node_key, 
                                           enkf_var_type var_type,  
                                           int iens); 
+
+  void              enkf_fs_fwrite_vectors(enkf_fs_type * enkf_fs ,
+                                           int num_vectors ,
+                                           buffer_type ** buffers ,
+                                           const char ** node_keys ,
+                                           enkf_var_type var_type ,
+                                           int iens);
+
+  int               enkf_fs_fread_vectors(enkf_fs_type * enkf_fs ,
+                                          int num_vectors ,
+                                          buffer_type ** buffers ,
+                                          const char ** node_keys ,
+                                          enkf_var_type var_type ,
+                                          int iens ,
+                                          bool * found);
   
   bool              enkf_fs_exists( const char * mount_point );
 
@@ -79,6 +95,10 @@ extern "C" {
   bool              enkf_fs_has_vector(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int iens);
   bool              enkf_fs_has_node(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int report_step , int iens);
 
+  field_block_driver_type * enkf_fs_get_field_block_driver( const enkf_fs_type * fs );
+  void              enkf_fs_fwrite_field_node(enkf_fs_type * enkf_fs , const char * node_key , int iens , const void * data , size_t byte_size);
+  void              enkf_fs_fread_field_node(enkf_fs_type * enkf_fs , const char * node_key , int iens , void * data , size_t byte_size);
+
   void              enkf_fs_debug_fprintf( const enkf_fs_type * fs);
 
   enkf_fs_type *    enkf_fs_create_fs( const char * mount_point , fs_driver_impl driver_id , void * arg, bool mount);
@@ -135,6 +135,8 @@ extern "C" {
   void             enkf_node_clear_serial_state(enkf_node_type * );
   void             enkf_node_serialize(enkf_node_type * enkf_node , enkf_fs_type * fs , node_id_type node_id , const active_list_type * active_list , matrix_type * A , int row_offset , int column);
   void             enkf_node_deserialize(enkf_node_type *enkf_node , enkf_fs_type * fs , node_id_type node_id , const active_list_type * active_list , const matrix_type * A , int row_offset , int column);
+  void             enkf_node_serialize__(enkf_node_type * enkf_node , node_id_type node_id , const active_list_type * active_list , matrix_type * A , int row_offset , int column);
+  void             enkf_node_deserialize__(enkf_node_type *enkf_node , node_id_type node_id , const active_list_type * active_list , const matrix_type * A , int row_offset , int column);
 
   bool             enkf_node_forward_load_vector(enkf_node_type *enkf_node , const forward_load_context_type * load_context , const int_vector_type * time_index);
   bool             enkf_node_forward_load  (enkf_node_type *, const forward_load_context_type * load_context);
@@ -166,8 +168,10 @@ extern "C" {
   void              enkf_node_load_vector( enkf_node_type * enkf_node , enkf_fs_type * fs , int iens);
   bool              enkf_node_store(enkf_node_type * enkf_node , enkf_fs_type * fs , bool force_vectors , node_id_type node_id);
   bool              enkf_node_store_vector(enkf_node_type *enkf_node , enkf_fs_type * fs , int iens );
+  int               enkf_node_store_vectors(enkf_node_type ** nodes , int num_nodes , enkf_fs_type * fs , int iens );
   bool              enkf_node_try_load(enkf_node_type *enkf_node , enkf_fs_type * fs , node_id_type node_id);
   bool              enkf_node_try_load_vector(enkf_node_type *enkf_node , enkf_fs_type * fs , int iens );
+  int               enkf_node_try_load_vectors(enkf_node_type ** nodes , int num_nodes , enkf_fs_type * fs , int iens );
   bool              enkf_node_exists( enkf_node_type *enkf_node , enkf_fs_type * fs , int report_step , int iens);
   bool              enkf_node_vector_storage( const enkf_node_type * node );
   enkf_node_type  * enkf_node_alloc_shared_container(const enkf_config_node_type * config, hash_type * node_hash);
@@ -76,6 +76,14 @@ extern "C" {
                                          meas_data_type           * meas_data,
                                          obs_data_type            * obs_data);
 
+  void enkf_obs_get_obs_and_measure_data_mt(const enkf_obs_type      * enkf_obs,
+                                            enkf_fs_type             * fs,
+                                            const local_obsdata_type * local_obsdata ,
+                                            const int_vector_type    * ens_active_list ,
+                                            meas_data_type           * meas_data,
+                                            obs_data_type            * obs_data,
+                                            int num_threads);
+
 
   stringlist_type * enkf_obs_alloc_typed_keylist( enkf_obs_type * enkf_obs , obs_impl_type );
   hash_type * enkf_obs_alloc_data_map(enkf_obs_type * enkf_obs);
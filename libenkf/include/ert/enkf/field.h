@@ -73,6 +73,8 @@ extern "C" {
   ecl_kw_type * field_alloc_ecl_kw_wrapper(const field_type * );
   void          field_update_sum(field_type * sum , field_type * field , double lower_limit , double upper_limit);
   void          field_upgrade_103(const char * filename);
+  void          field_store_blocks(const field_type * field , enkf_fs_type * fs , int iens);
+  void          field_load_blocks(field_type * field , enkf_fs_type * fs , int iens);
   
   UTIL_IS_INSTANCE_HEADER(field);
   UTIL_SAFE_CAST_HEADER_CONST(field);
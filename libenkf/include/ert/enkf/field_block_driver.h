@@ -0,0 +1,48 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'field_block_driver.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_FIELD_BLOCK_DRIVER_H
+#define ERT_FIELD_BLOCK_DRIVER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ert/util/type_macros.h>
+
+  typedef struct field_block_driver_struct field_block_driver_type;
+
+  field_block_driver_type * field_block_driver_alloc( const char * path , bool read_only );
+  void                      field_block_driver_free( field_block_driver_type * driver );
+  void                      field_block_driver_fsync( field_block_driver_type * driver );
+  int                       field_block_driver_get_block_size( field_block_driver_type * driver , const char * key );
+  bool                      field_block_driver_has_key( field_block_driver_type * driver , const char * key );
+  bool                      field_block_driver_has_node( field_block_driver_type * driver , const char * key , int iens );
+  void                      field_block_driver_save_node( field_block_driver_type * driver , const char * key , int iens , const void * data , size_t byte_size );
+  void                      field_block_driver_load_node( field_block_driver_type * driver , const char * key , int iens , void * data , size_t byte_size );
+  void                      field_block_driver_load_range( field_block_driver_type * driver , const char * key , size_t offset , size_t size , int iens1 , int iens2 , void ** member_data );
+  void                      field_block_driver_save_range( field_block_driver_type * driver , const char * key , size_t offset , size_t size , int iens1 , int iens2 , void ** member_data );
+
+  UTIL_IS_INSTANCE_HEADER( field_block_driver );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -39,6 +39,7 @@ extern "C" {
   void                        forward_load_context_update_result( forward_load_context_type * load_context , int flags);
   int                         forward_load_context_get_result( const forward_load_context_type * load_context );
   forward_load_context_type * forward_load_context_alloc( const run_arg_type * run_arg , bool load_summary , const ecl_config_type * ecl_config , const char * eclbase, stringlist_type * messages);
+  forward_load_context_type * forward_load_context_alloc_restricted( const run_arg_type * run_arg , bool load_summary , const stringlist_type * summary_keys , const ecl_config_type * ecl_config , const char * eclbase, stringlist_type * messages);
   void                        forward_load_context_free( forward_load_context_type * load_context );
   const ecl_sum_type        * forward_load_context_get_ecl_sum( const forward_load_context_type * load_context);
   const ecl_file_type       * forward_load_context_get_restart_file( const forward_load_context_type * load_context);
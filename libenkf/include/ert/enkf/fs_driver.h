@@ -169,7 +169,9 @@ extern "C" {
   typedef bool (has_node_ftype)     (void * driver, const char * , int , int );
   
   typedef void (load_vector_ftype)    (void * driver, const char * , int , buffer_type * );
+  typedef int  (load_vectors_ftype)   (void * driver, int , const char ** , int , buffer_type ** , bool * );
   typedef void (save_vector_ftype)    (void * driver, const char * , int , buffer_type * );
+  typedef void (save_vectors_ftype)   (void * driver, int , const char ** , int , buffer_type ** );
   typedef void (unlink_vector_ftype)  (void * driver, const char * , int );
   typedef bool (has_vector_ftype)     (void * driver, const char * , int );
   
@@ -204,7 +206,9 @@ save_node_ftype           * save_node;     \
 has_node_ftype            * has_node;      \
 unlink_node_ftype         * unlink_node;   \
 load_vector_ftype         * load_vector;   \
+load_vectors_ftype        * load_vectors;  \
 save_vector_ftype         * save_vector;   \
+save_vectors_ftype        * save_vectors;  \
 has_vector_ftype          * has_vector;    \
 unlink_vector_ftype       * unlink_vector; \
 free_driver_ftype         * free_driver;   \
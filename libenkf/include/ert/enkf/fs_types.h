@@ -40,10 +40,16 @@
 //  BLOCK_FS_DRIVER_INDEX_ID   = 3002 } fs_driver_impl;
 
 
+/*
+  BLOCK_FS_FIELD_DRIVER_ID is the block_fs drivers, with the FIELD
+  parameters stored ensemble-major by the field_block_driver.
+*/
+
 typedef enum {
   INVALID_DRIVER_ID          = 0,
   PLAIN_DRIVER_ID            = 1005,
-  BLOCK_FS_DRIVER_ID         = 3001} fs_driver_impl;
+  BLOCK_FS_DRIVER_ID         = 3001,
+  BLOCK_FS_FIELD_DRIVER_ID   = 3003} fs_driver_impl;
 
 
 
@@ -34,6 +34,7 @@ void                    local_updatestep_add_ministep( local_updatestep_type * u
 local_ministep_type   * local_updatestep_iget_ministep( const local_updatestep_type * updatestep , int index);
 local_obsdata_type    * local_updatestep_iget_obsdata( const local_updatestep_type * updatestep , int index);
 int                     local_updatestep_get_num_ministep( const local_updatestep_type * updatestep );
+int                     local_updatestep_get_independent_ministeps( const local_updatestep_type * updatestep , int first , int max_size);
 local_updatestep_type * local_updatestep_alloc_copy( const local_updatestep_type * src , const char * name );
 void                    local_updatestep_fprintf( const local_updatestep_type * updatestep , FILE * stream);
 const char            * local_updatestep_get_name( const local_updatestep_type * updatestep );
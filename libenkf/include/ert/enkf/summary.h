@@ -19,6 +19,7 @@
 #ifndef ERT_SUMMARY_H
 #define ERT_SUMMARY_H
 #include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
 
 #include <ert/ecl/ecl_sum.h>
 #include <ert/ecl/ecl_file.h>
@@ -35,6 +36,8 @@
 double    summary_get(const summary_type * summary, int report_step );
 bool      summary_active_value( double value );
 int       summary_length(const summary_type * summary);
+int_vector_type * summary_alloc_ministep_index( const ecl_sum_type * ecl_sum , const int_vector_type * time_index);
+void      summary_load_params_index( summary_type * summary , const ecl_sum_type * ecl_sum , int params_index , const int_vector_type * ministep_index);
 
 VOID_HAS_DATA_HEADER(summary);
 UTIL_SAFE_CAST_HEADER(summary);
@@ -136,6 +136,41 @@ void active_list_add_index(active_list_type * active_list, int new_index) {
 
 
 
+/**
+   Will allocate a new PARTLY_ACTIVE active_list instance with the
+   @length active indices starting at position @offset in the list of
+   active indices of @src; i.e. the rows [offset, offset + length) of
+   the part of the A matrix corresponding to @src. For an ALL_ACTIVE
+   @src the active indices are just 0,1,2,...
+*/
+
+active_list_type * active_list_alloc_subset( const active_list_type * src , int offset , int length) {
+  active_list_type * subset = active_list_alloc( );
+  if (src->mode == INACTIVE)
+    util_abort("%s: can not take subset of an INACTIVE active_list\n",__func__);
+
+  if ((src->mode == PARTLY_ACTIVE) && ((offset + length) > int_vector_size( src->index_list )))
+    util_abort("%s: invalid subset [%d,%d) - active size:%d \n",__func__ , offset , offset + length , int_vector_size( src->index_list ));
+
+  subset->mode = PARTLY_ACTIVE;
+  int_vector_resize( subset->index_list , length );
+  {
+    int * index_list = int_vector_get_ptr( subset->index_list );
+    if (src->mode == ALL_ACTIVE) {
+      for (int i = 0; i < length; i++)
+        index_list[i] = offset + i;
+    } else {
+      const int * src_list = int_vector_get_const_ptr( src->index_list );
+      for (int i = 0; i < length; i++)
+        index_list[i] = src_list[offset + i];
+    }
+  }
+  return subset;
+}
+
+
+
+
 /**
    When mode == PARTLY_ACTIVE the active_list instance knows the size
    of the active set; if the mode is INACTIVE 0 will be returned and
@@ -20,6 +20,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 #include <ert/util/util.h>
 #include <ert/util/stringlist.h>
@@ -65,6 +66,9 @@ struct analysis_config_struct {
   bool                            stop_long_running;
   bool                            std_scale_correlated_obs;
   int                             max_runtime;
+  size_t                          memory_limit;                /* Upper limit in bytes for the A matrix in the update; 0 => no limit. */
+  int                             num_threads;                 /* Number of threads used in the update; 0 => use all available cpus. */
+  bool                            single_precision;            /* Store the A matrix as float in the pipelined update. */
   double                          global_std_scaling;
 };
 
@@ -170,6 +174,58 @@ void analysis_config_set_max_runtime( analysis_config_type * config, int max_run
   config->max_runtime = max_runtime;
 }
 
+/**
+   The memory limit is given in bytes; in the configuration file the
+   ANALYSIS_MEMORY_LIMIT keyword is given in MB.
+*/
+
+size_t analysis_config_get_memory_limit( const analysis_config_type * config ) {
+  return config->memory_limit;
+}
+
+void analysis_config_set_memory_limit( analysis_config_type * config, size_t memory_limit ) {
+  config->memory_limit = memory_limit;
+}
+
+
+/**
+   The number of rows in the A matrix which can be processed in one
+   block without exceeding the memory limit; when no memory limit has
+   been set the function will return -1. With single precision
+   storage twice as many rows fit within the limit.
+*/
+
+int analysis_config_get_max_block_rows( const analysis_config_type * config , int ens_size) {
+  if (config->memory_limit > 0) {
+    size_t row_size = ens_size * (config->single_precision ? sizeof(float) : sizeof(double));
+    size_t rows     = config->memory_limit / util_size_t_max( row_size , 1 );
+
+    if (rows < 1)
+      rows = 1;
+    if (rows > INT_MAX)
+      rows = INT_MAX;
+    return rows;
+  } else
+    return -1;
+}
+
+/**
+   When single precision is selected the A matrix of the pipelined
+   update, i.e. for the modules which only calculate X, is stored as
+   float and multiplied with X in single precision. X itself, and all
+   the other matrices of the update, are still calculated in double
+   precision. The modules which use or update A directly are not
+   affected.
+*/
+
+void analysis_config_set_single_precision( analysis_config_type * config , bool single_precision) {
+  config->single_precision = single_precision;
+}
+
+bool analysis_config_get_single_precision( const analysis_config_type * config ) {
+  return config->single_precision;
+}
+
 static void analysis_config_set_min_realisations( analysis_config_type * config , int min_realisations) {
   config->min_realisations = min_realisations;
 }
@@ -272,12 +328,57 @@ void analysis_config_set_merge_observations( analysis_config_type * config , boo
 
 /*****************************************************************/
 
+/*
+  Modules which can run multithreaded support the integer variable
+  ANALYSIS_NUM_THREADS_VAR; the thread count from the ANALYSIS_THREADS
+  keyword is pushed to the modules when they are loaded, and when the
+  thread count is changed. An explicit ANALYSIS_SET_VAR will override
+  this.
+*/
+
+static void analysis_config_init_module_threads( const analysis_config_type * config , analysis_module_type * module) {
+  if (analysis_module_has_var( module , ANALYSIS_NUM_THREADS_VAR )) {
+    char * value = util_alloc_sprintf("%d" , analysis_config_get_num_threads( config ));
+    analysis_module_set_var( module , ANALYSIS_NUM_THREADS_VAR , value );
+    free( value );
+  }
+}
+
+
+void analysis_config_set_num_threads( analysis_config_type * config , int num_threads) {
+  config->num_threads = num_threads;
+  {
+    hash_iter_type * iter = hash_iter_alloc( config->analysis_modules );
+    while (!hash_iter_is_complete( iter )) {
+      analysis_module_type * module = hash_iter_get_next_value( iter );
+      analysis_config_init_module_threads( config , module );
+    }
+    hash_iter_free( iter );
+  }
+}
+
+
+/**
+   Will return the number of threads to use in the update; if the
+   ANALYSIS_THREADS keyword has not been set this is the number of
+   cpus available to the process.
+*/
+
+int analysis_config_get_num_threads( const analysis_config_type * config ) {
+  if (config->num_threads > 0)
+    return config->num_threads;
+  else
+    return util_get_num_cpu( );
+}
+
+
 void analysis_config_load_internal_module( analysis_config_type * config ,
                                            const char * symbol_table ) {
   analysis_module_type * module = analysis_module_alloc_internal( config->rng , symbol_table );
-  if (module != NULL)
+  if (module != NULL) {
+    analysis_config_init_module_threads( config , module );
     hash_insert_hash_owned_ref( config->analysis_modules , analysis_module_get_name( module ) , module , analysis_module_free__ );
-  else
+  } else
     fprintf(stderr,"** Warning: failed to load module %s from %s.\n", analysis_module_get_name( module ) , symbol_table);
 }
 
@@ -304,6 +405,7 @@ bool analysis_config_load_external_module( analysis_config_type * config ,
   if (module != NULL) {
     if (user_name)
       analysis_module_set_name(module, user_name);
+    analysis_config_init_module_threads( config , module );
     hash_insert_hash_owned_ref( config->analysis_modules , analysis_module_get_name( module ) ,  module , analysis_module_free__ );
     return true;
   } else {
@@ -327,6 +429,7 @@ void analysis_config_add_module_copy( analysis_config_type * config ,
     target_module = analysis_module_alloc_external( config->rng , lib_name );
   }
 
+  analysis_config_init_module_threads( config , target_module );
   hash_insert_hash_owned_ref( config->analysis_modules , target_name , target_module , analysis_module_free__ );
   analysis_module_set_name( target_module , target_name );
 }
@@ -509,6 +612,15 @@ void analysis_config_init( analysis_config_type * analysis , const config_conten
     analysis_config_set_max_runtime( analysis, config_content_get_value_as_int( config, MAX_RUNTIME_KEY ));
   }
 
+  if (config_content_has_item( config, ANALYSIS_THREADS_KEY))
+    analysis_config_set_num_threads( analysis, config_content_get_value_as_int( config, ANALYSIS_THREADS_KEY ));
+
+  if (config_content_has_item( config, ANALYSIS_MEMORY_LIMIT_KEY))
+    analysis_config_set_memory_limit( analysis, ((size_t) config_content_get_value_as_int( config, ANALYSIS_MEMORY_LIMIT_KEY )) * 1024 * 1024);
+
+  if (config_content_has_item( config, ANALYSIS_SINGLE_PRECISION_KEY))
+    analysis_config_set_single_precision( analysis, config_content_get_value_as_bool( config, ANALYSIS_SINGLE_PRECISION_KEY ));
+
 
   /* Loading external modules */
   analysis_config_load_all_external_modules_from_config(analysis, config);
@@ -612,6 +724,9 @@ analysis_config_type * analysis_config_alloc( rng_type * rng ) {
   analysis_config_set_min_realisations( config         , DEFAULT_ANALYSIS_MIN_REALISATIONS );
   analysis_config_set_stop_long_running( config        , DEFAULT_ANALYSIS_STOP_LONG_RUNNING );
   analysis_config_set_max_runtime( config              , DEFAULT_MAX_RUNTIME );
+  analysis_config_set_memory_limit( config             , DEFAULT_ANALYSIS_MEMORY_LIMIT );
+  analysis_config_set_single_precision( config         , DEFAULT_ANALYSIS_SINGLE_PRECISION );
+  config->num_threads               = DEFAULT_ANALYSIS_THREADS;
 
   config->analysis_module      = NULL;
   config->analysis_modules     = hash_alloc();
@@ -653,6 +768,9 @@ void analysis_config_add_config_items( config_parser_type * config ) {
   config_add_key_value( config , MIN_REALIZATIONS_KEY        , false , CONFIG_STRING );
   config_add_key_value( config , MAX_RUNTIME_KEY             , false , CONFIG_INT );
   config_add_key_value( config , STD_SCALE_CORRELATED_OBS_KEY, false , CONFIG_BOOL );
+  config_add_key_value( config , ANALYSIS_MEMORY_LIMIT_KEY   , false , CONFIG_INT );
+  config_add_key_value( config , ANALYSIS_THREADS_KEY        , false , CONFIG_INT );
+  config_add_key_value( config , ANALYSIS_SINGLE_PRECISION_KEY , false , CONFIG_BOOL );
 
   item = config_add_key_value( config , STOP_LONG_RUNNING_KEY, false,  CONFIG_BOOL );
   stringlist_type * child_list = stringlist_alloc_new();
@@ -702,6 +820,23 @@ void analysis_config_fprintf_config( analysis_config_type * config , FILE * stre
     fprintf( stream , "\n");
   }
 
+  if (config->num_threads != DEFAULT_ANALYSIS_THREADS) {
+    fprintf( stream , CONFIG_KEY_FORMAT   , ANALYSIS_THREADS_KEY);
+    fprintf( stream , CONFIG_INT_FORMAT   , config->num_threads );
+    fprintf( stream , "\n");
+  }
+
+  if (config->memory_limit != DEFAULT_ANALYSIS_MEMORY_LIMIT) {
+    fprintf( stream , CONFIG_KEY_FORMAT   , ANALYSIS_MEMORY_LIMIT_KEY);
+    fprintf( stream , CONFIG_INT_FORMAT   , (int) (config->memory_limit / (1024 * 1024)));
+    fprintf( stream , "\n");
+  }
+
+  if (config->single_precision != DEFAULT_ANALYSIS_SINGLE_PRECISION) {
+    fprintf( stream , CONFIG_KEY_FORMAT      , ANALYSIS_SINGLE_PRECISION_KEY);
+    fprintf( stream , CONFIG_ENDVALUE_FORMAT , CONFIG_BOOL_STRING( config->single_precision ));
+  }
+
   if (config->log_path != NULL) {
     fprintf( stream , CONFIG_KEY_FORMAT      , UPDATE_LOG_PATH_KEY);
     fprintf( stream , CONFIG_ENDVALUE_FORMAT , config->log_path );
@@ -19,8 +19,12 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
 
 #include <ert/util/util.h>
+#include <ert/util/hash.h>
 #include <ert/util/path_fmt.h>
 #include <ert/util/block_fs.h>
 #include <ert/util/buffer.h>
@@ -36,11 +40,33 @@
 typedef struct bfs_struct bfs_type;
 typedef struct bfs_config_struct bfs_config_type;
 
+
+/*
+  One slot in the binary node index, see the "Binary node index"
+  section below.
+*/
+
+typedef struct {
+  uint64_t   key;          /* The packed (key id, report_step, iens) key. */
+  char     * filename;     /* The block_fs filename; NULL for an empty slot. */
+  bool       exists;       /* Whether the file exists in the block_fs instance. */
+} node_slot_type;
+
+
+typedef struct {
+  pthread_rwlock_t   lock;
+  node_slot_type   * slots;
+  size_t             size;         /* The number of slots; always a power of two. */
+  size_t             count;        /* The number of slots in use. */
+} node_index_type;
+
+
 struct bfs_config_struct {
   int             fsync_interval;
   double          fragmentation_limit;
   bool            read_only;
   bool            preload;
+  bool            async_write;
   int             block_size;
   int             max_cache_size;
   bool            bfs_lock;
@@ -55,6 +81,7 @@ struct bfs_struct  {
   /* New variables */
   block_fs_type * block_fs;
   char          * mountfile;  // The full path to the file mounted by the block_fs layer - including extension. 
+  node_index_type node_index;
 
   const bfs_config_type * config;
 };
@@ -69,6 +96,9 @@ struct block_fs_driver_struct {
   
   // New variables
   bfs_type        ** fs_list;
+
+  pthread_rwlock_t   key_lock;    /* Protects key_ids. */
+  hash_type        * key_ids;     /* The interned node keys: node_key -> key id. */
 }; 
 
 /*****************************************************************/
@@ -82,6 +112,16 @@ bfs_config_type * bfs_config_alloc( fs_driver_enum driver_type , bool read_only,
   const bool DYNAMIC_preload       = true;
   const bool DEFAULT_preload       = false;
 
+  /*
+    The dynamic results are loaded from the forward model by many
+    threads at the same time; the writes are then queued and written
+    in batches by the block_fs writer thread, with one fsync() per
+    batch.
+  */
+  const bool PARAMETER_async_write = false;
+  const bool DYNAMIC_async_write   = true;
+  const bool DEFAULT_async_write   = false;
+
   const int max_cache_size         = 512; 
   const int fsync_interval         =  10;     /* An fsync() call is issued for every 10'th write. */
   const double fragmentation_limit = 1.0;     /* 1.0 => NO defrag is run. */
@@ -98,14 +138,17 @@ bfs_config_type * bfs_config_alloc( fs_driver_enum driver_type , bool read_only,
     case( DRIVER_PARAMETER ):
       config->block_size = PARAMETER_blocksize;
       config->preload = PARAMETER_preload;
+      config->async_write = PARAMETER_async_write;
       break;
     case(DRIVER_DYNAMIC_FORECAST):
       config->block_size = DYNAMIC_blocksize;
       config->preload = DYNAMIC_preload;
+      config->async_write = DYNAMIC_async_write;
       break;
     default:
       config->block_size = DEFAULT_blocksize;
       config->preload = DEFAULT_preload;
+      config->async_write = DEFAULT_async_write;
     }
     return config;
   }
@@ -115,6 +158,168 @@ void bfs_config_free( bfs_config_type * config ) {
   free( config );
 }
 
+/*****************************************************************/
+/*
+  Binary node index
+  -----------------
+
+  The files in the block_fs instances are named with the readable
+  string keys "node_key.report_step.iens" and "node_key.iens", see
+  block_fs_driver_format_key(). That is the on disk format, and it
+  is what block_fs_sscanf_key() parses when the files are listed.
+
+  To avoid formatting a string key for every access, each bfs
+  instance keeps a binary index of the nodes it has seen. The
+  node_key is interned to a small integer id by the driver, and the
+  (key id, report_step, iens) triplet is packed into one 64-bit key.
+  That key is looked up in a dedicated open addressing hash table,
+  which holds the block_fs filename - formatted once - and whether
+  the file exists. All writes and unlinks of the block_fs instance go
+  through the driver, so has_node() and has_vector() queries for
+  nodes in the index are answered without calling into block_fs.
+
+  Keys which do not fit in the packed format fall back to the string
+  keys formatted for each access.
+*/
+
+#define NODE_INDEX_STEP_BITS   21
+#define NODE_INDEX_IENS_BITS   21
+#define NODE_INDEX_KEY_BITS    (64 - NODE_INDEX_STEP_BITS - NODE_INDEX_IENS_BITS)
+#define NODE_INDEX_VECTOR_STEP ((1 << NODE_INDEX_STEP_BITS) - 1)  /* The step field of vectors; node steps are stored as report_step + 1. */
+#define NODE_INDEX_INIT_SIZE   1024
+
+
+static node_slot_type * node_index_alloc_slots( size_t size ) {
+  node_slot_type * slots = util_calloc( size , sizeof * slots );
+  for (size_t i = 0; i < size; i++)
+    slots[i].filename = NULL;
+  return slots;
+}
+
+
+static void node_index_init( node_index_type * index ) {
+  pthread_rwlock_init( &index->lock , NULL );
+  index->size  = NODE_INDEX_INIT_SIZE;
+  index->count = 0;
+  index->slots = node_index_alloc_slots( index->size );
+}
+
+
+static void node_index_free_data( node_index_type * index ) {
+  for (size_t i = 0; i < index->size; i++)
+    free( index->slots[i].filename );
+  free( index->slots );
+  pthread_rwlock_destroy( &index->lock );
+}
+
+
+/* The splitmix64 finalizer; the packed keys are far from random. */
+
+static size_t node_index_hash( uint64_t key ) {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+  return (size_t) key;
+}
+
+
+/*
+  Returns the slot of @key, or the empty slot where @key should be
+  inserted; the calling scope must hold the lock.
+*/
+
+static node_slot_type * node_index_lookup__( const node_index_type * index , uint64_t key ) {
+  size_t mask = index->size - 1;
+  size_t i    = node_index_hash( key ) & mask;
+
+  while (index->slots[i].filename != NULL && index->slots[i].key != key)
+    i = (i + 1) & mask;
+
+  return &index->slots[i];
+}
+
+
+static void node_index_grow__( node_index_type * index ) {
+  node_slot_type * old_slots = index->slots;
+  size_t old_size = index->size;
+
+  index->size *= 2;
+  index->slots = node_index_alloc_slots( index->size );
+  for (size_t i = 0; i < old_size; i++) {
+    if (old_slots[i].filename != NULL)
+      *node_index_lookup__( index , old_slots[i].key ) = old_slots[i];
+  }
+  free( old_slots );
+}
+
+
+/*
+  Looks up @key; if the key is found the filename and the existence
+  flag are returned, otherwise NULL is returned. The filename is owned
+  by the index and is valid until the index is freed.
+*/
+
+static const char * node_index_get( node_index_type * index , uint64_t key , bool * exists) {
+  const char * filename;
+
+  pthread_rwlock_rdlock( &index->lock );
+  {
+    const node_slot_type * slot = node_index_lookup__( index , key );
+    filename = slot->filename;
+    if (filename != NULL)
+      *exists = slot->exists;
+  }
+  pthread_rwlock_unlock( &index->lock );
+  return filename;
+}
+
+
+/*
+  Inserts @key with the filename @filename, and takes ownership of
+  @filename. If another thread has inserted the key in the meantime
+  @filename is discarded and the existing slot is used. Returns the
+  filename stored in the index.
+*/
+
+static const char * node_index_insert( node_index_type * index , uint64_t key , char * filename , bool * exists) {
+  const char * index_filename;
+
+  pthread_rwlock_wrlock( &index->lock );
+  {
+    node_slot_type * slot = node_index_lookup__( index , key );
+    if (slot->filename == NULL) {
+      if (2 * (index->count + 1) > index->size) {
+        node_index_grow__( index );
+        slot = node_index_lookup__( index , key );
+      }
+      slot->key      = key;
+      slot->filename = filename;
+      slot->exists   = *exists;
+      index->count++;
+    } else {
+      free( filename );
+      *exists = slot->exists;
+    }
+    index_filename = slot->filename;
+  }
+  pthread_rwlock_unlock( &index->lock );
+  return index_filename;
+}
+
+
+static void node_index_set_exists( node_index_type * index , uint64_t key , bool exists) {
+  pthread_rwlock_wrlock( &index->lock );
+  {
+    node_slot_type * slot = node_index_lookup__( index , key );
+    if (slot->filename != NULL)
+      slot->exists = exists;
+  }
+  pthread_rwlock_unlock( &index->lock );
+}
+
+
 /*****************************************************************/
 
 static UTIL_SAFE_CAST_FUNCTION(bfs , BFS_TYPE_ID);
@@ -122,6 +327,7 @@ static UTIL_SAFE_CAST_FUNCTION(bfs , BFS_TYPE_ID);
 static void bfs_close( bfs_type * bfs ) {
   if (bfs->block_fs != NULL)
     block_fs_close( bfs->block_fs , false);
+  node_index_free_data( &bfs->node_index );
   free( bfs->mountfile );
   free( bfs );
 }
@@ -141,6 +347,7 @@ static bfs_type * bfs_alloc( const bfs_config_type * config ) {
   
   // New init
   fs->mountfile = NULL;
+  node_index_init( &fs->node_index );
   
   return fs;
 }
@@ -164,6 +371,7 @@ static void bfs_mount( bfs_type * bfs) {
                                   config->preload , 
                                   config->read_only,
                                   config->bfs_lock);
+  block_fs_set_async_write( bfs->block_fs , config->async_write );
 }
 
 
@@ -199,17 +407,92 @@ static block_fs_driver_type * block_fs_driver_safe_cast( void * __driver) {
   return driver;
 }
 
-static char * block_fs_driver_alloc_node_key( const block_fs_driver_type * driver , const char * node_key , int report_step , int iens) {
-  char * key = util_alloc_sprintf("%s.%d.%d" , node_key , report_step , iens);
-  return key;
+/*
+  The block_fs keys are "node_key.report_step.iens" for nodes and
+  "node_key.iens" for vectors. The keys of nodes which can not be
+  held in the binary node index are created for every load and
+  store, so the keys are formatted into a buffer supplied by the
+  calling scope with a simple integer formatting instead of
+  util_alloc_sprintf(). The key is only allocated on the heap if
+  node_key is too long for the buffer; the key must be released with
+  block_fs_driver_free_key().
+*/
+
+#define KEY_BUFFER_SIZE 256
+
+static char * key_append_int( char * ptr , int value ) {
+  char digits[16];
+  int num_digits = 0;
+  unsigned int uvalue;
+
+  if (value < 0) {
+    *ptr++ = '-';
+    uvalue = - (unsigned int) value;
+  } else
+    uvalue = value;
+
+  do {
+    digits[num_digits++] = '0' + uvalue % 10;
+    uvalue /= 10;
+  } while (uvalue > 0);
+
+  while (num_digits > 0)
+    *ptr++ = digits[--num_digits];
+
+  return ptr;
 }
 
 
-static char * block_fs_driver_alloc_vector_key( const block_fs_driver_type * driver , const char * node_key , int iens) {
-  char * key = util_alloc_sprintf("%s.%d" , node_key , iens);
+static char * block_fs_driver_format_key( char * buffer , const char * node_key , bool node , int report_step , int iens) {
+  size_t key_length = strlen( node_key );
+  size_t max_length = key_length + 2 * (12 + 1) + 1;
+  char * key        = (max_length <= KEY_BUFFER_SIZE) ? buffer : util_malloc( max_length );
+  char * ptr        = key;
+
+  memcpy( ptr , node_key , key_length );
+  ptr += key_length;
+  if (node) {
+    *ptr++ = '.';
+    ptr = key_append_int( ptr , report_step );
+  }
+  *ptr++ = '.';
+  ptr = key_append_int( ptr , iens );
+  *ptr = '\0';
+
   return key;
 }
 
+
+static void block_fs_driver_free_key( char * buffer , char * key ) {
+  if (key != buffer)
+    free( key );
+}
+
+
+/*
+  Parses the integer which ends at @end, and returns a pointer to the
+  '.' in front of it - or NULL if the text in front of @end is not
+  ".integer".
+*/
+
+static const char * block_fs_sscanf_key_int( const char * start , const char * end , int * value ) {
+  const char * ptr = end;
+  while ((ptr > start) && (ptr[-1] != '.'))
+    ptr--;
+
+  if ((ptr == start) || (ptr == end))
+    return NULL;
+  {
+    char * error_ptr;
+    long tmp_value = strtol( ptr , &error_ptr , 10 );
+    if (error_ptr != end)
+      return NULL;
+    *value = tmp_value;
+  }
+  return ptr - 1;
+}
+
+
 /**
    This function will take an input string, and try to to parse it as
    string.int.int, where string is the normal enkf key, and the two
@@ -223,25 +506,24 @@ static char * block_fs_driver_alloc_vector_key( const block_fs_driver_type * dri
 */
 
 bool block_fs_sscanf_key(const char * key , char ** config_key , int * __report_step , int * __iens) {
-  char ** tmp;
-  int num_items;
+  const char * end = &key[ strlen( key ) ];
+  const char * iens_dot;
+  const char * step_dot = NULL;
+  int report_step , iens;
 
   *config_key = NULL;
-  util_split_string(key , "." , &num_items , &tmp);  /* The key can contain additional '.' - can not use sscanf(). */
-  if (num_items >= 3) {
-    int report_step , iens;
-    if (util_sscanf_int(tmp[num_items - 2] , &report_step) && util_sscanf_int(tmp[num_items - 1] , &iens)) {
-      /* OK - all is hunkadory */
-      *__report_step = report_step;
-      *__iens        = iens;
-      *config_key    = util_alloc_joined_string((const char **) tmp , num_items - 2 , ".");  /* This must bee freed by the calling scope */
-      util_free_stringlist( tmp , num_items );
-      return true;
-    } else  
-      /* Failed to parse the two last items as integers. */
-      return false;
+  iens_dot = block_fs_sscanf_key_int( key , end , &iens );
+  if (iens_dot != NULL)
+    step_dot = block_fs_sscanf_key_int( key , iens_dot , &report_step );
+
+  if ((step_dot != NULL) && (step_dot > key)) {
+    /* OK - all is hunkadory */
+    *__report_step = report_step;
+    *__iens        = iens;
+    *config_key    = util_alloc_substring_copy( key , 0 , step_dot - key );  /* This must bee freed by the calling scope */
+    return true;
   } else
-    /* Did not have at least three items. */
+    /* Did not have at least three items, or failed to parse the two last items as integers. */
     return false;
 }
 
@@ -255,16 +537,130 @@ static bfs_type * block_fs_driver_get_fs( block_fs_driver_type * driver , int ie
 }
 
 
+/*
+  Returns the interned id of @node_key, or -1 if the id space of the
+  packed keys is exhausted.
+*/
+
+static int block_fs_driver_get_key_id( block_fs_driver_type * driver , const char * node_key ) {
+  int key_id = -1;
+
+  pthread_rwlock_rdlock( &driver->key_lock );
+  if (hash_has_key( driver->key_ids , node_key ))
+    key_id = hash_get_int( driver->key_ids , node_key );
+  pthread_rwlock_unlock( &driver->key_lock );
+
+  if (key_id < 0) {
+    pthread_rwlock_wrlock( &driver->key_lock );
+    if (hash_has_key( driver->key_ids , node_key ))
+      key_id = hash_get_int( driver->key_ids , node_key );
+    else if (hash_get_size( driver->key_ids ) < (1 << NODE_INDEX_KEY_BITS)) {
+      key_id = hash_get_size( driver->key_ids );
+      hash_insert_int( driver->key_ids , node_key , key_id );
+    }
+    pthread_rwlock_unlock( &driver->key_lock );
+  }
+
+  return key_id;
+}
+
+
+/*
+  Packs (key id, report_step, iens) into one 64-bit key; vectors use
+  the reserved step field NODE_INDEX_VECTOR_STEP. Returns false if the
+  values do not fit in the packed format.
+*/
+
+static bool block_fs_driver_pack_key( int key_id , bool node , int report_step , int iens , uint64_t * key) {
+  uint64_t step_field;
+
+  if (key_id < 0 || iens < 0 || iens >= (1 << NODE_INDEX_IENS_BITS))
+    return false;
+
+  if (node) {
+    if (report_step < -1 || report_step + 1 >= NODE_INDEX_VECTOR_STEP)
+      return false;
+    step_field = report_step + 1;
+  } else
+    step_field = NODE_INDEX_VECTOR_STEP;
+
+  *key = ((uint64_t) key_id << (NODE_INDEX_STEP_BITS + NODE_INDEX_IENS_BITS)) |
+         (step_field << NODE_INDEX_IENS_BITS) |
+         (uint64_t) iens;
+  return true;
+}
+
+
+/*
+  A reference to one node or vector in the block_fs instance of its
+  realisation. If the key could be packed the reference uses the
+  binary node index, otherwise the string key is formatted into
+  key_buffer. A reference must be released with node_ref_release().
+*/
+
+typedef struct {
+  bfs_type   * bfs;
+  bool         indexed;
+  uint64_t     key;
+  bool         exists;         /* Only valid for indexed references. */
+  const char * filename;
+  char       * string_key;     /* The formatted key of references which are not indexed. */
+  char         key_buffer[KEY_BUFFER_SIZE];
+} node_ref_type;
+
+
+static void block_fs_driver_init_ref( block_fs_driver_type * driver , node_ref_type * ref , const char * node_key , bool node , int report_step , int iens) {
+  ref->bfs        = block_fs_driver_get_fs( driver , iens );
+  ref->string_key = NULL;
+  ref->indexed    = block_fs_driver_pack_key( block_fs_driver_get_key_id( driver , node_key ) , node , report_step , iens , &ref->key );
+
+  if (ref->indexed) {
+    ref->filename = node_index_get( &ref->bfs->node_index , ref->key , &ref->exists );
+    if (ref->filename == NULL) {
+      char * key      = block_fs_driver_format_key( ref->key_buffer , node_key , node , report_step , iens );
+      char * filename = util_alloc_string_copy( key );
+
+      block_fs_driver_free_key( ref->key_buffer , key );
+      ref->exists   = block_fs_has_file( ref->bfs->block_fs , filename );
+      ref->filename = node_index_insert( &ref->bfs->node_index , ref->key , filename , &ref->exists );
+    }
+  } else {
+    ref->string_key = block_fs_driver_format_key( ref->key_buffer , node_key , node , report_step , iens );
+    ref->filename   = ref->string_key;
+  }
+}
+
+
+static void node_ref_release( node_ref_type * ref ) {
+  if (ref->string_key != NULL)
+    block_fs_driver_free_key( ref->key_buffer , ref->string_key );
+}
+
+
+static bool node_ref_has_file( const node_ref_type * ref ) {
+  if (ref->indexed)
+    return ref->exists;
+  else
+    return block_fs_has_file( ref->bfs->block_fs , ref->filename );
+}
+
+
+static void node_ref_set_exists( node_ref_type * ref , bool exists ) {
+  if (ref->indexed && (ref->exists != exists)) {
+    node_index_set_exists( &ref->bfs->node_index , ref->key , exists );
+    ref->exists = exists;
+  }
+}
+
+
 
 static void block_fs_driver_load_node(void * _driver , const char * node_key , int report_step , int iens ,  buffer_type * buffer) {
   block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
   {
-    char * key          = block_fs_driver_alloc_node_key( driver , node_key , report_step , iens );
-    bfs_type      * bfs = block_fs_driver_get_fs( driver , iens );
-    
-    block_fs_fread_realloc_buffer( bfs->block_fs , key , buffer);
-    
-    free( key );
+    node_ref_type ref;
+    block_fs_driver_init_ref( driver , &ref , node_key , true , report_step , iens );
+    block_fs_fread_realloc_buffer( ref.bfs->block_fs , ref.filename , buffer);
+    node_ref_release( &ref );
   }
 }
 
@@ -272,11 +668,10 @@ static void block_fs_driver_load_node(void * _driver , const char * node_key , i
 static void block_fs_driver_load_vector(void * _driver , const char * node_key , int iens ,  buffer_type * buffer) {
   block_fs_driver_type * driver = block_fs_driver_safe_cast( _driver );
   {
-    char * key          = block_fs_driver_alloc_vector_key( driver , node_key , iens );
-    bfs_type      * bfs = block_fs_driver_get_fs( driver , iens );
-    
-    block_fs_fread_realloc_buffer( bfs->block_fs , key , buffer);
-    free( key );
+    node_ref_type ref;
+    block_fs_driver_init_ref( driver , &ref , node_key , false , 0 , iens );
+    block_fs_fread_realloc_buffer( ref.bfs->block_fs , ref.filename , buffer);
+    node_ref_release( &ref );
   }
 }
 
@@ -286,10 +681,11 @@ static void block_fs_driver_save_node(void * _driver , const char * node_key , i
   block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
   block_fs_driver_assert_cast(driver);
   {
-    char * key     = block_fs_driver_alloc_node_key( driver , node_key , report_step , iens );
-    bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
-    block_fs_fwrite_buffer( bfs->block_fs , key , buffer);
-    free( key );
+    node_ref_type ref;
+    block_fs_driver_init_ref( driver , &ref , node_key , true , report_step , iens );
+    block_fs_fwrite_buffer( ref.bfs->block_fs , ref.filename , buffer);
+    node_ref_set_exists( &ref , true );
+    node_ref_release( &ref );
   }
 }
 
@@ -298,10 +694,69 @@ static void block_fs_driver_save_vector(void * _driver , const char * node_key ,
   block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
   block_fs_driver_assert_cast(driver);
   {
-    char * key     = block_fs_driver_alloc_vector_key( driver , node_key , iens );
-    bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
-    block_fs_fwrite_buffer( bfs->block_fs , key , buffer);
-    free( key );
+    node_ref_type ref;
+    block_fs_driver_init_ref( driver , &ref , node_key , false , 0 , iens );
+    block_fs_fwrite_buffer( ref.bfs->block_fs , ref.filename , buffer);
+    node_ref_set_exists( &ref , true );
+    node_ref_release( &ref );
+  }
+}
+
+/*
+  All the vectors belong to the same realisation, and therefore to the
+  same block_fs instance; they are written in one batch.
+*/
+
+static void block_fs_driver_save_vectors(void * _driver , int num_vectors , const char ** node_keys , int iens ,  buffer_type ** buffers) {
+  block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
+  block_fs_driver_assert_cast(driver);
+  {
+    node_ref_type * refs     = util_calloc( util_int_max( num_vectors , 1 ) , sizeof * refs );
+    const char ** filenames  = util_calloc( util_int_max( num_vectors , 1 ) , sizeof * filenames );
+    bfs_type * bfs           = block_fs_driver_get_fs( driver , iens );
+
+    for (int i = 0; i < num_vectors; i++) {
+      block_fs_driver_init_ref( driver , &refs[i] , node_keys[i] , false , 0 , iens );
+      filenames[i] = refs[i].filename;
+    }
+
+    block_fs_fwrite_buffers( bfs->block_fs , num_vectors , filenames , buffers );
+
+    for (int i = 0; i < num_vectors; i++) {
+      node_ref_set_exists( &refs[i] , true );
+      node_ref_release( &refs[i] );
+    }
+    free( filenames );
+    free( refs );
+  }
+}
+
+/*
+  The counterpart to block_fs_driver_save_vectors(); the vectors which
+  are not stored have found[i] set to false.
+*/
+
+static int block_fs_driver_load_vectors(void * _driver , int num_vectors , const char ** node_keys , int iens , buffer_type ** buffers , bool * found) {
+  block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
+  block_fs_driver_assert_cast(driver);
+  {
+    node_ref_type * refs     = util_calloc( util_int_max( num_vectors , 1 ) , sizeof * refs );
+    const char ** filenames  = util_calloc( util_int_max( num_vectors , 1 ) , sizeof * filenames );
+    bfs_type * bfs           = block_fs_driver_get_fs( driver , iens );
+    int num_read;
+
+    for (int i = 0; i < num_vectors; i++) {
+      block_fs_driver_init_ref( driver , &refs[i] , node_keys[i] , false , 0 , iens );
+      filenames[i] = refs[i].filename;
+    }
+
+    num_read = block_fs_fread_buffers( bfs->block_fs , num_vectors , filenames , buffers , found );
+
+    for (int i = 0; i < num_vectors; i++)
+      node_ref_release( &refs[i] );
+    free( filenames );
+    free( refs );
+    return num_read;
   }
 }
 
@@ -311,10 +766,11 @@ void block_fs_driver_unlink_node(void * _driver , const char * node_key , int re
   block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
   block_fs_driver_assert_cast(driver);
   {
-    char * key     = block_fs_driver_alloc_node_key( driver , node_key , report_step , iens );
-    bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
-    block_fs_unlink_file( bfs->block_fs , key );
-    free( key );
+    node_ref_type ref;
+    block_fs_driver_init_ref( driver , &ref , node_key , true , report_step , iens );
+    block_fs_unlink_file( ref.bfs->block_fs , ref.filename );
+    node_ref_set_exists( &ref , false );
+    node_ref_release( &ref );
   }
 }
 
@@ -322,10 +778,11 @@ void block_fs_driver_unlink_vector(void * _driver , const char * node_key , int
   block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
   block_fs_driver_assert_cast(driver);
   {
-    char * key     = block_fs_driver_alloc_vector_key( driver , node_key , iens );
-    bfs_type * bfs = block_fs_driver_get_fs( driver , iens );
-    block_fs_unlink_file( bfs->block_fs , key );
-    free( key );
+    node_ref_type ref;
+    block_fs_driver_init_ref( driver , &ref , node_key , false , 0 , iens );
+    block_fs_unlink_file( ref.bfs->block_fs , ref.filename );
+    node_ref_set_exists( &ref , false );
+    node_ref_release( &ref );
   }
 }
 
@@ -336,10 +793,11 @@ bool block_fs_driver_has_node(void * _driver , const char * node_key , int repor
   block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
   block_fs_driver_assert_cast(driver);
   {
-    char * key      = block_fs_driver_alloc_node_key( driver , node_key , report_step , iens );
-    bfs_type  * bfs = block_fs_driver_get_fs( driver , iens );
-    bool has_node   = block_fs_has_file( bfs->block_fs , key );
-    free( key );
+    node_ref_type ref;
+    bool has_node;
+    block_fs_driver_init_ref( driver , &ref , node_key , true , report_step , iens );
+    has_node = node_ref_has_file( &ref );
+    node_ref_release( &ref );
     return has_node;
   }
 }
@@ -349,10 +807,11 @@ bool block_fs_driver_has_vector(void * _driver , const char * node_key , int ien
   block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
   block_fs_driver_assert_cast(driver);
   {
-    char * key      = block_fs_driver_alloc_vector_key( driver , node_key , iens );
-    bfs_type  * bfs = block_fs_driver_get_fs( driver , iens );
-    bool has_node   = block_fs_has_file( bfs->block_fs , key );
-    free( key );
+    node_ref_type ref;
+    bool has_node;
+    block_fs_driver_init_ref( driver , &ref , node_key , false , 0 , iens );
+    has_node = node_ref_has_file( &ref );
+    node_ref_release( &ref );
     return has_node;
   }
 }
@@ -379,6 +838,8 @@ void block_fs_driver_free(void *_driver) {
     thread_pool_free( tp );
   }
   bfs_config_free( driver->config );
+  hash_free( driver->key_ids );
+  pthread_rwlock_destroy( &driver->key_lock );
   free( driver->fs_list );
   free(driver);
 }
@@ -411,6 +872,8 @@ static block_fs_driver_type * block_fs_driver_alloc(int num_fs) {
 
   driver->load_vector   = block_fs_driver_load_vector;
   driver->save_vector   = block_fs_driver_save_vector;
+  driver->save_vectors  = block_fs_driver_save_vectors;
+  driver->load_vectors  = block_fs_driver_load_vectors;
   driver->unlink_vector = block_fs_driver_unlink_vector;
   driver->has_vector    = block_fs_driver_has_vector;
 
@@ -420,6 +883,8 @@ static block_fs_driver_type * block_fs_driver_alloc(int num_fs) {
   driver->num_fs        = num_fs;
 
   driver->fs_list       = util_calloc( driver->num_fs , sizeof * driver->fs_list );
+  driver->key_ids       = hash_alloc_unlocked();
+  pthread_rwlock_init( &driver->key_lock , NULL );
   return driver;
 }
 
@@ -35,6 +35,7 @@
 #include <ert/util/arg_pack.h>
 
 #include <ert/enkf/block_fs_driver.h>
+#include <ert/enkf/field_block_driver.h>
 #include <ert/enkf/enkf_fs.h>
 #include <ert/enkf/enkf_defaults.h>
 #include <ert/enkf/fs_driver.h>
@@ -212,6 +213,7 @@
 #define MISFIT_ENSEMBLE_FILE      "misfit-ensemble"
 #define CASE_CONFIG_FILE          "case_config"
 #define CUSTOM_KW_CONFIG_SET_FILE "custom_kw_config_set"
+#define FIELD_BLOCK_PATH          "FieldBlocks"
 
 struct enkf_fs_struct {
   UTIL_TYPE_ID_DECLARATION;
@@ -225,6 +227,7 @@ struct enkf_fs_struct {
   fs_driver_type         * dynamic_forecast;
   fs_driver_type         * parameter;
   fs_driver_type         * index ;
+  field_block_driver_type * field_blocks;  /* The FIELD parameters; only for BLOCK_FS_FIELD_DRIVER_ID filesystems. */
 
   bool                        read_only;             /* Whether this filesystem has been mounted read-only. */
   time_map_type             * time_map;
@@ -299,6 +302,7 @@ static enkf_fs_type * enkf_fs_alloc_empty( const char * mount_point ) {
   fs->index                  = NULL;
   fs->parameter              = NULL;
   fs->dynamic_forecast       = NULL;
+  fs->field_blocks           = NULL;
   fs->read_only              = true;
   fs->mount_point            = util_alloc_string_copy( mount_point );
   fs->refcount               = 0;
@@ -482,6 +486,7 @@ enkf_fs_type * enkf_fs_create_fs( const char * mount_point, fs_driver_impl drive
     {
       switch( driver_id ) {
       case( BLOCK_FS_DRIVER_ID ):
+      case( BLOCK_FS_FIELD_DRIVER_ID ):
         enkf_fs_create_block_fs( stream , num_drivers , mount_point , arg );
         break;
       case( PLAIN_DRIVER_ID ):
@@ -661,6 +666,14 @@ enkf_fs_type * enkf_fs_mount( const char * mount_point ) {
       case( BLOCK_FS_DRIVER_ID ):
         fs = enkf_fs_mount_block_fs( stream , mount_point);
         break;
+      case( BLOCK_FS_FIELD_DRIVER_ID ):
+        fs = enkf_fs_mount_block_fs( stream , mount_point);
+        {
+          char * field_block_path = util_alloc_filename( mount_point , FIELD_BLOCK_PATH , NULL );
+          fs->field_blocks = field_block_driver_alloc( field_block_path , fs->read_only );
+          free( field_block_path );
+        }
+        break;
       case( PLAIN_DRIVER_ID ):
         fs = enkf_fs_mount_plain( stream , mount_point );
         break;
@@ -720,6 +733,8 @@ static void enkf_fs_umount( enkf_fs_type * fs ) {
       enkf_fs_free_driver( fs->dynamic_forecast );
       enkf_fs_free_driver( fs->parameter );
       enkf_fs_free_driver( fs->index );
+      if (fs->field_blocks)
+        field_block_driver_free( fs->field_blocks );
 
       if (fs->lock_fd > 0) {
         close( fs->lock_fd );  // Closing the lock_file file descriptor - and releasing the lock.
@@ -786,6 +801,8 @@ void enkf_fs_fsync( enkf_fs_type * fs ) {
   enkf_fs_fsync_driver( fs->parameter );
   enkf_fs_fsync_driver( fs->dynamic_forecast );
   enkf_fs_fsync_driver( fs->index );
+  if (fs->field_blocks)
+    field_block_driver_fsync( fs->field_blocks );
 
   enkf_fs_fsync_time_map( fs );
   enkf_fs_fsync_cases_config( fs) ;
@@ -825,10 +842,76 @@ void enkf_fs_fread_vector(enkf_fs_type * enkf_fs , buffer_type * buffer ,
 }
 
 
+/**
+   Loads the vectors of several nodes with the same @var_type for one
+   realisation; the vectors which are not stored are skipped and have
+   found[i] set to false. Drivers which do not support reading several
+   vectors in one batch get one has_vector() and load_vector() call
+   for each vector. The return value is the number of vectors loaded.
+*/
+
+int enkf_fs_fread_vectors(enkf_fs_type * enkf_fs , int num_vectors , buffer_type ** buffers , const char ** node_keys , enkf_var_type var_type , int iens , bool * found) {
+  int num_read = 0;
+
+  if (num_vectors > 0) {
+    fs_driver_type * driver = fs_driver_safe_cast( enkf_fs_select_driver(enkf_fs , var_type , node_keys[0]) );
+    if (driver->load_vectors != NULL)
+      num_read = driver->load_vectors( driver , num_vectors , node_keys , iens , buffers , found );
+    else {
+      for (int i = 0; i < num_vectors; i++) {
+        found[i] = driver->has_vector( driver , node_keys[i] , iens );
+        if (found[i]) {
+          buffer_rewind( buffers[i] );
+          driver->load_vector( driver , node_keys[i] , iens , buffers[i] );
+          num_read++;
+        }
+      }
+    }
+  }
+  return num_read;
+}
+
+
 
 bool enkf_fs_has_node(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int report_step , int iens) {
-  fs_driver_type * driver = fs_driver_safe_cast(enkf_fs_select_driver(enkf_fs , var_type , node_key));
-  return driver->has_node(driver , node_key , report_step , iens );
+  if ((var_type == PARAMETER) && (report_step == 0) && enkf_fs->field_blocks && field_block_driver_has_key( enkf_fs->field_blocks , node_key ))
+    return field_block_driver_has_node( enkf_fs->field_blocks , node_key , iens );
+  else {
+    fs_driver_type * driver = fs_driver_safe_cast(enkf_fs_select_driver(enkf_fs , var_type , node_key));
+    return driver->has_node(driver , node_key , report_step , iens );
+  }
+}
+
+
+/**
+   In a BLOCK_FS_FIELD_DRIVER_ID filesystem the FIELD parameters are
+   stored by the field_block_driver, as raw data and not through a
+   buffer; the function returns NULL for other filesystems. The
+   update uses the driver directly to serialize a range of cells for
+   many realisations at once.
+*/
+
+field_block_driver_type * enkf_fs_get_field_block_driver( const enkf_fs_type * fs ) {
+  return fs->field_blocks;
+}
+
+
+void enkf_fs_fwrite_field_node(enkf_fs_type * enkf_fs , const char * node_key , int iens , const void * data , size_t byte_size) {
+  if (enkf_fs->read_only)
+    util_abort("%s: attempt to write to read_only filesystem mounted at:%s - aborting. \n",__func__ , enkf_fs->mount_point);
+
+  if (enkf_fs->field_blocks == NULL)
+    util_abort("%s: the filesystem mounted at:%s does not store field blocks \n",__func__ , enkf_fs->mount_point);
+
+  field_block_driver_save_node( enkf_fs->field_blocks , node_key , iens , data , byte_size );
+}
+
+
+void enkf_fs_fread_field_node(enkf_fs_type * enkf_fs , const char * node_key , int iens , void * data , size_t byte_size) {
+  if (enkf_fs->field_blocks == NULL)
+    util_abort("%s: the filesystem mounted at:%s does not store field blocks \n",__func__ , enkf_fs->mount_point);
+
+  field_block_driver_load_node( enkf_fs->field_blocks , node_key , iens , data , byte_size );
 }
 
 
@@ -871,6 +954,28 @@ void enkf_fs_fwrite_vector(enkf_fs_type * enkf_fs , buffer_type * buffer , const
 
 
 
+/**
+   Stores the vectors of several nodes with the same @var_type for one
+   realisation. Drivers which do not support writing several vectors
+   in one batch get one save_vector() call for each vector.
+*/
+
+void enkf_fs_fwrite_vectors(enkf_fs_type * enkf_fs , int num_vectors , buffer_type ** buffers , const char ** node_keys , enkf_var_type var_type , int iens ) {
+  if (enkf_fs->read_only)
+    util_abort("%s: attempt to write to read_only filesystem mounted at:%s - aborting. \n",__func__ , enkf_fs->mount_point);
+
+  if (num_vectors > 0) {
+    fs_driver_type * driver = fs_driver_safe_cast( enkf_fs_select_driver(enkf_fs , var_type , node_keys[0]) );
+    if (driver->save_vectors != NULL)
+      driver->save_vectors( driver , num_vectors , node_keys , iens , buffers );
+    else {
+      for (int i = 0; i < num_vectors; i++)
+        driver->save_vector( driver , node_keys[i] , iens , buffers[i] );
+    }
+  }
+}
+
+
 /*****************************************************************/
 
 
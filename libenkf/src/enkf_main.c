@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <signal.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <pthread.h>
 #include <dirent.h>
@@ -40,6 +41,7 @@
 #include <ert/util/hash.h>
 #include <ert/util/path_fmt.h>
 #include <ert/util/thread_pool.h>
+#include <ert/util/timer.h>
 #include <ert/util/arg_pack.h>
 #include <ert/util/msg.h>
 #include <ert/util/stringlist.h>
@@ -640,6 +642,49 @@ static int __get_active_size(const ensemble_config_type * ensemble_config , enkf
 
 
 /*****************************************************************/
+/**
+   Single precision storage of the A matrix in the pipelined update:
+   column major with @rows as leading dimension. The nodes are still
+   serialized through a normal double matrix, one column at a time,
+   and the column is then converted to float.
+*/
+
+typedef struct {
+  float * data;
+  int     rows;
+  int     columns;
+} float_block_type;
+
+
+static float_block_type * float_block_alloc( int rows , int columns ) {
+  float_block_type * block = util_malloc( sizeof * block );
+  block->rows    = rows;
+  block->columns = columns;
+  block->data    = util_calloc( util_size_t_max( (size_t) rows * columns , 1 ) , sizeof * block->data );
+  return block;
+}
+
+
+/* The content is not preserved. */
+static void float_block_resize( float_block_type * block , int rows ) {
+  free( block->data );
+  block->rows = rows;
+  block->data = util_calloc( util_size_t_max( (size_t) rows * block->columns , 1 ) , sizeof * block->data );
+}
+
+
+/* The rows * columns product can be larger than INT_MAX. */
+static float * float_block_iget_ptr( const float_block_type * block , int row , int column ) {
+  return &block->data[ (size_t) row + (size_t) column * block->rows ];
+}
+
+
+static void float_block_free( float_block_type * block ) {
+  free( block->data );
+  free( block );
+}
+
+
 /**
    Helper struct used to pass information to the multithreaded
    serialize / deserialize functions.
@@ -658,10 +703,176 @@ typedef struct {
   int                       row_offset;
   const active_list_type  * active_list;
   matrix_type             * A;
+  float_block_type        * A_float;  /* Single precision storage used instead of A; NULL => use A. */
+  int                       rows;     /* The number of rows serialized for the node; only used with A_float. */
   const int_vector_type   * iens_active_index;
+  bool                      load;     /* Load the node before serializing. */
+  bool                      store;    /* Store the node after deserializing. */
 } serialize_info_type;
 
 
+/*****************************************************************/
+/**
+   Serialization of FIELD parameters stored by a field_block_driver;
+   see field_block_driver.c. Instead of loading the complete field
+   for one realisation at a time, the active cells are read for all
+   the realisations of the job at once, one block of cells at a time,
+   directly into the rows of A; deserialize is the reverse. The
+   enkf_node instances of the ensemble are not used.
+
+   The field block path is only used when the node is stored in field
+   blocks in the source case and the target case also has a field
+   block driver; the same decision is made when serializing and
+   deserializing, otherwise the node is serialized and deserialized
+   one realisation at a time. Realisations which have not yet been
+   stored in the target case are copied from the source case before
+   the updated rows are written.
+*/
+
+static double field_block_iget( const char * data , ecl_type_enum ecl_type , int index ) {
+  if (ecl_type == ECL_FLOAT_TYPE)
+    return ((const float *) data)[index];
+  else
+    return ((const double *) data)[index];
+}
+
+
+static void field_block_iset( char * data , ecl_type_enum ecl_type , int index , double value ) {
+  if (ecl_type == ECL_FLOAT_TYPE)
+    ((float *) data)[index] = value;
+  else
+    ((double *) data)[index] = value;
+}
+
+
+static bool serialize_use_field_blocks( const serialize_info_type * info ) {
+  field_block_driver_type * src_driver    = enkf_fs_get_field_block_driver( info->src_fs );
+  field_block_driver_type * target_driver = enkf_fs_get_field_block_driver( info->target_fs );
+
+  if ((src_driver == NULL) || (target_driver == NULL) || (info->iens1 == info->iens2))
+    return false;
+
+  {
+    const enkf_config_node_type * config_node = enkf_node_get_config( enkf_state_get_node( info->ensemble[ info->iens1 ] , info->key ));
+    return ((enkf_config_node_get_impl_type( config_node ) == FIELD) &&
+            (enkf_config_node_get_var_type( config_node ) == PARAMETER) &&
+            field_block_driver_has_key( src_driver , info->key ));
+  }
+}
+
+
+static void field_block_seed_members( const serialize_info_type * info , const int * columns , size_t byte_size ) {
+  field_block_driver_type * src_driver    = enkf_fs_get_field_block_driver( info->src_fs );
+  field_block_driver_type * target_driver = enkf_fs_get_field_block_driver( info->target_fs );
+  void * data = NULL;
+
+  for (int iens = info->iens1; iens < info->iens2; iens++) {
+    if ((columns[iens - info->iens1] >= 0) && !field_block_driver_has_node( target_driver , info->key , iens )) {
+      if (data == NULL)
+        data = util_malloc( byte_size );
+      field_block_driver_load_node( src_driver , info->key , iens , data , byte_size );
+      field_block_driver_save_node( target_driver , info->key , iens , data , byte_size );
+    }
+  }
+  free( data );
+}
+
+
+static void serialize_field_blocks( const serialize_info_type * info , bool deserialize ) {
+  enkf_fs_type * fs = deserialize ? info->target_fs : info->src_fs;
+  field_block_driver_type * driver = enkf_fs_get_field_block_driver( fs );
+
+  {
+    const enkf_config_node_type * config_node = enkf_node_get_config( enkf_state_get_node( info->ensemble[ info->iens1 ] , info->key ));
+    {
+      const field_config_type * field_config = enkf_config_node_get_ref( config_node );
+      const int data_size     = field_config_get_data_size_from_grid( field_config );
+      const int sizeof_ctype  = field_config_get_sizeof_ctype( field_config );
+      const ecl_type_enum ecl_type = field_config_get_ecl_type( field_config );
+      const int block_cells   = field_block_driver_get_block_size( enkf_fs_get_field_block_driver( info->src_fs ) , info->key ) / sizeof_ctype;
+      const int num_members   = info->iens2 - info->iens1;
+      const int * active_list = active_list_get_active( info->active_list );
+      const int active_size   = active_list_get_active_size( info->active_list , data_size );
+      char  * scratch         = util_malloc( (size_t) num_members * block_cells * sizeof_ctype );
+      void ** member_data     = util_calloc( num_members , sizeof * member_data );
+      int   * columns         = util_calloc( num_members , sizeof * columns );
+      int row1 = 0;
+
+      for (int m = 0; m < num_members; m++) {
+        columns[m]     = int_vector_iget( info->iens_active_index , info->iens1 + m );
+        member_data[m] = (columns[m] >= 0) ? &scratch[ (size_t) m * block_cells * sizeof_ctype ] : NULL;
+      }
+
+      if (deserialize)
+        field_block_seed_members( info , columns , (size_t) data_size * sizeof_ctype );
+
+      while (row1 < active_size) {
+        int first_cell = active_list ? active_list[row1] : row1;
+        int block      = first_cell / block_cells;
+        int min_cell   = first_cell;
+        int max_cell   = first_cell;
+        int row2       = row1 + 1;
+
+        /* The consecutive rows with cells in the same block. */
+        while (row2 < active_size) {
+          int cell = active_list ? active_list[row2] : row2;
+          if ((cell / block_cells) != block)
+            break;
+          min_cell = util_int_min( min_cell , cell );
+          max_cell = util_int_max( max_cell , cell );
+          row2++;
+        }
+
+        {
+          size_t offset = (size_t) min_cell * sizeof_ctype;
+          size_t size   = (size_t) (max_cell - min_cell + 1) * sizeof_ctype;
+
+          /* When deserializing a range with cells which are not updated the range must be read first. */
+          if (!deserialize || ((max_cell - min_cell + 1) != (row2 - row1)))
+            field_block_driver_load_range( driver , info->key , offset , size , info->iens1 , info->iens2 , member_data );
+
+          for (int m = 0; m < num_members; m++) {
+            char * data = member_data[m];
+            if (data) {
+              for (int row = row1; row < row2; row++) {
+                int index = (active_list ? active_list[row] : row) - min_cell;
+                if (info->A_float) {
+                  float * A_value = float_block_iget_ptr( info->A_float , info->row_offset + row , columns[m] );
+                  if (deserialize)
+                    field_block_iset( data , ecl_type , index , *A_value );
+                  else
+                    *A_value = field_block_iget( data , ecl_type , index );
+                } else {
+                  if (deserialize)
+                    field_block_iset( data , ecl_type , index , matrix_iget( info->A , info->row_offset + row , columns[m] ));
+                  else
+                    matrix_iset( info->A , info->row_offset + row , columns[m] , field_block_iget( data , ecl_type , index ));
+                }
+              }
+            }
+          }
+
+          if (deserialize)
+            field_block_driver_save_range( driver , info->key , offset , size , info->iens1 , info->iens2 , member_data );
+        }
+        row1 = row2;
+      }
+
+      if (deserialize) {
+        for (int m = 0; m < num_members; m++) {
+          if (columns[m] >= 0)
+            state_map_update_undefined( enkf_fs_get_state_map( fs ) , info->iens1 + m , STATE_INITIALIZED );
+        }
+      }
+
+      free( columns );
+      free( member_data );
+      free( scratch );
+    }
+  }
+}
+
+
 static void serialize_node( enkf_fs_type * fs ,
                             enkf_state_type ** ensemble ,
                             const char * key ,
@@ -670,17 +881,26 @@ static void serialize_node( enkf_fs_type * fs ,
                             int row_offset ,
                             int column,
                             const active_list_type * active_list,
+                            bool load,
                             matrix_type * A) {
 
   enkf_node_type * node = enkf_state_get_node( ensemble[iens] , key);
   node_id_type node_id = {.report_step = report_step, .iens = iens  };
-  enkf_node_serialize( node , fs , node_id , active_list , A , row_offset , column);
+  if (load)
+    enkf_node_serialize( node , fs , node_id , active_list , A , row_offset , column);
+  else
+    enkf_node_serialize__( node , node_id , active_list , A , row_offset , column);
 }
 
 
 static void * serialize_nodes_mt( void * arg ) {
   serialize_info_type * info = (serialize_info_type *) arg;
   int iens;
+  if (serialize_use_field_blocks( info )) {
+    serialize_field_blocks( info , false );
+    return NULL;
+  }
+
   for (iens = info->iens1; iens < info->iens2; iens++) {
     int column = int_vector_iget( info->iens_active_index , iens);
     if (column >= 0)
@@ -692,31 +912,72 @@ static void * serialize_nodes_mt( void * arg ) {
                       info->row_offset ,
                       column,
                       info->active_list ,
+                      info->load ,
                       info->A );
   }
   return NULL;
 }
 
 
-static void enkf_main_serialize_node( const char * node_key ,
-                                      const active_list_type * active_list ,
-                                      int row_offset ,
-                                      thread_pool_type * work_pool ,
-                                      serialize_info_type * serialize_info) {
+/*
+  Serialize into the float storage: each node is serialized into a
+  double column and then converted to float; a float FIELD therefore
+  ends up in A_float without any loss of precision.
+*/
+
+static void * serialize_nodes_float_mt( void * arg ) {
+  serialize_info_type * info = (serialize_info_type *) arg;
+  if (serialize_use_field_blocks( info )) {
+    serialize_field_blocks( info , false );
+    return NULL;
+  }
+
+  float_block_type * A_float = info->A_float;
+  matrix_type * column_A = matrix_alloc( info->rows , 1 );
+  const double * column_data = matrix_get_data( column_A );
+
+  for (int iens = info->iens1; iens < info->iens2; iens++) {
+    int column = int_vector_iget( info->iens_active_index , iens);
+    if (column >= 0) {
+      float * A_column = float_block_iget_ptr( A_float , info->row_offset , column );
+
+      serialize_node( info->src_fs , info->ensemble , info->key , iens , info->report_step , 0 , 0 , info->active_list , info->load , column_A );
+      for (int i = 0; i < info->rows; i++)
+        A_column[i] = column_data[i];
+    }
+  }
+  matrix_free( column_A );
+  return NULL;
+}
+
+
+/**
+   Adds one job for each of the realisation ranges in @serialize_info
+   to the running @work_pool, serializing or deserializing the node
+   @key. The job arguments are copied into @jobs, which must be kept
+   alive until the work_pool has been joined; that way the jobs for
+   several nodes can be added before one common join.
+*/
+
+static void enkf_main_add_node_jobs( serialize_info_type * jobs ,
+                                     void * (*job_func) (void *) ,
+                                     const char * key ,
+                                     const active_list_type * active_list ,
+                                     int row_offset ,
+                                     thread_pool_type * work_pool ,
+                                     const serialize_info_type * serialize_info) {
 
-  /* Multithreaded serializing*/
   const int num_cpu_threads = thread_pool_get_max_running( work_pool );
   int icpu;
 
-  thread_pool_restart( work_pool );
   for (icpu = 0; icpu < num_cpu_threads; icpu++) {
-    serialize_info[icpu].key         = node_key;
-    serialize_info[icpu].active_list = active_list;
-    serialize_info[icpu].row_offset  = row_offset;
+    jobs[icpu]             = serialize_info[icpu];
+    jobs[icpu].key         = key;
+    jobs[icpu].active_list = active_list;
+    jobs[icpu].row_offset  = row_offset;
 
-    thread_pool_add_job( work_pool , serialize_nodes_mt , &serialize_info[icpu]);
+    thread_pool_add_job( work_pool , job_func , &jobs[icpu]);
   }
-  thread_pool_join( work_pool );
 }
 
 
@@ -724,6 +985,11 @@ static void enkf_main_serialize_node( const char * node_key ,
 /**
    The return value is the number of rows in the serialized
    A matrix.
+
+   The layout of the A matrix is determined, and the matrix resized,
+   before any node is serialized; after that all the nodes are
+   serialized with one common join at the end, i.e. there is no
+   barrier between the different nodes.
 */
 
 static int enkf_main_serialize_dataset( const ensemble_config_type * ens_config ,
@@ -738,6 +1004,8 @@ static int enkf_main_serialize_dataset( const ensemble_config_type * ens_config
   matrix_type * A   = serialize_info->A;
   stringlist_type * update_keys = local_dataset_alloc_keys( dataset );
   const int num_kw  = stringlist_get_size( update_keys );
+  const int num_cpu_threads = thread_pool_get_max_running( work_pool );
+  serialize_info_type * jobs = util_calloc( num_kw * num_cpu_threads , sizeof * jobs );
   int ens_size      = matrix_get_columns( A );
   int current_row   = 0;
 
@@ -755,20 +1023,25 @@ static int enkf_main_serialize_dataset( const ensemble_config_type * ens_config
       enkf_fs_type * src_fs = serialize_info->src_fs;
       active_size[ikw] = __get_active_size( ens_config , src_fs , key , report_step , active_list );
       row_offset[ikw]  = current_row;
+      current_row += active_size[ikw];
+    }
+  }
 
-      {
-        int matrix_rows = matrix_get_rows( A );
-        if ((active_size[ikw] + current_row) > matrix_rows)
-          matrix_resize( A , matrix_rows + 2 * active_size[ikw] , ens_size , true );
-      }
+  if (current_row > matrix_get_rows( A ))
+    matrix_resize( A , current_row , ens_size , false );
 
-      if (active_size[ikw] > 0) {
-        enkf_main_serialize_node( key , active_list , row_offset[ikw] , work_pool , serialize_info );
-        current_row += active_size[ikw];
-      }
+  thread_pool_restart( work_pool );
+  for (int ikw=0; ikw < num_kw; ikw++) {
+    if (active_size[ikw] > 0) {
+      const char * key = stringlist_iget(update_keys , ikw);
+      const active_list_type * active_list = local_dataset_get_node_active_list( dataset , key );
+      enkf_main_add_node_jobs( &jobs[ikw * num_cpu_threads] , serialize_nodes_mt , key , active_list , row_offset[ikw] , work_pool , serialize_info );
     }
   }
+  thread_pool_join( work_pool );
+
   matrix_shrink_header( A , current_row , ens_size );
+  free( jobs );
   stringlist_free( update_keys );
   return matrix_get_rows( A );
 }
@@ -781,12 +1054,16 @@ static void deserialize_node( enkf_fs_type            * fs,
                               int row_offset ,
                               int column,
                               const active_list_type * active_list,
+                              bool store,
                               matrix_type * A) {
 
   enkf_node_type * node = enkf_state_get_node( ensemble[iens] , key);
   node_id_type node_id = { .report_step = target_step , .iens = iens };
-  enkf_node_deserialize(node , fs , node_id , active_list , A , row_offset , column);
-  state_map_update_undefined(enkf_fs_get_state_map(fs) , iens , STATE_INITIALIZED);
+  if (store) {
+    enkf_node_deserialize(node , fs , node_id , active_list , A , row_offset , column);
+    state_map_update_undefined(enkf_fs_get_state_map(fs) , iens , STATE_INITIALIZED);
+  } else
+    enkf_node_deserialize__(node , node_id , active_list , A , row_offset , column);
 }
 
 
@@ -794,15 +1071,46 @@ static void deserialize_node( enkf_fs_type            * fs,
 static void * deserialize_nodes_mt( void * arg ) {
   serialize_info_type * info = (serialize_info_type *) arg;
   int iens;
+  if (serialize_use_field_blocks( info )) {
+    serialize_field_blocks( info , true );
+    return NULL;
+  }
+
   for (iens = info->iens1; iens < info->iens2; iens++) {
     int column = int_vector_iget( info->iens_active_index , iens );
     if (column >= 0)
-      deserialize_node( info->target_fs , info->ensemble , info->key , iens , info->target_step , info->row_offset , column, info->active_list , info->A );
+      deserialize_node( info->target_fs , info->ensemble , info->key , iens , info->target_step , info->row_offset , column, info->active_list , info->store , info->A );
   }
   return NULL;
 }
 
 
+static void * deserialize_nodes_float_mt( void * arg ) {
+  serialize_info_type * info = (serialize_info_type *) arg;
+  if (serialize_use_field_blocks( info )) {
+    serialize_field_blocks( info , true );
+    return NULL;
+  }
+
+  float_block_type * A_float = info->A_float;
+  matrix_type * column_A = matrix_alloc( info->rows , 1 );
+  double * column_data = matrix_get_data( column_A );
+
+  for (int iens = info->iens1; iens < info->iens2; iens++) {
+    int column = int_vector_iget( info->iens_active_index , iens );
+    if (column >= 0) {
+      const float * A_column = float_block_iget_ptr( A_float , info->row_offset , column );
+
+      for (int i = 0; i < info->rows; i++)
+        column_data[i] = A_column[i];
+      deserialize_node( info->target_fs , info->ensemble , info->key , iens , info->target_step , 0 , 0 , info->active_list , info->store , column_A );
+    }
+  }
+  matrix_free( column_A );
+  return NULL;
+}
+
+
 static void enkf_main_deserialize_dataset( ensemble_config_type * ensemble_config ,
                                            const local_dataset_type * dataset ,
                                            const int * active_size ,
@@ -810,9 +1118,13 @@ static void enkf_main_deserialize_dataset( ensemble_config_type * ensemble_confi
                                            serialize_info_type * serialize_info ,
                                            thread_pool_type * work_pool ) {
 
-  int num_cpu_threads = thread_pool_get_max_running( work_pool );
   stringlist_type * update_keys = local_dataset_alloc_keys( dataset );
-  for (int i = 0; i < stringlist_get_size( update_keys ); i++) {
+  const int num_kw  = stringlist_get_size( update_keys );
+  const int num_cpu_threads = thread_pool_get_max_running( work_pool );
+  serialize_info_type * jobs = util_calloc( num_kw * num_cpu_threads , sizeof * jobs );
+
+  thread_pool_restart( work_pool );
+  for (int i = 0; i < num_kw; i++) {
     const char             * key         = stringlist_iget(update_keys , i);
     enkf_config_node_type * config_node  = ensemble_config_get_node( ensemble_config , key );
     if ((serialize_info[0].run_mode == SMOOTHER_UPDATE) && (enkf_config_node_get_var_type( config_node ) != PARAMETER))
@@ -825,23 +1137,390 @@ static void enkf_main_deserialize_dataset( ensemble_config_type * ensemble_confi
     else {
       if (active_size[i] > 0) {
         const active_list_type * active_list      = local_dataset_get_node_active_list( dataset , key );
+        enkf_main_add_node_jobs( &jobs[i * num_cpu_threads] , deserialize_nodes_mt , key , active_list , row_offset[i] , work_pool , serialize_info );
+      }
+    }
+  }
+  thread_pool_join( work_pool );
 
-        {
-          /* Multithreaded */
-          int icpu;
-          thread_pool_restart( work_pool );
-          for (icpu = 0; icpu < num_cpu_threads; icpu++) {
-            serialize_info[icpu].key         = key;
-            serialize_info[icpu].active_list = active_list;
-            serialize_info[icpu].row_offset  = row_offset[i];
-
-            thread_pool_add_job( work_pool , deserialize_nodes_mt , &serialize_info[icpu]);
-          }
-          thread_pool_join( work_pool );
+  free( jobs );
+  stringlist_free( update_keys );
+}
+
+
+/*****************************************************************/
+/**
+   Wall time used in the different phases of the update of one
+   ministep; written to the log when the update is complete. In the
+   pipelined update the phases overlap, for that part the total wall
+   time is recorded along with the thread time spent in each phase.
+*/
+
+typedef enum {
+  PIPELINE_SERIALIZE   = 0,
+  PIPELINE_MULTIPLY    = 1,
+  PIPELINE_DESERIALIZE = 2,
+  PIPELINE_COMPLETE    = 3
+} pipeline_stage_enum;
+
+
+typedef struct {
+  timer_type * serialize;
+  timer_type * module;       /* initX() or updateA() in the analysis module. */
+  timer_type * matmul;       /* A = A*X */
+  timer_type * deserialize;
+  timer_type * pipeline;
+  double       task_time[PIPELINE_COMPLETE];
+} update_timer_type;
+
+
+static update_timer_type * update_timer_alloc( ) {
+  update_timer_type * timer = util_malloc( sizeof * timer );
+  timer->serialize   = timer_alloc( true );
+  timer->module      = timer_alloc( true );
+  timer->matmul      = timer_alloc( true );
+  timer->deserialize = timer_alloc( true );
+  timer->pipeline    = timer_alloc( true );
+  for (int stage = 0; stage < PIPELINE_COMPLETE; stage++)
+    timer->task_time[stage] = 0;
+  return timer;
+}
+
+
+static void update_timer_free( update_timer_type * timer ) {
+  timer_free( timer->serialize );
+  timer_free( timer->module );
+  timer_free( timer->matmul );
+  timer_free( timer->deserialize );
+  timer_free( timer->pipeline );
+  free( timer );
+}
+
+
+static void update_timer_log( const update_timer_type * timer , const char * ministep_name , int num_threads ) {
+  ert_log_add_fmt_message( 1 , NULL , "Update of ministep:%s with %d threads - serialize:%.3fs  module:%.3fs  A*X:%.3fs  deserialize:%.3fs  pipelined:%.3fs (thread time serialize:%.3fs  A*X:%.3fs  deserialize:%.3fs)",
+                           ministep_name , num_threads ,
+                           timer_get_total_time( timer->serialize ) ,
+                           timer_get_total_time( timer->module ) ,
+                           timer_get_total_time( timer->matmul ) ,
+                           timer_get_total_time( timer->deserialize ) ,
+                           timer_get_total_time( timer->pipeline ) ,
+                           timer->task_time[ PIPELINE_SERIALIZE ] ,
+                           timer->task_time[ PIPELINE_MULTIPLY ] ,
+                           timer->task_time[ PIPELINE_DESERIALIZE ]);
+}
+
+
+/*****************************************************************/
+/**
+   Pipelined update of a set of rows in the A matrix, when X has been
+   calculated up front, i.e. when the analysis module neither uses
+   nor updates the A matrix directly.
+
+   The rows are organized in segments, one for each node. The work is
+   split in tasks: serialize of one segment for one range of
+   realisations, multiplication of a range of rows of one segment with
+   X, and deserialize of one segment for one range of realisations.
+   Since A = A*X can be evaluated row by row the rows of one segment
+   can be multiplied as soon as that segment has been serialized for
+   all realisations, and deserialized as soon as all its rows have
+   been multiplied. There is no barrier between the segments, so
+   loading one node from storage overlaps with the multiplication and
+   storing of the other nodes.
+
+   The tasks are run by one worker job for each thread in the
+   work_pool; the workers pick the next ready task from the segments
+   under a common mutex, preferring multiply and deserialize tasks so
+   that the segments are completed in order.
+*/
+
+#define PIPELINE_MIN_MULTIPLY_ROWS 256
+
+typedef struct {
+  const char             * key;
+  const active_list_type * active_list;
+  active_list_type       * subset;      /* Owned by the segment; NULL when the whole node is in one block. */
+  int                      row_offset;
+  int                      rows;
+  bool                     load;
+  bool                     store;
+} row_segment_type;
+
+
+typedef struct {
+  const row_segment_type * segment;
+  pipeline_stage_enum      stage;
+  int                      num_tasks;      /* The number of tasks in the current stage. */
+  int                      next_task;      /* The next task in the current stage which has not been started. */
+  int                      pending;        /* The number of tasks in the current stage which have not completed. */
+  int                      multiply_rows;  /* The number of rows in one multiply task. */
+} pipeline_segment_type;
+
+
+typedef struct {
+  pthread_mutex_t          mutex;
+  pthread_cond_t           cond;
+  pipeline_segment_type  * segments;
+  int                      num_segments;
+  int                      num_complete;
+  int                      num_chunks;     /* The number of realisation ranges in serialize_info. */
+  const matrix_type      * X;
+  serialize_info_type    * serialize_info;
+  double                   task_time[PIPELINE_COMPLETE];
+} update_pipeline_type;
+
+
+static void pipeline_segment_set_stage( pipeline_segment_type * pipeline_segment , pipeline_stage_enum stage , int num_chunks) {
+  pipeline_segment->stage     = stage;
+  pipeline_segment->next_task = 0;
+  if (stage == PIPELINE_COMPLETE)
+    pipeline_segment->num_tasks = 0;
+  else if (stage == PIPELINE_MULTIPLY)
+    pipeline_segment->num_tasks = (pipeline_segment->segment->rows + pipeline_segment->multiply_rows - 1) / pipeline_segment->multiply_rows;
+  else
+    pipeline_segment->num_tasks = num_chunks;
+  pipeline_segment->pending = pipeline_segment->num_tasks;
+}
+
+
+/*
+  Must be called with the pipeline mutex held; returns NULL if no
+  task is ready to run.
+*/
+
+static pipeline_segment_type * update_pipeline_get_task( update_pipeline_type * pipeline , int * task) {
+  pipeline_segment_type * serialize_segment = NULL;
+
+  for (int iseg = 0; iseg < pipeline->num_segments; iseg++) {
+    pipeline_segment_type * pipeline_segment = &pipeline->segments[iseg];
+    if (pipeline_segment->next_task < pipeline_segment->num_tasks) {
+      if (pipeline_segment->stage != PIPELINE_SERIALIZE) {
+        *task = pipeline_segment->next_task++;
+        return pipeline_segment;
+      } else if (serialize_segment == NULL)
+        serialize_segment = pipeline_segment;
+    }
+  }
+
+  if (serialize_segment)
+    *task = serialize_segment->next_task++;
+  return serialize_segment;
+}
+
+
+static void update_pipeline_run_task( update_pipeline_type * pipeline , const pipeline_segment_type * pipeline_segment , pipeline_stage_enum stage , int task) {
+  const row_segment_type * segment = pipeline_segment->segment;
+
+  if (stage == PIPELINE_MULTIPLY) {
+    float_block_type * A_float = pipeline->serialize_info->A_float;
+    int row_offset   = task * pipeline_segment->multiply_rows;
+    int rows         = util_int_min( pipeline_segment->multiply_rows , segment->rows - row_offset );
+
+    if (A_float)
+      matrix_inplace_matmul_float( float_block_iget_ptr( A_float , segment->row_offset + row_offset , 0 ) , rows , A_float->rows , pipeline->X );
+    else {
+      matrix_type * A  = pipeline->serialize_info->A;
+      matrix_type * A_view = matrix_alloc_shared( A , segment->row_offset + row_offset , 0 , rows , matrix_get_columns( A ));
+
+      matrix_inplace_matmul( A_view , pipeline->X );
+      matrix_free( A_view );
+    }
+  } else {
+    serialize_info_type info = pipeline->serialize_info[task];
+    info.key         = segment->key;
+    info.active_list = segment->active_list;
+    info.row_offset  = segment->row_offset;
+    info.rows        = segment->rows;
+    info.load        = segment->load;
+    info.store       = segment->store;
+
+    if (stage == PIPELINE_SERIALIZE) {
+      if (info.A_float)
+        serialize_nodes_float_mt( &info );
+      else
+        serialize_nodes_mt( &info );
+    } else {
+      if (info.A_float)
+        deserialize_nodes_float_mt( &info );
+      else
+        deserialize_nodes_mt( &info );
+    }
+  }
+}
+
+
+static void * update_pipeline_worker( void * arg ) {
+  update_pipeline_type * pipeline = arg;
+  timer_type * task_timer = timer_alloc( true );
+  double task_time[PIPELINE_COMPLETE] = { 0 };
+
+  pthread_mutex_lock( &pipeline->mutex );
+  while (pipeline->num_complete < pipeline->num_segments) {
+    int task;
+    pipeline_segment_type * pipeline_segment = update_pipeline_get_task( pipeline , &task );
+
+    if (pipeline_segment) {
+      pipeline_stage_enum stage = pipeline_segment->stage;
+      pthread_mutex_unlock( &pipeline->mutex );
+
+      timer_start( task_timer );
+      update_pipeline_run_task( pipeline , pipeline_segment , stage , task );
+      task_time[stage] += timer_stop( task_timer );
+
+      pthread_mutex_lock( &pipeline->mutex );
+      pipeline_segment->pending--;
+      if (pipeline_segment->pending == 0) {
+        pipeline_segment_set_stage( pipeline_segment , stage + 1 , pipeline->num_chunks );
+        if (pipeline_segment->stage == PIPELINE_COMPLETE)
+          pipeline->num_complete++;
+        pthread_cond_broadcast( &pipeline->cond );
+      }
+    } else
+      pthread_cond_wait( &pipeline->cond , &pipeline->mutex );
+  }
+
+  for (int stage = 0; stage < PIPELINE_COMPLETE; stage++)
+    pipeline->task_time[stage] += task_time[stage];
+  pthread_mutex_unlock( &pipeline->mutex );
+
+  timer_free( task_timer );
+  return NULL;
+}
+
+
+static void enkf_main_update_segments( row_segment_type * segments ,
+                                       int num_segments ,
+                                       const matrix_type * X ,
+                                       thread_pool_type * work_pool ,
+                                       serialize_info_type * serialize_info ,
+                                       update_timer_type * timer) {
+
+  const int num_cpu_threads = thread_pool_get_max_running( work_pool );
+  update_pipeline_type pipeline;
+
+  pthread_mutex_init( &pipeline.mutex , NULL );
+  pthread_cond_init( &pipeline.cond , NULL );
+  pipeline.segments       = util_calloc( num_segments , sizeof * pipeline.segments );
+  pipeline.num_segments   = num_segments;
+  pipeline.num_complete   = 0;
+  pipeline.num_chunks     = num_cpu_threads;
+  pipeline.X              = X;
+  pipeline.serialize_info = serialize_info;
+  for (int stage = 0; stage < PIPELINE_COMPLETE; stage++)
+    pipeline.task_time[stage] = 0;
+
+  for (int iseg = 0; iseg < num_segments; iseg++) {
+    pipeline_segment_type * pipeline_segment = &pipeline.segments[iseg];
+    pipeline_segment->segment       = &segments[iseg];
+    pipeline_segment->multiply_rows = util_int_max( PIPELINE_MIN_MULTIPLY_ROWS , (segments[iseg].rows + num_cpu_threads - 1) / num_cpu_threads );
+    pipeline_segment_set_stage( pipeline_segment , PIPELINE_SERIALIZE , num_cpu_threads );
+  }
+
+  timer_start( timer->pipeline );
+  thread_pool_restart( work_pool );
+  for (int icpu = 0; icpu < num_cpu_threads; icpu++)
+    thread_pool_add_job( work_pool , update_pipeline_worker , &pipeline );
+  thread_pool_join( work_pool );
+  timer_stop( timer->pipeline );
+
+  for (int stage = 0; stage < PIPELINE_COMPLETE; stage++)
+    timer->task_time[stage] += pipeline.task_time[stage];
+
+  for (int iseg = 0; iseg < num_segments; iseg++) {
+    if (segments[iseg].subset)
+      active_list_free( segments[iseg].subset );
+  }
+  free( pipeline.segments );
+  pthread_cond_destroy( &pipeline.cond );
+  pthread_mutex_destroy( &pipeline.mutex );
+}
+
+
+/**
+   Update of one dataset through the pipeline. When @block_rows > 0
+   the update is streamed: the rows of the dataset are serialized in
+   blocks of at most @block_rows rows into the A matrix, and each
+   block is completely updated before the next block is started. The
+   peak memory used by the A matrix is then O(block_rows * ens_size)
+   instead of O(total_rows * ens_size). When @block_rows <= 0 all the
+   rows of the dataset go in one block, and the A matrix is grown as
+   needed. When serialize_info->A_float is set the rows are stored in
+   that single precision block instead of the A matrix.
+
+   A node which does not fit in the remaining part of the current
+   block is split over several blocks; such a node is only loaded
+   before the first block and stored after the last block, in between
+   the partially updated node is held by the enkf_node instances of
+   the ensemble.
+*/
+
+static void enkf_main_update_dataset_pipelined( const ensemble_config_type * ens_config ,
+                                                const local_dataset_type * dataset ,
+                                                int report_step ,
+                                                int block_rows ,
+                                                const matrix_type * X ,
+                                                thread_pool_type * work_pool ,
+                                                serialize_info_type * serialize_info ,
+                                                update_timer_type * timer) {
+
+  matrix_type * A   = serialize_info->A;
+  float_block_type * A_float = serialize_info->A_float;
+  stringlist_type * update_keys = local_dataset_alloc_keys( dataset );
+  const int num_kw  = stringlist_get_size( update_keys );
+  const int max_rows = (block_rows > 0) ? block_rows : INT_MAX;
+  row_segment_type * segments = util_calloc( util_int_min( num_kw , max_rows ) , sizeof * segments );
+  int num_segments  = 0;
+  int current_row   = 0;
+
+  for (int ikw=0; ikw < num_kw; ikw++) {
+    const char             * key         = stringlist_iget(update_keys , ikw);
+    enkf_config_node_type * config_node  = ensemble_config_get_node( ens_config , key );
+    if ((serialize_info[0].run_mode == SMOOTHER_UPDATE) && (enkf_config_node_get_var_type( config_node ) != PARAMETER))
+      continue;
+    else {
+      const active_list_type * active_list = local_dataset_get_node_active_list( dataset , key );
+      int active_size = __get_active_size( ens_config , serialize_info->src_fs , key , report_step , active_list );
+      int node_row    = 0;
+
+      while (node_row < active_size) {
+        int rows = util_int_min( active_size - node_row , max_rows - current_row );
+        row_segment_type * segment = &segments[num_segments];
+
+        segment->key        = key;
+        segment->row_offset = current_row;
+        segment->rows       = rows;
+        segment->load       = (node_row == 0);
+        segment->store      = ((node_row + rows) == active_size);
+        if (rows == active_size) {
+          segment->subset      = NULL;
+          segment->active_list = active_list;
+        } else {
+          segment->subset      = active_list_alloc_subset( active_list , node_row , rows );
+          segment->active_list = segment->subset;
+        }
+
+        num_segments++;
+        node_row    += rows;
+        current_row += rows;
+        if (current_row == max_rows) {
+          enkf_main_update_segments( segments , num_segments , X , work_pool , serialize_info , timer );
+          num_segments = 0;
+          current_row  = 0;
         }
       }
     }
   }
+
+  if (current_row > 0) {
+    if (A_float) {
+      if (current_row > A_float->rows)
+        float_block_resize( A_float , current_row );
+    } else if (current_row > matrix_get_rows( A ))
+      matrix_resize( A , current_row , matrix_get_columns( A ) , false );
+    enkf_main_update_segments( segments , num_segments , X , work_pool , serialize_info , timer );
+  }
+
+  free( segments );
   stringlist_free( update_keys );
 }
 
@@ -858,6 +1537,7 @@ static serialize_info_type * serialize_info_alloc( enkf_fs_type * src_fs,
                                                    run_mode_type run_mode ,
                                                    int report_step ,
                                                    matrix_type * A ,
+                                                   float_block_type * A_float ,
                                                    int num_cpu_threads ) {
 
   serialize_info_type * serialize_info = util_calloc( num_cpu_threads , sizeof * serialize_info );
@@ -873,6 +1553,9 @@ static serialize_info_type * serialize_info_alloc( enkf_fs_type * src_fs,
     serialize_info[icpu].ensemble    = ensemble;
     serialize_info[icpu].report_step = report_step;
     serialize_info[icpu].A           = A;
+    serialize_info[icpu].A_float     = A_float;
+    serialize_info[icpu].load        = true;
+    serialize_info[icpu].store       = true;
     serialize_info[icpu].iens1       = iens_offset;
     serialize_info[icpu].iens2       = iens_offset + (ens_size - iens_offset) / (num_cpu_threads - icpu);
     iens_offset = serialize_info[icpu].iens2;
@@ -968,6 +1651,46 @@ void enkf_main_get_PC( const matrix_type * S,
 
 
 
+/*****************************************************************/
+/**
+   When several ministeps are updated concurrently they take turns, in
+   the order of the updatestep, with the parts of the update which
+   must run serially: collecting the observations and measurements,
+   which also writes to the update log, drawing random numbers and
+   using the analysis module. The turn is passed on when the analysis
+   module is complete; the rest of the update, i.e. updating the
+   parameters, runs concurrently with the other ministeps. With this
+   the result is the same as when the ministeps are updated one after
+   another. When @turn is NULL the ministeps are updated serially.
+*/
+
+typedef struct {
+  pthread_mutex_t   mutex;
+  pthread_cond_t    cond;
+  int               next;     /* The index of the ministep which has the turn. */
+} ministep_turn_type;
+
+
+static void ministep_turn_wait( ministep_turn_type * turn , int index ) {
+  if (turn) {
+    pthread_mutex_lock( &turn->mutex );
+    while (turn->next != index)
+      pthread_cond_wait( &turn->cond , &turn->mutex );
+    pthread_mutex_unlock( &turn->mutex );
+  }
+}
+
+
+static void ministep_turn_pass( ministep_turn_type * turn ) {
+  if (turn) {
+    pthread_mutex_lock( &turn->mutex );
+    turn->next++;
+    pthread_cond_broadcast( &turn->cond );
+    pthread_mutex_unlock( &turn->mutex );
+  }
+}
+
+
 static void assert_matrix_size(const matrix_type * m , const char * name , int rows , int columns) {
   if (m) {
     if (!matrix_check_dims(m , rows , columns))
@@ -992,27 +1715,55 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
                                        int step2 ,
                                        const local_ministep_type * ministep ,
                                        const meas_data_type * forecast ,
-                                       obs_data_type * obs_data) {
+                                       obs_data_type * obs_data ,
+                                       int cpu_threads ,
+                                       ministep_turn_type * turn) {
 
-  const int cpu_threads       = 4;
   const int matrix_start_size = 250000;
   thread_pool_type * tp       = thread_pool_alloc( cpu_threads , false );
+  update_timer_type * timer   = update_timer_alloc( );
   int active_ens_size   = meas_data_get_active_ens_size( forecast );
   int active_size       = obs_data_get_active_size( obs_data );
   matrix_type * X       = matrix_alloc( active_ens_size , active_ens_size );
   matrix_type * S       = meas_data_allocS( forecast );
   matrix_type * R       = obs_data_allocR( obs_data );
   matrix_type * dObs    = obs_data_allocdObs( obs_data );
-  matrix_type * A       = matrix_alloc( matrix_start_size , active_ens_size );
+  matrix_type * A       = NULL;
+  float_block_type * A_float = NULL;
   matrix_type * E       = NULL;
   matrix_type * D       = NULL;
   matrix_type * localA  = NULL;
   int_vector_type * iens_active_index = bool_vector_alloc_active_index_list(ens_mask , -1);
+  int block_rows        = -1;
+  bool single_precision = false;
 
   analysis_module_type * module = analysis_config_get_active_module( enkf_main->analysis_config );
   if ( local_ministep_has_analysis_module (ministep))
     module = local_ministep_get_analysis_module (ministep);
 
+  /*
+    When the module only needs the X matrix the update goes through
+    the serialize/multiply/deserialize pipeline; if a memory limit has
+    been configured as well the update is streamed through an A matrix
+    of at most block_rows rows. The block is never larger than the
+    initial size of the full A matrix. With single precision the rows
+    go in a float block instead of the A matrix; without a memory
+    limit the float block is grown as needed.
+  */
+  if (!(analysis_module_check_option( module , ANALYSIS_USE_A) || analysis_module_check_option(module , ANALYSIS_UPDATE_A))) {
+    single_precision = analysis_config_get_single_precision( enkf_main->analysis_config );
+    block_rows = analysis_config_get_max_block_rows( enkf_main->analysis_config , active_ens_size );
+    if (block_rows > 0)
+      block_rows = util_int_min( block_rows , matrix_start_size );
+  }
+
+  if (single_precision)
+    A_float = float_block_alloc( util_int_max( block_rows , 0 ) , active_ens_size );
+  else if (block_rows > 0)
+    A = matrix_alloc( block_rows , active_ens_size );
+  else
+    A = matrix_alloc( matrix_start_size , active_ens_size );
+
   assert_matrix_size(X , "X" , active_ens_size , active_ens_size);
   assert_matrix_size(S , "S" , active_size , active_ens_size);
   assert_matrix_size(R , "R" , active_size , active_size);
@@ -1045,6 +1796,7 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
                                                                  run_mode ,
                                                                  step2 ,
                                                                  A ,
+                                                                 A_float ,
                                                                  cpu_threads);
 
 
@@ -1073,38 +1825,57 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
       double_vector_free( singular_values );
     }
 
-    if (localA == NULL)
+    if (localA == NULL) {
+      timer_start( timer->module );
       analysis_module_initX( module , X , NULL , S , R , dObs , E , D );
+      timer_stop( timer->module );
+
+      /* The module is not needed for the rest of the update. */
+      analysis_module_complete_update( module );
+      ministep_turn_pass( turn );
+    }
 
 
     while (!hash_iter_is_complete( dataset_iter )) {
       const char * dataset_name = hash_iter_get_next_key( dataset_iter );
       const local_dataset_type * dataset = local_ministep_get_dataset( ministep , dataset_name );
-      if (local_dataset_get_size( dataset )) {
+      if (local_dataset_get_size( dataset ) && (localA == NULL))
+        enkf_main_update_dataset_pipelined( enkf_main->ensemble_config , dataset , step2 , block_rows , X , tp , serialize_info , timer );
+      else if (local_dataset_get_size( dataset )) {
         int * active_size = util_calloc( local_dataset_get_size( dataset ) , sizeof * active_size );
         int * row_offset  = util_calloc( local_dataset_get_size( dataset ) , sizeof * row_offset  );
         local_obsdata_type   * local_obsdata = local_ministep_get_obsdata( ministep );
 
+        timer_start( timer->serialize );
         enkf_main_serialize_dataset( enkf_main->ensemble_config , dataset , step2 ,  use_count , active_size , row_offset , tp , serialize_info);
+        timer_stop( timer->serialize );
         module_info_type * module_info = enkf_main_module_info_alloc(ministep, obs_data, dataset, local_obsdata, active_size , row_offset);
 
         if (analysis_module_check_option( module , ANALYSIS_UPDATE_A)){
+          timer_start( timer->module );
           if (analysis_module_check_option( module , ANALYSIS_ITERABLE)){
             analysis_module_updateA( module , localA , S , R , dObs , E , D , module_info );
           }
           else
             analysis_module_updateA( module , localA , S , R , dObs , E , D , module_info );
+          timer_stop( timer->module );
         }
         else {
           if (analysis_module_check_option( module , ANALYSIS_USE_A)){
+            timer_start( timer->module );
             analysis_module_initX( module , X , localA , S , R , dObs , E , D );
+            timer_stop( timer->module );
           }
 
+          timer_start( timer->matmul );
           matrix_inplace_matmul_mt2( A , X , tp );
+          timer_stop( timer->matmul );
         }
 
         // The deserialize also calls enkf_node_store() functions.
+        timer_start( timer->deserialize );
         enkf_main_deserialize_dataset( enkf_main_get_ensemble_config( enkf_main ) , dataset , active_size , row_offset , serialize_info , tp);
+        timer_stop( timer->deserialize );
 
         free( active_size );
         free( row_offset );
@@ -1114,11 +1885,17 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
     hash_iter_free( dataset_iter );
     serialize_info_free( serialize_info );
   }
-  analysis_module_complete_update( module );
+  if (localA != NULL) {
+    analysis_module_complete_update( module );
+    ministep_turn_pass( turn );
+  }
+  update_timer_log( timer , local_ministep_get_name( ministep ) , cpu_threads );
 
 
   /*****************************************************************/
 
+  update_timer_free( timer );
+  thread_pool_free( tp );
   int_vector_free(iens_active_index);
   matrix_safe_free( E );
   matrix_safe_free( D );
@@ -1126,7 +1903,9 @@ static void enkf_main_analysis_update( enkf_main_type * enkf_main ,
   matrix_free( R );
   matrix_free( dObs );
   matrix_free( X );
-  matrix_free( A );
+  matrix_safe_free( A );
+  if (A_float)
+    float_block_free( A_float );
 }
 
 
@@ -1147,6 +1926,140 @@ static FILE * enkf_main_log_step_list(enkf_main_type * enkf_main, const int_vect
 }
 
 
+/**
+   Helper struct with the input to the update of one ministep.
+*/
+
+typedef struct {
+  enkf_main_type          * enkf_main;
+  local_ministep_type     * ministep;
+  const int_vector_type   * step_list;
+  enkf_fs_type            * source_fs;
+  enkf_fs_type            * target_fs;
+  int                       target_step;
+  run_mode_type             run_mode;
+  const bool_vector_type  * ens_mask;
+  const int_vector_type   * ens_active_list;
+  hash_type               * use_count;
+  FILE                    * log_stream;
+  meas_data_type          * meas_data;
+  obs_data_type           * obs_data;
+  int                       num_threads;
+  ministep_turn_type      * turn;
+  int                       turn_index;
+} ministep_update_type;
+
+
+static void * enkf_main_update_ministep( void * arg ) {
+  ministep_update_type * update = arg;
+  enkf_main_type * enkf_main = update->enkf_main;
+  local_ministep_type * ministep = update->ministep;
+  local_obsdata_type * obsdata = local_ministep_get_obsdata(ministep);
+  const int_vector_type * step_list = update->step_list;
+  meas_data_type * meas_data = update->meas_data;
+  obs_data_type * obs_data = update->obs_data;
+
+  ministep_turn_wait(update->turn, update->turn_index);
+  obs_data_reset(obs_data);
+  meas_data_reset(meas_data);
+
+  /*
+    Temporarily we will just force the timestep from the input
+    argument onto the obsdata instance; in the future the
+    obsdata should hold it's own here.
+  */
+  local_obsdata_reset_tstep_list(obsdata, step_list);
+
+  if (analysis_config_get_std_scale_correlated_obs(enkf_main->analysis_config)) {
+    double scale_factor = enkf_obs_scale_correlated_std(enkf_main->obs, update->source_fs,
+                                                        update->ens_active_list, obsdata);
+    ert_log_add_fmt_message(1, NULL,
+                            "Scaling standard deviation in obdsata set:%s with %g",
+                            local_obsdata_get_name(obsdata), scale_factor);
+  }
+  enkf_obs_get_obs_and_measure_data_mt(enkf_main->obs, update->source_fs, obsdata,
+                                       update->ens_active_list, meas_data, obs_data,
+                                       update->num_threads);
+
+  double alpha = analysis_config_get_alpha(enkf_main->analysis_config);
+  double std_cutoff = analysis_config_get_std_cutoff(enkf_main->analysis_config);
+  enkf_analysis_deactivate_outliers(obs_data, meas_data,
+                                    std_cutoff, alpha, enkf_main->verbose);
+
+  if (enkf_main->verbose)
+    enkf_analysis_fprintf_obs_summary(obs_data, meas_data, step_list, local_ministep_get_name(ministep), stdout);
+  enkf_analysis_fprintf_obs_summary(obs_data, meas_data, step_list, local_ministep_get_name(ministep), update->log_stream);
+
+  if ((obs_data_get_active_size(obs_data) > 0) && (meas_data_get_active_obs_size(meas_data) > 0))
+    enkf_main_analysis_update(enkf_main,
+                              update->target_fs,
+                              update->ens_mask,
+                              update->target_step,
+                              update->use_count,
+                              update->run_mode,
+                              int_vector_get_first(step_list),
+                              int_vector_get_last(step_list),
+                              ministep,
+                              meas_data,
+                              obs_data,
+                              update->num_threads,
+                              update->turn);
+  else {
+    if (update->target_fs != update->source_fs)
+      ert_log_add_fmt_message(1, stderr, "No active observations/parameters for MINISTEP: %s.",
+                              local_ministep_get_name(ministep));
+    ministep_turn_pass(update->turn);
+  }
+
+  return NULL;
+}
+
+
+/**
+   Updates the @batch_size ministeps starting with @first_ministep
+   concurrently; the ministeps must update disjoint sets of nodes. The
+   threads are divided evenly between the ministeps, and each ministep
+   gets its own obs_data and meas_data instances.
+*/
+
+static void enkf_main_update_ministeps_concurrent(const ministep_update_type * common,
+                                                  const local_updatestep_type * updatestep,
+                                                  int first_ministep,
+                                                  int batch_size,
+                                                  double global_std_scaling) {
+
+  ministep_update_type * updates = util_calloc(batch_size, sizeof * updates);
+  thread_pool_type * tp = thread_pool_alloc(batch_size, true);
+  ministep_turn_type turn;
+
+  pthread_mutex_init(&turn.mutex, NULL);
+  pthread_cond_init(&turn.cond, NULL);
+  turn.next = 0;
+
+  for (int i = 0; i < batch_size; i++) {
+    updates[i] = *common;
+    updates[i].ministep    = local_updatestep_iget_ministep(updatestep, first_ministep + i);
+    updates[i].meas_data   = meas_data_alloc(common->ens_mask);
+    updates[i].obs_data    = obs_data_alloc(global_std_scaling);
+    updates[i].num_threads = util_int_max(1, common->num_threads / batch_size);
+    updates[i].turn        = &turn;
+    updates[i].turn_index  = i;
+
+    thread_pool_add_job(tp, enkf_main_update_ministep, &updates[i]);
+  }
+  thread_pool_join(tp);
+  thread_pool_free(tp);
+
+  for (int i = 0; i < batch_size; i++) {
+    meas_data_free(updates[i].meas_data);
+    obs_data_free(updates[i].obs_data);
+  }
+  pthread_cond_destroy(&turn.cond);
+  pthread_mutex_destroy(&turn.mutex);
+  free(updates);
+}
+
+
 /**
  * This is THE ENKF update function.  It should only be called from enkf_main_UPDATE.
  */
@@ -1200,57 +2113,43 @@ static void enkf_main_update__(enkf_main_type * enkf_main, const int_vector_type
     {
       hash_type * use_count = hash_alloc();
       int current_step = int_vector_get_last(step_list);
+      ministep_update_type common = { .enkf_main       = enkf_main ,
+                                      .ministep        = NULL ,
+                                      .step_list       = step_list ,
+                                      .source_fs       = source_fs ,
+                                      .target_fs       = target_fs ,
+                                      .target_step     = target_step ,
+                                      .run_mode        = run_mode ,
+                                      .ens_mask        = ens_mask ,
+                                      .ens_active_list = ens_active_list ,
+                                      .use_count       = use_count ,
+                                      .log_stream      = log_stream ,
+                                      .meas_data       = meas_data ,
+                                      .obs_data        = obs_data ,
+                                      .num_threads     = analysis_config_get_num_threads( analysis_config ) ,
+                                      .turn            = NULL ,
+                                      .turn_index      = 0 };
+      const int num_ministep = local_updatestep_get_num_ministep(updatestep);
+      int ministep_nr = 0;
 
+      /*
+        Looping over local analysis ministep; in smoother mode
+        consecutive ministeps which update disjoint sets of parameters
+        are updated concurrently.
+      */
+      while (ministep_nr < num_ministep) {
+        int batch_size = 1;
+        if ((run_mode == SMOOTHER_UPDATE) && (common.num_threads > 1))
+          batch_size = local_updatestep_get_independent_ministeps(updatestep, ministep_nr, common.num_threads);
+
+        if (batch_size == 1) {
+          ministep_update_type update = common;
+          update.ministep = local_updatestep_iget_ministep(updatestep, ministep_nr);
+          enkf_main_update_ministep(&update);
+        } else
+          enkf_main_update_ministeps_concurrent(&common, updatestep, ministep_nr, batch_size, global_std_scaling);
 
-      /* Looping over local analysis ministep */
-      for (int ministep_nr = 0; ministep_nr < local_updatestep_get_num_ministep(updatestep); ministep_nr++) {
-        local_ministep_type * ministep = local_updatestep_iget_ministep(updatestep, ministep_nr);
-        local_obsdata_type * obsdata = local_ministep_get_obsdata(ministep);
-
-        obs_data_reset(obs_data);
-        meas_data_reset(meas_data);
-
-        /*
-          Temporarily we will just force the timestep from the input
-          argument onto the obsdata instance; in the future the
-          obsdata should hold it's own here.
-        */
-        local_obsdata_reset_tstep_list(obsdata, step_list);
-
-        if (analysis_config_get_std_scale_correlated_obs(enkf_main->analysis_config)) {
-          double scale_factor = enkf_obs_scale_correlated_std(enkf_main->obs, source_fs,
-                                                              ens_active_list, obsdata);
-          ert_log_add_fmt_message(1, NULL,
-                                  "Scaling standard deviation in obdsata set:%s with %g",
-                                  local_obsdata_get_name(obsdata), scale_factor);
-        }
-        enkf_obs_get_obs_and_measure_data(enkf_main->obs, source_fs, obsdata,
-                                          ens_active_list, meas_data, obs_data);
-
-        double alpha = analysis_config_get_alpha(enkf_main->analysis_config);
-        double std_cutoff = analysis_config_get_std_cutoff(enkf_main->analysis_config);
-        enkf_analysis_deactivate_outliers(obs_data, meas_data,
-                                          std_cutoff, alpha, enkf_main->verbose);
-
-        if (enkf_main->verbose)
-          enkf_analysis_fprintf_obs_summary(obs_data, meas_data, step_list, local_ministep_get_name(ministep), stdout);
-        enkf_analysis_fprintf_obs_summary(obs_data, meas_data, step_list, local_ministep_get_name(ministep), log_stream);
-
-        if ((obs_data_get_active_size(obs_data) > 0) && (meas_data_get_active_obs_size(meas_data) > 0))
-            enkf_main_analysis_update(enkf_main,
-                                      target_fs,
-                                      ens_mask,
-                                      target_step,
-                                      use_count,
-                                      run_mode,
-                                      int_vector_get_first(step_list),
-                                      current_step,
-                                      ministep,
-                                      meas_data,
-                                      obs_data);
-        else if (target_fs != source_fs)
-          ert_log_add_fmt_message(1, stderr, "No active observations/parameters for MINISTEP: %s.",
-                                  local_ministep_get_name(ministep));
+        ministep_nr += batch_size;
       }
 
       enkf_main_inflate(enkf_main, source_fs, target_fs, current_step, use_count);
@@ -2030,7 +2929,7 @@ static void enkf_main_init_user_config( const enkf_main_type * enkf_main , confi
 
   item = config_add_schema_item(config , DBASE_TYPE_KEY , false  );
   config_schema_item_set_argc_minmax(item , 1, 1 );
-  config_schema_item_set_common_selection_set(item , 2 , (const char *[2]) {"PLAIN" , "BLOCK_FS"});
+  config_schema_item_set_common_selection_set(item , 3 , (const char *[3]) {"PLAIN" , "BLOCK_FS" , "BLOCK_FS_FIELD"});
 
   item = config_add_schema_item(config , FORWARD_MODEL_KEY , false  );
   config_schema_item_set_argc_minmax(item , 1 , CONFIG_DEFAULT_ARG_MAX);
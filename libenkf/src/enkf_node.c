@@ -447,27 +447,42 @@ bool enkf_node_forward_load_vector(enkf_node_type *enkf_node , const forward_loa
 
 
 
-static bool enkf_node_store_buffer( enkf_node_type * enkf_node , enkf_fs_type * fs , int report_step , int iens) {
+/*
+  Returns the buffer with the data of the node as it should go to
+  storage, or NULL if the node did not have any data to write.
+*/
+
+static buffer_type * enkf_node_alloc_store_buffer( enkf_node_type * enkf_node , int report_step ) {
   FUNC_ASSERT(enkf_node->write_to_buffer);
   {
-    bool data_written;
     buffer_type * buffer = buffer_alloc( 100 );
-    const enkf_config_node_type * config_node = enkf_node_get_config( enkf_node );
     buffer_fwrite_time_t( buffer , time(NULL));
-    data_written = enkf_node->write_to_buffer(enkf_node->data , buffer , report_step );
-    if (data_written) {
-      const char * node_key = enkf_config_node_get_key( config_node );
-      enkf_var_type var_type = enkf_config_node_get_var_type( config_node );
+    if (enkf_node->write_to_buffer(enkf_node->data , buffer , report_step ))
+      return buffer;
+    else {
+      buffer_free( buffer );
+      return NULL;
+    }
+  }
+}
 
-      if (enkf_node->vector_storage)
-        enkf_fs_fwrite_vector( fs , buffer , node_key , var_type , iens );
-      else
-        enkf_fs_fwrite_node( fs , buffer , node_key , var_type , report_step , iens );
 
-    }
+static bool enkf_node_store_buffer( enkf_node_type * enkf_node , enkf_fs_type * fs , int report_step , int iens) {
+  buffer_type * buffer = enkf_node_alloc_store_buffer( enkf_node , report_step );
+  if (buffer) {
+    const enkf_config_node_type * config_node = enkf_node_get_config( enkf_node );
+    const char * node_key = enkf_config_node_get_key( config_node );
+    enkf_var_type var_type = enkf_config_node_get_var_type( config_node );
+
+    if (enkf_node->vector_storage)
+      enkf_fs_fwrite_vector( fs , buffer , node_key , var_type , iens );
+    else
+      enkf_fs_fwrite_node( fs , buffer , node_key , var_type , report_step , iens );
+
     buffer_free( buffer );
-    return data_written;
-  }
+    return true;
+  } else
+    return false;
 }
 
 bool enkf_node_store_vector(enkf_node_type *enkf_node , enkf_fs_type * fs , int iens ) {
@@ -475,6 +490,61 @@ bool enkf_node_store_vector(enkf_node_type *enkf_node , enkf_fs_type * fs , int
 }
 
 
+/**
+   Stores the vectors of several nodes for realisation @iens in one
+   batch; all the nodes must have vector storage and the same
+   var_type. This is used when internalizing the summary results, where
+   one realisation can have tens of thousands of summary vectors. The
+   return value is the number of vectors written.
+*/
+
+int enkf_node_store_vectors(enkf_node_type ** nodes , int num_nodes , enkf_fs_type * fs , int iens ) {
+  buffer_type ** buffers  = util_calloc( util_int_max( num_nodes , 1 ) , sizeof * buffers );
+  const char ** node_keys = util_calloc( util_int_max( num_nodes , 1 ) , sizeof * node_keys );
+  enkf_var_type var_type  = INVALID_VAR;
+  int num_vectors = 0;
+
+  for (int inode = 0; inode < num_nodes; inode++) {
+    enkf_node_type * enkf_node = nodes[inode];
+    const enkf_config_node_type * config_node = enkf_node_get_config( enkf_node );
+
+    if (!enkf_node->vector_storage)
+      util_abort("%s: node:%s does not have vector storage\n",__func__ , enkf_node_get_key( enkf_node ));
+
+    if (inode == 0)
+      var_type = enkf_config_node_get_var_type( config_node );
+    else if (enkf_config_node_get_var_type( config_node ) != var_type)
+      util_abort("%s: all nodes must have the same var_type\n",__func__);
+
+    buffers[num_vectors] = enkf_node_alloc_store_buffer( enkf_node , -1 );
+    if (buffers[num_vectors]) {
+      node_keys[num_vectors] = enkf_config_node_get_key( config_node );
+      num_vectors++;
+    }
+  }
+
+  enkf_fs_fwrite_vectors( fs , num_vectors , buffers , node_keys , var_type , iens );
+
+  for (int i = 0; i < num_vectors; i++)
+    buffer_free( buffers[i] );
+  free( buffers );
+  free( node_keys );
+  return num_vectors;
+}
+
+
+
+/*
+  In a filesystem with a field_block_driver the FIELD parameters are
+  stored directly by the driver, and not through a buffer.
+*/
+
+static bool enkf_node_use_field_blocks( const enkf_node_type * enkf_node , enkf_fs_type * fs ) {
+  return (enkf_node_get_impl_type( enkf_node ) == FIELD) &&
+         (enkf_config_node_get_var_type( enkf_node->config ) == PARAMETER) &&
+         (enkf_fs_get_field_block_driver( fs ) != NULL);
+}
+
 
 bool enkf_node_store(enkf_node_type * enkf_node , enkf_fs_type * fs , bool force_vectors , node_id_type node_id) {
   if (enkf_node->vector_storage) {
@@ -489,6 +559,13 @@ bool enkf_node_store(enkf_node_type * enkf_node , enkf_fs_type * fs , bool force
         return false;             /* For report step == 0 the summary data is just garbage. */
     }
 
+    if (enkf_node_use_field_blocks( enkf_node , fs )) {
+      if (node_id.report_step > 0)
+        util_abort("%s: Parameters can only be saved for report_step = 0   %s:%d\n", __func__ , enkf_node_get_key( enkf_node ) , node_id.report_step);
+      field_store_blocks( enkf_node->data , fs , node_id.iens );
+      return true;
+    }
+
     return enkf_node_store_buffer( enkf_node , fs , node_id.report_step , node_id.iens );
   }
 }
@@ -556,6 +633,8 @@ void enkf_node_load(enkf_node_type * enkf_node , enkf_fs_type * fs , node_id_typ
   else {
     if (enkf_node->vector_storage)
       enkf_node_load_vector( enkf_node , fs , node_id.iens );
+    else if (enkf_node_use_field_blocks( enkf_node , fs ))
+      field_load_blocks( enkf_node->data , fs , node_id.iens );
     else
       /* Normal load path */
       enkf_node_buffer_load( enkf_node , fs , node_id.report_step, node_id.iens );
@@ -572,6 +651,55 @@ bool enkf_node_try_load_vector(enkf_node_type *enkf_node , enkf_fs_type * fs , i
 }
 
 
+/**
+   The counterpart to enkf_node_store_vectors(); will load the stored
+   vectors of several nodes for realisation @iens in one batch. The
+   nodes which do not have a stored vector are left unchanged. The
+   return value is the number of vectors loaded.
+*/
+
+int enkf_node_try_load_vectors(enkf_node_type ** nodes , int num_nodes , enkf_fs_type * fs , int iens ) {
+  buffer_type ** buffers  = util_calloc( util_int_max( num_nodes , 1 ) , sizeof * buffers );
+  const char ** node_keys = util_calloc( util_int_max( num_nodes , 1 ) , sizeof * node_keys );
+  bool * found            = util_calloc( util_int_max( num_nodes , 1 ) , sizeof * found );
+  enkf_var_type var_type  = INVALID_VAR;
+  int num_vectors;
+
+  for (int inode = 0; inode < num_nodes; inode++) {
+    enkf_node_type * enkf_node = nodes[inode];
+    const enkf_config_node_type * config_node = enkf_node_get_config( enkf_node );
+
+    if (!enkf_node->vector_storage)
+      util_abort("%s: node:%s does not have vector storage\n",__func__ , enkf_node_get_key( enkf_node ));
+
+    if (inode == 0)
+      var_type = enkf_config_node_get_var_type( config_node );
+    else if (enkf_config_node_get_var_type( config_node ) != var_type)
+      util_abort("%s: all nodes must have the same var_type\n",__func__);
+
+    FUNC_ASSERT(enkf_node->read_from_buffer);
+    node_keys[inode] = enkf_config_node_get_key( config_node );
+    buffers[inode] = buffer_alloc( 100 );
+  }
+
+  num_vectors = enkf_fs_fread_vectors( fs , num_nodes , buffers , node_keys , var_type , iens , found );
+
+  for (int inode = 0; inode < num_nodes; inode++) {
+    if (found[inode]) {
+      enkf_node_type * enkf_node = nodes[inode];
+
+      buffer_fskip_time_t( buffers[inode] );
+      enkf_node->read_from_buffer( enkf_node->data , buffers[inode] , fs , -1 );
+    }
+    buffer_free( buffers[inode] );
+  }
+  free( buffers );
+  free( node_keys );
+  free( found );
+  return num_vectors;
+}
+
+
 
 
 
@@ -702,22 +830,42 @@ enkf_node_type ** enkf_node_load_alloc_ensemble( const enkf_config_node_type * c
 
 
 
-void enkf_node_serialize(enkf_node_type *enkf_node , enkf_fs_type * fs, node_id_type node_id ,
-                         const active_list_type * active_list , matrix_type * A , int row_offset , int column) {
+/**
+   The serialize__ and deserialize__ functions only move data between
+   the in-memory node and the A matrix, without loading or storing the
+   node. They are used when one node is serialized in several row
+   blocks; the node is then loaded before the first block and stored
+   after the last.
+*/
+
+void enkf_node_serialize__(enkf_node_type *enkf_node , node_id_type node_id ,
+                           const active_list_type * active_list , matrix_type * A , int row_offset , int column) {
 
   FUNC_ASSERT(enkf_node->serialize);
-  enkf_node_load( enkf_node , fs , node_id);
   enkf_node->serialize(enkf_node->data , node_id , active_list , A , row_offset , column);
+}
+
+
+void enkf_node_serialize(enkf_node_type *enkf_node , enkf_fs_type * fs, node_id_type node_id ,
+                         const active_list_type * active_list , matrix_type * A , int row_offset , int column) {
 
+  enkf_node_load( enkf_node , fs , node_id);
+  enkf_node_serialize__( enkf_node , node_id , active_list , A , row_offset , column );
 }
 
 
+void enkf_node_deserialize__(enkf_node_type *enkf_node , node_id_type node_id,
+                             const active_list_type * active_list , const matrix_type * A , int row_offset , int column) {
+
+  FUNC_ASSERT(enkf_node->deserialize);
+  enkf_node->deserialize(enkf_node->data , node_id , active_list , A , row_offset , column);
+}
+
 
 void enkf_node_deserialize(enkf_node_type *enkf_node , enkf_fs_type * fs , node_id_type node_id,
                            const active_list_type * active_list , const matrix_type * A , int row_offset , int column) {
 
-  FUNC_ASSERT(enkf_node->deserialize);
-  enkf_node->deserialize(enkf_node->data , node_id , active_list , A , row_offset , column);
+  enkf_node_deserialize__( enkf_node , node_id , active_list , A , row_offset , column );
   enkf_node_store( enkf_node , fs , true , node_id );
 }
 
@@ -19,11 +19,13 @@
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
 
 #include <ert/util/hash.h>
 #include <ert/util/util.h>
 #include <ert/util/msg.h>
 #include <ert/util/vector.h>
+#include <ert/util/thread_pool.h>
 #include <ert/util/type_vector_functions.h>
 
 #include <ert/config/conf.h>
@@ -362,17 +364,70 @@ static matrix_type * estimate_covar_alloc_matrix(const enkf_obs_type * enkf_obs,
 }
 
 
-static void enkf_obs_get_obs_and_measure_summary(const enkf_obs_type      * enkf_obs,
-                                                 obs_vector_type          * obs_vector ,
-                                                 enkf_fs_type             * fs,
-                                                 const local_obsdata_node_type * obs_node ,
-                                                 const int_vector_type      * ens_active_list ,
-                                                 meas_data_type             * meas_data,
-                                                 obs_data_type              * obs_data,
-                                                 double_vector_type         * obs_value ,
-                                                 double_vector_type         * obs_std) {
+/*
+  The summary observations of one key are collected in one block
+  with one row per active report step. The simulated responses are
+  stored as one vector per realisation, i.e. the vector of each
+  realisation is loaded once and all the active steps are picked
+  from it. The summary_measure instance holds what is needed to fill
+  the meas_block; the loading can be split on several threads, each
+  thread handling a range of the active realisations.
+
+  The threads do not write to the meas_block; meas_block_iset() also
+  updates the active flags and the statistics state of the block,
+  which are shared by all realisations. Each job instead loads the
+  values into its own buffer, and the meas_block is assigned from
+  the buffers by the calling thread when all the jobs are complete.
+*/
+
+typedef struct {
+  const enkf_config_node_type * config_node;
+  int_vector_type             * step_list;      /* The report steps of the rows in the block. */
+  meas_block_type             * meas_block;
+  obs_block_type              * obs_block;
+  int                           sim_length;     /* Length of the shortest simulated vector. */
+} summary_measure_type;
+
+
+typedef struct {
+  summary_measure_type  * summary_measure;
+  enkf_fs_type          * fs;
+  const int_vector_type * ens_active_list;
+  int                     index_offset;
+  int                     index_size;
+  int                     sim_length;
+  double                * values;         /* index_size x num_steps values, one row per realisation. */
+  int                   * length;         /* The length of the simulated vector of each realisation. */
+} summary_measure_job_type;
+
+
+static void summary_measure_free( summary_measure_type * summary_measure ) {
+  int_vector_free( summary_measure->step_list );
+  free( summary_measure );
+}
+
+
+static void summary_measure_free__( void * arg ) {
+  summary_measure_free( arg );
+}
+
+
+
+/*
+  Will return NULL if there are no active observations for this key.
+*/
+
+static summary_measure_type * enkf_obs_alloc_summary_measure(const enkf_obs_type      * enkf_obs,
+                                                             obs_vector_type          * obs_vector ,
+                                                             const local_obsdata_node_type * obs_node ,
+                                                             meas_data_type             * meas_data,
+                                                             obs_data_type              * obs_data) {
 
   const active_list_type * active_list = local_obsdata_node_get_active_list( obs_node );
+  double_vector_type * obs_value = double_vector_alloc( 0 , -1 );
+  double_vector_type * obs_std   = double_vector_alloc( 0 , -1 );
+  int_vector_type * step_list    = int_vector_alloc( 0 , -1 );
+  summary_measure_type * summary_measure = NULL;
 
   matrix_type * error_covar = NULL;
   int active_count          = 0;
@@ -380,9 +435,6 @@ static void enkf_obs_get_obs_and_measure_summary(const enkf_obs_type      * enkf
   int step = -1;
 
   /*1: Determine which report_steps have active observations; and collect the observed values. */
-  double_vector_reset( obs_std );
-  double_vector_reset( obs_value );
-
   while (true) {
     step = obs_vector_get_next_active_step( obs_vector , step );
     if (step < 0)
@@ -394,104 +446,210 @@ static void enkf_obs_get_obs_and_measure_summary(const enkf_obs_type      * enkf
       const summary_obs_type * summary_obs = obs_vector_iget_node( obs_vector , step );
       double_vector_iset( obs_std   , active_count , summary_obs_get_std( summary_obs ) * summary_obs_get_std_scaling( summary_obs ));
       double_vector_iset( obs_value , active_count , summary_obs_get_value( summary_obs ));
+      int_vector_iset( step_list , active_count , step );
       last_step = step;
       active_count++;
     }
   }
 
-  if (active_count <= 0)
-    return;
+  if (active_count > 0) {
+    /*
+      2: Estimate a covariance matrix.
+      Will be owned by the obs_block instance.
+    */
+    error_covar = estimate_covar_alloc_matrix(enkf_obs, obs_vector, obs_std,
+                                              last_step, active_count);
 
-  /*
-    2: Estimate a covariance matrix.
-    Will be owned by the obs_block instance.
-  */
-  error_covar = estimate_covar_alloc_matrix(enkf_obs, obs_vector, obs_std,
-                                            last_step, active_count);
+    /*
+      3: Create the obs_block and meas_block structures for this
+      time-aggregated summary observation.  Passing in the error_covar
+      matrix (which can be NULL) to the obs_block instance. The
+      meas_block is filled with the simulated values afterwards.
+    */
+    summary_measure = util_malloc( sizeof * summary_measure );
+    summary_measure->config_node = obs_vector_get_config_node( obs_vector );
+    summary_measure->step_list   = step_list;
+    summary_measure->obs_block   = obs_data_add_block( obs_data , obs_vector_get_obs_key( obs_vector ) , active_count , error_covar , true);
+    summary_measure->meas_block  = meas_data_add_block( meas_data, obs_vector_get_obs_key( obs_vector ) , last_step , active_count );
+    summary_measure->sim_length  = INT_MAX;
 
-  /*
-    3: Fill up the obs_block and meas_block structures with this
-    time-aggregated summary observation.  Passing in the error_covar
-    matrix (which can be NULL) to the obs_block instance.
-  */
+    for (int i=0; i < active_count; i++)
+      obs_block_iset( summary_measure->obs_block , i , double_vector_iget( obs_value , i) , double_vector_iget( obs_std , i ));
+  } else
+    int_vector_free( step_list );
 
-  {
-    obs_block_type  * obs_block  = obs_data_add_block( obs_data , obs_vector_get_obs_key( obs_vector ) , active_count , error_covar , true);
-    meas_block_type * meas_block = meas_data_add_block( meas_data, obs_vector_get_obs_key( obs_vector ) , last_step , active_count );
+  double_vector_free( obs_std );
+  double_vector_free( obs_value );
+  return summary_measure;
+}
 
-    enkf_node_type  * work_node  = enkf_node_alloc( obs_vector_get_config_node( obs_vector ));
 
-    for (int i=0; i < active_count; i++)
-      obs_block_iset( obs_block , i , double_vector_iget( obs_value , i) , double_vector_iget( obs_std , i ));
-
-    int active_size = int_vector_size( ens_active_list );
-    active_count = 0;
-    step = -1;
-    while (true) {
-      step = obs_vector_get_next_active_step( obs_vector , step );
-      if (step < 0)
-        break;
-
-      if (local_obsdata_node_tstep_active(obs_node, step)
-          && obs_vector_iget_active( obs_vector , step )
-          && active_list_iget( active_list , 0 /* Index into the scalar summary observation */)) {
-        for (int iens_index = 0; iens_index < active_size; iens_index++) {
-          const int iens = int_vector_iget( ens_active_list , iens_index );
-          node_id_type node_id = {.report_step = step,
-                                  .iens        = iens};
-          enkf_node_load( work_node , fs , node_id );
-
-          int smlength   = summary_length( enkf_node_value_ptr( work_node ) );
-          if (step >= smlength) {
-            // if obs vector and sim vector have different length
-            // deactivate and continue to next
-            char * msg = util_alloc_sprintf("length of observation vector and simulated differ: %d vs. %d ", step, smlength);
-            meas_block_deactivate(meas_block , active_count);
-            obs_block_deactivate(obs_block , active_count, true, msg);
-            free( msg );
-            break;
-          } else {
-            meas_block_iset(meas_block , iens , active_count ,
-                            summary_get( enkf_node_value_ptr( work_node ),
-                                         node_id.report_step ));
-          }
-        }
-        active_count++;
+/*
+  Loads the simulated vectors of the realisations
+  ens_active_list[index_offset, index_offset + index_size) and stores
+  the values at the observed report steps in the job buffer, along
+  with the length of the shortest simulated vector; observations
+  beyond the end of the simulated vectors are deactivated afterwards
+  in summary_measure_deactivate_steps().
+*/
+
+static void summary_measure_load( summary_measure_job_type * job ) {
+  const summary_measure_type * summary_measure = job->summary_measure;
+  enkf_node_type * work_node = enkf_node_alloc( summary_measure->config_node );
+  int num_steps = int_vector_size( summary_measure->step_list );
+
+  job->sim_length = INT_MAX;
+  for (int index = 0; index < job->index_size; index++) {
+    const int iens = int_vector_iget( job->ens_active_list , job->index_offset + index );
+    node_id_type node_id = {.report_step = int_vector_iget( summary_measure->step_list , 0 ),
+                            .iens        = iens};
+    enkf_node_load( work_node , job->fs , node_id );
+    {
+      const summary_type * summary = enkf_node_value_ptr( work_node );
+      int smlength = summary_length( summary );
+
+      for (int i=0; i < num_steps; i++) {
+        int step = int_vector_iget( summary_measure->step_list , i );
+        if (step < smlength)
+          job->values[ index * num_steps + i ] = summary_get( summary , step );
       }
+      job->length[ index ] = smlength;
+      job->sim_length = util_int_min( job->sim_length , smlength );
     }
-    enkf_node_free( work_node );
   }
+
+  enkf_node_free( work_node );
 }
 
 
-void enkf_obs_get_obs_and_measure_node( const enkf_obs_type      * enkf_obs,
-                                        enkf_fs_type             * fs,
-                                        const local_obsdata_node_type * obs_node ,
-                                        const int_vector_type    * ens_active_list ,
-                                        meas_data_type           * meas_data,
-                                        obs_data_type            * obs_data) {
+static void * summary_measure_load_mt( void * arg ) {
+  summary_measure_load( arg );
+  return NULL;
+}
+
+
+/*
+  Assigns the values loaded by one job to the meas_block; must be
+  called by one thread at a time for each meas_block.
+*/
+
+static void summary_measure_job_assign( const summary_measure_job_type * job ) {
+  const summary_measure_type * summary_measure = job->summary_measure;
+  int num_steps = int_vector_size( summary_measure->step_list );
+
+  for (int index = 0; index < job->index_size; index++) {
+    const int iens = int_vector_iget( job->ens_active_list , job->index_offset + index );
+    for (int i=0; i < num_steps; i++) {
+      int step = int_vector_iget( summary_measure->step_list , i );
+      if (step < job->length[ index ])
+        meas_block_iset( summary_measure->meas_block , iens , i , job->values[ index * num_steps + i ] );
+    }
+  }
+}
+
+
+static void summary_measure_deactivate_steps( const summary_measure_type * summary_measure ) {
+  for (int i=0; i < int_vector_size( summary_measure->step_list ); i++) {
+    int step = int_vector_iget( summary_measure->step_list , i );
+    if (step >= summary_measure->sim_length) {
+      // if obs vector and sim vector have different length
+      // deactivate the observation.
+      char * msg = util_alloc_sprintf("length of observation vector and simulated differ: %d vs. %d ", step, summary_measure->sim_length);
+      meas_block_deactivate( summary_measure->meas_block , i );
+      obs_block_deactivate( summary_measure->obs_block , i , true , msg );
+      free( msg );
+    }
+  }
+}
+
+
+/*
+  Loads the simulated vectors for all the summary_measure instances
+  in @summary_list; each (key, realisation range) combination is one
+  job in the thread pool. The meas_blocks have already been added to
+  the meas_data instance, so the order of the blocks is not affected
+  by the order the jobs are run in. The meas_blocks are assigned when
+  all the jobs have completed.
+*/
+
+static void enkf_obs_load_summary_measure( vector_type * summary_list ,
+                                           enkf_fs_type * fs ,
+                                           const int_vector_type * ens_active_list ,
+                                           int num_threads) {
+  int num_keys = vector_get_size( summary_list );
+  int ens_size = int_vector_size( ens_active_list );
+  if ((num_keys == 0) || (ens_size == 0))
+    return;
+
+  {
+    int num_chunks = util_int_max( 1 , util_int_min( num_threads , ens_size ));
+    summary_measure_job_type * jobs = util_calloc( num_keys * num_chunks , sizeof * jobs );
+    thread_pool_type * tp = thread_pool_alloc( util_int_max( 1 , num_threads ) , true );
+
+    for (int ikey = 0; ikey < num_keys; ikey++) {
+      int index_offset = 0;
+      for (int ichunk = 0; ichunk < num_chunks; ichunk++) {
+        summary_measure_job_type * job = &jobs[ ikey * num_chunks + ichunk ];
+        job->summary_measure = vector_iget( summary_list , ikey );
+        job->fs              = fs;
+        job->ens_active_list = ens_active_list;
+        job->index_offset    = index_offset;
+        job->index_size      = ens_size / num_chunks + ((ichunk < (ens_size % num_chunks)) ? 1 : 0);
+        job->sim_length      = INT_MAX;
+        job->values          = util_calloc( job->index_size * int_vector_size( job->summary_measure->step_list ) , sizeof * job->values );
+        job->length          = util_calloc( job->index_size , sizeof * job->length );
+        index_offset        += job->index_size;
+
+        thread_pool_add_job( tp , summary_measure_load_mt , job );
+      }
+    }
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+
+    for (int i = 0; i < num_keys * num_chunks; i++) {
+      summary_measure_type * summary_measure = jobs[i].summary_measure;
+      summary_measure_job_assign( &jobs[i] );
+      summary_measure->sim_length = util_int_min( summary_measure->sim_length , jobs[i].sim_length );
+      free( jobs[i].values );
+      free( jobs[i].length );
+    }
+    free( jobs );
+  }
+
+  for (int ikey = 0; ikey < num_keys; ikey++)
+    summary_measure_deactivate_steps( vector_iget_const( summary_list , ikey ));
+}
+
+
+
+/*
+  Adds the obs_block and meas_block for one local observation node;
+  the simulated values of SUMMARY_OBS observations are not loaded
+  here, instead a summary_measure instance is appended to
+  @summary_list (if the observation is active). The GEN_OBS and
+  BLOCK_OBS observations are measured straight away.
+*/
+
+static void enkf_obs_get_obs_and_measure_node__( const enkf_obs_type      * enkf_obs,
+                                                 enkf_fs_type             * fs,
+                                                 const local_obsdata_node_type * obs_node ,
+                                                 const int_vector_type    * ens_active_list ,
+                                                 meas_data_type           * meas_data,
+                                                 obs_data_type            * obs_data,
+                                                 vector_type              * summary_list) {
 
   const char * obs_key         = local_obsdata_node_get_key( obs_node );
   obs_vector_type * obs_vector = hash_get( enkf_obs->obs_hash , obs_key );
   obs_impl_type obs_type       = obs_vector_get_impl_type( obs_vector );
 
   if (obs_type == SUMMARY_OBS)  {
-    // this if also used to test: (end_step >= start_step+2)
-    double_vector_type * work_value  = double_vector_alloc( 0 , -1 );
-    double_vector_type * work_std    = double_vector_alloc( 0 , -1 );
-
-    enkf_obs_get_obs_and_measure_summary( enkf_obs ,
-                                          obs_vector ,
-                                          fs ,
-                                          obs_node ,
-                                          ens_active_list ,
-                                          meas_data ,
-                                          obs_data ,
-                                          work_value,
-                                          work_std);
-
-    double_vector_free( work_std   );
-    double_vector_free( work_value );
+    summary_measure_type * summary_measure = enkf_obs_alloc_summary_measure( enkf_obs ,
+                                                                             obs_vector ,
+                                                                             obs_node ,
+                                                                             meas_data ,
+                                                                             obs_data );
+    if (summary_measure)
+      vector_append_owned_ref( summary_list , summary_measure , summary_measure_free__ );
     return;
   }
 
@@ -515,11 +673,60 @@ void enkf_obs_get_obs_and_measure_node( const enkf_obs_type      * enkf_obs,
 }
 
 
+void enkf_obs_get_obs_and_measure_node( const enkf_obs_type      * enkf_obs,
+                                        enkf_fs_type             * fs,
+                                        const local_obsdata_node_type * obs_node ,
+                                        const int_vector_type    * ens_active_list ,
+                                        meas_data_type           * meas_data,
+                                        obs_data_type            * obs_data) {
+
+  vector_type * summary_list = vector_alloc_new();
+  enkf_obs_get_obs_and_measure_node__( enkf_obs , fs , obs_node , ens_active_list , meas_data , obs_data , summary_list );
+  enkf_obs_load_summary_measure( summary_list , fs , ens_active_list , 1 );
+  vector_free( summary_list );
+}
+
+
 /*
   This will append observations and simulated responses from
   report_step to obs_data and meas_data.
   Call obs_data_reset and meas_data_reset on obs_data and meas_data
   if you want to use fresh instances.
+
+  The blocks are added to obs_data and meas_data in the order of the
+  local_obsdata nodes; the loading of the simulated summary vectors
+  is then distributed over @num_threads threads, both across the
+  observation keys and across the realisations.
+*/
+
+void enkf_obs_get_obs_and_measure_data_mt(const enkf_obs_type      * enkf_obs,
+                                          enkf_fs_type             * fs,
+                                          const local_obsdata_type * local_obsdata ,
+                                          const int_vector_type    * ens_active_list ,
+                                          meas_data_type           * meas_data,
+                                          obs_data_type            * obs_data,
+                                          int num_threads) {
+
+  vector_type * summary_list = vector_alloc_new();
+  int iobs;
+  for (iobs = 0; iobs < local_obsdata_get_size( local_obsdata ); iobs++) {
+    const local_obsdata_node_type * obs_node = local_obsdata_iget( local_obsdata , iobs );
+    enkf_obs_get_obs_and_measure_node__( enkf_obs ,
+                                         fs ,
+                                         obs_node ,
+                                         ens_active_list ,
+                                         meas_data ,
+                                         obs_data ,
+                                         summary_list);
+  }
+  enkf_obs_load_summary_measure( summary_list , fs , ens_active_list , num_threads );
+  vector_free( summary_list );
+}
+
+
+/*
+  As enkf_obs_get_obs_and_measure_data_mt(), but all the loading is
+  done by one thread.
 */
 
 void enkf_obs_get_obs_and_measure_data(const enkf_obs_type      * enkf_obs,
@@ -528,18 +735,7 @@ void enkf_obs_get_obs_and_measure_data(const enkf_obs_type      * enkf_obs,
                                        const int_vector_type    * ens_active_list ,
                                        meas_data_type           * meas_data,
                                        obs_data_type            * obs_data) {
-
-
-  int iobs;
-  for (iobs = 0; iobs < local_obsdata_get_size( local_obsdata ); iobs++) {
-    const local_obsdata_node_type * obs_node = local_obsdata_iget( local_obsdata , iobs );
-    enkf_obs_get_obs_and_measure_node( enkf_obs ,
-                                       fs ,
-                                       obs_node ,
-                                       ens_active_list ,
-                                       meas_data ,
-                                       obs_data);
-  }
+  enkf_obs_get_obs_and_measure_data_mt( enkf_obs , fs , local_obsdata , ens_active_list , meas_data , obs_data , 1 );
 }
 
 
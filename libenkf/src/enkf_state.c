@@ -604,24 +604,53 @@ static bool enkf_state_internalize_dynamic_eclipse_results(enkf_state_type * enk
 
         const ecl_smspec_type * smspec = ecl_sum_get_smspec(summary);
 
-        for(int i = 0; i < ecl_smspec_num_nodes(smspec); i++) {
+        /*
+          All the matched summary vectors are first loaded from the
+          storage in one batch, so that what is currently on file is
+          kept for the steps before load_start. They are then updated
+          from the ecl_sum instance with one common mapping from the
+          stored vector to the ministeps in the summary file, and
+          stored in one batch; i.e. one read and one write round trip
+          to the storage for the realisation instead of one for each
+          key.
+        */
+        {
+          summary_key_set_type * key_set = enkf_fs_get_summary_key_set(result_fs);
+          int_vector_type * ministep_index = summary_alloc_ministep_index( summary , time_index );
+          enkf_node_type ** nodes = util_calloc( util_int_max( ecl_smspec_num_nodes(smspec) , 1 ) , sizeof * nodes );
+          int * params_index = util_calloc( util_int_max( ecl_smspec_num_nodes(smspec) , 1 ) , sizeof * params_index );
+          int num_nodes = 0;
+
+          for(int i = 0; i < ecl_smspec_num_nodes(smspec); i++) {
             const smspec_node_type * smspec_node = ecl_smspec_iget_node(smspec, i);
             const char * key = smspec_node_get_gen_key1(smspec_node);
 
             if(summary_key_matcher_match_summary_key(matcher, key)) {
-                summary_key_set_type * key_set = enkf_fs_get_summary_key_set(result_fs);
-                summary_key_set_add_summary_key(key_set, key);
+              summary_key_set_add_summary_key(key_set, key);
 
-                enkf_config_node_type * config_node = ensemble_config_get_or_create_summary_node(enkf_state->ensemble_config, key);
-                enkf_node_type * node = enkf_state_get_or_create_node(enkf_state, config_node);
+              enkf_config_node_type * config_node = ensemble_config_get_or_create_summary_node(enkf_state->ensemble_config, key);
+              enkf_node_type * node = enkf_state_get_or_create_node(enkf_state, config_node);
 
+              if (enkf_node_get_impl_type( node ) == SUMMARY) {
+                params_index[num_nodes] = ecl_sum_get_general_var_params_index( summary , key );
+                nodes[num_nodes++] = node;
+              } else {
                 enkf_node_try_load_vector( node , result_fs , iens );  // Ensure that what is currently on file is loaded before we update.
-
                 enkf_node_forward_load_vector( node , load_context , time_index);
                 enkf_node_store_vector( node , result_fs , iens );
+              }
             }
-        }
+          }
 
+          enkf_node_try_load_vectors( nodes , num_nodes , result_fs , iens );
+          for (int inode = 0; inode < num_nodes; inode++)
+            summary_load_params_index( enkf_node_value_ptr( nodes[inode] ) , summary , params_index[inode] , ministep_index );
+          enkf_node_store_vectors( nodes , num_nodes , result_fs , iens );
+
+          free( params_index );
+          free( nodes );
+          int_vector_free( ministep_index );
+        }
         int_vector_free( time_index );
 
         /*
@@ -814,11 +843,23 @@ static void enkf_state_internalize_eclipse_state(enkf_state_type * enkf_state ,
 
 
 
+/*
+  Only the summary vectors which will actually be internalized are
+  loaded from the summary files, i.e. the keys of the SUMMARY nodes
+  and the keys/patterns in the summary key matcher.
+*/
+
 static forward_load_context_type * enkf_state_alloc_load_context( const enkf_state_type * state , run_arg_type * run_arg, stringlist_type * messages) {
-  bool load_summary = ensemble_config_has_impl_type(state->ensemble_config, SUMMARY);
-  if (!load_summary) {
-    const summary_key_matcher_type * matcher = ensemble_config_get_summary_key_matcher(state->ensemble_config);
+  const summary_key_matcher_type * matcher = ensemble_config_get_summary_key_matcher(state->ensemble_config);
+  stringlist_type * summary_keys = ensemble_config_alloc_keylist_from_impl_type(state->ensemble_config, SUMMARY);
+  bool load_summary = (stringlist_get_size( summary_keys ) > 0);
+  if (!load_summary)
     load_summary = (summary_key_matcher_get_size(matcher) > 0);
+
+  {
+    stringlist_type * matcher_keys = summary_key_matcher_get_keys( matcher );
+    stringlist_append_stringlist_copy( summary_keys , matcher_keys );
+    stringlist_free( matcher_keys );
   }
 
   {
@@ -826,11 +867,13 @@ static forward_load_context_type * enkf_state_alloc_load_context( const enkf_sta
     const ecl_config_type * ecl_config = state->shared_info->ecl_config;
     const char * eclbase = enkf_state_get_eclbase( state );
 
-    load_context = forward_load_context_alloc( run_arg,
-                                               load_summary,
-                                               ecl_config ,
-                                               eclbase,
-                                               messages );
+    load_context = forward_load_context_alloc_restricted( run_arg,
+                                                          load_summary,
+                                                          summary_keys,
+                                                          ecl_config ,
+                                                          eclbase,
+                                                          messages );
+    stringlist_free( summary_keys );
     return load_context;
   }
 }
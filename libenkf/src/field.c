@@ -540,6 +540,23 @@ bool field_write_to_buffer(const field_type * field , buffer_type * buffer , int
 }
 
 
+/*
+  Storage of parameter fields in a filesystem with field blocks; the
+  data is stored as it is, without going through a buffer.
+*/
+
+void field_store_blocks(const field_type * field , enkf_fs_type * fs , int iens) {
+  int byte_size = field_config_get_byte_size( field->config );
+  enkf_fs_fwrite_field_node( fs , field_config_get_key( field->config ) , iens , field->data , byte_size );
+}
+
+
+void field_load_blocks(field_type * field , enkf_fs_type * fs , int iens) {
+  int byte_size = field_config_get_byte_size( field->config );
+  enkf_fs_fread_field_node( fs , field_config_get_key( field->config ) , iens , field->data , byte_size );
+}
+
+
 
 void field_ecl_write1D_fortio(const field_type * field , fortio_type * fortio) {
   const int data_size = field_config_get_data_size(field->config );
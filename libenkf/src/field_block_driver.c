@@ -0,0 +1,553 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'field_block_driver.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <ert/util/util.h>
+#include <ert/util/hash.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/enkf/field_block_driver.h>
+
+/**
+   The field_block_driver stores FIELD parameters ensemble-major. The
+   normal drivers store one compressed blob for each (key, iens); to
+   get a subset of the cells for all the realisations in the update
+   every member must be loaded and uncompressed completely. Here all
+   the realisations of one FIELD are stored in one file, split in
+   blocks of cells, where all the realisations of one block are stored
+   next to each other. The cells of a localized region are then read
+   for all realisations with a few contiguous reads, which map
+   directly onto rows of the A matrix.
+
+   The data is stored uncompressed in the native element type of the
+   field; the driver itself only deals with bytes. The file layout is:
+
+     [ header ][ group 0 ][ group 1 ] ....
+
+   The header is FIELD_BLOCK_HEADER_SIZE bytes, with the format
+   information at the start and a bitmap of the realisations which
+   have been stored at offset FIELD_BLOCK_MAP_OFFSET. The realisations
+   are split in groups of group_size realisations, so that the file
+   can grow without knowing the ensemble size up front. Each group
+   holds group_size * byte_size bytes:
+
+     [ block 0 : iens0 iens1 ... ][ block 1 : iens0 iens1 ... ] ....
+
+   where each block holds block_size bytes of each realisation; the
+   last block is shorter if block_size does not divide byte_size.
+
+   The files are accessed with pread() / pwrite() and can be read and
+   written concurrently for different realisations, the bitmap is
+   protected by a mutex. Observe that parameters are only stored at
+   report_step 0, so there is no report_step in the interface.
+*/
+
+#define FIELD_BLOCK_DRIVER_TYPE_ID 7710364
+
+#define FIELD_BLOCK_MAGIC          77100213
+#define FIELD_BLOCK_VERSION        1
+#define FIELD_BLOCK_HEADER_SIZE    4096
+#define FIELD_BLOCK_MAP_OFFSET     64
+#define FIELD_BLOCK_MAP_SIZE       (FIELD_BLOCK_HEADER_SIZE - FIELD_BLOCK_MAP_OFFSET)
+#define FIELD_BLOCK_MAX_MEMBERS    (FIELD_BLOCK_MAP_SIZE * 8)
+
+#define FIELD_BLOCK_SIZE           16384  /* Bytes of each realisation in one block; a multiple of sizeof(double). */
+#define FIELD_BLOCK_GROUP_SIZE     64
+
+
+typedef struct {
+  char            * filename;
+  int               fd;
+  int64_t           byte_size;
+  int               block_size;
+  int               group_size;
+  int               num_blocks;
+  unsigned char     member_map[FIELD_BLOCK_MAP_SIZE];
+  pthread_mutex_t   mutex;
+} field_block_file_type;
+
+
+struct field_block_driver_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  char            * path;
+  bool              read_only;
+  hash_type       * files;
+  pthread_mutex_t   mutex;        /* Protects the files hash. */
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( field_block_driver , FIELD_BLOCK_DRIVER_TYPE_ID )
+
+/*****************************************************************/
+
+static void field_block_pread( const field_block_file_type * file , void * data , size_t size , off_t offset) {
+  char * ptr = data;
+  while (size > 0) {
+    ssize_t bytes_read = pread( file->fd , ptr , size , offset );
+    if (bytes_read > 0) {
+      ptr    += bytes_read;
+      offset += bytes_read;
+      size   -= bytes_read;
+    } else if (bytes_read == 0) {
+      /* Reading a part of the file which has never been written. */
+      memset( ptr , 0 , size );
+      size = 0;
+    } else if (errno != EINTR)
+      util_abort("%s: failed to read from %s: %s \n",__func__ , file->filename , strerror( errno ));
+  }
+}
+
+
+static void field_block_pwrite( const field_block_file_type * file , const void * data , size_t size , off_t offset) {
+  const char * ptr = data;
+  while (size > 0) {
+    ssize_t bytes_written = pwrite( file->fd , ptr , size , offset );
+    if (bytes_written >= 0) {
+      ptr    += bytes_written;
+      offset += bytes_written;
+      size   -= bytes_written;
+    } else if (errno != EINTR)
+      util_abort("%s: failed to write to %s: %s \n",__func__ , file->filename , strerror( errno ));
+  }
+}
+
+
+static int field_block_file_get_num_blocks( int64_t byte_size , int block_size ) {
+  return (int) ((byte_size + block_size - 1) / block_size);
+}
+
+
+static field_block_file_type * field_block_file_alloc__( const char * filename , int fd ) {
+  field_block_file_type * file = util_malloc( sizeof * file );
+  file->filename = util_alloc_string_copy( filename );
+  file->fd       = fd;
+  memset( file->member_map , 0 , sizeof file->member_map );
+  pthread_mutex_init( &file->mutex , NULL );
+  return file;
+}
+
+
+static void field_block_file_free( field_block_file_type * file ) {
+  close( file->fd );
+  pthread_mutex_destroy( &file->mutex );
+  free( file->filename );
+  free( file );
+}
+
+
+static void field_block_file_free__( void * arg ) {
+  field_block_file_free( arg );
+}
+
+
+static field_block_file_type * field_block_file_create( const char * filename , int64_t byte_size ) {
+  int fd = open( filename , O_RDWR | O_CREAT | O_TRUNC , S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH );
+  if (fd == -1)
+    util_abort("%s: failed to create %s: %s \n",__func__ , filename , strerror( errno ));
+  {
+    field_block_file_type * file = field_block_file_alloc__( filename , fd );
+    char header[FIELD_BLOCK_HEADER_SIZE];
+    int  header_int[4] = { FIELD_BLOCK_MAGIC , FIELD_BLOCK_VERSION , FIELD_BLOCK_SIZE , FIELD_BLOCK_GROUP_SIZE };
+
+    file->byte_size  = byte_size;
+    file->block_size = FIELD_BLOCK_SIZE;
+    file->group_size = FIELD_BLOCK_GROUP_SIZE;
+    file->num_blocks = field_block_file_get_num_blocks( byte_size , file->block_size );
+
+    memset( header , 0 , sizeof header );
+    memcpy( header , header_int , sizeof header_int );
+    memcpy( &header[ sizeof header_int ] , &byte_size , sizeof byte_size );
+    field_block_pwrite( file , header , sizeof header , 0 );
+    return file;
+  }
+}
+
+
+/*
+  Returns NULL if the file is not a valid field block file; failing
+  to open the file is fatal.
+*/
+
+static field_block_file_type * field_block_file_open( const char * filename , bool read_only ) {
+  int fd = open( filename , read_only ? O_RDONLY : O_RDWR );
+  if (fd == -1)
+    util_abort("%s: failed to open %s: %s \n",__func__ , filename , strerror( errno ));
+  {
+    field_block_file_type * file = field_block_file_alloc__( filename , fd );
+    char header[FIELD_BLOCK_HEADER_SIZE];
+    int  header_int[4];
+    ssize_t bytes_read = pread( fd , header , sizeof header , 0 );
+
+    if (bytes_read == sizeof header) {
+      memcpy( header_int , header , sizeof header_int );
+      memcpy( &file->byte_size , &header[ sizeof header_int ] , sizeof file->byte_size );
+      if ((header_int[0] == FIELD_BLOCK_MAGIC) && (header_int[1] == FIELD_BLOCK_VERSION) && (header_int[2] > 0) && (header_int[3] > 0)) {
+        file->block_size = header_int[2];
+        file->group_size = header_int[3];
+        file->num_blocks = field_block_file_get_num_blocks( file->byte_size , file->block_size );
+        memcpy( file->member_map , &header[ FIELD_BLOCK_MAP_OFFSET ] , sizeof file->member_map );
+        return file;
+      }
+    }
+
+    fprintf(stderr,"** Warning: %s is not a valid field block file - ignored.\n", filename );
+    field_block_file_free( file );
+    return NULL;
+  }
+}
+
+
+static bool field_block_file_has_member( const field_block_file_type * file , int iens ) {
+  if ((iens < 0) || (iens >= FIELD_BLOCK_MAX_MEMBERS))
+    return false;
+  return (file->member_map[ iens / 8 ] & (1 << (iens % 8))) != 0;
+}
+
+
+/*
+  The bit for @iens is updated both in memory and on disk. The data
+  must be written before the bit is set.
+*/
+
+static void field_block_file_set_member( field_block_file_type * file , int iens ) {
+  pthread_mutex_lock( &file->mutex );
+  {
+    unsigned char * map_byte = &file->member_map[ iens / 8 ];
+    *map_byte |= 1 << (iens % 8);
+    field_block_pwrite( file , map_byte , 1 , FIELD_BLOCK_MAP_OFFSET + iens / 8 );
+  }
+  pthread_mutex_unlock( &file->mutex );
+}
+
+
+static void field_block_file_assert_member( const field_block_file_type * file , int iens ) {
+  if (!field_block_file_has_member( file , iens ))
+    util_abort("%s: no data for realisation:%d in %s \n",__func__ , iens , file->filename );
+}
+
+
+static int field_block_file_iget_block_size( const field_block_file_type * file , int block ) {
+  int64_t remaining = file->byte_size - (int64_t) block * file->block_size;
+  if (remaining < file->block_size)
+    return (int) remaining;
+  else
+    return file->block_size;
+}
+
+
+/*
+  The offset of the start of @block for the first realisation in the
+  group of @iens.
+*/
+
+static off_t field_block_file_get_block_offset( const field_block_file_type * file , int block , int iens) {
+  int64_t group = iens / file->group_size;
+  return FIELD_BLOCK_HEADER_SIZE + group * file->group_size * file->byte_size + (int64_t) block * file->block_size * file->group_size;
+}
+
+
+/*
+  Reads or writes bytes [offset, offset + size) of the realisations
+  [iens1, iens2) from / to the member_data pointers; realisations
+  with member_data[iens - iens1] == NULL are skipped. For each block
+  and group of realisations the range is covered by one contiguous
+  read, and when writing a part of a block one read and one write.
+*/
+
+static void field_block_file_transfer( field_block_file_type * file , size_t offset , size_t size , int iens1 , int iens2 , void ** member_data , bool write) {
+  char * scratch = NULL;
+
+  if ((int64_t) (offset + size) > file->byte_size)
+    util_abort("%s: range [%zu,%zu) is outside the %ld bytes of %s \n",__func__ , offset , offset + size , (long) file->byte_size , file->filename);
+
+  for (int iens = iens1; iens < iens2; iens++) {
+    if (member_data[iens - iens1] != NULL)
+      field_block_file_assert_member( file , iens );
+  }
+
+  if (size == 0)
+    return;
+
+  {
+    int block1 = offset / file->block_size;
+    int block2 = (offset + size - 1) / file->block_size + 1;
+
+    for (int block = block1; block < block2; block++) {
+      size_t block_start = (size_t) block * file->block_size;
+      int    block_size  = field_block_file_iget_block_size( file , block );
+      size_t pos1        = util_size_t_max( offset , block_start ) - block_start;
+      size_t pos2        = util_size_t_min( offset + size , block_start + block_size ) - block_start;
+      size_t data_offset = block_start + pos1 - offset;
+      int    group_start = iens1;
+
+      while (group_start < iens2) {
+        int group_end = util_int_min( iens2 , (group_start / file->group_size + 1) * file->group_size );
+        int first     = group_start;
+        int last      = group_end - 1;
+
+        while ((first <= last) && (member_data[first - iens1] == NULL))
+          first++;
+        while ((last >= first) && (member_data[last - iens1] == NULL))
+          last--;
+
+        if (first <= last) {
+          off_t block_offset = field_block_file_get_block_offset( file , block , first );
+          off_t span_start   = block_offset + (off_t) (first % file->group_size) * block_size + pos1;
+          off_t span_end     = block_offset + (off_t) (last  % file->group_size) * block_size + pos2;
+
+          if (first == last) {
+            char * data = member_data[ first - iens1 ];
+            if (write)
+              field_block_pwrite( file , &data[data_offset] , pos2 - pos1 , span_start );
+            else
+              field_block_pread( file , &data[data_offset] , pos2 - pos1 , span_start );
+          } else {
+            bool complete = ((pos2 - pos1) == (size_t) block_size);
+
+            if (scratch == NULL)
+              scratch = util_malloc( (size_t) file->group_size * file->block_size );
+
+            for (int iens = first; iens <= last; iens++)
+              complete = complete && (member_data[iens - iens1] != NULL);
+
+            if (!write || !complete)
+              field_block_pread( file , scratch , span_end - span_start , span_start );
+
+            for (int iens = first; iens <= last; iens++) {
+              char * data = member_data[ iens - iens1 ];
+              if (data) {
+                char * scratch_data = &scratch[ (size_t) (iens - first) * block_size ];
+                if (write)
+                  memcpy( scratch_data , &data[data_offset] , pos2 - pos1 );
+                else
+                  memcpy( &data[data_offset] , scratch_data , pos2 - pos1 );
+              }
+            }
+
+            if (write)
+              field_block_pwrite( file , scratch , span_end - span_start , span_start );
+          }
+        }
+        group_start = group_end;
+      }
+    }
+  }
+
+  free( scratch );
+}
+
+
+/*****************************************************************/
+
+
+field_block_driver_type * field_block_driver_alloc( const char * path , bool read_only ) {
+  field_block_driver_type * driver = util_malloc( sizeof * driver );
+  UTIL_TYPE_ID_INIT( driver , FIELD_BLOCK_DRIVER_TYPE_ID );
+  driver->path      = util_alloc_string_copy( path );
+  driver->read_only = read_only;
+  driver->files     = hash_alloc();
+  pthread_mutex_init( &driver->mutex , NULL );
+
+  if (!read_only)
+    util_make_path( path );
+
+  {
+    DIR * dirH = opendir( path );
+    if (dirH) {
+      struct dirent * dentry;
+      while ((dentry = readdir( dirH )) != NULL) {
+        if (dentry->d_name[0] != '.') {
+          char * filename = util_alloc_filename( path , dentry->d_name , NULL );
+          if (util_is_file( filename )) {
+            field_block_file_type * file = field_block_file_open( filename , read_only );
+            if (file)
+              hash_insert_hash_owned_ref( driver->files , dentry->d_name , file , field_block_file_free__ );
+          }
+          free( filename );
+        }
+      }
+      closedir( dirH );
+    }
+  }
+
+  return driver;
+}
+
+
+void field_block_driver_free( field_block_driver_type * driver ) {
+  hash_free( driver->files );
+  pthread_mutex_destroy( &driver->mutex );
+  free( driver->path );
+  free( driver );
+}
+
+
+void field_block_driver_fsync( field_block_driver_type * driver ) {
+  if (!driver->read_only) {
+    pthread_mutex_lock( &driver->mutex );
+    {
+      hash_iter_type * iter = hash_iter_alloc( driver->files );
+      while (!hash_iter_is_complete( iter )) {
+        field_block_file_type * file = hash_iter_get_next_value( iter );
+        fsync( file->fd );
+      }
+      hash_iter_free( iter );
+    }
+    pthread_mutex_unlock( &driver->mutex );
+  }
+}
+
+
+static field_block_file_type * field_block_driver_get_file( field_block_driver_type * driver , const char * key ) {
+  field_block_file_type * file = NULL;
+  pthread_mutex_lock( &driver->mutex );
+  if (hash_has_key( driver->files , key ))
+    file = hash_get( driver->files , key );
+  pthread_mutex_unlock( &driver->mutex );
+  return file;
+}
+
+
+static field_block_file_type * field_block_driver_get_existing_file( field_block_driver_type * driver , const char * key ) {
+  field_block_file_type * file = field_block_driver_get_file( driver , key );
+  if (file == NULL)
+    util_abort("%s: no field blocks stored for:%s \n",__func__ , key );
+  return file;
+}
+
+
+/*
+  Returns the file for @key, the file is created if it does not
+  exist. The size of a FIELD can not change.
+*/
+
+static field_block_file_type * field_block_driver_get_write_file( field_block_driver_type * driver , const char * key , size_t byte_size) {
+  field_block_file_type * file;
+
+  if (driver->read_only)
+    util_abort("%s: attempt to write:%s to a read only driver \n",__func__ , key );
+
+  pthread_mutex_lock( &driver->mutex );
+  if (hash_has_key( driver->files , key ))
+    file = hash_get( driver->files , key );
+  else {
+    char * filename = util_alloc_filename( driver->path , key , NULL );
+    file = field_block_file_create( filename , byte_size );
+    hash_insert_hash_owned_ref( driver->files , key , file , field_block_file_free__ );
+    free( filename );
+  }
+  pthread_mutex_unlock( &driver->mutex );
+
+  if (file->byte_size != (int64_t) byte_size)
+    util_abort("%s: size mismatch for %s: %zu bytes - stored with %ld bytes \n",__func__ , key , byte_size , (long) file->byte_size);
+
+  return file;
+}
+
+
+int field_block_driver_get_block_size( field_block_driver_type * driver , const char * key ) {
+  field_block_file_type * file = field_block_driver_get_existing_file( driver , key );
+  return file->block_size;
+}
+
+
+bool field_block_driver_has_key( field_block_driver_type * driver , const char * key ) {
+  return (field_block_driver_get_file( driver , key ) != NULL);
+}
+
+
+bool field_block_driver_has_node( field_block_driver_type * driver , const char * key , int iens ) {
+  field_block_file_type * file = field_block_driver_get_file( driver , key );
+  if (file)
+    return field_block_file_has_member( file , iens );
+  else
+    return false;
+}
+
+
+void field_block_driver_save_node( field_block_driver_type * driver , const char * key , int iens , const void * data , size_t byte_size ) {
+  field_block_file_type * file = field_block_driver_get_write_file( driver , key , byte_size );
+  const char * char_data = data;
+
+  if ((iens < 0) || (iens >= FIELD_BLOCK_MAX_MEMBERS))
+    util_abort("%s: realisation:%d outside the supported range [0,%d) \n",__func__ , iens , FIELD_BLOCK_MAX_MEMBERS);
+
+  for (int block = 0; block < file->num_blocks; block++) {
+    int block_size = field_block_file_iget_block_size( file , block );
+    off_t offset   = field_block_file_get_block_offset( file , block , iens ) + (off_t) (iens % file->group_size) * block_size;
+    field_block_pwrite( file , &char_data[ (size_t) block * file->block_size ] , block_size , offset );
+  }
+
+  if (!field_block_file_has_member( file , iens ))
+    field_block_file_set_member( file , iens );
+}
+
+
+void field_block_driver_load_node( field_block_driver_type * driver , const char * key , int iens , void * data , size_t byte_size ) {
+  field_block_file_type * file = field_block_driver_get_existing_file( driver , key );
+  char * char_data = data;
+
+  if (file->byte_size != (int64_t) byte_size)
+    util_abort("%s: size mismatch for %s: %zu bytes - stored with %ld bytes \n",__func__ , key , byte_size , (long) file->byte_size);
+  field_block_file_assert_member( file , iens );
+
+  for (int block = 0; block < file->num_blocks; block++) {
+    int block_size = field_block_file_iget_block_size( file , block );
+    off_t offset   = field_block_file_get_block_offset( file , block , iens ) + (off_t) (iens % file->group_size) * block_size;
+    field_block_pread( file , &char_data[ (size_t) block * file->block_size ] , block_size , offset );
+  }
+}
+
+
+/**
+   Loads bytes [offset, offset + size) of the realisations [iens1,
+   iens2); the data for realisation iens is stored in
+   member_data[iens - iens1], which must hold @size bytes, or be NULL
+   to skip that realisation. All realisations which are not skipped
+   must have been stored.
+*/
+
+void field_block_driver_load_range( field_block_driver_type * driver , const char * key , size_t offset , size_t size , int iens1 , int iens2 , void ** member_data ) {
+  field_block_file_type * file = field_block_driver_get_existing_file( driver , key );
+  field_block_file_transfer( file , offset , size , iens1 , iens2 , member_data , false );
+}
+
+
+/**
+   The reverse of field_block_driver_load_range(); the realisations
+   must already have been stored with field_block_driver_save_node(),
+   only the bytes in the range are updated.
+*/
+
+void field_block_driver_save_range( field_block_driver_type * driver , const char * key , size_t offset , size_t size , int iens1 , int iens2 , void ** member_data ) {
+  field_block_file_type * file = field_block_driver_get_existing_file( driver , key );
+  if (driver->read_only)
+    util_abort("%s: attempt to write:%s to a read only driver \n",__func__ , key );
+  field_block_file_transfer( file , offset , size , iens1 , iens2 , member_data , true );
+}
@@ -51,7 +51,7 @@ UTIL_IS_INSTANCE_FUNCTION( forward_load_context , FORWARD_LOAD_CONTEXT_TYPE_ID)
 
 
 
-static void forward_load_context_load_ecl_sum(forward_load_context_type * load_context) {
+static void forward_load_context_load_ecl_sum(forward_load_context_type * load_context , const stringlist_type * summary_keys) {
   ecl_sum_type * summary                 = NULL;
 
   if (ecl_config_active( load_context->ecl_config )) {
@@ -91,7 +91,7 @@ static void forward_load_context_load_ecl_sum(forward_load_context_type * load_c
     }
 
     if ((header_file != NULL) && (stringlist_get_size(data_files) > 0)) {
-      summary = ecl_sum_fread_alloc(header_file , data_files , SUMMARY_KEY_JOIN_STRING );
+      summary = ecl_sum_fread_alloc_restricted(header_file , data_files , SUMMARY_KEY_JOIN_STRING , summary_keys );
       {
         time_t end_time = ecl_config_get_end_date( load_context->ecl_config );
         if (end_time > 0) {
@@ -134,7 +134,13 @@ static void forward_load_context_load_ecl_sum(forward_load_context_type * load_c
 
 
 
-forward_load_context_type * forward_load_context_alloc( const run_arg_type * run_arg , bool load_summary , const ecl_config_type * ecl_config , const char * eclbase , stringlist_type * messages) {
+/*
+  If @summary_keys is non NULL only the summary vectors matching one of
+  the (possibly wildcarded) keys are loaded from the summary files;
+  with NULL all the vectors are loaded.
+*/
+
+forward_load_context_type * forward_load_context_alloc_restricted( const run_arg_type * run_arg , bool load_summary , const stringlist_type * summary_keys , const ecl_config_type * ecl_config , const char * eclbase , stringlist_type * messages) {
   forward_load_context_type * load_context = util_malloc( sizeof * load_context );
   UTIL_TYPE_ID_INIT( load_context , FORWARD_LOAD_CONTEXT_TYPE_ID );
 
@@ -148,12 +154,17 @@ forward_load_context_type * forward_load_context_alloc( const run_arg_type * run
   load_context->eclbase = util_alloc_string_copy( eclbase );
 
   if (load_summary)
-    forward_load_context_load_ecl_sum(load_context);
+    forward_load_context_load_ecl_sum(load_context , summary_keys);
 
   return load_context;
 }
 
 
+forward_load_context_type * forward_load_context_alloc( const run_arg_type * run_arg , bool load_summary , const ecl_config_type * ecl_config , const char * eclbase , stringlist_type * messages) {
+  return forward_load_context_alloc_restricted( run_arg , load_summary , NULL , ecl_config , eclbase , messages );
+}
+
+
 
 bool forward_load_context_accept_messages( const forward_load_context_type * load_context ) {
   if (load_context->messages)
@@ -43,7 +43,9 @@ void fs_driver_init(fs_driver_type * driver) {
   driver->unlink_node = NULL;
 
   driver->load_vector   = NULL;
+  driver->load_vectors  = NULL;
   driver->save_vector   = NULL;
+  driver->save_vectors  = NULL;
   driver->has_vector    = NULL;
   driver->unlink_vector = NULL;
   
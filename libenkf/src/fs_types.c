@@ -30,6 +30,8 @@ fs_driver_impl fs_types_lookup_string_name(const char * driver_name) {
     return PLAIN_DRIVER_ID;
   else if (strcmp(driver_name , "BLOCK_FS") == 0)
     return BLOCK_FS_DRIVER_ID;
+  else if (strcmp(driver_name , "BLOCK_FS_FIELD") == 0)
+    return BLOCK_FS_FIELD_DRIVER_ID;
   else {
     util_abort("%s: could not determine driver type for input:%s \n",__func__ , driver_name);
     return INVALID_DRIVER_ID;
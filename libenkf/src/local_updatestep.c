@@ -19,6 +19,7 @@
 #include <ert/util/util.h>
 #include <ert/util/hash.h>
 #include <ert/util/vector.h>
+#include <ert/util/stringlist.h>
 
 #include <ert/enkf/local_ministep.h>
 #include <ert/enkf/local_updatestep.h>
@@ -111,6 +112,50 @@ int local_updatestep_get_num_ministep( const local_updatestep_type * updatestep)
   return vector_get_size( updatestep->ministep );
 }
 
+
+/**
+   Returns the number of consecutive ministeps, starting with ministep
+   @first, which do not update any common nodes; such ministeps can be
+   updated concurrently. The return value is at most @max_size, and at
+   least one as long as @first is a valid ministep index.
+
+   Two ministeps which update the same key are never considered
+   independent, even if their active lists for that key are
+   disjoint: each ministep loads the complete node from the target
+   case, updates the active elements and stores the complete node
+   again, so concurrent updates of the same node would overwrite each
+   other.
+*/
+
+int local_updatestep_get_independent_ministeps( const local_updatestep_type * updatestep , int first , int max_size) {
+  hash_type * data_keys = hash_alloc();
+  int num_ministep = 0;
+
+  while ((first + num_ministep) < vector_get_size( updatestep->ministep ) && (num_ministep < max_size)) {
+    const local_ministep_type * ministep = vector_iget_const( updatestep->ministep , first + num_ministep );
+    stringlist_type * ministep_keys = local_ministep_alloc_data_keys( ministep );
+    bool overlap = false;
+
+    for (int i = 0; i < stringlist_get_size( ministep_keys ); i++) {
+      if (hash_has_key( data_keys , stringlist_iget( ministep_keys , i )))
+        overlap = true;
+    }
+
+    if (!overlap) {
+      for (int i = 0; i < stringlist_get_size( ministep_keys ); i++)
+        hash_insert_int( data_keys , stringlist_iget( ministep_keys , i ) , 1 );
+      num_ministep++;
+    }
+    stringlist_free( ministep_keys );
+
+    if (overlap)
+      break;
+  }
+
+  hash_free( data_keys );
+  return num_ministep;
+}
+
 const char * local_updatestep_get_name( const local_updatestep_type * updatestep ) {
   return updatestep->name;
 }
@@ -247,6 +247,37 @@ bool summary_forward_load(summary_type * summary , const char * ecl_file_name ,
 
 
 
+/**
+   Maps each element of the stored vector to the ministep in @ecl_sum
+   with the value for that element, i.e. the last ministep of the
+   report step given by @time_index; elements which should not be
+   loaded get the value -1. The mapping is common to all the summary
+   vectors in one ecl_sum instance, so when loading many vectors it
+   should be calculated once and passed to summary_load_params_index().
+*/
+
+int_vector_type * summary_alloc_ministep_index( const ecl_sum_type * ecl_sum , const int_vector_type * time_index) {
+  int_vector_type * ministep_index = int_vector_alloc( int_vector_size( time_index ) , -1 );
+
+  for (int store_index = 0; store_index < int_vector_size( time_index ); store_index++) {
+    int summary_index = int_vector_iget( time_index , store_index );
+
+    if ((summary_index >= 0) && ecl_sum_has_report_step( ecl_sum , summary_index ))
+      int_vector_iset( ministep_index , store_index , ecl_sum_iget_report_end( ecl_sum , summary_index ));
+  }
+  return ministep_index;
+}
+
+
+void summary_load_params_index( summary_type * summary , const ecl_sum_type * ecl_sum , int params_index , const int_vector_type * ministep_index) {
+  for (int store_index = 0; store_index < int_vector_size( ministep_index ); store_index++) {
+    int ministep = int_vector_iget( ministep_index , store_index );
+    if (ministep >= 0)
+      double_vector_iset( summary->data_vector , store_index , ecl_sum_iget( ecl_sum , ministep , params_index ));
+  }
+}
+
+
 bool summary_forward_load_vector(summary_type * summary , 
 				 const char * ecl_file_name , 
 				 const forward_load_context_type * load_context , 
@@ -284,18 +315,10 @@ bool summary_forward_load_vector(summary_type * summary ,
       
     if (normal_load) {
       int key_index  = ecl_sum_get_general_var_params_index( ecl_sum , var_key );
-      
-      for (int store_index = 0; store_index < int_vector_size( time_index ); store_index++) {
-        int summary_index = int_vector_iget( time_index , store_index );
-        
-        if (summary_index >= 0) {
-          if (ecl_sum_has_report_step( ecl_sum , summary_index )) {
-            int last_ministep_index = ecl_sum_iget_report_end( ecl_sum , summary_index );
-            double_vector_iset( summary->data_vector , store_index , ecl_sum_iget(ecl_sum , last_ministep_index  , key_index ));
-          }
-        }
-        
-      }
+      int_vector_type * ministep_index = summary_alloc_ministep_index( ecl_sum , time_index );
+
+      summary_load_params_index( summary , ecl_sum , key_index , ministep_index );
+      int_vector_free( ministep_index );
       loadOK = true;
     }
   } 
@@ -58,6 +58,25 @@ int main(int argc , char ** argv) {
   active_list_copy( active_list1 , active_list2 );
   test_assert_true(active_list_equal( active_list1 , active_list2 ));
 
+  {
+    active_list_type * all_active = active_list_alloc( );
+    active_list_type * subset1 = active_list_alloc_subset( all_active , 5 , 3 );
+    active_list_type * subset2 = active_list_alloc_subset( active_list1 , 1 , 2 );
+
+    test_assert_int_equal( PARTLY_ACTIVE , active_list_get_mode( subset1 ));
+    test_assert_int_equal( 3 , active_list_get_active_size( subset1 , 100 ));
+    test_assert_int_equal( 5 , active_list_get_active( subset1 )[0] );
+    test_assert_int_equal( 7 , active_list_get_active( subset1 )[2] );
+
+    test_assert_int_equal( 2 , active_list_get_active_size( subset2 , 100 ));
+    test_assert_int_equal( 12 , active_list_get_active( subset2 )[0] );
+    test_assert_int_equal( 13 , active_list_get_active( subset2 )[1] );
+
+    active_list_free( subset2 );
+    active_list_free( subset1 );
+    active_list_free( all_active );
+  }
+
   active_list_free( active_list1 );
   active_list_free( active_list2 );
   exit(0);
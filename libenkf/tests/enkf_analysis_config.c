@@ -121,6 +121,32 @@ void test_stop_long_running( ) {
   analysis_config_free( ac );
 }
 
+void test_memory_limit( ) {
+  analysis_config_type * ac = create_analysis_config( );
+  test_assert_int_equal( 0 , analysis_config_get_memory_limit( ac ));
+  test_assert_int_equal( -1 , analysis_config_get_max_block_rows( ac , 100 ));
+
+  analysis_config_set_memory_limit( ac , 100 * 1024 * 1024 );
+  test_assert_size_t_equal( 100 * 1024 * 1024 , analysis_config_get_memory_limit( ac ));
+  test_assert_int_equal( 100 * 1024 * 1024 / (100 * sizeof(double)) , analysis_config_get_max_block_rows( ac , 100 ));
+
+  analysis_config_set_memory_limit( ac , 10 );
+  test_assert_int_equal( 1 , analysis_config_get_max_block_rows( ac , 100 ));
+  analysis_config_free( ac );
+}
+
+void test_num_threads( ) {
+  analysis_config_type * ac = create_analysis_config( );
+  test_assert_true( analysis_config_get_num_threads( ac ) >= 1 );
+  test_assert_int_equal( util_get_num_cpu( ) , analysis_config_get_num_threads( ac ));
+
+  analysis_config_load_internal_module( ac , "BOOTSTRAP_ENKF");
+  analysis_config_set_num_threads( ac , 3 );
+  test_assert_int_equal( 3 , analysis_config_get_num_threads( ac ));
+  test_assert_int_equal( 3 , analysis_module_get_int( analysis_config_get_module( ac , "BOOTSTRAP_ENKF") , ANALYSIS_NUM_THREADS_VAR ));
+  analysis_config_free( ac );
+}
+
 void test_min_realizations_percent() {
   {
     const char * num_realizations_str = "NUM_REALIZATIONS 80\n";
@@ -193,6 +219,8 @@ int main(int argc , char ** argv) {
   test_min_realizations_number();
   test_current_module_options();
   test_stop_long_running();
+  test_memory_limit();
+  test_num_threads();
   exit(0);
 }
 
@@ -0,0 +1,186 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'enkf_block_fs_driver_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+#include <ert/util/buffer.h>
+#include <ert/util/block_fs.h>
+
+#include <ert/enkf/fs_driver.h>
+#include <ert/enkf/block_fs_driver.h>
+
+#define NUM_FS 2
+
+/*
+  The nodes are stored through the binary node index of the driver,
+  except the ones with report_step or iens too large for the packed
+  keys, which use the string keys directly.
+*/
+
+#define LARGE_STEP (1 << 22)
+#define LARGE_IENS ((1 << 22) + 1)
+
+
+static fs_driver_type * open_driver( const char * mount_point ) {
+  FILE * stream = util_fopen( "fstab" , "r" );
+  fs_driver_enum driver_type;
+  fs_driver_type * driver;
+
+  test_assert_int_equal( 1 , fread( &driver_type , sizeof driver_type , 1 , stream ));
+  driver = block_fs_driver_open( stream , mount_point , driver_type , false );
+  fclose( stream );
+  return driver;
+}
+
+
+static void save_node( fs_driver_type * driver , const char * key , int step , int iens ) {
+  buffer_type * buffer = buffer_alloc( 16 );
+  buffer_fwrite_int( buffer , step );
+  buffer_fwrite_int( buffer , iens );
+  driver->save_node( driver , key , step , iens , buffer );
+  buffer_free( buffer );
+}
+
+
+static void test_node( fs_driver_type * driver , const char * key , int step , int iens ) {
+  buffer_type * buffer = buffer_alloc( 16 );
+  test_assert_true( driver->has_node( driver , key , step , iens ));
+  driver->load_node( driver , key , step , iens , buffer );
+  test_assert_int_equal( step , buffer_fread_int( buffer ));
+  test_assert_int_equal( iens , buffer_fread_int( buffer ));
+  buffer_free( buffer );
+}
+
+
+static void test_vectors( fs_driver_type * driver , int iens ) {
+  const char * keys[3] = {"FOPR" , "WOPR:OP_1" , "WWCT:OP_1"};
+  buffer_type * buffers[3];
+  bool found[3];
+
+  test_assert_false( driver->has_vector( driver , "FOPR" , iens ));
+  for (int i = 0; i < 3; i++) {
+    buffers[i] = buffer_alloc( 16 );
+    buffer_fwrite_int( buffers[i] , i * 100 + iens );
+  }
+  driver->save_vectors( driver , 2 , keys , iens , buffers );
+  test_assert_true( driver->has_vector( driver , "FOPR" , iens ));
+  test_assert_true( driver->has_vector( driver , "WOPR:OP_1" , iens ));
+  test_assert_false( driver->has_vector( driver , "WWCT:OP_1" , iens ));
+
+  test_assert_int_equal( 2 , driver->load_vectors( driver , 3 , keys , iens , buffers , found ));
+  test_assert_true( found[0] );
+  test_assert_true( found[1] );
+  test_assert_false( found[2] );
+  test_assert_int_equal( iens , buffer_fread_int( buffers[0] ));
+  test_assert_int_equal( 100 + iens , buffer_fread_int( buffers[1] ));
+
+  driver->unlink_vector( driver , "FOPR" , iens );
+  test_assert_false( driver->has_vector( driver , "FOPR" , iens ));
+  test_assert_true( driver->has_vector( driver , "WOPR:OP_1" , iens ));
+
+  for (int i = 0; i < 3; i++)
+    buffer_free( buffers[i] );
+}
+
+
+static void test_driver( const char * mount_point ) {
+  fs_driver_type * driver = open_driver( mount_point );
+
+  test_assert_false( driver->has_node( driver , "PERMX" , 0 , 0 ));
+  for (int iens = 0; iens < 10; iens++) {
+    save_node( driver , "PERMX" , 0 , iens );
+    save_node( driver , "PERMX" , -1 , iens );
+    save_node( driver , "PORO" , 5 , iens );
+  }
+  save_node( driver , "PERMX" , LARGE_STEP , 3 );
+  save_node( driver , "PERMX" , 0 , LARGE_IENS );
+
+  for (int iens = 0; iens < 10; iens++) {
+    test_node( driver , "PERMX" , 0 , iens );
+    test_node( driver , "PERMX" , -1 , iens );
+    test_node( driver , "PORO" , 5 , iens );
+    test_assert_false( driver->has_node( driver , "PORO" , 4 , iens ));
+  }
+  test_node( driver , "PERMX" , LARGE_STEP , 3 );
+  test_node( driver , "PERMX" , 0 , LARGE_IENS );
+
+  driver->unlink_node( driver , "PERMX" , 0 , 3 );
+  driver->unlink_node( driver , "PERMX" , LARGE_STEP , 3 );
+  test_assert_false( driver->has_node( driver , "PERMX" , 0 , 3 ));
+  test_assert_false( driver->has_node( driver , "PERMX" , LARGE_STEP , 3 ));
+  test_node( driver , "PERMX" , -1 , 3 );
+
+  save_node( driver , "PERMX" , 0 , 3 );
+  test_node( driver , "PERMX" , 0 , 3 );
+
+  test_vectors( driver , 7 );
+  driver->free_driver( driver );
+}
+
+
+/*
+  The nodes must be found again when the driver is mounted with an
+  empty index, and the files must be stored with the readable
+  "key.step.iens" and "key.iens" names.
+*/
+
+static void test_reopen( const char * mount_point ) {
+  {
+    fs_driver_type * driver = open_driver( mount_point );
+    test_node( driver , "PERMX" , 0 , 3 );
+    test_node( driver , "PORO" , 5 , 8 );
+    test_node( driver , "PERMX" , 0 , LARGE_IENS );
+    test_assert_false( driver->has_node( driver , "PERMX" , LARGE_STEP , 3 ));
+    test_assert_false( driver->has_vector( driver , "FOPR" , 7 ));
+    test_assert_true( driver->has_vector( driver , "WOPR:OP_1" , 7 ));
+    driver->free_driver( driver );
+  }
+
+  {
+    block_fs_type * block_fs = block_fs_mount( "Ensemble/mod_1/PARAMETER.mnt" , 64 , 0 , 1.0 , 0 , false , true , false );
+    test_assert_true( block_fs_has_file( block_fs , "PERMX.0.3" ));
+    test_assert_true( block_fs_has_file( block_fs , "PERMX.-1.3" ));
+    test_assert_true( block_fs_has_file( block_fs , "PORO.5.7" ));
+    test_assert_true( block_fs_has_file( block_fs , "WOPR:OP_1.7" ));
+    test_assert_false( block_fs_has_file( block_fs , "FOPR.7" ));
+    block_fs_close( block_fs , false );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("block_fs_driver_index");
+  char * mount_point = util_alloc_cwd( );
+  {
+    FILE * stream = util_fopen( "fstab" , "w" );
+    block_fs_driver_create_fs( stream , mount_point , DRIVER_PARAMETER , NUM_FS , "Ensemble/mod_%d" , "PARAMETER" );
+    fclose( stream );
+  }
+
+  test_driver( mount_point );
+  test_reopen( mount_point );
+
+  free( mount_point );
+  test_work_area_free( work_area );
+  exit(0);
+}
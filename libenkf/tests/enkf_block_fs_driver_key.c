@@ -0,0 +1,65 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'enkf_block_fs_driver_key.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+
+#include <ert/enkf/block_fs_driver.h>
+
+
+void test_key( const char * key , const char * expected_config_key , int expected_report_step , int expected_iens) {
+  char * config_key;
+  int report_step = -99;
+  int iens = -99;
+
+  test_assert_true( block_fs_sscanf_key( key , &config_key , &report_step , &iens ));
+  test_assert_string_equal( config_key , expected_config_key );
+  test_assert_int_equal( report_step , expected_report_step );
+  test_assert_int_equal( iens , expected_iens );
+  free( config_key );
+}
+
+
+void test_invalid_key( const char * key ) {
+  char * config_key;
+  int report_step = -99;
+  int iens = -99;
+
+  test_assert_false( block_fs_sscanf_key( key , &config_key , &report_step , &iens ));
+  test_assert_NULL( config_key );
+  test_assert_int_equal( report_step , -99 );
+  test_assert_int_equal( iens , -99 );
+}
+
+
+int main(int argc , char ** argv) {
+  test_key( "PERMX.0.17" , "PERMX" , 0 , 17 );
+  test_key( "WOPR:OP_1.100.2" , "WOPR:OP_1" , 100 , 2 );
+  test_key( "GEN.DATA.KEY.5.1" , "GEN.DATA.KEY" , 5 , 1 );
+  test_key( "KEY.-1.3" , "KEY" , -1 , 3 );
+
+  test_invalid_key( "PERMX.17" );
+  test_invalid_key( "PERMX.X.17" );
+  test_invalid_key( "PERMX.1.17X" );
+  test_invalid_key( "PERMX.1." );
+  test_invalid_key( ".1.17" );
+  test_invalid_key( "PERMX" );
+  test_invalid_key( "" );
+  exit(0);
+}
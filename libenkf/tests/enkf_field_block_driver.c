@@ -0,0 +1,207 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'enkf_field_block_driver.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+#include <ert/enkf/field_block_driver.h>
+#include <ert/enkf/enkf_fs.h>
+
+/*
+  The data size is chosen so that the field does not fill the last
+  block, and the ensemble size so that there are several groups of
+  realisations.
+*/
+
+#define DATA_SIZE 10007
+#define ENS_SIZE  150
+
+
+static float value( int iens , int index ) {
+  return iens * 100000 + index;
+}
+
+
+static float * alloc_member( int iens ) {
+  float * data = util_calloc( DATA_SIZE , sizeof * data );
+  for (int i = 0; i < DATA_SIZE; i++)
+    data[i] = value( iens , i );
+  return data;
+}
+
+
+static void test_member( field_block_driver_type * driver , int iens ) {
+  float * data = util_calloc( DATA_SIZE , sizeof * data );
+  field_block_driver_load_node( driver , "PORO" , iens , data , DATA_SIZE * sizeof * data );
+  for (int i = 0; i < DATA_SIZE; i++)
+    test_assert_float_equal( data[i] , value( iens , i ));
+  free( data );
+}
+
+
+static void test_save_load( ) {
+  test_work_area_type * work_area = test_work_area_alloc("field_block_driver/save_load");
+  {
+    field_block_driver_type * driver = field_block_driver_alloc( "FieldBlocks" , false );
+    test_assert_true( field_block_driver_is_instance( driver ));
+    test_assert_false( field_block_driver_has_key( driver , "PORO" ));
+    test_assert_false( field_block_driver_has_node( driver , "PORO" , 0 ));
+
+    for (int iens = 0; iens < ENS_SIZE; iens += 2) {
+      float * data = alloc_member( iens );
+      field_block_driver_save_node( driver , "PORO" , iens , data , DATA_SIZE * sizeof * data );
+      free( data );
+    }
+    test_assert_true( field_block_driver_has_key( driver , "PORO" ));
+    test_assert_true( field_block_driver_has_node( driver , "PORO" , 0 ));
+    test_assert_false( field_block_driver_has_node( driver , "PORO" , 1 ));
+
+    for (int iens = 0; iens < ENS_SIZE; iens += 2)
+      test_member( driver , iens );
+
+    field_block_driver_fsync( driver );
+    field_block_driver_free( driver );
+  }
+
+  {
+    field_block_driver_type * driver = field_block_driver_alloc( "FieldBlocks" , true );
+    test_assert_true( field_block_driver_has_key( driver , "PORO" ));
+    test_assert_true( field_block_driver_has_node( driver , "PORO" , 4 ));
+    test_assert_false( field_block_driver_has_node( driver , "PORO" , 5 ));
+    test_member( driver , 148 );
+    field_block_driver_free( driver );
+  }
+  test_work_area_free( work_area );
+}
+
+
+
+/*
+  Loads and stores a range of cells crossing a block boundary for all
+  the realisations, skipping every third realisation.
+*/
+
+static void test_range( ) {
+  test_work_area_type * work_area = test_work_area_alloc("field_block_driver/range");
+  field_block_driver_type * driver = field_block_driver_alloc( "FieldBlocks" , false );
+  int iens1 = 5;
+  int iens2 = ENS_SIZE;
+  int block_cells , index1 , index2;
+
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    float * data = alloc_member( iens );
+    field_block_driver_save_node( driver , "PERMX" , iens , data , DATA_SIZE * sizeof * data );
+    free( data );
+  }
+
+  block_cells = field_block_driver_get_block_size( driver , "PERMX" ) / sizeof(float);
+  index1 = block_cells - 10;
+  index2 = util_int_min( 2 * block_cells + 10 , DATA_SIZE );
+  {
+    int range_size = index2 - index1;
+    void ** member_data = util_calloc( iens2 - iens1 , sizeof * member_data );
+
+    for (int iens = iens1; iens < iens2; iens++) {
+      if ((iens % 3) != 0)
+        member_data[iens - iens1] = util_calloc( range_size , sizeof(float) );
+      else
+        member_data[iens - iens1] = NULL;
+    }
+
+    field_block_driver_load_range( driver , "PERMX" , index1 * sizeof(float) , range_size * sizeof(float) , iens1 , iens2 , member_data );
+    for (int iens = iens1; iens < iens2; iens++) {
+      float * data = member_data[iens - iens1];
+      if (data) {
+        for (int i = 0; i < range_size; i++) {
+          test_assert_float_equal( data[i] , value( iens , index1 + i ));
+          data[i] = -data[i];
+        }
+      }
+    }
+
+    field_block_driver_save_range( driver , "PERMX" , index1 * sizeof(float) , range_size * sizeof(float) , iens1 , iens2 , member_data );
+    for (int iens = 0; iens < ENS_SIZE; iens++) {
+      float * data = util_calloc( DATA_SIZE , sizeof * data );
+      bool updated = (iens >= iens1) && ((iens % 3) != 0);
+
+      field_block_driver_load_node( driver , "PERMX" , iens , data , DATA_SIZE * sizeof * data );
+      for (int i = 0; i < DATA_SIZE; i++) {
+        if (updated && (i >= index1) && (i < index2))
+          test_assert_float_equal( data[i] , -value( iens , i ));
+        else
+          test_assert_float_equal( data[i] , value( iens , i ));
+      }
+      free( data );
+    }
+
+    for (int iens = iens1; iens < iens2; iens++)
+      free( member_data[iens - iens1] );
+    free( member_data );
+  }
+  field_block_driver_free( driver );
+  test_work_area_free( work_area );
+}
+
+
+
+static void test_enkf_fs( ) {
+  test_work_area_type * work_area = test_work_area_alloc("field_block_driver/enkf_fs");
+  {
+    enkf_fs_type * fs = enkf_fs_create_fs( "mnt" , BLOCK_FS_DRIVER_ID , NULL , true );
+    test_assert_NULL( enkf_fs_get_field_block_driver( fs ));
+    enkf_fs_decref( fs );
+  }
+  {
+    enkf_fs_type * fs = enkf_fs_create_fs( "field_mnt" , BLOCK_FS_FIELD_DRIVER_ID , NULL , true );
+    float * data = alloc_member( 3 );
+
+    test_assert_true( field_block_driver_is_instance( enkf_fs_get_field_block_driver( fs )));
+    test_assert_false( enkf_fs_has_node( fs , "PORO" , PARAMETER , 0 , 3 ));
+    enkf_fs_fwrite_field_node( fs , "PORO" , 3 , data , DATA_SIZE * sizeof * data );
+    test_assert_true( enkf_fs_has_node( fs , "PORO" , PARAMETER , 0 , 3 ));
+    test_assert_false( enkf_fs_has_node( fs , "PORO" , PARAMETER , 0 , 4 ));
+    test_assert_false( enkf_fs_has_node( fs , "MULTFLT" , PARAMETER , 0 , 3 ));
+    enkf_fs_decref( fs );
+    free( data );
+  }
+  {
+    enkf_fs_type * fs = enkf_fs_mount( "field_mnt" );
+    float * data = util_calloc( DATA_SIZE , sizeof * data );
+
+    test_assert_true( enkf_fs_has_node( fs , "PORO" , PARAMETER , 0 , 3 ));
+    enkf_fs_fread_field_node( fs , "PORO" , 3 , data , DATA_SIZE * sizeof * data );
+    for (int i = 0; i < DATA_SIZE; i++)
+      test_assert_float_equal( data[i] , value( 3 , i ));
+
+    enkf_fs_decref( fs );
+    free( data );
+  }
+  test_work_area_free( work_area );
+}
+
+
+int main(int argc , char ** argv) {
+  test_save_load();
+  test_range();
+  test_enkf_fs();
+  exit(0);
+}
@@ -61,6 +61,24 @@ void testS( ert_test_context_type * test_context ) {
       matrix_free( S0 );
       fclose( stream );
     }
+
+    /* Loading the summary vectors on several threads should give the same S matrix. */
+    {
+      obs_data_type * obs_data_mt = obs_data_alloc(1.0);
+      meas_data_type * meas_data_mt = meas_data_alloc( ens_mask );
+      matrix_type * S = meas_data_allocS( meas_data );
+      matrix_type * S_mt;
+
+      enkf_obs_get_obs_and_measure_data_mt( enkf_obs , fs , obs_set,  active_list , meas_data_mt , obs_data_mt , 4);
+      S_mt = meas_data_allocS( meas_data_mt );
+      test_assert_int_equal( obs_data_get_active_size( obs_data ) , obs_data_get_active_size( obs_data_mt ));
+      test_assert_true( matrix_equal( S , S_mt ));
+
+      matrix_free( S_mt );
+      matrix_free( S );
+      meas_data_free( meas_data_mt );
+      obs_data_free( obs_data_mt );
+    }
     int_vector_free( active_list );
     meas_data_free( meas_data );
     obs_data_free( obs_data );
@@ -0,0 +1,96 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'enkf_obs_measure_summary.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/matrix.h>
+#include <ert/util/type_vector_functions.h>
+
+#include <ert/enkf/enkf_main.h>
+#include <ert/enkf/enkf_obs.h>
+#include <ert/enkf/meas_data.h>
+#include <ert/enkf/obs_data.h>
+#include <ert/enkf/local_obsdata.h>
+#include <ert/enkf/ert_test_context.h>
+
+
+/*
+  The S matrix assembled when the summary vectors are loaded on
+  several threads should be equal to the S matrix assembled one
+  observation node at a time.
+*/
+
+static matrix_type * alloc_S( enkf_obs_type * enkf_obs , enkf_fs_type * fs , const local_obsdata_type * obs_set ,
+                              const int_vector_type * active_list , const bool_vector_type * ens_mask , int num_threads) {
+  obs_data_type * obs_data = obs_data_alloc( 1.0 );
+  meas_data_type * meas_data = meas_data_alloc( ens_mask );
+  matrix_type * S;
+
+  if (num_threads > 0)
+    enkf_obs_get_obs_and_measure_data_mt( enkf_obs , fs , obs_set , active_list , meas_data , obs_data , num_threads );
+  else {
+    for (int i = 0; i < local_obsdata_get_size( obs_set ); i++)
+      enkf_obs_get_obs_and_measure_node( enkf_obs , fs , local_obsdata_iget( obs_set , i ) , active_list , meas_data , obs_data );
+  }
+  S = meas_data_allocS( meas_data );
+
+  meas_data_free( meas_data );
+  obs_data_free( obs_data );
+  return S;
+}
+
+
+int main(int argc , char ** argv) {
+  const char * config_file = argv[1];
+  ert_test_context_type * test_context = ert_test_context_alloc("ENKF_OBS_MEASURE_SUMMARY" , config_file );
+  enkf_main_type * enkf_main = ert_test_context_get_main( test_context );
+  enkf_obs_type * enkf_obs = enkf_main_get_obs( enkf_main );
+  enkf_fs_type * fs = enkf_main_get_fs( enkf_main );
+  local_obsdata_type * obs_set = local_obsdata_alloc( "SUMMARY" );
+  int_vector_type * active_list = int_vector_alloc( 0 , 0 );
+  bool_vector_type * ens_mask;
+
+  for (int i = 0; i < enkf_main_get_ensemble_size( enkf_main ); i++)
+    int_vector_append( active_list , i );
+  ens_mask = int_vector_alloc_mask( active_list );
+  enkf_obs_add_local_nodes_with_data( enkf_obs , obs_set , fs , ens_mask );
+  test_assert_true( local_obsdata_get_size( obs_set ) > 0 );
+
+  {
+    matrix_type * S0 = alloc_S( enkf_obs , fs , obs_set , active_list , ens_mask , 0 );
+    matrix_type * S1 = alloc_S( enkf_obs , fs , obs_set , active_list , ens_mask , 1 );
+    matrix_type * S4 = alloc_S( enkf_obs , fs , obs_set , active_list , ens_mask , 4 );
+
+    test_assert_true( matrix_get_rows( S0 ) > 0 );
+    test_assert_int_equal( matrix_get_columns( S0 ) , int_vector_size( active_list ));
+    test_assert_true( matrix_equal( S0 , S1 ));
+    test_assert_true( matrix_equal( S0 , S4 ));
+
+    matrix_free( S0 );
+    matrix_free( S1 );
+    matrix_free( S4 );
+  }
+
+  bool_vector_free( ens_mask );
+  int_vector_free( active_list );
+  local_obsdata_free( obs_set );
+  ert_test_context_free( test_context );
+  exit(0);
+}
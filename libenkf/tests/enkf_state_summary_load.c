@@ -0,0 +1,154 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'enkf_state_summary_load.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_smspec.h>
+
+#include <ert/enkf/enkf_main.h>
+#include <ert/enkf/enkf_node.h>
+#include <ert/enkf/summary.h>
+#include <ert/enkf/run_arg.h>
+#include <ert/enkf/state_map.h>
+#include <ert/enkf/ert_test_context.h>
+
+
+/*
+  Loads the refcase of the snake_oil case as the summary results of
+  realisation 0, and checks that all the summary vectors, which are
+  stored in one batch, can be read back one by one with the values
+  from the report steps of the summary file.
+*/
+
+static void load_summary( enkf_main_type * enkf_main , enkf_fs_type * fs , const char * runpath) {
+  run_arg_type * run_arg = run_arg_alloc_ENSEMBLE_EXPERIMENT( fs , 0 , 0 , runpath );
+  stringlist_type * msg_list = stringlist_alloc_new();
+
+  enkf_state_load_from_forward_model( enkf_main_iget_state( enkf_main , 0 ) , run_arg , msg_list );
+
+  stringlist_free( msg_list );
+  run_arg_free( run_arg );
+}
+
+
+static void test_vectors( enkf_main_type * enkf_main , enkf_fs_type * fs , const ecl_sum_type * ecl_sum ) {
+  const ensemble_config_type * ens_config = enkf_main_get_ensemble_config( enkf_main );
+  const ecl_smspec_type * smspec = ecl_sum_get_smspec( ecl_sum );
+  int num_checked = 0;
+
+  for (int i = 0; i < ecl_smspec_num_nodes( smspec ); i++) {
+    const char * key = smspec_node_get_gen_key1( ecl_smspec_iget_node( smspec , i ));
+    if (key && ecl_sum_has_general_var( ecl_sum , key )) {
+      enkf_node_type * node = enkf_node_alloc( ensemble_config_get_node( ens_config , key ));
+      int params_index = ecl_sum_get_general_var_params_index( ecl_sum , key );
+
+      test_assert_true( enkf_node_try_load_vector( node , fs , 0 ));
+      for (int report_step = 1; report_step <= ecl_sum_get_last_report_step( ecl_sum ); report_step++) {
+        if (ecl_sum_has_report_step( ecl_sum , report_step )) {
+          int ministep = ecl_sum_iget_report_end( ecl_sum , report_step );
+          test_assert_double_equal( summary_get( enkf_node_value_ptr( node ) , report_step ) ,
+                                    ecl_sum_iget( ecl_sum , ministep , params_index ));
+        }
+      }
+      enkf_node_free( node );
+      num_checked++;
+    }
+  }
+  test_assert_true( num_checked > 0 );
+}
+
+
+/*
+  Loads all the vectors in one batch, and compares with the vectors
+  loaded one by one; realisation 1 has not been loaded, i.e. nothing
+  is found there.
+*/
+
+static void test_batch_load( enkf_main_type * enkf_main , enkf_fs_type * fs , const ecl_sum_type * ecl_sum ) {
+  const ensemble_config_type * ens_config = enkf_main_get_ensemble_config( enkf_main );
+  const ecl_smspec_type * smspec = ecl_sum_get_smspec( ecl_sum );
+  enkf_node_type ** nodes = util_calloc( ecl_smspec_num_nodes( smspec ) , sizeof * nodes );
+  int num_nodes = 0;
+
+  for (int i = 0; i < ecl_smspec_num_nodes( smspec ); i++) {
+    const char * key = smspec_node_get_gen_key1( ecl_smspec_iget_node( smspec , i ));
+    if (key && ecl_sum_has_general_var( ecl_sum , key ))
+      nodes[num_nodes++] = enkf_node_alloc( ensemble_config_get_node( ens_config , key ));
+  }
+
+  test_assert_int_equal( enkf_node_try_load_vectors( nodes , num_nodes , fs , 1 ) , 0 );
+  test_assert_int_equal( enkf_node_try_load_vectors( nodes , num_nodes , fs , 0 ) , num_nodes );
+  for (int inode = 0; inode < num_nodes; inode++) {
+    enkf_node_type * node = enkf_node_alloc( enkf_node_get_config( nodes[inode] ));
+    const summary_type * summary1 = enkf_node_value_ptr( nodes[inode] );
+    const summary_type * summary2;
+
+    test_assert_true( enkf_node_try_load_vector( node , fs , 0 ));
+    summary2 = enkf_node_value_ptr( node );
+    for (int report_step = 1; report_step <= ecl_sum_get_last_report_step( ecl_sum ); report_step++)
+      test_assert_double_equal( summary_get( summary1 , report_step ) , summary_get( summary2 , report_step ));
+
+    enkf_node_free( node );
+    enkf_node_free( nodes[inode] );
+  }
+  free( nodes );
+}
+
+
+int main(int argc , char ** argv) {
+  const char * config_file = argv[1];
+  ert_test_context_type * test_context = ert_test_context_alloc("ENKF_STATE_SUMMARY_LOAD" , config_file );
+  enkf_main_type * enkf_main = ert_test_context_get_main( test_context );
+  const char * runpath = "simulations/run0";
+
+  util_make_path( runpath );
+  util_copy_file( "refcase/SNAKE_OIL_FIELD.SMSPEC" , "simulations/run0/SNAKE_OIL_FIELD.SMSPEC" );
+  util_copy_file( "refcase/SNAKE_OIL_FIELD.UNSMRY" , "simulations/run0/SNAKE_OIL_FIELD.UNSMRY" );
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case( "simulations/run0/SNAKE_OIL_FIELD" , ":" );
+    enkf_fs_type * fs;
+
+    enkf_main_select_fs( enkf_main , "summary_load" );
+    fs = enkf_main_get_fs( enkf_main );
+    /*
+      The snake_oil results for CUSTOM_KW and GEN_DATA are not in the
+      runpath, i.e. the load of the realisation will fail; that is only
+      a legal state transition for an initialized realisation.
+    */
+    state_map_iset( enkf_fs_get_state_map( fs ) , 0 , STATE_INITIALIZED );
+
+    load_summary( enkf_main , fs , runpath );
+    test_vectors( enkf_main , fs , ecl_sum );
+
+    /* Loading again updates the vectors already in storage. */
+    load_summary( enkf_main , fs , runpath );
+    test_vectors( enkf_main , fs , ecl_sum );
+    test_batch_load( enkf_main , fs , ecl_sum );
+
+    ecl_sum_free( ecl_sum );
+  }
+
+  ert_test_context_free( test_context );
+  exit(0);
+}
@@ -0,0 +1,248 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'enkf_update_field_blocks.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+#include <ert/enkf/enkf_main.h>
+#include <ert/enkf/enkf_fs.h>
+#include <ert/enkf/enkf_node.h>
+#include <ert/enkf/field.h>
+#include <ert/enkf/field_config.h>
+#include <ert/enkf/fs_driver.h>
+#include <ert/enkf/field_block_driver.h>
+#include <ert/enkf/model_config.h>
+#include <ert/enkf/analysis_config.h>
+#include <ert/enkf/local_config.h>
+
+
+/*
+  Smoother updates of a localized FIELD parameter from a BLOCK_FS_FIELD
+  case, where the FIELD is stored ensemble-major in field blocks, into
+  fresh cases. The field block path of the update is compared with
+  the per-realisation path, which is used when the target case is a
+  plain BLOCK_FS case, both with a double and a float A matrix and
+  with the node split over several row segments.
+
+  The source case is a copy of the default_0 case of the snake_oil
+  test data, with the driver id in the fstab file changed to
+  BLOCK_FS_FIELD; the snake_oil simulator does not know about the
+  PORO field, which is therefor written directly to the source case.
+*/
+
+#define FIELD_KEY "PORO"
+
+
+static float poro_value( int iens , int index ) {
+  return 0.25 + 0.10 * sin( 0.37 * index + 1.7 * iens );
+}
+
+
+static void create_source_case( enkf_main_type * enkf_main , int data_size ) {
+  const char * enspath = model_config_get_enspath( enkf_main_get_model_config( enkf_main ));
+  char * src_path    = util_alloc_filename( enspath , "default_0" , NULL );
+  char * target_path = util_alloc_filename( enspath , "field_source" , NULL );
+  char * fstab_file  = fs_driver_alloc_fstab_file( target_path );
+
+  util_copy_directory_content( src_path , target_path );
+  {
+    FILE * stream = util_fopen( fstab_file , "r+" );
+    fseek( stream , sizeof(long) + sizeof(int) , SEEK_SET );
+    util_fwrite_int( BLOCK_FS_FIELD_DRIVER_ID , stream );
+    fclose( stream );
+  }
+
+  {
+    enkf_fs_type * fs = enkf_main_mount_alt_fs( enkf_main , "field_source" , false );
+    float * data = util_calloc( data_size , sizeof * data );
+
+    test_assert_not_NULL( enkf_fs_get_field_block_driver( fs ));
+    for (int iens = 0; iens < enkf_main_get_ensemble_size( enkf_main ); iens++) {
+      for (int i = 0; i < data_size; i++)
+        data[i] = poro_value( iens , i );
+      enkf_fs_fwrite_field_node( fs , FIELD_KEY , iens , data , data_size * sizeof * data );
+    }
+    enkf_fs_fsync( fs );
+    enkf_fs_decref( fs );
+    free( data );
+  }
+
+  free( fstab_file );
+  free( target_path );
+  free( src_path );
+}
+
+
+/*
+  One ministep updating every third cell and a contiguous range of
+  the field.
+*/
+
+static bool is_active( int index , int data_size ) {
+  return ((index % 3) == 0) || ((index >= data_size / 2) && (index < data_size / 2 + 50));
+}
+
+
+static void setup_local_config( enkf_main_type * enkf_main , int data_size ) {
+  local_config_type * local_config = enkf_main_get_local_config( enkf_main );
+  local_updatestep_type * updatestep;
+  local_ministep_type * ministep;
+  local_obsdata_type * obsdata;
+  local_dataset_type * dataset;
+  const char * obs_keys[] = {"FOPR" , "WOPR_OP1_9" , "WOPR_OP1_36" , "WOPR_OP1_72" , "WOPR_OP1_108"};
+
+  local_config_clear( local_config );
+  updatestep = local_config_get_updatestep( local_config );
+  ministep = local_config_alloc_ministep( local_config , "FIELD_MINISTEP" , NULL );
+  obsdata  = local_config_alloc_obsdata( local_config , "FIELD_OBS" );
+  dataset  = local_config_alloc_dataset( local_config , "FIELD_DATA" );
+
+  for (int i = 0; i < 5; i++)
+    local_obsdata_add_node( obsdata , local_obsdata_node_alloc( obs_keys[i] , true ));
+
+  local_dataset_add_node( dataset , FIELD_KEY );
+  {
+    active_list_type * active_list = local_dataset_get_node_active_list( dataset , FIELD_KEY );
+    for (int i = 0; i < data_size; i++) {
+      if (is_active( i , data_size ))
+        active_list_add_index( active_list , i );
+    }
+  }
+
+  local_ministep_add_obsdata( ministep , obsdata );
+  local_ministep_add_dataset( ministep , dataset );
+  local_updatestep_add_ministep( updatestep , ministep );
+}
+
+
+static void smoother_update( enkf_main_type * enkf_main , const char * target_case , const char * dbase_type , size_t memory_limit , bool single_precision) {
+  analysis_config_type * analysis_config = enkf_main_get_analysis_config( enkf_main );
+  enkf_fs_type * source_fs;
+  enkf_fs_type * target_fs;
+
+  model_config_set_dbase_type( enkf_main_get_model_config( enkf_main ) , dbase_type );
+  source_fs = enkf_main_mount_alt_fs( enkf_main , "field_source" , false );
+  target_fs = enkf_main_mount_alt_fs( enkf_main , target_case , true );
+  if (strcmp( dbase_type , "BLOCK_FS_FIELD" ) == 0)
+    test_assert_not_NULL( enkf_fs_get_field_block_driver( target_fs ));
+  else
+    test_assert_NULL( enkf_fs_get_field_block_driver( target_fs ));
+
+  analysis_config_set_memory_limit( analysis_config , memory_limit );
+  analysis_config_set_single_precision( analysis_config , single_precision );
+  enkf_main_rng_init( enkf_main );
+  test_assert_true( enkf_main_smoother_update( enkf_main , source_fs , target_fs ));
+
+  enkf_fs_decref( target_fs );
+  enkf_fs_decref( source_fs );
+}
+
+
+static float * alloc_member( enkf_main_type * enkf_main , const char * case_name , int iens , int data_size ) {
+  const ensemble_config_type * ens_config = enkf_main_get_ensemble_config( enkf_main );
+  enkf_fs_type * fs = enkf_main_mount_alt_fs( enkf_main , case_name , false );
+  enkf_node_type * node = enkf_node_alloc( ensemble_config_get_node( ens_config , FIELD_KEY ));
+  node_id_type node_id = {.report_step = 0 , .iens = iens };
+  float * data = util_calloc( data_size , sizeof * data );
+
+  test_assert_true( enkf_node_try_load( node , fs , node_id ));
+  for (int i = 0; i < data_size; i++)
+    data[i] = field_iget_float( enkf_node_value_ptr( node ) , i );
+
+  enkf_node_free( node );
+  enkf_fs_decref( fs );
+  return data;
+}
+
+
+/*
+  The cells outside the active list must be unchanged, and the
+  updated cells must agree with the reference case.
+*/
+
+static void test_update( enkf_main_type * enkf_main , const char * case_name , const char * ref_case , int data_size ) {
+  int num_updated = 0;
+  for (int iens = 0; iens < enkf_main_get_ensemble_size( enkf_main ); iens++) {
+    float * data     = alloc_member( enkf_main , case_name , iens , data_size );
+    float * ref_data = alloc_member( enkf_main , ref_case , iens , data_size );
+
+    for (int i = 0; i < data_size; i++) {
+      if (is_active( i , data_size )) {
+        if (data[i] != poro_value( iens , i ))
+          num_updated++;
+      } else
+        test_assert_float_equal( data[i] , poro_value( iens , i ));
+      test_assert_float_equal( data[i] , ref_data[i] );
+    }
+
+    free( ref_data );
+    free( data );
+  }
+  test_assert_true( num_updated > 0 );
+}
+
+
+int main(int argc , char ** argv) {
+  const char * config_file = argv[1];
+  const char * grid_file   = argv[2];
+  test_work_area_type * work_area = test_work_area_alloc( "update_field_blocks" );
+
+  test_work_area_copy_parent_content( work_area , config_file );
+  test_work_area_copy_file( work_area , grid_file );
+  {
+    FILE * stream = util_fopen( "snake_oil.ert" , "a" );
+    fprintf( stream , "\nGRID CASE.EGRID\nFIELD %s PARAMETER poro.grdecl\n" , FIELD_KEY );
+    fclose( stream );
+  }
+
+  {
+    enkf_main_type * enkf_main = enkf_main_bootstrap( "snake_oil.ert" , true , false );
+    const ensemble_config_type * ens_config = enkf_main_get_ensemble_config( enkf_main );
+    const field_config_type * field_config = enkf_config_node_get_ref( ensemble_config_get_node( ens_config , FIELD_KEY ));
+    int data_size = field_config_get_data_size_from_grid( field_config );
+    int ens_size = enkf_main_get_ensemble_size( enkf_main );
+
+    create_source_case( enkf_main , data_size );
+    setup_local_config( enkf_main , data_size );
+
+    smoother_update( enkf_main , "plain"  , "BLOCK_FS" , 0 , false );
+    smoother_update( enkf_main , "blocks" , "BLOCK_FS_FIELD" , 0 , false );
+    test_update( enkf_main , "blocks" , "plain" , data_size );
+
+    analysis_config_set_num_threads( enkf_main_get_analysis_config( enkf_main ) , 4 );
+    smoother_update( enkf_main , "blocks_segments" , "BLOCK_FS_FIELD" , 7 * ens_size * sizeof(double) , false );
+    test_update( enkf_main , "blocks_segments" , "plain" , data_size );
+
+    smoother_update( enkf_main , "plain_float"  , "BLOCK_FS" , 0 , true );
+    smoother_update( enkf_main , "blocks_float" , "BLOCK_FS_FIELD" , 0 , true );
+    test_update( enkf_main , "blocks_float" , "plain_float" , data_size );
+
+    smoother_update( enkf_main , "blocks_float_segments" , "BLOCK_FS_FIELD" , 7 * ens_size * sizeof(float) , true );
+    test_update( enkf_main , "blocks_float_segments" , "plain_float" , data_size );
+
+    enkf_main_free( enkf_main );
+  }
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,109 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'enkf_update_memory_limit.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/enkf/enkf_main.h>
+#include <ert/enkf/enkf_node.h>
+#include <ert/enkf/gen_kw.h>
+#include <ert/enkf/analysis_config.h>
+#include <ert/enkf/ert_test_context.h>
+
+
+/*
+  Runs the same smoother update twice; once with the full A matrix and
+  once with a memory limit which only allows a few rows in the A
+  matrix, i.e. the parameters are updated in row blocks and the
+  GEN_KW node is split over several blocks. The blocked update is
+  also run with several threads in the update pipeline. The updated
+  parameters should be identical. Finally the update is run with the
+  A matrix in single precision, with and without blocks; then the
+  parameters should agree to within the tolerance of
+  test_assert_double_equal().
+*/
+
+static void smoother_update( enkf_main_type * enkf_main , const char * target_case , size_t memory_limit) {
+  analysis_config_type * analysis_config = enkf_main_get_analysis_config( enkf_main );
+  enkf_fs_type * source_fs = enkf_main_mount_alt_fs( enkf_main , "default_0" , false );
+  enkf_fs_type * target_fs = enkf_main_mount_alt_fs( enkf_main , target_case , true );
+
+  analysis_config_set_memory_limit( analysis_config , memory_limit );
+  enkf_main_rng_init( enkf_main );
+  test_assert_true( enkf_main_smoother_update( enkf_main , source_fs , target_fs ));
+
+  enkf_fs_decref( target_fs );
+  enkf_fs_decref( source_fs );
+}
+
+
+static void test_equal( enkf_main_type * enkf_main , const char * case1 , const char * case2 , const char * key) {
+  const ensemble_config_type * ens_config = enkf_main_get_ensemble_config( enkf_main );
+  enkf_fs_type * fs1 = enkf_main_mount_alt_fs( enkf_main , case1 , false );
+  enkf_fs_type * fs2 = enkf_main_mount_alt_fs( enkf_main , case2 , false );
+  enkf_node_type * node1 = enkf_node_alloc( ensemble_config_get_node( ens_config , key ));
+  enkf_node_type * node2 = enkf_node_alloc( ensemble_config_get_node( ens_config , key ));
+  int data_size = gen_kw_data_size( enkf_node_value_ptr( node1 ));
+
+  for (int iens = 0; iens < enkf_main_get_ensemble_size( enkf_main ); iens++) {
+    node_id_type node_id = {.report_step = 0 , .iens = iens };
+
+    test_assert_true( enkf_node_try_load( node1 , fs1 , node_id ));
+    test_assert_true( enkf_node_try_load( node2 , fs2 , node_id ));
+    for (int i = 0; i < data_size; i++)
+      test_assert_double_equal( gen_kw_data_iget( enkf_node_value_ptr( node1 ) , i , false ) ,
+                                gen_kw_data_iget( enkf_node_value_ptr( node2 ) , i , false ));
+  }
+
+  enkf_node_free( node1 );
+  enkf_node_free( node2 );
+  enkf_fs_decref( fs1 );
+  enkf_fs_decref( fs2 );
+}
+
+
+int main(int argc , char ** argv) {
+  const char * config_file = argv[1];
+  ert_test_context_type * test_context = ert_test_context_alloc("UPDATE_MEMORY_LIMIT" , config_file );
+  enkf_main_type * enkf_main = ert_test_context_get_main( test_context );
+  int ens_size = enkf_main_get_ensemble_size( enkf_main );
+
+  smoother_update( enkf_main , "full" , 0 );
+  smoother_update( enkf_main , "blocked" , 3 * ens_size * sizeof(double) );
+  test_equal( enkf_main , "full" , "blocked" , "SNAKE_OIL_PARAM" );
+
+  analysis_config_set_num_threads( enkf_main_get_analysis_config( enkf_main ) , 4 );
+  smoother_update( enkf_main , "threads" , 3 * ens_size * sizeof(double) );
+  test_equal( enkf_main , "full" , "threads" , "SNAKE_OIL_PARAM" );
+
+  analysis_config_set_single_precision( enkf_main_get_analysis_config( enkf_main ) , true );
+  smoother_update( enkf_main , "float" , 0 );
+  test_assert_int_equal( analysis_config_get_max_block_rows( enkf_main_get_analysis_config( enkf_main ) , ens_size ) , -1 );
+  test_equal( enkf_main , "full" , "float" , "SNAKE_OIL_PARAM" );
+
+  smoother_update( enkf_main , "float_blocked" , 3 * ens_size * sizeof(float) );
+  test_assert_int_equal( analysis_config_get_max_block_rows( enkf_main_get_analysis_config( enkf_main ) , ens_size ) , 3 );
+  test_equal( enkf_main , "full" , "float_blocked" , "SNAKE_OIL_PARAM" );
+  test_equal( enkf_main , "float" , "float_blocked" , "SNAKE_OIL_PARAM" );
+
+  ert_test_context_free( test_context );
+  exit(0);
+}
@@ -0,0 +1,136 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'enkf_update_ministeps.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/enkf/enkf_main.h>
+#include <ert/enkf/enkf_node.h>
+#include <ert/enkf/gen_kw.h>
+#include <ert/enkf/analysis_config.h>
+#include <ert/enkf/local_config.h>
+#include <ert/enkf/ert_test_context.h>
+
+
+static void add_ministep( local_config_type * local_config , const char * name , const char * data_key , int num_obs , const char ** obs_keys) {
+  local_updatestep_type * updatestep = local_config_get_updatestep( local_config );
+  local_ministep_type * ministep = local_config_alloc_ministep( local_config , name , NULL );
+  char * obsdata_name = util_alloc_sprintf( "%s_OBS" , name );
+  local_obsdata_type * obsdata = local_config_alloc_obsdata( local_config , obsdata_name );
+
+  for (int i = 0; i < num_obs; i++)
+    local_obsdata_add_node( obsdata , local_obsdata_node_alloc( obs_keys[i] , true ));
+  local_ministep_add_obsdata( ministep , obsdata );
+
+  if (data_key) {
+    char * dataset_name = util_alloc_sprintf( "%s_DATA" , name );
+    local_dataset_type * dataset = local_config_alloc_dataset( local_config , dataset_name );
+    local_dataset_add_node( dataset , data_key );
+    local_ministep_add_dataset( ministep , dataset );
+    free( dataset_name );
+  }
+
+  local_updatestep_add_ministep( updatestep , ministep );
+  free( obsdata_name );
+}
+
+
+/*
+  Three ministeps; the first two update disjoint sets of parameters
+  and can be updated concurrently, whereas the third updates the same
+  parameters as the first and must wait for it.
+*/
+
+static void setup_local_config( enkf_main_type * enkf_main ) {
+  local_config_type * local_config = enkf_main_get_local_config( enkf_main );
+  const char * obs1[] = {"FOPR"};
+  const char * obs2[] = {"WOPR_OP1_9" , "WOPR_OP1_36" , "WOPR_OP1_72"};
+  const char * obs3[] = {"WOPR_OP1_108" , "WOPR_OP1_144" , "WOPR_OP1_190"};
+
+  local_config_clear( local_config );
+  add_ministep( local_config , "MINISTEP1" , "SNAKE_OIL_PARAM" , 1 , obs1 );
+  add_ministep( local_config , "MINISTEP2" , NULL , 3 , obs2 );
+  add_ministep( local_config , "MINISTEP3" , "SNAKE_OIL_PARAM" , 3 , obs3 );
+
+  {
+    const local_updatestep_type * updatestep = local_config_get_updatestep( local_config );
+    test_assert_int_equal( 3 , local_updatestep_get_num_ministep( updatestep ));
+    test_assert_int_equal( 2 , local_updatestep_get_independent_ministeps( updatestep , 0 , 4 ));
+    test_assert_int_equal( 1 , local_updatestep_get_independent_ministeps( updatestep , 0 , 1 ));
+    test_assert_int_equal( 2 , local_updatestep_get_independent_ministeps( updatestep , 1 , 4 ));
+    test_assert_int_equal( 1 , local_updatestep_get_independent_ministeps( updatestep , 2 , 4 ));
+    test_assert_int_equal( 0 , local_updatestep_get_independent_ministeps( updatestep , 3 , 4 ));
+  }
+}
+
+
+static void smoother_update( enkf_main_type * enkf_main , const char * target_case , int num_threads) {
+  analysis_config_type * analysis_config = enkf_main_get_analysis_config( enkf_main );
+  enkf_fs_type * source_fs = enkf_main_mount_alt_fs( enkf_main , "default_0" , false );
+  enkf_fs_type * target_fs = enkf_main_mount_alt_fs( enkf_main , target_case , true );
+
+  analysis_config_set_num_threads( analysis_config , num_threads );
+  enkf_main_rng_init( enkf_main );
+  test_assert_true( enkf_main_smoother_update( enkf_main , source_fs , target_fs ));
+
+  enkf_fs_decref( target_fs );
+  enkf_fs_decref( source_fs );
+}
+
+
+static void test_equal( enkf_main_type * enkf_main , const char * case1 , const char * case2 , const char * key) {
+  const ensemble_config_type * ens_config = enkf_main_get_ensemble_config( enkf_main );
+  enkf_fs_type * fs1 = enkf_main_mount_alt_fs( enkf_main , case1 , false );
+  enkf_fs_type * fs2 = enkf_main_mount_alt_fs( enkf_main , case2 , false );
+  enkf_node_type * node1 = enkf_node_alloc( ensemble_config_get_node( ens_config , key ));
+  enkf_node_type * node2 = enkf_node_alloc( ensemble_config_get_node( ens_config , key ));
+  int data_size = gen_kw_data_size( enkf_node_value_ptr( node1 ));
+
+  for (int iens = 0; iens < enkf_main_get_ensemble_size( enkf_main ); iens++) {
+    node_id_type node_id = {.report_step = 0 , .iens = iens };
+
+    test_assert_true( enkf_node_try_load( node1 , fs1 , node_id ));
+    test_assert_true( enkf_node_try_load( node2 , fs2 , node_id ));
+    for (int i = 0; i < data_size; i++)
+      test_assert_double_equal( gen_kw_data_iget( enkf_node_value_ptr( node1 ) , i , false ) ,
+                                gen_kw_data_iget( enkf_node_value_ptr( node2 ) , i , false ));
+  }
+
+  enkf_node_free( node1 );
+  enkf_node_free( node2 );
+  enkf_fs_decref( fs1 );
+  enkf_fs_decref( fs2 );
+}
+
+
+int main(int argc , char ** argv) {
+  const char * config_file = argv[1];
+  ert_test_context_type * test_context = ert_test_context_alloc("UPDATE_MINISTEPS" , config_file );
+  enkf_main_type * enkf_main = ert_test_context_get_main( test_context );
+
+  setup_local_config( enkf_main );
+  smoother_update( enkf_main , "serial" , 1 );
+  smoother_update( enkf_main , "concurrent" , 4 );
+  test_equal( enkf_main , "serial" , "concurrent" , "SNAKE_OIL_PARAM" );
+
+  ert_test_context_free( test_context );
+  exit(0);
+}
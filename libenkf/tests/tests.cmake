@@ -91,6 +91,18 @@ add_executable( enkf_fs enkf_fs.c )
 target_link_libraries( enkf_fs enkf  )
 add_test( enkf_fs  ${EXECUTABLE_OUTPUT_PATH}/enkf_fs )
 
+add_executable( enkf_block_fs_driver_key enkf_block_fs_driver_key.c )
+target_link_libraries( enkf_block_fs_driver_key enkf  )
+add_test( enkf_block_fs_driver_key  ${EXECUTABLE_OUTPUT_PATH}/enkf_block_fs_driver_key )
+
+add_executable( enkf_block_fs_driver_index enkf_block_fs_driver_index.c )
+target_link_libraries( enkf_block_fs_driver_index enkf  )
+add_test( enkf_block_fs_driver_index  ${EXECUTABLE_OUTPUT_PATH}/enkf_block_fs_driver_index )
+
+add_executable( enkf_field_block_driver enkf_field_block_driver.c )
+target_link_libraries( enkf_field_block_driver enkf  )
+add_test( enkf_field_block_driver  ${EXECUTABLE_OUTPUT_PATH}/enkf_field_block_driver )
+
 add_executable( enkf_workflow_job_test_version enkf_workflow_job_test_version.c )
 target_link_libraries( enkf_workflow_job_test_version enkf  )
 add_test( enkf_workflow_job_test_version  ${EXECUTABLE_OUTPUT_PATH}/enkf_workflow_job_test_version 
@@ -252,3 +264,34 @@ add_test( enkf_ensemble_GEN_PARAM  ${EXECUTABLE_OUTPUT_PATH}/enkf_ensemble_GEN_P
 add_executable( enkf_ensemble enkf_ensemble.c )
 target_link_libraries( enkf_ensemble enkf  )
 add_test( enkf_ensemble  ${EXECUTABLE_OUTPUT_PATH}/enkf_ensemble )
+
+add_executable( enkf_update_memory_limit enkf_update_memory_limit.c )
+target_link_libraries( enkf_update_memory_limit enkf  )
+add_test( enkf_update_memory_limit
+          ${EXECUTABLE_OUTPUT_PATH}/enkf_update_memory_limit
+          ${PROJECT_SOURCE_DIR}/test-data/local/snake_oil/snake_oil.ert )
+
+add_executable( enkf_update_field_blocks enkf_update_field_blocks.c )
+target_link_libraries( enkf_update_field_blocks enkf  )
+add_test( enkf_update_field_blocks
+          ${EXECUTABLE_OUTPUT_PATH}/enkf_update_field_blocks
+          ${PROJECT_SOURCE_DIR}/test-data/local/snake_oil/snake_oil.ert
+          ${PROJECT_SOURCE_DIR}/test-data/local/snake_oil_field/grid/CASE.EGRID )
+
+add_executable( enkf_update_ministeps enkf_update_ministeps.c )
+target_link_libraries( enkf_update_ministeps enkf  )
+add_test( enkf_update_ministeps
+          ${EXECUTABLE_OUTPUT_PATH}/enkf_update_ministeps
+          ${PROJECT_SOURCE_DIR}/test-data/local/snake_oil/snake_oil.ert )
+
+add_executable( enkf_state_summary_load enkf_state_summary_load.c )
+target_link_libraries( enkf_state_summary_load enkf  )
+add_test( enkf_state_summary_load
+          ${EXECUTABLE_OUTPUT_PATH}/enkf_state_summary_load
+          ${PROJECT_SOURCE_DIR}/test-data/local/snake_oil/snake_oil.ert )
+
+add_executable( enkf_obs_measure_summary enkf_obs_measure_summary.c )
+target_link_libraries( enkf_obs_measure_summary enkf  )
+add_test( enkf_obs_measure_summary
+          ${EXECUTABLE_OUTPUT_PATH}/enkf_obs_measure_summary
+          ${PROJECT_SOURCE_DIR}/test-data/local/snake_oil/snake_oil.ert )
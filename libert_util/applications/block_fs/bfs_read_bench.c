@@ -0,0 +1,165 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'bfs_read_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/util.h>
+#include <ert/util/block_fs.h>
+#include <ert/util/buffer.h>
+#include <ert/util/timer.h>
+#include <ert/util/thread_pool.h>
+
+
+/*
+  Small benchmark of concurrent reads from one block_fs instance: a
+  filesystem with @num_files files of @file_size bytes is created,
+  remounted and then all the files are read back with 1, 2, 4, ...
+  @max_threads threads. Thread t reads the files t, t + num_threads,
+  ... and every file is read both with block_fs_fread_file() and
+  block_fs_fread_realloc_buffer().
+*/
+
+
+typedef struct {
+  block_fs_type * block_fs;
+  int             num_files;
+  int             file_size;
+  int             num_threads;
+  int             thread_nr;
+  long            checksum;
+} read_arg_type;
+
+
+static char * alloc_filename( int ifile ) {
+  return util_alloc_sprintf( "FILE.%d" , ifile );
+}
+
+
+static void create_fs( const char * mount_file , int num_files , int file_size ) {
+  block_fs_type * block_fs = block_fs_mount( mount_file , 1 , 0 , 1.0 , 0 , false , false , false );
+  char * data = util_malloc( file_size );
+
+  for (int ifile = 0; ifile < num_files; ifile++) {
+    char * filename = alloc_filename( ifile );
+    for (int i = 0; i < file_size; i++)
+      data[i] = (char) (ifile + i);
+    block_fs_fwrite_file( block_fs , filename , data , file_size );
+    free( filename );
+  }
+
+  free( data );
+  block_fs_close( block_fs , false );
+}
+
+
+static void * read_files( void * arg ) {
+  read_arg_type * read_arg = arg;
+  char * data = util_malloc( read_arg->file_size );
+  buffer_type * buffer = buffer_alloc( read_arg->file_size );
+
+  read_arg->checksum = 0;
+  for (int ifile = read_arg->thread_nr; ifile < read_arg->num_files; ifile += read_arg->num_threads) {
+    char * filename = alloc_filename( ifile );
+
+    block_fs_fread_file( read_arg->block_fs , filename , data );
+    block_fs_fread_realloc_buffer( read_arg->block_fs , filename , buffer );
+    if (memcmp( data , buffer_get_data( buffer ) , read_arg->file_size ) != 0)
+      util_abort("%s: inconsistent content in file:%s \n",__func__ , filename );
+
+    for (int i = 0; i < read_arg->file_size; i++)
+      read_arg->checksum += (unsigned char) data[i];
+    free( filename );
+  }
+
+  buffer_free( buffer );
+  free( data );
+  return NULL;
+}
+
+
+static void read_bench( block_fs_type * block_fs , int num_files , int file_size , int num_threads ) {
+  thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+  read_arg_type * args = util_calloc( num_threads , sizeof * args );
+  timer_type * timer = timer_alloc( true );
+  long checksum = 0;
+
+  timer_start( timer );
+  for (int t = 0; t < num_threads; t++) {
+    args[t].block_fs = block_fs;
+    args[t].num_files = num_files;
+    args[t].file_size = file_size;
+    args[t].num_threads = num_threads;
+    args[t].thread_nr = t;
+    thread_pool_add_job( tp , read_files , &args[t] );
+  }
+  thread_pool_join( tp );
+  timer_stop( timer );
+
+  for (int t = 0; t < num_threads; t++)
+    checksum += args[t].checksum;
+
+  printf("threads: %3d   time: %8.3f s   %8.1f MB/s   checksum: %ld\n", num_threads ,
+         timer_get_total_time( timer ) ,
+         2.0 * num_files * file_size / (1024 * 1024 * timer_get_total_time( timer )) ,
+         checksum );
+
+  timer_free( timer );
+  free( args );
+  thread_pool_free( tp );
+}
+
+
+static int usage( void ) {
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Usage:\n\n");
+  fprintf(stderr,"   bash%% bfs_read_bench BLOCK_FILE.mnt num_files file_size max_threads\n\n");
+  fprintf(stderr,"Will create the block_fs BLOCK_FILE.mnt, and time concurrent reads of all the files.\n");
+  exit(1);
+}
+
+
+int main(int argc , char ** argv) {
+  if (argc != 5)
+    usage();
+  {
+    const char * mount_file = argv[1];
+    int num_files , file_size , max_threads;
+
+    if (util_file_exists( mount_file )) {
+      fprintf(stderr,"The file:%s already exists - will not overwrite it.\n" , mount_file);
+      exit(1);
+    }
+
+    if (!(util_sscanf_int( argv[2] , &num_files ) &&
+          util_sscanf_int( argv[3] , &file_size ) &&
+          util_sscanf_int( argv[4] , &max_threads )))
+      usage();
+
+    create_fs( mount_file , num_files , file_size );
+    {
+      block_fs_type * block_fs = block_fs_mount( mount_file , 1 , 0 , 1.0 , 0 , false , true , false );
+      for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+        read_bench( block_fs , num_files , file_size , num_threads );
+      block_fs_close( block_fs , false );
+    }
+  }
+  exit(0);
+}
@@ -0,0 +1,123 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'matmul_bench.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/timer.h>
+#include <ert/util/matrix.h>
+#include <ert/util/rng.h>
+
+
+/*
+  Small benchmark of A = A*X with the dimensions of an EnKF update
+  with an ensemble of 200 realisations, i.e. A:[rows,200] and
+  X:[200,200]; the reference triple loop, the panel blocked
+  matrix_inplace_matmul(), the threaded matrix_inplace_matmul_mt1()
+  and the single precision matrix_inplace_matmul_float() are timed.
+  The default of 1000000 rows corresponds to a field with 1e6 active
+  cells.
+*/
+
+#define ENS_SIZE 200
+
+
+static void reference_matmul( matrix_type * A , const matrix_type * B ) {
+  const int rows    = matrix_get_rows( A );
+  const int columns = matrix_get_columns( A );
+  double * tmp = util_calloc( columns , sizeof * tmp );
+
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < columns; j++) {
+      double sum = 0;
+      for (int k = 0; k < columns; k++)
+        sum += matrix_iget( A , i , k ) * matrix_iget( B , k , j );
+      tmp[j] = sum;
+    }
+    for (int j = 0; j < columns; j++)
+      matrix_iset( A , i , j , tmp[j] );
+  }
+  free( tmp );
+}
+
+
+static void matmul_bench( rng_type * rng , int rows , bool include_reference ) {
+  matrix_type * A = matrix_alloc( rows , ENS_SIZE );
+  matrix_type * X = matrix_alloc( ENS_SIZE , ENS_SIZE );
+  float * A_float = util_calloc( (size_t) rows * ENS_SIZE , sizeof * A_float );
+  timer_type * timer = timer_alloc( true );
+  int num_threads = util_get_num_cpu( );
+
+  matrix_random_init( A , rng );
+  matrix_random_init( X , rng );
+  printf("A = A*X with A:[%d,%d]\n" , rows , ENS_SIZE);
+
+  if (include_reference) {
+    timer_start( timer );
+    reference_matmul( A , X );
+    printf("   reference:                 %8.3f s\n" , timer_stop( timer ));
+  }
+
+  timer_start( timer );
+  matrix_inplace_matmul( A , X );
+  printf("   blocked:                   %8.3f s\n" , timer_stop( timer ));
+
+  timer_start( timer );
+  matrix_inplace_matmul_mt1( A , X , num_threads );
+  printf("   blocked with %3d threads:  %8.3f s\n" , num_threads , timer_stop( timer ));
+
+  timer_start( timer );
+  matrix_inplace_matmul_float( A_float , rows , rows , X );
+  printf("   float:                     %8.3f s\n" , timer_stop( timer ));
+
+  timer_free( timer );
+  free( A_float );
+  matrix_free( A );
+  matrix_free( X );
+}
+
+
+static int usage( void ) {
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Usage:\n\n");
+  fprintf(stderr,"   bash%% matmul_bench [rows] [--no-reference]\n\n");
+  fprintf(stderr,"Will time A = A*X for A:[rows,%d] and X:[%d,%d]; rows defaults to 1000000.\n" , ENS_SIZE , ENS_SIZE , ENS_SIZE);
+  exit(1);
+}
+
+
+int main(int argc , char ** argv) {
+  int rows = 1000000;
+  bool include_reference = true;
+
+  for (int iarg = 1; iarg < argc; iarg++) {
+    if (util_string_equal( argv[iarg] , "--no-reference" ))
+      include_reference = false;
+    else if (!util_sscanf_int( argv[iarg] , &rows ) || rows <= 0)
+      usage();
+  }
+
+  {
+    rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+    matmul_bench( rng , rows , include_reference );
+    rng_free( rng );
+  }
+  exit(0);
+}
@@ -39,6 +39,9 @@ extern "C" {
   double          block_fs_get_fragmentation( const block_fs_type * block_fs );
   bool            block_fs_rotate( block_fs_type * block_fs , double fragmentation_limit);
   void            block_fs_fsync( block_fs_type * block_fs );
+  void            block_fs_flush( block_fs_type * block_fs );
+  void            block_fs_set_async_write( block_fs_type * block_fs , bool async_write);
+  bool            block_fs_get_async_write( const block_fs_type * block_fs );
   bool            block_fs_is_mount( const char * mount_file );
   bool            block_fs_is_readonly( const block_fs_type * block_fs);
   block_fs_type * block_fs_mount( const char * mount_file , 
@@ -52,9 +55,11 @@ extern "C" {
   void            block_fs_close( block_fs_type * block_fs , bool unlink_empty);
   void            block_fs_fwrite_file(block_fs_type * block_fs , const char * filename , const void * ptr , size_t byte_size);
   void            block_fs_fwrite_buffer(block_fs_type * block_fs , const char * filename , const buffer_type * buffer);
+  void            block_fs_fwrite_buffers(block_fs_type * block_fs , int num_files , const char ** filenames , buffer_type ** buffers);
   void            block_fs_fread_file( block_fs_type * block_fs , const char * filename , void * ptr);
   int             block_fs_get_filesize( block_fs_type * block_fs , const char * filename);
   void            block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * filename , buffer_type * buffer);
+  int             block_fs_fread_buffers( block_fs_type * block_fs , int num_files , const char ** filenames , buffer_type ** buffers , bool * found);
   void            block_fs_sync( block_fs_type * block_fs );
   void            block_fs_unlink_file( block_fs_type * block_fs , const char * filename);
   bool            block_fs_has_file( block_fs_type * block_fs , const char * filename);
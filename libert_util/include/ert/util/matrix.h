@@ -120,6 +120,7 @@ typedef struct matrix_struct matrix_type;
 
   void          matrix_inplace_matmul(matrix_type * A, const matrix_type * B);
   void          matrix_inplace_matmul_mt1(matrix_type * A, const matrix_type * B , int num_threads);
+  void          matrix_inplace_matmul_float( float * A , int rows , int lda , const matrix_type * B );
 #ifdef HAVE_THREAD_POOL
   void          matrix_inplace_matmul_mt2(matrix_type * A, const matrix_type * B , thread_pool_type * thread_pool);
 #endif
@@ -36,6 +36,7 @@ void          matrix_dgemv(const matrix_type * A , const double * x , double * y
 void          matrix_mul_vector(const matrix_type * A , const double * x , double * y);
 void          matrix_gram_set( const matrix_type * X , matrix_type * G, bool col);
 matrix_type * matrix_alloc_gram( const matrix_type * X , bool col);
+void          matrix_sgemm_data( int m , int n , int k , const float * A , int lda , const float * B , int ldb , float * C , int ldc);
 
 
 #ifdef __cplusplus
@@ -175,6 +175,8 @@ typedef enum {left_pad   = 0,
 
   void         util_usleep( unsigned long micro_seconds );
   void         util_yield(void);
+  int          util_get_num_cpu( void );
+  int          util_get_cgroup_cpu_quota( const char * cgroup_file , const char * cgroup_root );
   char       * util_blocking_alloc_stdin_line(unsigned long );
 
   int          util_roundf( float x );
@@ -529,6 +531,10 @@ void    util_abort_set_executable( const char * argv0 );
   bool         util_try_lockf(const char *  , mode_t  , int * );
 #endif
 
+#ifdef ERT_HAVE_UNISTD
+  void         util_pread(int fd , void * ptr , size_t byte_size , long int offset , const char * caller);
+#endif
+
 
 
 
@@ -21,12 +21,18 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <errno.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <time.h>
 #include <fnmatch.h>
 
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 #include <ert/util/hash.h>
 #include <ert/util/util.h>
 #include <ert/util/block_fs.h>
@@ -38,11 +44,22 @@
 #define MOUNT_MAP_MAGIC_INT  8861290
 #define BLOCK_FS_TYPE_ID     7100652
 #define INDEX_MAGIC_INT      1213775
-#define INDEX_FORMAT_VERSION       1
+#define INDEX_FORMAT_VERSION       2
 
 // #define ENABLE_CACHE
 
 
+/*
+  With asynchronous writes the writer thread will block new writes
+  when more than ASYNC_MAX_QUEUE_SIZE bytes are waiting in the queue,
+  and the nodes of one batch are written to disk in contiguous chunks
+  of at most ASYNC_MAX_WRITE_SIZE bytes.
+*/
+
+#define ASYNC_MAX_QUEUE_SIZE   (256 * 1024 * 1024)
+#define ASYNC_MAX_WRITE_SIZE    (16 * 1024 * 1024)
+
+
 /*
   During mounting a significant part of the time is spent on filling
   up the index hash table. By default a hash table is created with a
@@ -58,6 +75,50 @@
 #define DEFAULT_INDEX_SIZE 2048
 
 
+/*
+  The index file
+  --------------
+
+  When the filesystem is closed the index is written to the index file
+  in a form which can be used directly from an mmap() of the file:
+
+     index_header_type
+     index_slot_type  table[table_size]       <- Open addressing hash table of the files.
+     index_slot_type  free_nodes[num_free_nodes]
+     char             strings[string_size]    <- The \0 terminated filenames.
+
+  The table is probed linearly from index_hash( filename ) and the
+  key_offset field of empty slots is -1. The index file is only used
+  if the data file still has the size and mtime stored in the header.
+
+  When mounting from the index file only the free nodes are loaded,
+  the file nodes are moved from the index file to the index hash
+  table the first time the file is modified; reads are served
+  directly from the index file.
+*/
+
+typedef struct {
+  int32_t  magic;
+  int32_t  version;
+  int64_t  data_mtime;       /* st_mtime of the data file when the index was written. */
+  int64_t  data_size;        /* st_size of the data file when the index was written. */
+  int64_t  data_file_size;   /* The data_file_size field of the block_fs instance. */
+  int64_t  num_files;
+  int64_t  num_free_nodes;
+  int64_t  table_size;       /* A power of two, larger than num_files. */
+  int64_t  string_size;
+} index_header_type;
+
+
+typedef struct {
+  int64_t  node_offset;
+  int32_t  key_offset;       /* Offset of the filename in the string table; -1 for empty slots and free nodes. */
+  int32_t  node_size;
+  int32_t  data_offset;
+  int32_t  data_size;
+} index_slot_type;
+
+
 
 /**
    These should be bitwise "smart" - so it is possible
@@ -147,8 +208,7 @@ struct block_fs_struct {
   int              block_size;      /* The size of blocks in bytes. */
   int              lock_fd;         /* The file descriptor for the lock_file. Set to -1 if we do not have write access. */
   
-  pthread_mutex_t  io_lock;         /* Lock held during fread of the data file. */
-  pthread_rwlock_t rw_lock;         /* Read-write lock during all access to the fs. */
+  pthread_rwlock_t rw_lock;         /* Read-write lock during all access to the fs; reads use pread() on data_fd and need no further locking. */
   
   int              num_free_nodes;   
   hash_type      * index;           /* THE HASH table of all the nodes/files which have been stored. */
@@ -156,6 +216,12 @@ struct block_fs_struct {
   vector_type    * file_nodes;      /* This vector owns all the file_node instances - the index and free_nodes structures
                                        only contain pointers to the objects stored in this vector. */
   int              write_count;     /* This just counts the number of writes since the file system was mounted. */
+
+  char           * index_data;      /* The content of the index file loaded at mount; NULL when all files are in the index hash table. */
+  size_t           index_data_size;
+  bool             index_mmapped;   /* Whether index_data is mmap()'ed or malloc()'ed. */
+  char           * index_loaded;    /* index_loaded[i] is set when slot i has been moved to the index hash table. */
+  long             index_unloaded;  /* The number of files which are only found in index_data. */
   int              max_cache_size;
   size_t           total_cache_size;
   size_t           max_total_cache_size;
@@ -164,11 +230,37 @@ struct block_fs_struct {
                                             fragmentation_limit == 0.0 : Rotate when one byte is wasted. */
   bool             data_owner;
   int              fsync_interval;  /* 0: never  n: every nth iteration. */
+
+  /* Asynchronous writes - see block_fs_set_async_write(). */
+  bool             async_write;
+  bool             writer_exit;     /* Set to tell the writer thread to exit when the queue is empty. */
+  bool             writer_busy;     /* The writer thread is writing a batch it has taken from the queue. */
+  pthread_t        writer_thread;
+  pthread_mutex_t  queue_lock;      /* Protects the write_queue, pending, queue_size and writer_xxx fields. */
+  pthread_cond_t   queue_cond;      /* Signalled when a write is queued, or the writer thread should exit. */
+  pthread_cond_t   flush_cond;      /* Signalled when the writer thread has completed a batch. */
+  vector_type    * write_queue;     /* The write_request instances waiting for the writer thread. */
+  hash_type      * pending;         /* filename -> the last write_request of that file which is not yet on disk. */
+  size_t           queue_size;      /* The number of data bytes in pending write requests. */
 };
 
+
+/*
+  A write which has been queued for the writer thread; the request
+  holds a private copy of the data.
+*/
+
+typedef struct {
+  char   * filename;
+  char   * data;
+  size_t   data_size;
+} write_request_type;
+
 /*****************************************************************/
 
 static void block_fs_rotate__( block_fs_type * block_fs );
+static void block_fs_fsync__( block_fs_type * block_fs );
+static const write_request_type * block_fs_get_pending__( const block_fs_type * block_fs , const char * filename);
 
 UTIL_SAFE_CAST_FUNCTION( block_fs , BLOCK_FS_TYPE_ID )
 
@@ -414,45 +506,6 @@ static void file_node_set_data_offset( file_node_type * file_node, const char *
 
 
 
-static void file_node_dump_index( const file_node_type * file_node , FILE * index_stream) {
-  util_fwrite_int( file_node->status , index_stream );
-  util_fwrite_long( file_node->node_offset , index_stream );
-  util_fwrite_int( file_node->node_size   , index_stream );
-  util_fwrite_int( file_node->data_offset , index_stream );
-  util_fwrite_int( file_node->data_size   , index_stream );
-}
-
-
-
-/*
-static file_node_type * file_node_index_fread_alloc( FILE * stream ) {
-  node_status_type status = util_fread_int( stream );
-  long int node_offset    = util_fread_long( stream );
-  int node_size           = util_fread_int( stream );
-  {
-    file_node_type * file_node = file_node_alloc( status , node_offset , node_size );
-    file_node->data_offset = util_fread_int( stream );
-    file_node->data_size   = util_fread_int( stream );
-    
-    return file_node;
-  }
-}
-*/
-
-static file_node_type * file_node_index_buffer_fread_alloc( buffer_type * buffer) {
-  node_status_type status = buffer_fread_int( buffer );
-  long int node_offset    = buffer_fread_long( buffer );
-  int node_size           = buffer_fread_int( buffer );
-  {
-    file_node_type * file_node = file_node_alloc( status , node_offset , node_size );
-
-    file_node->data_offset = buffer_fread_int( buffer );
-    file_node->data_size   = buffer_fread_int( buffer );
-    
-    return file_node;
-  }
-}
-
 /* file_node functions - end. */
 /*****************************************************************/
 
@@ -497,6 +550,19 @@ static inline void block_fs_release_rwlock( block_fs_type * block_fs ) {
 }
 
 
+/*
+  The writes go through the buffered data_stream, whereas the reads
+  use pread() directly on the data_fd file descriptor; the stream
+  must therefore be flushed before the write lock is released.
+*/
+
+static inline void block_fs_release_wlock( block_fs_type * block_fs ) {
+  if (block_fs->data_stream != NULL)
+    fflush( block_fs->data_stream );
+  pthread_rwlock_unlock( &block_fs->rw_lock );
+}
+
+
 static inline void block_fs_aquire_rlock( block_fs_type * block_fs ) {
   pthread_rwlock_rdlock( &block_fs->rw_lock );
   /*
@@ -602,6 +668,179 @@ static void block_fs_install_node(block_fs_type * block_fs , file_node_type * no
 }
 
 
+/*****************************************************************/
+/* The index file loaded at mount. */
+
+static uint32_t index_hash( const char * key ) {
+  uint32_t hash = 2166136261u;     /* FNV-1a: the hash values are stored on disk and must not change. */
+  for (const unsigned char * c = (const unsigned char *) key; *c; c++) {
+    hash ^= *c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+
+static const index_header_type * block_fs_index_header( const block_fs_type * block_fs ) {
+  return (const index_header_type *) block_fs->index_data;
+}
+
+
+static const index_slot_type * block_fs_index_slots( const block_fs_type * block_fs ) {
+  return (const index_slot_type *) &block_fs->index_data[ sizeof(index_header_type) ];
+}
+
+
+static const char * block_fs_index_strings( const block_fs_type * block_fs ) {
+  const index_header_type * header = block_fs_index_header( block_fs );
+  return &block_fs->index_data[ sizeof(index_header_type) + (header->table_size + header->num_free_nodes) * sizeof(index_slot_type) ];
+}
+
+
+/*
+  Returns the slot of @filename in the index file, or -1 if the file
+  is not in the index file or has already been moved to the index
+  hash table.
+*/
+
+static long block_fs_lookup_slot( const block_fs_type * block_fs , const char * filename ) {
+  if (block_fs->index_data != NULL) {
+    const index_header_type * header = block_fs_index_header( block_fs );
+    const index_slot_type * slots    = block_fs_index_slots( block_fs );
+    const char * strings             = block_fs_index_strings( block_fs );
+    long mask  = header->table_size - 1;
+    long islot = index_hash( filename ) & mask;
+
+    while (slots[islot].key_offset >= 0) {
+      if (strcmp( &strings[ slots[islot].key_offset ] , filename ) == 0) {
+        if (block_fs->index_loaded[islot])
+          return -1;
+        else
+          return islot;
+      }
+      islot = (islot + 1) & mask;
+    }
+  }
+  return -1;
+}
+
+
+static void file_node_init_from_slot( file_node_type * file_node , node_status_type status , const index_slot_type * slot ) {
+  file_node->status      = status;
+  file_node->node_offset = slot->node_offset;
+  file_node->node_size   = slot->node_size;
+  file_node->data_offset = slot->data_offset;
+  file_node->data_size   = slot->data_size;
+#ifdef ENABLE_CACHE
+  file_node->cache      = NULL;
+  file_node->cache_size = 0;
+#endif
+}
+
+
+/*
+  Moves the file in slot @islot of the index file to the index hash
+  table; must be called with the write lock held.
+*/
+
+static file_node_type * block_fs_load_slot( block_fs_type * block_fs , long islot ) {
+  const index_slot_type * slot = &block_fs_index_slots( block_fs )[islot];
+  const char * filename        = &block_fs_index_strings( block_fs )[ slot->key_offset ];
+  file_node_type * file_node   = file_node_alloc( NODE_IN_USE , slot->node_offset , slot->node_size );
+
+  file_node->data_offset = slot->data_offset;
+  file_node->data_size   = slot->data_size;
+  block_fs_install_node( block_fs , file_node );
+  block_fs_insert_index_node( block_fs , filename , file_node );
+  block_fs->index_loaded[islot] = 1;
+  block_fs->index_unloaded--;
+  return file_node;
+}
+
+
+static void block_fs_free_index_data( block_fs_type * block_fs ) {
+  if (block_fs->index_data != NULL) {
+#ifdef ERT_HAVE_MMAP
+    if (block_fs->index_mmapped)
+      munmap( block_fs->index_data , block_fs->index_data_size );
+    else
+#endif
+      free( block_fs->index_data );
+
+    free( block_fs->index_loaded );
+    block_fs->index_data     = NULL;
+    block_fs->index_loaded   = NULL;
+    block_fs->index_unloaded = 0;
+  }
+}
+
+
+/*
+  Moves all the remaining files from the index file to the index hash
+  table, and releases the index file; must be called with the write
+  lock held. Used before operations which need to iterate over all
+  the files.
+*/
+
+static void block_fs_load_all_slots( block_fs_type * block_fs ) {
+  if (block_fs->index_data != NULL) {
+    const index_header_type * header = block_fs_index_header( block_fs );
+    const index_slot_type * slots    = block_fs_index_slots( block_fs );
+
+    hash_resize( block_fs->index , 2 * (hash_get_size( block_fs->index ) + block_fs->index_unloaded) + 64 );
+    for (long islot = 0; islot < header->table_size; islot++)
+      if ((slots[islot].key_offset >= 0) && !block_fs->index_loaded[islot])
+        block_fs_load_slot( block_fs , islot );
+
+    block_fs_free_index_data( block_fs );
+  }
+}
+
+
+/*
+  Returns the node of @filename, or NULL if the file does not exist;
+  a file which is only in the index file is moved to the index hash
+  table, i.e. this must be called with the write lock held.
+*/
+
+static file_node_type * block_fs_get_node( block_fs_type * block_fs , const char * filename ) {
+  if (hash_has_key( block_fs->index , filename ))
+    return hash_get( block_fs->index , filename );
+  else {
+    long islot = block_fs_lookup_slot( block_fs , filename );
+    if (islot >= 0)
+      return block_fs_load_slot( block_fs , islot );
+    else
+      return NULL;
+  }
+}
+
+
+/*
+  The read only version of block_fs_get_node() for use with the read
+  lock: a file which is only in the index file is returned in the
+  storage supplied by the calling scope.
+*/
+
+static const file_node_type * block_fs_get_read_node( const block_fs_type * block_fs , const char * filename , file_node_type * mapped_node) {
+  if (hash_has_key( block_fs->index , filename ))
+    return hash_get( block_fs->index , filename );
+  else {
+    long islot = block_fs_lookup_slot( block_fs , filename );
+    if (islot < 0)
+      util_abort("%s: the file:%s does not exist \n",__func__ , filename );
+
+    file_node_init_from_slot( mapped_node , NODE_IN_USE , &block_fs_index_slots( block_fs )[islot] );
+    return mapped_node;
+  }
+}
+
+
+static long block_fs_get_num_files( const block_fs_type * block_fs ) {
+  return hash_get_size( block_fs->index ) + block_fs->index_unloaded;
+}
+
+
 static void block_fs_set_filenames( block_fs_type * block_fs ) {
   char * data_ext  = util_alloc_sprintf("data_%d" , block_fs->version );
   char * lock_ext  = util_alloc_sprintf("lock_%d" , block_fs->version );
@@ -661,8 +900,16 @@ static block_fs_type * block_fs_alloc_empty( const char * mount_file ,
   
   block_fs->fragmentation_limit = fragmentation_limit;   
   util_alloc_file_components( mount_file , &block_fs->path , &block_fs->base_name, NULL );
-  pthread_mutex_init( &block_fs->io_lock  , NULL);
   pthread_rwlock_init( &block_fs->rw_lock , NULL);
+  pthread_mutex_init( &block_fs->queue_lock , NULL );
+  pthread_cond_init( &block_fs->queue_cond , NULL );
+  pthread_cond_init( &block_fs->flush_cond , NULL );
+  block_fs->async_write = false;
+  block_fs->writer_exit = false;
+  block_fs->writer_busy = false;
+  block_fs->write_queue = vector_alloc_new();
+  block_fs->pending     = hash_alloc();
+  block_fs->queue_size  = 0;
   {
     FILE * stream            = util_fopen( mount_file , "r");
     int id                   = util_fread_int( stream );
@@ -675,6 +922,9 @@ static block_fs_type * block_fs_alloc_empty( const char * mount_file ,
   block_fs->data_file   = NULL;
   block_fs->lock_file   = NULL;
   block_fs->index_file  = NULL;
+  block_fs->index_data     = NULL;
+  block_fs->index_loaded   = NULL;
+  block_fs->index_unloaded = 0;
   block_fs_reinit( block_fs );
 
 
@@ -842,7 +1092,10 @@ static void block_fs_update_cache_node( block_fs_type * block_fs, file_node_type
 static void block_fs_preload( block_fs_type * block_fs ) {
   if ((block_fs->max_cache_size > 0) && (block_fs->data_stream != NULL) && (block_fs->max_total_cache_size > 0)) {
     void * buffer = util_malloc( block_fs->max_cache_size );
-    hash_iter_type * index_iter = hash_iter_alloc( block_fs->index );
+    hash_iter_type * index_iter;
+
+    block_fs_load_all_slots( block_fs );
+    index_iter = hash_iter_alloc( block_fs->index );
     
     while (!hash_iter_is_complete( index_iter )) {
       file_node_type * node = hash_iter_get_next_value( index_iter );
@@ -974,13 +1227,69 @@ static void block_fs_build_index( block_fs_type * block_fs , long_vector_type *
 }
 
 
+static bool index_slot_check_node( const index_slot_type * slot , int64_t data_size ) {
+  if ((slot->node_offset < 0) || (slot->node_size <= 0) || (slot->node_offset + slot->node_size > data_size))
+    return false;
+
+  if ((slot->data_offset < 0) || (slot->data_size < 0) || ((int64_t) slot->data_offset + slot->data_size > slot->node_size))
+    return false;
+
+  return true;
+}
+
+
+/*
+  Checks the slots of an index file which has been mapped into
+  index_data: all the nodes must be inside the data file, the key
+  offsets must point into the string table and the number of files
+  must agree with the header. The header itself has been checked in
+  block_fs_load_index().
+*/
+
+static bool block_fs_check_index_data( const block_fs_type * block_fs ) {
+  const index_header_type * header = block_fs_index_header( block_fs );
+  const index_slot_type * slots    = block_fs_index_slots( block_fs );
+  const char * strings             = block_fs_index_strings( block_fs );
+  int64_t num_files = 0;
+
+  if ((header->string_size > 0) && (strings[ header->string_size - 1 ] != '\0'))
+    return false;
+
+  for (long islot = 0; islot < header->table_size; islot++) {
+    const index_slot_type * slot = &slots[islot];
+    if (slot->key_offset == -1)
+      continue;
+
+    if ((slot->key_offset < 0) || (slot->key_offset >= header->string_size))
+      return false;
+
+    if (!index_slot_check_node( slot , header->data_size ))
+      return false;
+
+    num_files++;
+  }
+
+  for (long i = 0; i < header->num_free_nodes; i++) {
+    const index_slot_type * slot = &slots[ header->table_size + i ];
+    if ((slot->key_offset != -1) || !index_slot_check_node( slot , header->data_size ))
+      return false;
+  }
+
+  return (num_files == header->num_files);
+}
+
+
 /**
-   Load an index for (slightly) faster mounting of the filesystem. The
-   function starts be reading a header and check if the current index
-   file is applicable.
+   Load an index for faster mounting of the filesystem. The function
+   starts be reading the header and check if the current index file
+   is applicable; in that case the index file is mmap()'ed (or read
+   in one operation if mmap() is not available) and only the free
+   nodes are loaded, see the documentation of the index file at the
+   top.
 
    Will return true of the loading succedeed, and false if no index
-   was loaded.  
+   was loaded; an index file with an inconsistent header or slots is
+   not loaded, and the index is then built by scanning the data file.
 */
 
 
@@ -989,45 +1298,67 @@ static bool block_fs_load_index( block_fs_type * block_fs ) {
   if (fstat( block_fs->data_fd , &data_stat) == 0) {
     FILE * stream = fopen( block_fs->index_file , "r");
     if (stream != NULL) {
-      int    id          = util_fread_int( stream );
-      int    version     = util_fread_int( stream );
-      time_t index_mtime = util_fread_time_t( stream );
-
-      time_t data_mtime  = data_stat.st_mtime;
-      fclose( stream );
+      index_header_type header;
+      stat_type index_stat;
+      bool valid = false;
+
+      if ((fstat( fileno( stream ) , &index_stat ) == 0) && (fread( &header , sizeof header , 1 , stream ) == 1)) {
+        if ((header.magic == INDEX_MAGIC_INT) &&                 /* This is indeed an index file. */
+            (header.version == INDEX_FORMAT_VERSION) &&          /* The version on disk agrees with this version. */
+            (header.data_mtime == data_stat.st_mtime) &&         /* The time stamp agrees with the time stamp of the data. */
+            (header.data_size == data_stat.st_size)) {           /* The size agrees with the size of the data. */
+          int64_t max_slots = index_stat.st_size / sizeof(index_slot_type);
+
+          if ((header.table_size > 0) && ((header.table_size & (header.table_size - 1)) == 0) &&
+              (header.num_files >= 0) && (header.num_files < header.table_size) &&
+              (header.num_free_nodes >= 0) && (header.string_size >= 0) &&
+              (header.table_size <= max_slots) && (header.num_free_nodes <= max_slots) &&
+              (header.string_size <= index_stat.st_size)) {
+            size_t index_size = sizeof header + (header.table_size + header.num_free_nodes) * sizeof(index_slot_type) + header.string_size;
+            valid = (index_size == index_stat.st_size);
+          }
+        }
+      }
 
-      if ((id == INDEX_MAGIC_INT) &&               /* This is indeed an index file. */ 
-          (version == INDEX_FORMAT_VERSION) &&     /* The version on disk agrees with this version. */
-          (index_mtime == data_mtime)) {           /* The time stamp agrees with the time stamp of the data. */
-        
-        /* Read the whole index file in one single read operation. */
-        buffer_type * buffer = buffer_fread_alloc( block_fs->index_file );
-        
-        buffer_fskip( buffer , sizeof( time_t ) + 2 * sizeof( int ));
-        /*1: Loading all the active nodes. */
+      if (valid) {
+        block_fs->index_data_size = index_stat.st_size;
+        block_fs->index_mmapped   = false;
+#ifdef ERT_HAVE_MMAP
         {
-          int num_active_nodes = buffer_fread_int( buffer );
-          hash_resize( block_fs->index , num_active_nodes * 2 + 64);
-          
-          for (int i=0; i < num_active_nodes; i++) {
-            const char * filename = buffer_fread_string( buffer );
-            file_node_type * file_node = file_node_index_buffer_fread_alloc( buffer );
-            block_fs_install_node( block_fs , file_node);
-            block_fs_insert_index_node(block_fs , filename , file_node);
+          void * data = mmap( NULL , block_fs->index_data_size , PROT_READ , MAP_SHARED , fileno( stream ) , 0 );
+          if (data != MAP_FAILED) {
+            block_fs->index_data    = data;
+            block_fs->index_mmapped = true;
           }
         }
-        
-        /*2: Loading all the free nodes. */
+#endif
+        if (!block_fs->index_mmapped) {
+          block_fs->index_data = util_malloc( block_fs->index_data_size );
+          util_pread( fileno( stream ) , block_fs->index_data , block_fs->index_data_size , 0 , __func__ );
+        }
+      }
+      fclose( stream );
+
+      if (valid && !block_fs_check_index_data( block_fs )) {
+        block_fs_free_index_data( block_fs );
+        valid = false;
+      }
+
+      if (valid) {
+        block_fs->index_loaded   = util_calloc( header.table_size , sizeof * block_fs->index_loaded );
+        memset( block_fs->index_loaded , 0 , header.table_size * sizeof * block_fs->index_loaded );
+        block_fs->index_unloaded = header.num_files;
+        block_fs->data_file_size = header.data_file_size;
+
+        /* Loading all the free nodes. */
         {
-          int num_free_nodes = buffer_fread_int( buffer );
-          for (int i=0; i < num_free_nodes; i++) {
-            file_node_type * file_node = file_node_index_buffer_fread_alloc( buffer );
+          const index_slot_type * free_slots = &block_fs_index_slots( block_fs )[ header.table_size ];
+          for (long i = 0; i < header.num_free_nodes; i++) {
+            file_node_type * file_node = file_node_alloc( NODE_FREE , free_slots[i].node_offset , free_slots[i].node_size );
             block_fs_install_node( block_fs , file_node);
             block_fs_insert_free_node(block_fs , file_node);
           }
         }
-        buffer_free( buffer );
-        
         return true;
       }
     } 
@@ -1171,13 +1502,21 @@ static file_node_type * block_fs_get_new_node( block_fs_type * block_fs , const
 
 
 bool block_fs_has_file__( const block_fs_type * block_fs , const char * filename) {
-  return hash_has_key( block_fs->index , filename );
+  return hash_has_key( block_fs->index , filename ) || (block_fs_lookup_slot( block_fs , filename ) >= 0);
 }
 
 
 
 bool block_fs_has_file( block_fs_type * block_fs , const char * filename) {
   bool has_file;
+  if (block_fs->async_write) {
+    pthread_mutex_lock( &block_fs->queue_lock );
+    has_file = (block_fs_get_pending__( block_fs , filename ) != NULL);
+    pthread_mutex_unlock( &block_fs->queue_lock );
+    if (has_file)
+      return true;
+  }
+
   block_fs_aquire_rlock( block_fs );
   {
     has_file = block_fs_has_file__( block_fs , filename );
@@ -1190,7 +1529,10 @@ bool block_fs_has_file( block_fs_type * block_fs , const char * filename) {
 
 
 static void block_fs_unlink_file__( block_fs_type * block_fs , const char * filename ) {
-  file_node_type * node = hash_pop( block_fs->index , filename );
+  file_node_type * node;
+
+  block_fs_get_node( block_fs , filename );   /* Moves the file from the index file to the index hash table. */
+  node = hash_pop( block_fs->index , filename );
   block_fs_clear_cache_node( block_fs , node );
 
   node->status      = NODE_FREE;
@@ -1214,13 +1556,14 @@ double block_fs_get_fragmentation( const block_fs_type * block_fs ) {
 
 
 void block_fs_unlink_file( block_fs_type * block_fs , const char * filename) {
+  block_fs_flush( block_fs );
   block_fs_aquire_wlock( block_fs );
 
   block_fs_unlink_file__( block_fs , filename );
   if (block_fs_get_fragmentation( block_fs ) > block_fs->fragmentation_limit) 
     block_fs_rotate__( block_fs );
   
-  block_fs_release_rwlock( block_fs );
+  block_fs_release_wlock( block_fs );
 }
 
 
@@ -1242,10 +1585,11 @@ void block_fs_unlink_file( block_fs_type * block_fs , const char * filename) {
 */
 
 bool block_fs_rotate( block_fs_type * block_fs , double fragmentation_limit) {
+  block_fs_flush( block_fs );
   if (block_fs_get_fragmentation( block_fs ) > fragmentation_limit) {
     block_fs_aquire_wlock( block_fs );
     block_fs_rotate__( block_fs );
-    block_fs_release_rwlock( block_fs );
+    block_fs_release_wlock( block_fs );
     return true;
   } else
     return false;
@@ -1260,7 +1604,7 @@ bool block_fs_rotate( block_fs_type * block_fs , double fragmentation_limit) {
    Could possibly use fdatasync() to improve speed slightly?
 */
 
-void block_fs_fsync( block_fs_type * block_fs ) {
+static void block_fs_fsync__( block_fs_type * block_fs ) {
   if (block_fs->data_owner) {
     //fdatasync( block_fs->data_fd );
     fsync( block_fs->data_fd );
@@ -1270,6 +1614,18 @@ void block_fs_fsync( block_fs_type * block_fs ) {
 }
 
 
+/*
+  With asynchronous writes all the queued writes are completed before
+  the fsync(), i.e. when this function returns everything which has
+  been written to the block_fs instance is on disk.
+*/
+
+void block_fs_fsync( block_fs_type * block_fs ) {
+  block_fs_flush( block_fs );
+  block_fs_fsync__( block_fs );
+}
+
+
 
 
 /**
@@ -1322,20 +1678,29 @@ static void block_fs_fwrite__(block_fs_type * block_fs , const char * filename ,
     block_fs_update_cache_node( block_fs , node , data_size , ptr);
     block_fs->write_count++;
     if (block_fs->fsync_interval && ((block_fs->write_count % block_fs->fsync_interval) == 0)) 
-      block_fs_fsync( block_fs );
+      block_fs_fsync__( block_fs );
     
   }
 }
 
 
 
-static void block_fs_fwrite_file_unlocked(block_fs_type * block_fs , const char * filename , const void * ptr , size_t data_size) {
+/*
+  Finds the node where @filename should be written; either the
+  existing node of @filename, or a new node if @filename does not
+  exist or the existing node is too small. The new_node argument is
+  set to true if the node must be inserted in the index when the
+  write is complete.
+*/
+
+static file_node_type * block_fs_get_write_node( block_fs_type * block_fs , const char * filename , size_t data_size , bool * new_node) {
   file_node_type * file_node;
-  bool   new_node = true;   
   size_t min_size = data_size + file_node_header_size( filename );
+
+  *new_node = true;
   
-  if (block_fs_has_file__( block_fs , filename )) {
-    file_node = hash_get( block_fs->index , filename );
+  file_node = block_fs_get_node( block_fs , filename );
+  if (file_node != NULL) {
     if (file_node->node_size < min_size) {
       /* 
          The current node is too small for the new content:
@@ -1349,10 +1714,17 @@ static void block_fs_fwrite_file_unlocked(block_fs_type * block_fs , const char
       block_fs_unlink_file__( block_fs , filename );
       file_node = block_fs_get_new_node( block_fs , filename , min_size );
     } else
-      new_node = false;  /* We are reusing the existing node. */
+      *new_node = false;  /* We are reusing the existing node. */
   } else 
     file_node = block_fs_get_new_node( block_fs , filename , min_size );
-  
+
+  return file_node;
+}
+
+
+static void block_fs_fwrite_file_unlocked(block_fs_type * block_fs , const char * filename , const void * ptr , size_t data_size) {
+  bool new_node;
+  file_node_type * file_node = block_fs_get_write_node( block_fs , filename , data_size , &new_node );
   
   /* The actual writing ... */
   block_fs_fwrite__( block_fs , filename , file_node , ptr , data_size);
@@ -1361,8 +1733,363 @@ static void block_fs_fwrite_file_unlocked(block_fs_type * block_fs , const char
 }
 
 
+/*****************************************************************/
+/*
+  Asynchronous writes
+  -------------------
+
+  When asynchronous writes are enabled with block_fs_set_async_write()
+  the block_fs_fwrite_xxx() functions will only copy the data into a
+  write_request and append it to the write_queue; the actual writing
+  is done by a separate writer thread. The writer thread takes all
+  the requests in the queue as one batch, and writes the batch with
+  one acquisition of the write lock:
+
+   1. Only the last request for each filename is written, and the
+      nodes are found for all the files before anything is written.
+
+   2. The nodes are sorted on offset, and nodes which are adjacent in
+      the data file are assembled in memory and written with one
+      fwrite(). In this first pass the nodes are marked with
+      NODE_WRITE_ACTIVE_START and NODE_WRITE_ACTIVE_END.
+
+   3. When the data of all the nodes has been written the
+      NODE_WRITE_ACTIVE tags are replaced with NODE_IN_USE and
+      NODE_END_TAG, and the data file is fsync()'ed once for the whole
+      batch (unless fsync_interval == 0).
+
+  I.e. if the application crashes while a batch is written the nodes
+  of the batch are either discarded as NODE_WRITE_ACTIVE or fixed as
+  invalid nodes when the filesystem is mounted again - exactly as for
+  a crash during a normal write.
+
+  Until a request has been written it is registered in the pending
+  hash table, and the read functions will serve the data from there,
+  i.e. a reader will always see its own writes.
+*/
+
+
+typedef struct {
+  const write_request_type * request;
+  file_node_type           * node;
+} batch_node_type;
+
+
+static write_request_type * write_request_alloc( const char * filename , const void * data , size_t data_size) {
+  write_request_type * request = util_malloc( sizeof * request );
+  request->filename  = util_alloc_string_copy( filename );
+  request->data      = util_alloc_copy( data , data_size );
+  request->data_size = data_size;
+  return request;
+}
+
+
+static void write_request_free( write_request_type * request ) {
+  free( request->filename );
+  free( request->data );
+  free( request );
+}
+
+
+static void write_request_free__( void * arg ) {
+  write_request_free( (write_request_type *) arg );
+}
+
+
+static int batch_node_cmp( const void * arg1 , const void * arg2 ) {
+  const batch_node_type * batch_node1 = arg1;
+  const batch_node_type * batch_node2 = arg2;
+
+  if (batch_node1->node->node_offset < batch_node2->node->node_offset)
+    return -1;
+  else if (batch_node1->node->node_offset > batch_node2->node->node_offset)
+    return 1;
+  else
+    return 0;
+}
+
+
+static long int batch_node_end( const batch_node_type * batch_node ) {
+  return batch_node->node->node_offset + batch_node->node->node_size;
+}
+
+
+/*
+  Assembles the nodes [first_node, last_node) of the sorted
+  batch_nodes array, which are adjacent in the data file, in one
+  buffer and writes them with one fwrite(). The status and end tag of
+  the nodes are written as NODE_WRITE_ACTIVE_START and
+  NODE_WRITE_ACTIVE_END.
+*/
+
+static void block_fs_fwrite_batch_chunk( block_fs_type * block_fs , const batch_node_type * batch_nodes , int first_node , int last_node) {
+  long int chunk_offset = batch_nodes[first_node].node->node_offset;
+  size_t chunk_size     = batch_node_end( &batch_nodes[last_node - 1] ) - chunk_offset;
+  char * chunk          = util_calloc( chunk_size , sizeof * chunk );
+
+  for (int inode = first_node; inode < last_node; inode++) {
+    const write_request_type * request = batch_nodes[inode].request;
+    const file_node_type * node        = batch_nodes[inode].node;
+    char * node_ptr = &chunk[ node->node_offset - chunk_offset ];
+    int key_length  = strlen( request->filename );
+    int length_tag  = (key_length == 0) ? -1 : key_length;   /* -1 is the util_fwrite_string() tag for "". */
+    char * ptr      = node_ptr;
+
+    /* The same layout as file_node_fwrite() & util_fwrite_string(). */
+    memcpy( ptr , &NODE_WRITE_ACTIVE_START , sizeof NODE_WRITE_ACTIVE_START );   ptr += sizeof NODE_WRITE_ACTIVE_START;
+    memcpy( ptr , &length_tag , sizeof length_tag );                             ptr += sizeof length_tag;
+    memcpy( ptr , request->filename , key_length + 1 );                          ptr += key_length + 1;
+    memcpy( ptr , &node->node_size , sizeof node->node_size );                   ptr += sizeof node->node_size;
+    memcpy( ptr , &node->data_size , sizeof node->data_size );
+
+    memcpy( &node_ptr[ node->data_offset ] , request->data , request->data_size );
+    memcpy( &node_ptr[ node->node_size - sizeof NODE_WRITE_ACTIVE_END ] , &NODE_WRITE_ACTIVE_END , sizeof NODE_WRITE_ACTIVE_END );
+  }
+
+  block_fs_fseek( block_fs , chunk_offset );
+  util_fwrite( chunk , 1 , chunk_size , block_fs->data_stream , __func__ );
+  free( chunk );
+}
+
+
+/*
+  Replaces the NODE_WRITE_ACTIVE tags of all the nodes in the batch
+  with NODE_IN_USE and NODE_END_TAG; when two nodes are adjacent the
+  end tag of the first node and the status of the second node are
+  written together.
+*/
+
+static void block_fs_fwrite_batch_tags( block_fs_type * block_fs , const batch_node_type * batch_nodes , int num_nodes) {
+  const int in_use = NODE_IN_USE;
+
+  for (int inode = 0; inode < num_nodes; inode++) {
+    const file_node_type * node = batch_nodes[inode].node;
+
+    if ((inode > 0) && (batch_node_end( &batch_nodes[inode - 1]) == node->node_offset)) {
+      int tags[2] = { NODE_END_TAG , in_use };
+      block_fs_fseek( block_fs , node->node_offset - sizeof NODE_END_TAG );
+      util_fwrite( tags , sizeof tags[0] , 2 , block_fs->data_stream , __func__ );
+    } else {
+      if (inode > 0) {
+        block_fs_fseek( block_fs , batch_node_end( &batch_nodes[inode - 1]) - sizeof NODE_END_TAG );
+        util_fwrite_int( NODE_END_TAG , block_fs->data_stream );
+      }
+      block_fs_fseek( block_fs , node->node_offset );
+      util_fwrite_int( in_use , block_fs->data_stream );
+    }
+  }
+
+  if (num_nodes > 0) {
+    block_fs_fseek( block_fs , batch_node_end( &batch_nodes[num_nodes - 1]) - sizeof NODE_END_TAG );
+    util_fwrite_int( NODE_END_TAG , block_fs->data_stream );
+  }
+}
+
+
+/*
+  Writes all the requests in the batch vector; must be called with
+  the write lock held.
+*/
+
+static void block_fs_fwrite_batch( block_fs_type * block_fs , const vector_type * batch ) {
+  int num_requests = vector_get_size( batch );
+  batch_node_type * batch_nodes = util_calloc( num_requests , sizeof * batch_nodes );
+  int num_nodes = 0;
+
+  /* 1: Find the nodes of the last request for each file. */
+  {
+    hash_type * written = hash_alloc();
+    for (int irequest = num_requests - 1; irequest >= 0; irequest--) {
+      const write_request_type * request = vector_iget_const( batch , irequest );
+      if (!hash_has_key( written , request->filename )) {
+        bool new_node;
+        file_node_type * node = block_fs_get_write_node( block_fs , request->filename , request->data_size , &new_node );
+
+        node->status    = NODE_IN_USE;
+        node->data_size = request->data_size;
+        file_node_set_data_offset( node , request->filename );
+        if (new_node)
+          block_fs_insert_index_node( block_fs , request->filename , node );
+        block_fs_update_cache_node( block_fs , node , request->data_size , request->data );
+
+        batch_nodes[num_nodes].request = request;
+        batch_nodes[num_nodes].node    = node;
+        num_nodes++;
+        hash_insert_int( written , request->filename , 1 );
+      }
+    }
+    hash_free( written );
+  }
+
+  /* 2: Write the nodes in chunks of adjacent nodes, marked as NODE_WRITE_ACTIVE. */
+  qsort( batch_nodes , num_nodes , sizeof * batch_nodes , batch_node_cmp );
+  {
+    int first_node = 0;
+    while (first_node < num_nodes) {
+      int last_node = first_node + 1;
+      while ((last_node < num_nodes) &&
+             (batch_node_end( &batch_nodes[last_node - 1] ) == batch_nodes[last_node].node->node_offset) &&
+             (batch_node_end( &batch_nodes[last_node] ) - batch_nodes[first_node].node->node_offset <= ASYNC_MAX_WRITE_SIZE))
+        last_node++;
+
+      block_fs_fwrite_batch_chunk( block_fs , batch_nodes , first_node , last_node );
+      first_node = last_node;
+    }
+  }
+  fflush( block_fs->data_stream );
+
+  /* 3: Mark the nodes as complete and sync the whole batch. */
+  block_fs_fwrite_batch_tags( block_fs , batch_nodes , num_nodes );
+  fflush( block_fs->data_stream );
+  block_fs->write_count += num_nodes;
+  if (block_fs->fsync_interval)
+    block_fs_fsync__( block_fs );
+
+  if ((block_fs->free_size * 1.0 / block_fs->data_file_size) > block_fs->fragmentation_limit)
+    block_fs_rotate__( block_fs );
+
+  free( batch_nodes );
+}
+
+
+static void * block_fs_writer_main( void * arg ) {
+  block_fs_type * block_fs = arg;
+
+  pthread_mutex_lock( &block_fs->queue_lock );
+  while (true) {
+    while ((vector_get_size( block_fs->write_queue ) == 0) && !block_fs->writer_exit)
+      pthread_cond_wait( &block_fs->queue_cond , &block_fs->queue_lock );
+
+    if (vector_get_size( block_fs->write_queue ) == 0)
+      break;    /* writer_exit has been set and the queue is empty. */
+    {
+      vector_type * batch = block_fs->write_queue;
+      block_fs->write_queue = vector_alloc_new();
+      block_fs->writer_busy = true;
+      pthread_mutex_unlock( &block_fs->queue_lock );
+
+      block_fs_aquire_wlock( block_fs );
+      block_fs_fwrite_batch( block_fs , batch );
+
+      /*
+        The requests are removed from the pending table before the
+        write lock is released, i.e. a reader will find the file
+        either in the pending table or in the index.
+      */
+      pthread_mutex_lock( &block_fs->queue_lock );
+      for (int irequest = 0; irequest < vector_get_size( batch ); irequest++) {
+        const write_request_type * request = vector_iget_const( batch , irequest );
+        if (hash_has_key( block_fs->pending , request->filename ) && (hash_get( block_fs->pending , request->filename ) == request))
+          hash_del( block_fs->pending , request->filename );
+        block_fs->queue_size -= request->data_size;
+      }
+      block_fs->writer_busy = false;
+      pthread_cond_broadcast( &block_fs->flush_cond );
+      pthread_mutex_unlock( &block_fs->queue_lock );
+      block_fs_release_wlock( block_fs );
+
+      vector_free( batch );
+      pthread_mutex_lock( &block_fs->queue_lock );
+    }
+  }
+  pthread_mutex_unlock( &block_fs->queue_lock );
+  return NULL;
+}
+
+
+static void block_fs_enqueue_write( block_fs_type * block_fs , const char * filename , const void * ptr , size_t data_size) {
+  write_request_type * request = write_request_alloc( filename , ptr , data_size );
+
+  pthread_mutex_lock( &block_fs->queue_lock );
+  {
+    /* Back pressure: wait for the writer thread if the queue has grown too large. */
+    while ((block_fs->queue_size > 0) && (block_fs->queue_size + data_size > ASYNC_MAX_QUEUE_SIZE))
+      pthread_cond_wait( &block_fs->flush_cond , &block_fs->queue_lock );
+
+    vector_append_owned_ref( block_fs->write_queue , request , write_request_free__ );
+    hash_insert_ref( block_fs->pending , filename , request );
+    block_fs->queue_size += data_size;
+    pthread_cond_signal( &block_fs->queue_cond );
+  }
+  pthread_mutex_unlock( &block_fs->queue_lock );
+}
+
+
+/*
+  Looks up @filename among the writes which have not yet been
+  written by the writer thread; must be called with the queue_lock
+  held. Returns NULL if there is no pending write for @filename.
+*/
+
+static const write_request_type * block_fs_get_pending__( const block_fs_type * block_fs , const char * filename) {
+  if (hash_has_key( block_fs->pending , filename ))
+    return hash_get( block_fs->pending , filename );
+  else
+    return NULL;
+}
+
+
+/**
+   Will block until all the writes which have been queued with
+   asynchronous writes are written to the data file. When
+   asynchronous writes are not enabled this function does nothing.
+*/
+
+void block_fs_flush( block_fs_type * block_fs ) {
+  if (block_fs->async_write) {
+    pthread_mutex_lock( &block_fs->queue_lock );
+    while ((vector_get_size( block_fs->write_queue ) > 0) || block_fs->writer_busy)
+      pthread_cond_wait( &block_fs->flush_cond , &block_fs->queue_lock );
+    pthread_mutex_unlock( &block_fs->queue_lock );
+  }
+}
+
+
+/**
+   Turns asynchronous writes on or off, see the documentation of the
+   writer thread above. When asynchronous writes are turned off all
+   the queued writes are completed and the writer thread is joined
+   before this function returns. The setting is ignored for block_fs
+   instances which are not data owner.
+
+   Observe that the async_write setting should not be changed while
+   other threads are using the block_fs instance.
+*/
+
+void block_fs_set_async_write( block_fs_type * block_fs , bool async_write) {
+  if (!block_fs->data_owner)
+    return;
+
+  if (async_write && !block_fs->async_write) {
+    block_fs->writer_exit = false;
+    block_fs->async_write = true;
+    if (pthread_create( &block_fs->writer_thread , NULL , block_fs_writer_main , block_fs ) != 0)
+      util_abort("%s: failed to start the writer thread \n",__func__);
+  } else if (!async_write && block_fs->async_write) {
+    pthread_mutex_lock( &block_fs->queue_lock );
+    block_fs->writer_exit = true;
+    pthread_cond_signal( &block_fs->queue_cond );
+    pthread_mutex_unlock( &block_fs->queue_lock );
+
+    pthread_join( block_fs->writer_thread , NULL );
+    block_fs->async_write = false;
+  }
+}
+
+
+bool block_fs_get_async_write( const block_fs_type * block_fs ) {
+  return block_fs->async_write;
+}
+
+
+
 
 void block_fs_fwrite_file(block_fs_type * block_fs , const char * filename , const void * ptr , size_t data_size) {
+  if (block_fs->async_write) {
+    block_fs_enqueue_write( block_fs , filename , ptr , data_size );
+    return;
+  }
+
   block_fs_aquire_wlock( block_fs );
   {
     block_fs_fwrite_file_unlocked( block_fs , filename , ptr , data_size );
@@ -1372,14 +2099,40 @@ void block_fs_fwrite_file(block_fs_type * block_fs , const char * filename , con
       block_fs_rotate__( block_fs );
 
   }
-  block_fs_release_rwlock( block_fs );
+  block_fs_release_wlock( block_fs );
+}
+
+
+/**
+   Writes several files with one acquisition of the write lock, and
+   with the fragmentation check done once after all the files have
+   been written; used when many small files are stored together.
+*/
+
+void block_fs_fwrite_buffers(block_fs_type * block_fs , int num_files , const char ** filenames , buffer_type ** buffers) {
+  if (block_fs->async_write) {
+    for (int i = 0; i < num_files; i++)
+      block_fs_enqueue_write( block_fs , filenames[i] , buffer_get_data( buffers[i] ) , buffer_get_size( buffers[i] ));
+    return;
+  }
+
+  block_fs_aquire_wlock( block_fs );
+  {
+    for (int i = 0; i < num_files; i++)
+      block_fs_fwrite_file_unlocked( block_fs , filenames[i] , buffer_get_data( buffers[i] ) , buffer_get_size( buffers[i] ));
+
+    if ((block_fs->free_size * 1.0 / block_fs->data_file_size) > block_fs->fragmentation_limit)
+      block_fs_rotate__( block_fs );
+  }
+  block_fs_release_wlock( block_fs );
 }
 
 
 void block_fs_defrag( block_fs_type * block_fs ) {
+  block_fs_flush( block_fs );
   block_fs_aquire_wlock( block_fs );
   block_fs_rotate__( block_fs );
-  block_fs_release_rwlock( block_fs );
+  block_fs_release_wlock( block_fs );
 }
 
 
@@ -1389,8 +2142,9 @@ void block_fs_fwrite_buffer(block_fs_type * block_fs , const char * filename , c
 
 
 /**
-   Need extra locking here - because the global rwlock allows many
-   concurrent readers.
+   The data is read with pread(), which does not use the file
+   position of data_fd; i.e. the many concurrent readers allowed by
+   the global rwlock do not need any further locking.
 */
 static void block_fs_fread__(block_fs_type * block_fs , const file_node_type * file_node , void * ptr , size_t read_bytes) {
 
@@ -1403,11 +2157,7 @@ static void block_fs_fread__(block_fs_type * block_fs , const file_node_type * f
 #endif
 
   {
-    pthread_mutex_lock( &block_fs->io_lock );
-    block_fs_fseek_node_data( block_fs , file_node );
-    util_fread( ptr , 1 , read_bytes , block_fs->data_stream , __func__);
-    //file_node_verify_end_tag( file_node , block_fs->data_stream );
-    pthread_mutex_unlock( &block_fs->io_lock );
+    util_pread( block_fs->data_fd , ptr , read_bytes , file_node->node_offset + file_node->data_offset , __func__);
   }
 }
 
@@ -1417,9 +2167,27 @@ static void block_fs_fread__(block_fs_type * block_fs , const file_node_type * f
 */
 
 void block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * filename , buffer_type * buffer) {
+  if (block_fs->async_write) {
+    bool pending_read = false;
+    pthread_mutex_lock( &block_fs->queue_lock );
+    {
+      const write_request_type * request = block_fs_get_pending__( block_fs , filename );
+      if (request != NULL) {
+        buffer_clear( buffer );
+        buffer_fwrite( buffer , request->data , 1 , request->data_size );
+        buffer_rewind( buffer );
+        pending_read = true;
+      }
+    }
+    pthread_mutex_unlock( &block_fs->queue_lock );
+    if (pending_read)
+      return;
+  }
+
   block_fs_aquire_rlock( block_fs );
   {
-    file_node_type * node = hash_get( block_fs->index , filename);
+    file_node_type mapped_node;
+    const file_node_type * node = block_fs_get_read_node( block_fs , filename , &mapped_node );
     
     buffer_clear( buffer );   /* Setting: content_size = 0; pos = 0;  */
     {
@@ -1437,11 +2205,7 @@ void block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * file
 #endif
 
       {
-        pthread_mutex_lock( &block_fs->io_lock );
-        block_fs_fseek_node_data(block_fs , node );
-        buffer_stream_fread( buffer , node->data_size , block_fs->data_stream );
-        //file_node_verify_end_tag( node , block_fs->data_stream );
-        pthread_mutex_unlock( &block_fs->io_lock );
+        buffer_fd_pread( buffer , node->data_size , block_fs->data_fd , node->node_offset + node->data_offset );
       }
       
     }
@@ -1453,6 +2217,58 @@ void block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * file
 
 
 
+/**
+   Reads several files with one acquisition of the read lock; the
+   counterpart to block_fs_fwrite_buffers(). The files which do not
+   exist are skipped, and have found[i] set to false - i.e. this also
+   replaces a block_fs_has_file() call for each file. The return value
+   is the number of files read.
+*/
+
+int block_fs_fread_buffers( block_fs_type * block_fs , int num_files , const char ** filenames , buffer_type ** buffers , bool * found) {
+  int num_read = 0;
+
+  for (int i = 0; i < num_files; i++)
+    found[i] = false;
+
+  if (block_fs->async_write) {
+    pthread_mutex_lock( &block_fs->queue_lock );
+    for (int i = 0; i < num_files; i++) {
+      const write_request_type * request = block_fs_get_pending__( block_fs , filenames[i] );
+      if (request != NULL) {
+        buffer_clear( buffers[i] );
+        buffer_fwrite( buffers[i] , request->data , 1 , request->data_size );
+        buffer_rewind( buffers[i] );
+        found[i] = true;
+        num_read++;
+      }
+    }
+    pthread_mutex_unlock( &block_fs->queue_lock );
+  }
+
+  block_fs_aquire_rlock( block_fs );
+  for (int i = 0; i < num_files; i++) {
+    if (!found[i] && block_fs_has_file__( block_fs , filenames[i] )) {
+      file_node_type mapped_node;
+      const file_node_type * node = block_fs_get_read_node( block_fs , filenames[i] , &mapped_node );
+
+      buffer_clear( buffers[i] );
+#ifdef ENABLE_CACHE
+      if (node->cache != NULL)
+        file_node_buffer_read_from_cache( node , buffers[i] );
+      else
+#endif
+        buffer_fd_pread( buffers[i] , node->data_size , block_fs->data_fd , node->node_offset + node->data_offset );
+      buffer_rewind( buffers[i] );
+
+      found[i] = true;
+      num_read++;
+    }
+  }
+  block_fs_release_rwlock( block_fs );
+
+  return num_read;
+}
 
 
 
@@ -1465,9 +2281,25 @@ void block_fs_fread_realloc_buffer( block_fs_type * block_fs , const char * file
 
 
 void block_fs_fread_file( block_fs_type * block_fs , const char * filename , void * ptr) {
+  if (block_fs->async_write) {
+    bool pending_read = false;
+    pthread_mutex_lock( &block_fs->queue_lock );
+    {
+      const write_request_type * request = block_fs_get_pending__( block_fs , filename );
+      if (request != NULL) {
+        memcpy( ptr , request->data , request->data_size );
+        pending_read = true;
+      }
+    }
+    pthread_mutex_unlock( &block_fs->queue_lock );
+    if (pending_read)
+      return;
+  }
+
   block_fs_aquire_rlock( block_fs );
   {
-    file_node_type * node = hash_get( block_fs->index , filename);
+    file_node_type mapped_node;
+    const file_node_type * node = block_fs_get_read_node( block_fs , filename , &mapped_node );
     block_fs_fread__( block_fs , node , ptr , node->data_size);
   }
   block_fs_release_rwlock( block_fs );
@@ -1476,10 +2308,23 @@ void block_fs_fread_file( block_fs_type * block_fs , const char * filename , voi
 
 
 int block_fs_get_filesize( block_fs_type * block_fs , const char * filename) {
-  int data_size;
+  int data_size = -1;
+  if (block_fs->async_write) {
+    pthread_mutex_lock( &block_fs->queue_lock );
+    {
+      const write_request_type * request = block_fs_get_pending__( block_fs , filename );
+      if (request != NULL)
+        data_size = request->data_size;
+    }
+    pthread_mutex_unlock( &block_fs->queue_lock );
+    if (data_size >= 0)
+      return data_size;
+  }
+
   block_fs_aquire_rlock( block_fs );
   {
-    file_node_type * node = hash_get( block_fs->index , filename );
+    file_node_type mapped_node;
+    const file_node_type * node = block_fs_get_read_node( block_fs , filename , &mapped_node );
     data_size = node->data_size;
   }
   block_fs_release_rwlock( block_fs );
@@ -1487,45 +2332,132 @@ int block_fs_get_filesize( block_fs_type * block_fs , const char * filename) {
 }
 
 
+static void index_table_insert( index_slot_type * table , long table_size , const char * key , int32_t key_offset , const file_node_type * file_node) {
+  long mask  = table_size - 1;
+  long islot = index_hash( key ) & mask;
+
+  while (table[islot].key_offset >= 0)
+    islot = (islot + 1) & mask;
+
+  table[islot].node_offset = file_node->node_offset;
+  table[islot].key_offset  = key_offset;
+  table[islot].node_size   = file_node->node_size;
+  table[islot].data_offset = file_node->data_offset;
+  table[islot].data_size   = file_node->data_size;
+}
+
+
+static int32_t index_strings_add( buffer_type * strings , const char * key ) {
+  int32_t key_offset = buffer_get_size( strings );
+  buffer_fwrite( strings , key , 1 , strlen( key ) + 1 );
+  return key_offset;
+}
+
+
+/*
+  Writes the index file, see the documentation at the top. The file
+  is written to a temporary file which is renamed to the index file,
+  i.e. an index file which is mmap()'ed is never modified. If no
+  file has been touched since the index file was loaded it is still
+  valid, and is not written again.
+*/
+
 static void block_fs_dump_index( block_fs_type * block_fs ) {
   if (block_fs->data_owner) {
     struct stat stat_buffer;
     int stat_return = stat(block_fs->data_file , &stat_buffer);
     if (stat_return != 0)
       return;
-    {
-      time_t data_mtime = stat_buffer.st_mtime;
-      FILE * index_stream = util_fopen( block_fs->index_file , "w");
-      util_fwrite_int( INDEX_MAGIC_INT , index_stream );
-      util_fwrite_int( INDEX_FORMAT_VERSION , index_stream );
-      util_fwrite_time_t( data_mtime , index_stream );
 
-      /* 1: Dumping the hash table of active nodes. */
+    if ((block_fs->index_data != NULL) &&
+        (hash_get_size( block_fs->index ) == 0) &&
+        (block_fs->index_unloaded == block_fs_index_header( block_fs )->num_files)) {
+      const index_header_type * header = block_fs_index_header( block_fs );
+      if ((header->data_mtime == stat_buffer.st_mtime) && (header->data_size == stat_buffer.st_size))
+        return;
+    }
+
+    {
+      index_header_type header;
+      buffer_type * strings = buffer_alloc( 1024 );
+      index_slot_type * table;
+
+      header.magic          = INDEX_MAGIC_INT;
+      header.version        = INDEX_FORMAT_VERSION;
+      header.data_mtime     = stat_buffer.st_mtime;
+      header.data_size      = stat_buffer.st_size;
+      header.data_file_size = block_fs->data_file_size;
+      header.num_files      = block_fs_get_num_files( block_fs );
+      header.num_free_nodes = block_fs->num_free_nodes;
+      header.table_size     = 16;
+      while (header.table_size < 2 * header.num_files)
+        header.table_size *= 2;
+
+      table = util_malloc( header.table_size * sizeof * table );
+      for (long islot = 0; islot < header.table_size; islot++)
+        table[islot].key_offset = -1;
+
+      /* 1: The files in the index hash table. */
       {
         hash_iter_type * index_iter = hash_iter_alloc( block_fs->index );
-        
-        util_fwrite_int( hash_get_size( block_fs->index ) , index_stream);
         while (!hash_iter_is_complete( index_iter )) {
           const char * key = hash_iter_get_next_key( index_iter );
           const file_node_type * file_node = hash_get( block_fs->index , key );
-          
-          util_fwrite_string( key , index_stream);
-          file_node_dump_index( file_node , index_stream );
+          index_table_insert( table , header.table_size , key , index_strings_add( strings , key ) , file_node );
         }
         hash_iter_free( index_iter );
       }
-      
-      /* 2: Dumping information about empty slots in the datafile. */
-      util_fwrite_int( block_fs->num_free_nodes , index_stream );
+
+      /* 2: The files which are still only in the old index file. */
+      if (block_fs->index_data != NULL) {
+        const index_slot_type * slots = block_fs_index_slots( block_fs );
+        const char * old_strings      = block_fs_index_strings( block_fs );
+
+        for (long islot = 0; islot < block_fs_index_header( block_fs )->table_size; islot++) {
+          if ((slots[islot].key_offset >= 0) && !block_fs->index_loaded[islot]) {
+            const char * key = &old_strings[ slots[islot].key_offset ];
+            file_node_type file_node;
+            file_node_init_from_slot( &file_node , NODE_IN_USE , &slots[islot] );
+            index_table_insert( table , header.table_size , key , index_strings_add( strings , key ) , &file_node );
+          }
+        }
+      }
+      header.string_size = buffer_get_size( strings );
+
       {
-        free_node_type * current = block_fs->free_nodes;
-        while ( current != NULL) {
-          file_node_dump_index( current->file_node , index_stream );
-          current = current->next;
+        char * tmp_file = util_alloc_sprintf( "%s.tmp" , block_fs->index_file );
+        FILE * index_stream = util_fopen( tmp_file , "w");
+
+        util_fwrite( &header , sizeof header , 1 , index_stream , __func__ );
+        util_fwrite( table , sizeof * table , header.table_size , index_stream , __func__ );
+
+        /* 3: The empty slots in the datafile. */
+        {
+          free_node_type * current = block_fs->free_nodes;
+          while ( current != NULL) {
+            index_slot_type free_slot;
+            free_slot.node_offset = current->file_node->node_offset;
+            free_slot.key_offset  = -1;
+            free_slot.node_size   = current->file_node->node_size;
+            free_slot.data_offset = 0;
+            free_slot.data_size   = 0;
+            util_fwrite( &free_slot , sizeof free_slot , 1 , index_stream , __func__ );
+            current = current->next;
+          }
         }
+
+        util_fwrite( buffer_get_data( strings ) , 1 , header.string_size , index_stream , __func__ );
+
+        /* The content must be on disk before the rename() makes it visible as the index file. */
+        fflush( index_stream );
+        fsync( fileno( index_stream ));
+        fclose( index_stream );
+        if (rename( tmp_file , block_fs->index_file ) != 0)
+          util_abort("%s: failed to rename %s -> %s: %s \n",__func__ , tmp_file , block_fs->index_file , strerror( errno ));
+        free( tmp_file );
       }
-      
-      fclose( index_stream );
+      free( table );
+      buffer_free( strings );
     }
   }
 }
@@ -1540,6 +2472,7 @@ static void block_fs_dump_index( block_fs_type * block_fs ) {
 */
 
 void block_fs_close( block_fs_type * block_fs , bool unlink_empty) {
+  block_fs_set_async_write( block_fs , false );
   block_fs_fsync( block_fs );
   
   if (block_fs->data_owner) 
@@ -1557,7 +2490,7 @@ void block_fs_close( block_fs_type * block_fs , bool unlink_empty) {
   }
 
   if (block_fs->data_owner) {
-    if ( unlink_empty && (hash_get_size( block_fs->index) == 0)) {
+    if ( unlink_empty && (block_fs_get_num_files( block_fs ) == 0)) {
       util_unlink_existing( block_fs->data_file );
       util_unlink_existing( block_fs->index_file );
       util_unlink_existing( block_fs->mount_file );
@@ -1573,8 +2506,14 @@ void block_fs_close( block_fs_type * block_fs , bool unlink_empty) {
   free( block_fs->mount_file );
   
   free_node_free_list( block_fs->free_nodes );
+  block_fs_free_index_data( block_fs );
   hash_free( block_fs->index );
+  hash_free( block_fs->pending );
+  vector_free( block_fs->write_queue );
   vector_free( block_fs->file_nodes );
+  pthread_mutex_destroy( &block_fs->queue_lock );
+  pthread_cond_destroy( &block_fs->queue_cond );
+  pthread_cond_destroy( &block_fs->flush_cond );
   free( block_fs );
 }
 
@@ -1597,6 +2536,7 @@ static void block_fs_rotate__( block_fs_type * block_fs ) {
      Write a updated mount map where the version info has been bumped
      up with one; the new_fs will mount based on this mount_file.
   */
+  block_fs_load_all_slots( block_fs );
   block_fs->version++;
   block_fs_fwrite_mount_info__( block_fs->mount_file , block_fs->version ); 
   {
@@ -1770,6 +2710,12 @@ vector_type * block_fs_alloc_filelist( block_fs_type * block_fs  , const char *
   vector_type    * sort_vector = vector_alloc_new();
 
   /* Inserting the nodes from the index. */
+  block_fs_flush( block_fs );
+  if (block_fs->index_data != NULL) {
+    block_fs_aquire_wlock( block_fs );
+    block_fs_load_all_slots( block_fs );
+    block_fs_release_wlock( block_fs );
+  }
   block_fs_aquire_rlock( block_fs );
   {
     hash_iter_type * iter        = hash_iter_alloc( block_fs->index );
@@ -715,6 +715,26 @@ void buffer_stream_fread( buffer_type * buffer , size_t byte_size , FILE * strea
 }
 
 
+#ifdef ERT_HAVE_UNISTD
+/**
+   As buffer_stream_fread(), but the data is read with util_pread()
+   from the absolute position @offset in the file @fd; the file
+   position of @fd is not changed.
+*/
+
+void buffer_fd_pread( buffer_type * buffer , size_t byte_size , int fd , long int offset) {
+  size_t min_size = byte_size + buffer->pos;
+  if (buffer->alloc_size < min_size)
+    buffer_resize__(buffer , min_size , true);
+
+  util_pread( fd , &buffer->data[buffer->pos] , byte_size , offset , __func__);
+
+  buffer->content_size += byte_size;
+  buffer->pos          += byte_size;
+}
+#endif
+
+
 
 
 /**
@@ -28,6 +28,9 @@
 #include <ert/util/matrix.h>
 #include <ert/util/arg_pack.h>
 #include <ert/util/rng.h>
+#ifdef ERT_HAVE_LAPACK
+#include <ert/util/matrix_blas.h>
+#endif
 
 /**
    This is V E R Y  S I M P L E matrix implementation. It is not
@@ -1070,33 +1073,165 @@ matrix_type * matrix_alloc_transpose( const matrix_type * A) {
 */
 
 
+/*
+  The in place multiplication A = A*B is done in panels of rows: a
+  panel of rows from A is multiplied with B into a scratch panel,
+  which is then copied back into A. The panel size is chosen so that
+  the panel of A and the scratch panel together stay within the cache.
+*/
+
+#define MATRIX_MATMUL_PANEL_BYTES  (512 * 1024)
+#define MATRIX_MATMUL_MIN_PANEL_ROWS 16
+
+
+static int matrix_matmul_panel_rows( int columns ) {
+  return util_int_max( MATRIX_MATMUL_MIN_PANEL_ROWS , MATRIX_MATMUL_PANEL_BYTES / (2 * sizeof(double) * util_int_max( columns , 1 )));
+}
+
+
+/*
+  C = A*B for a panel without BLAS; the innermost loop runs down the
+  columns of A and C, which is contiguous memory in the normal column
+  major layout and lets the compiler vectorize the loop.
+*/
+
+static void matrix_matmul_panel__( matrix_type * C , const matrix_type * A , const matrix_type * B ) {
+  const int rows = C->rows;
+  int i,j,k;
+
+  for (j = 0; j < C->columns; j++) {
+    double * c = &C->data[ GET_INDEX(C , 0 , j) ];
+
+    for (i = 0; i < rows; i++)
+      c[ i * C->row_stride ] = 0;
+
+    for (k = 0; k < A->columns; k++) {
+      const double   b = B->data[ GET_INDEX(B , k , j) ];
+      const double * a = &A->data[ GET_INDEX(A , 0 , k) ];
+
+      if ((A->row_stride == 1) && (C->row_stride == 1)) {
+        for (i = 0; i < rows; i++)
+          c[i] += a[i] * b;
+      } else {
+        for (i = 0; i < rows; i++)
+          c[ i * C->row_stride ] += a[ i * A->row_stride ] * b;
+      }
+    }
+  }
+}
+
+
+static void matrix_inplace_matmul_panel( matrix_type * A_panel , const matrix_type * B , matrix_type * tmp_panel) {
+#ifdef ERT_HAVE_LAPACK
+  if ((A_panel->row_stride == 1) && (B->row_stride == 1))
+    matrix_dgemm( tmp_panel , A_panel , B , false , false , 1 , 0 );
+  else
+    matrix_matmul_panel__( tmp_panel , A_panel , B );
+#else
+  matrix_matmul_panel__( tmp_panel , A_panel , B );
+#endif
+  matrix_assign( A_panel , tmp_panel );
+}
+
+
 void matrix_inplace_matmul(matrix_type * A, const matrix_type * B) {
   if ((A->columns == B->rows) && (B->rows == B->columns)) {
-    double * tmp = util_malloc( sizeof * A->data * A->columns );
-    int i,j,k;
-
-    for (i=0; i < A->rows; i++) {
+    if (A->rows > 0) {
+      const int panel_rows = util_int_min( matrix_matmul_panel_rows( A->columns ) , A->rows );
+      matrix_type * tmp    = matrix_alloc( panel_rows , A->columns );
+      int row_offset;
 
-      /* Clearing the tmp vector */
-      for (k=0; k < B->rows; k++)
-        tmp[k] = 0;
+      for (row_offset = 0; row_offset < A->rows; row_offset += panel_rows) {
+        const int rows = util_int_min( panel_rows , A->rows - row_offset );
+        matrix_type * A_panel   = matrix_alloc_shared( A , row_offset , 0 , rows , A->columns );
+        matrix_type * tmp_panel = matrix_alloc_shared( tmp , 0 , 0 , rows , A->columns );
 
-      for (j=0; j < B->rows; j++) {
-        double scalar_product = 0;
-        for (k=0; k < A->columns; k++)
-          scalar_product += A->data[ GET_INDEX(A,i,k) ] * B->data[ GET_INDEX(B,k,j) ];
+        matrix_inplace_matmul_panel( A_panel , B , tmp_panel );
 
-        /* Assign first to tmp[j] */
-        tmp[j] = scalar_product;
+        matrix_free( tmp_panel );
+        matrix_free( A_panel );
       }
-      for (j=0; j < A->columns; j++)
-        A->data[ GET_INDEX(A , i, j) ] = tmp[j];
+      matrix_free( tmp );
     }
-    free(tmp);
   } else
     util_abort("%s: size mismatch: A:[%d,%d]   B:[%d,%d]\n",__func__ , matrix_get_rows(A) , matrix_get_columns(A) , matrix_get_rows(B) , matrix_get_columns(B));
 }
 
+
+#ifndef ERT_HAVE_LAPACK
+/*
+  C = A*B for a float panel without BLAS, with the same loop order as
+  matrix_matmul_panel__().
+*/
+
+static void matrix_matmul_float_panel__( float * C , int ldc , const float * A , int lda , const float * B , int rows , int columns) {
+  int i,j,k;
+
+  for (j = 0; j < columns; j++) {
+    float * c = &C[ (size_t) j * ldc ];
+
+    for (i = 0; i < rows; i++)
+      c[i] = 0;
+
+    for (k = 0; k < columns; k++) {
+      const float   b = B[ k + j * columns ];
+      const float * a = &A[ (size_t) k * lda ];
+
+      for (i = 0; i < rows; i++)
+        c[i] += a[i] * b;
+    }
+  }
+}
+#endif
+
+
+/**
+   A = A*B where A is a plain column major float array with @rows rows
+   and leading dimension @lda, and B is a normal (double) square
+   matrix. B is converted to float, and the product is evaluated in
+   single precision panel by panel as in matrix_inplace_matmul(), with
+   sgemm() when BLAS is available. This is used when the A matrix of
+   the update is stored in single precision, the update matrix B is
+   calculated in double precision.
+*/
+
+void matrix_inplace_matmul_float( float * A , int rows , int lda , const matrix_type * B ) {
+  const int columns = B->rows;
+
+  if (B->rows != B->columns)
+    util_abort("%s: B must be square: B:[%d,%d]\n",__func__ , B->rows , B->columns);
+
+  if (lda < rows)
+    util_abort("%s: invalid leading dimension:%d for %d rows\n",__func__ , lda , rows);
+
+  if ((rows > 0) && (columns > 0)) {
+    const int panel_rows = util_int_min( 2 * matrix_matmul_panel_rows( columns ) , rows );
+    float * B_float = util_calloc( columns * columns , sizeof * B_float );
+    float * tmp     = util_calloc( (size_t) panel_rows * columns , sizeof * tmp );
+    int row_offset;
+    int i,j;
+
+    for (j = 0; j < columns; j++)
+      for (i = 0; i < columns; i++)
+        B_float[ i + j * columns ] = B->data[ GET_INDEX( B , i , j ) ];
+
+    for (row_offset = 0; row_offset < rows; row_offset += panel_rows) {
+      const int prows = util_int_min( panel_rows , rows - row_offset );
+
+#ifdef ERT_HAVE_LAPACK
+      matrix_sgemm_data( prows , columns , columns , &A[row_offset] , lda , B_float , columns , tmp , panel_rows );
+#else
+      matrix_matmul_float_panel__( tmp , panel_rows , &A[row_offset] , lda , B_float , prows , columns );
+#endif
+      for (j = 0; j < columns; j++)
+        memcpy( &A[ row_offset + (size_t) j * lda ] , &tmp[ (size_t) j * panel_rows ] , prows * sizeof * tmp );
+    }
+
+    free( tmp );
+    free( B_float );
+  }
+}
+
 /*****************************************************************/
 /* If the current build has a thread_pool implementation enabled a
    proper matrix_implace_matmul_mt() function will be built, otherwise
@@ -1132,6 +1267,9 @@ static void * matrix_inplace_matmul_mt__(void * arg) {
 
    If the thread_pool has not been correctly prepared, according to
    this specification, it will be crash and burn.
+
+   Each thread multiplies its own range of rows with the panel blocked
+   matrix_inplace_matmul(), i.e. with its own scratch panel.
 */
 
 void matrix_inplace_matmul_mt2(matrix_type * A, const matrix_type * B , thread_pool_type * thread_pool){
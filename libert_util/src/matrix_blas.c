@@ -29,6 +29,7 @@ extern "C" {
 /*****************************************************************/
 void  dgemm_(char * , char * , int * , int * , int * , double * , double * , int * , double * , int *  , double * , double * , int *);
 void  dgemv_(char * , int * , int * , double * , double * , int * , const double * , int * , double * , double * , int * );
+void  sgemm_(char * , char * , int * , int * , int * , float * , const float * , int * , const float * , int *  , float * , float * , int *);
 /*****************************************************************/
 
 
@@ -221,6 +222,25 @@ void matrix_matmul(matrix_type * C, const matrix_type * A , const matrix_type *
 }
 
 
+/**
+   C = A*B for plain column major single precision arrays, where A is
+   [m x k], B is [k x n] and C is [m x n] with leading dimensions lda,
+   ldb and ldc. There is no float matrix type; this is used for the
+   float storage of the A matrix in the update.
+*/
+
+void matrix_sgemm_data( int m , int n , int k , const float * A , int lda , const float * B , int ldb , float * C , int ldc) {
+  char  trans = 'N';
+  float alpha = 1;
+  float beta  = 0;
+
+  if ((lda < util_int_max(1 , m)) || (ldb < util_int_max(1 , k)) || (ldc < util_int_max(1 , m)))
+    util_abort("%s: invalid leading dimension lda:%d ldb:%d ldc:%d for m:%d k:%d\n",__func__ , lda , ldb , ldc , m , k);
+
+  sgemm_(&trans , &trans , &m , &n , &k , &alpha , A , &lda , B , &ldb , &beta , C , &ldc);
+}
+
+
 /**
    Allocates new matrix C = AB
 */
@@ -21,6 +21,12 @@
 #include <string.h>
 #include <math.h>
 
+#include "ert/util/build_config.h"
+
+#ifdef HAVE_GETTIMEOFDAY
+#include <sys/time.h>
+#endif
+
 #include <ert/util/util.h>
 #include <ert/util/timer.h>
 
@@ -32,7 +38,7 @@ struct timer_struct {
   size_t   count;
 
   clock_t  clock_start;
-  time_t   epoch_start;
+  double   epoch_start;
   double   sum1 , sum2;
   double   min_time , max_time;
   bool     running , epoch_time;
@@ -40,6 +46,22 @@ struct timer_struct {
 
 
 
+/*
+  Wall clock time in seconds; with subsecond resolution if
+  gettimeofday() is available.
+*/
+
+static double timer_epoch_time( ) {
+#ifdef HAVE_GETTIMEOFDAY
+  struct timeval tv;
+  gettimeofday( &tv , NULL );
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+#else
+  return 1.0 * time( NULL );
+#endif
+}
+
+
 timer_type * timer_alloc(bool epoch_time) {
   timer_type *timer;
   timer       = util_malloc(sizeof * timer );
@@ -61,7 +83,7 @@ void timer_start(timer_type *timer) {
   timer->running    = true;
 
   if (timer->epoch_time)
-    time( &timer->epoch_start );
+    timer->epoch_start = timer_epoch_time( );
   else
     timer->clock_start = clock();
   
@@ -69,14 +91,13 @@ void timer_start(timer_type *timer) {
 
 
 double timer_stop(timer_type *timer) {
-  time_t  epoch_time;
+  double  epoch_time = timer_epoch_time( );
   clock_t clock_time = clock();
   
-  time(&epoch_time);
   if (timer->running) {
     double cpu_sec;
     if (timer->epoch_time)
-      cpu_sec = 1.0 * (epoch_time - timer->epoch_start);
+      cpu_sec = epoch_time - timer->epoch_start;
     else
       cpu_sec = 1.0 * (clock_time - timer->clock_start) / CLOCKS_PER_SEC;
     
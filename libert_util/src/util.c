@@ -75,6 +75,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef ERT_HAVE_UNISTD
+#include <unistd.h>
+#endif
+
 #ifdef HAVE_PTHREAD
 #include <pthread.h>
 #endif
@@ -83,6 +87,10 @@
 #include <execinfo.h>
 #endif
 
+#ifdef HAVE_SYSCONF
+#include <unistd.h>
+#endif
+
 #ifdef HAVE_FTRUNCATE
 #include <unistd.h>
 #include <sys/types.h>
@@ -140,7 +148,7 @@
 
 
 static uint16_t util_endian_convert16( uint16_t u ) {
-  return (( u >> 8U ) & 0xFFU) | (( u & 0xFFU) >> 8U);
+  return (( u >> 8U ) & 0xFFU) | (( u & 0xFFU) << 8U);
 }
 
 
@@ -179,6 +187,88 @@ static uint64_t util_endian_convert32_64( uint64_t u ) {
 
 
 
+/*
+   Vectorized versions of the 32 and 64 bit endian flip. The SSE2
+   versions are used on all x86 builds, whereas the AVX2 versions are
+   compiled with a target attribute and only selected at runtime if
+   the cpu supports AVX2; i.e. no special compiler flags are needed.
+
+   The functions flip the largest prefix of the vector which fills
+   complete registers, and return the number of elements flipped; the
+   remaining tail must be flipped by the scalar code.
+*/
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define UTIL_ENDIAN_SSE2
+
+static int util_endian_flip_sse2( void * data , int element_size , int elements) {
+  char * ptr = data;
+  int elements_per_register = sizeof(__m128i) / element_size;
+  int i;
+
+  for (i = 0; i + elements_per_register <= elements; i += elements_per_register) {
+    __m128i * reg_ptr = (__m128i *) &ptr[i * element_size];
+    __m128i v = _mm_loadu_si128( reg_ptr );
+
+    if (element_size == 4) {
+      v = _mm_shufflelo_epi16( v , _MM_SHUFFLE(2,3,0,1));
+      v = _mm_shufflehi_epi16( v , _MM_SHUFFLE(2,3,0,1));
+    } else {
+      v = _mm_shufflelo_epi16( v , _MM_SHUFFLE(0,1,2,3));
+      v = _mm_shufflehi_epi16( v , _MM_SHUFFLE(0,1,2,3));
+    }
+    v = _mm_or_si128( _mm_slli_epi16( v , 8 ) , _mm_srli_epi16( v , 8 ));
+    _mm_storeu_si128( reg_ptr , v );
+  }
+  return i;
+}
+#endif
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define UTIL_ENDIAN_AVX2
+
+__attribute__((target("avx2")))
+static int util_endian_flip_avx2( void * data , int element_size , int elements) {
+  char * ptr = data;
+  int elements_per_register = sizeof(__m256i) / element_size;
+  __m256i mask;
+  int i;
+
+  if (element_size == 4)
+    mask = _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11,10, 9, 8,15,14,13,12,
+                             3, 2, 1, 0, 7, 6, 5, 4, 11,10, 9, 8,15,14,13,12);
+  else
+    mask = _mm256_setr_epi8( 7, 6, 5, 4, 3, 2, 1, 0, 15,14,13,12,11,10, 9, 8,
+                             7, 6, 5, 4, 3, 2, 1, 0, 15,14,13,12,11,10, 9, 8);
+
+  for (i = 0; i + elements_per_register <= elements; i += elements_per_register) {
+    __m256i * reg_ptr = (__m256i *) &ptr[i * element_size];
+    __m256i v = _mm256_loadu_si256( reg_ptr );
+    _mm256_storeu_si256( reg_ptr , _mm256_shuffle_epi8( v , mask ));
+  }
+  return i;
+}
+#endif
+
+
+static int util_endian_flip_simd( void * data , int element_size , int elements) {
+#ifdef UTIL_ENDIAN_AVX2
+  if (__builtin_cpu_supports("avx2"))
+    return util_endian_flip_avx2( data , element_size , elements );
+#endif
+
+#ifdef UTIL_ENDIAN_SSE2
+  return util_endian_flip_sse2( data , element_size , elements );
+#else
+  return 0;
+#endif
+}
+
+
+
 void util_endian_flip_vector(void *data, int element_size , int elements) {
   int i;
   switch (element_size) {
@@ -194,29 +284,29 @@ void util_endian_flip_vector(void *data, int element_size , int elements) {
     }
   case(4):
     {
+      uint32_t *tmp32 = (uint32_t *) data;
+      int offset = util_endian_flip_simd( data , element_size , elements );
 #ifdef ARCH64
       /*
-        In the case of a 64 bit CPU the fastest way to swap 32 bit
-        variables will be by swapping two elements in one operation;
-        this is provided by the util_endian_convert32_64() function. In the case
-        of binary ECLIPSE files this case is quite common, and
-        therefor worth supporting as a special case.
+        In the case of a 64 bit CPU the fastest scalar way to swap 32
+        bit variables will be by swapping two elements in one
+        operation; this is provided by the util_endian_convert32_64()
+        function. In the case of binary ECLIPSE files this case is
+        quite common, and therefor worth supporting as a special case.
       */
-      uint64_t *tmp64 = (uint64_t *) data;
+      uint64_t *tmp64 = (uint64_t *) &tmp32[offset];
+      int remaining = elements - offset;
 
-      for (i = 0; i <elements/2; i++)
+      for (i = 0; i < remaining/2; i++)
         tmp64[i] = util_endian_convert32_64(tmp64[i]);
 
-      if ( elements & 1 ) {
+      if ( remaining & 1 ) {
         // Odd number of elements - flip the last element as an ordinary 32 bit swap.
-        uint32_t *tmp32 = (uint32_t *) data;
         tmp32[ elements - 1] = util_endian_convert32( tmp32[elements - 1] );
       }
       break;
 #else
-      uint32_t *tmp32 = (uint32_t *) data;
-
-      for (i = 0; i <elements; i++)
+      for (i = offset; i <elements; i++)
         tmp32[i] = util_endian_convert32(tmp32[i]);
 
       break;
@@ -226,7 +316,7 @@ void util_endian_flip_vector(void *data, int element_size , int elements) {
     {
       uint64_t *tmp64 = (uint64_t *) data;
 
-      for (i = 0; i <elements; i++)
+      for (i = util_endian_flip_simd( data , element_size , elements ); i <elements; i++)
         tmp64[i] = util_endian_convert64(tmp64[i]);
       break;
     }
@@ -775,6 +865,196 @@ void util_yield() {
 #endif
 }
 
+/*
+  Returns the number of cpus, rounded upwards, corresponding to the
+  CFS quota set in the cgroup directory @path; the quota is read from
+  'cpu.max' for cgroup v2 and from 'cpu.cfs_quota_us' and
+  'cpu.cfs_period_us' for cgroup v1. Returns -1 if there is no quota.
+*/
+
+static int util_get_cgroup_dir_cpu_quota( const char * path , bool v2 ) {
+  long quota  = -1;
+  long period = -1;
+
+  if (v2) {
+    char * filename = util_alloc_filename( path , "cpu.max" , NULL );
+    FILE * stream = fopen( filename , "r" );
+    if (stream) {
+      char quota_string[32];
+      if (fscanf( stream , "%31s %ld" , quota_string , &period ) == 2) {
+        int int_quota;
+        if (util_sscanf_int( quota_string , &int_quota ))
+          quota = int_quota;   /* The string 'max' => no quota. */
+      }
+      fclose( stream );
+    }
+    free( filename );
+  } else {
+    char * quota_file  = util_alloc_filename( path , "cpu.cfs_quota_us" , NULL );
+    char * period_file = util_alloc_filename( path , "cpu.cfs_period_us" , NULL );
+    FILE * stream = fopen( quota_file , "r" );
+    if (stream) {
+      if (fscanf( stream , "%ld" , &quota ) != 1)
+        quota = -1;
+      fclose( stream );
+    }
+
+    stream = fopen( period_file , "r" );
+    if (stream) {
+      if (fscanf( stream , "%ld" , &period ) != 1)
+        period = -1;
+      fclose( stream );
+    }
+    free( period_file );
+    free( quota_file );
+  }
+
+  if ((quota > 0) && (period > 0))
+    return (quota + period - 1) / period;
+  else
+    return -1;
+}
+
+
+/*
+  Finds the cgroup of the current process in @cgroup_file, normally
+  '/proc/self/cgroup', where each line is 'id:controllers:path'. The
+  cgroup v1 hierarchy with the 'cpu' controller is used if there is
+  one, otherwise the cgroup v2 hierarchy, i.e. the line with id 0 and
+  no controllers. Returns NULL if no cgroup is found.
+*/
+
+static char * util_alloc_cgroup_path( const char * cgroup_file , bool * v2 ) {
+  char * cgroup_path = NULL;
+  FILE * stream = fopen( cgroup_file , "r" );
+
+  if (stream) {
+    char line[4096];
+    while (fgets( line , sizeof line , stream )) {
+      char * controllers = strchr( line , ':' );
+      char * path = controllers ? strchr( controllers + 1 , ':' ) : NULL;
+
+      if (path) {
+        *controllers++ = '\0';
+        *path++ = '\0';
+        path[ strcspn( path , "\n" ) ] = '\0';
+
+        if ((controllers[0] == '\0') && (strcmp( line , "0" ) == 0)) {
+          if (cgroup_path == NULL) {
+            cgroup_path = util_alloc_string_copy( path );
+            *v2 = true;
+          }
+        } else {
+          char * controller_list = util_alloc_sprintf( ",%s," , controllers );
+          bool cpu_controller = (strstr( controller_list , ",cpu," ) != NULL);
+
+          free( controller_list );
+          if (cpu_controller) {
+            free( cgroup_path );
+            cgroup_path = util_alloc_string_copy( path );
+            *v2 = false;
+            break;
+          }
+        }
+      }
+    }
+    fclose( stream );
+  }
+  return cgroup_path;
+}
+
+
+/**
+   Will look for a CFS cpu quota for the cgroup of the current
+   process. The cgroup is found in @cgroup_file, normally
+   '/proc/self/cgroup', and the cgroup filesystem is mounted at
+   @cgroup_root, normally '/sys/fs/cgroup'; the v1 cpu hierarchy is
+   assumed to be mounted at @cgroup_root/cpu.
+
+   The quota of the cgroup and of all its parents up to the root of
+   the hierarchy apply, and the smallest is used. When the process
+   runs in a cgroup namespace, e.g. in a container, the path in
+   @cgroup_file need not exist below @cgroup_root; the parents which
+   do exist, and finally the root which is then the cgroup of the
+   container, are still checked. Without @cgroup_file only the root
+   is checked.
+
+   If a quota is found the number of cpus it corresponds to, rounded
+   upwards, is returned; otherwise the function will return -1.
+*/
+
+int util_get_cgroup_cpu_quota( const char * cgroup_file , const char * cgroup_root ) {
+  int num_cpu = -1;
+  bool v2 = true;
+  char * cgroup_path = util_alloc_cgroup_path( cgroup_file , &v2 );
+  char * root;
+  char * path;
+
+  if (cgroup_path == NULL) {
+    char * cpu_max = util_alloc_filename( cgroup_root , "cpu.max" , NULL );
+    v2 = util_file_exists( cpu_max );
+    free( cpu_max );
+  }
+
+  root = v2 ? util_alloc_string_copy( cgroup_root ) : util_alloc_filename( cgroup_root , "cpu" , NULL );
+  path = util_alloc_sprintf( "%s%s" , root , cgroup_path ? cgroup_path : "" );
+  {
+    size_t root_length = strlen( root );
+    while (true) {
+      int dir_cpu;
+      size_t length = strlen( path );
+
+      while ((length > root_length) && (path[length - 1] == '/'))
+        path[--length] = '\0';
+
+      dir_cpu = util_get_cgroup_dir_cpu_quota( path , v2 );
+      if ((dir_cpu > 0) && ((num_cpu < 0) || (dir_cpu < num_cpu)))
+        num_cpu = dir_cpu;
+
+      if (length <= root_length)
+        break;
+      {
+        char * sep = strrchr( &path[root_length] , '/' );
+        if (sep)
+          *sep = '\0';
+        else
+          path[root_length] = '\0';
+      }
+    }
+  }
+
+  free( path );
+  free( root );
+  free( cgroup_path );
+  return num_cpu;
+}
+
+
+/**
+   Returns the number of cpus available for the current process; that
+   is the number of online processors limited by the cgroup cpu quota
+   if the process runs in a cgroup with a quota (e.g. in a container
+   or under a batch system). The return value is always >= 1.
+*/
+
+int util_get_num_cpu( ) {
+  int num_cpu = 1;
+#ifdef HAVE_SYSCONF
+  {
+    long online = sysconf( _SC_NPROCESSORS_ONLN );
+    if (online > 0)
+      num_cpu = online;
+  }
+#endif
+  {
+    int quota_cpu = util_get_cgroup_cpu_quota( "/proc/self/cgroup" , "/sys/fs/cgroup" );
+    if ((quota_cpu > 0) && (quota_cpu < num_cpu))
+      num_cpu = quota_cpu;
+  }
+  return num_cpu;
+}
+
+
 /**
    This function will allocate and read a line from stdin. If there is
    no input waiting on stdin (this typically only applies if stdin is
@@ -4601,6 +4881,31 @@ void util_fread(void *ptr , size_t element_size , size_t items, FILE * stream ,
 }
 
 
+#ifdef ERT_HAVE_UNISTD
+/*
+  Reads @byte_size bytes starting at the absolute position @offset in
+  the file @fd. The file position of @fd is neither used nor updated,
+  i.e. several threads can read from the same file descriptor
+  concurrently without any locking.
+*/
+
+void util_pread(int fd , void * ptr , size_t byte_size , long int offset , const char * caller) {
+  char * data = ptr;
+  size_t bytes_read = 0;
+
+  while (bytes_read < byte_size) {
+    ssize_t read_size = pread( fd , &data[bytes_read] , byte_size - bytes_read , offset + bytes_read );
+    if (read_size > 0)
+      bytes_read += read_size;
+    else if ((read_size < 0) && (errno == EINTR))
+      continue;
+    else
+      util_abort("%s/%s: only read %zu/%zu bytes from disk - aborting.\n %s(%d) \n",caller , __func__ , bytes_read , byte_size , strerror(errno) , errno);
+  }
+}
+#endif
+
+
 
 void util_fread_from_buffer(void * ptr , size_t element_size , size_t items , char ** buffer) {
   int bytes = element_size * items;
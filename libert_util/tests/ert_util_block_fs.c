@@ -17,13 +17,19 @@
 */
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/block_fs.h>
+#include <ert/util/util.h>
 #include <ert/util/test_util.h>
 #include <ert/util/test_work_area.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
 
 void test_assert_util_abort(const char * function_name , void call_func (void *) , void * arg);
 
@@ -102,8 +108,371 @@ void test_lock_conflict() {
 
 
 
+/*
+  Writes a batch of files, where one of them already exists with a
+  smaller size, and reads them back after the filesystem has been
+  remounted.
+*/
+
+void test_fwrite_buffers() {
+  const int num_files = 100;
+  test_work_area_type * work_area = test_work_area_alloc("block_fs/fwrite_buffers");
+  char ** filenames = util_calloc( num_files , sizeof * filenames );
+  buffer_type ** buffers = util_calloc( num_files , sizeof * buffers );
+
+  for (int i = 0; i < num_files; i++) {
+    filenames[i] = util_alloc_sprintf( "FILE.%d" , i );
+    buffers[i] = buffer_alloc( 100 );
+    for (int j = 0; j <= i; j++)
+      buffer_fwrite_int( buffers[i] , i * 1000 + j );
+  }
+
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 1000 , 10000 , 0.67 , 10 , true , false , false );
+    block_fs_fwrite_file( bfs , filenames[50] , "XX" , 2 );
+    block_fs_fwrite_buffers( bfs , num_files , (const char **) filenames , buffers );
+    block_fs_close( bfs , false );
+  }
+
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 1000 , 10000 , 0.67 , 10 , true , false , false );
+    buffer_type * buffer = buffer_alloc( 100 );
+    for (int i = 0; i < num_files; i++) {
+      test_assert_true( block_fs_has_file( bfs , filenames[i] ));
+      block_fs_fread_realloc_buffer( bfs , filenames[i] , buffer );
+      test_assert_int_equal( buffer_get_size( buffer ) , buffer_get_size( buffers[i] ));
+      for (int j = 0; j <= i; j++)
+        test_assert_int_equal( buffer_fread_int( buffer ) , i * 1000 + j );
+    }
+    buffer_free( buffer );
+    block_fs_close( bfs , false );
+  }
+
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 1000 , 10000 , 0.67 , 10 , true , false , false );
+    const char ** read_names = util_calloc( num_files + 1 , sizeof * read_names );
+    buffer_type ** read_buffers = util_calloc( num_files + 1 , sizeof * read_buffers );
+    bool * found = util_calloc( num_files + 1 , sizeof * found );
+
+    for (int i = 0; i < num_files; i++) {
+      read_names[i] = filenames[i];
+      read_buffers[i] = buffer_alloc( 100 );
+    }
+    read_names[num_files] = "MISSING";
+    read_buffers[num_files] = buffer_alloc( 100 );
+
+    test_assert_int_equal( block_fs_fread_buffers( bfs , num_files + 1 , read_names , read_buffers , found ) , num_files );
+    test_assert_false( found[num_files] );
+    for (int i = 0; i < num_files; i++) {
+      test_assert_true( found[i] );
+      test_assert_int_equal( buffer_get_size( read_buffers[i] ) , buffer_get_size( buffers[i] ));
+      for (int j = 0; j <= i; j++)
+        test_assert_int_equal( buffer_fread_int( read_buffers[i] ) , i * 1000 + j );
+    }
+
+    for (int i = 0; i <= num_files; i++)
+      buffer_free( read_buffers[i] );
+    free( read_buffers );
+    free( read_names );
+    free( found );
+    block_fs_close( bfs , false );
+  }
+
+  for (int i = 0; i < num_files; i++)
+    buffer_free( buffers[i] );
+  free( buffers );
+  util_free_stringlist( filenames , num_files );
+  test_work_area_free( work_area );
+}
+
+
+#define NUM_INDEX_FILES 1000
+
+static void write_index_file( block_fs_type * bfs , const char * filename , int value , int size) {
+  int * data = util_calloc( size , sizeof * data );
+  for (int i = 0; i < size; i++)
+    data[i] = value + i;
+  block_fs_fwrite_file( bfs , filename , data , size * sizeof * data );
+  free( data );
+}
+
+
+static void check_index_file( block_fs_type * bfs , const char * filename , int value , int size) {
+  int * data = util_calloc( size , sizeof * data );
+  test_assert_true( block_fs_has_file( bfs , filename ));
+  test_assert_int_equal( block_fs_get_filesize( bfs , filename ) , size * sizeof * data );
+  block_fs_fread_file( bfs , filename , data );
+  for (int i = 0; i < size; i++)
+    test_assert_int_equal( data[i] , value + i );
+  free( data );
+}
+
+
+static void check_index_files( block_fs_type * bfs ) {
+  for (int ifile = 0; ifile < NUM_INDEX_FILES; ifile++) {
+    char * filename = util_alloc_sprintf( "FILE.%d" , ifile );
+    if (ifile == 3)
+      check_index_file( bfs , filename , 77 , 100 );
+    else if (ifile == 5)
+      test_assert_false( block_fs_has_file( bfs , filename ));
+    else
+      check_index_file( bfs , filename , ifile , 1 + ifile % 10 );
+    free( filename );
+  }
+  check_index_file( bfs , "NEW.0" , 99 , 3 );
+  test_assert_false( block_fs_has_file( bfs , "NEW.1" ));
+}
+
+
+/*
+  The files of a filesystem mounted from the index file are only
+  loaded from the index file when they are modified; check that
+  modifications survive a new round trip through the index file,
+  and that an index file which does not match the data file is
+  ignored.
+*/
+
+void test_index() {
+  test_work_area_type * work_area = test_work_area_alloc("block_fs/index");
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 16 , 10000 , 1.0 , 10 , false , false , false );
+    for (int ifile = 0; ifile < NUM_INDEX_FILES; ifile++) {
+      char * filename = util_alloc_sprintf( "FILE.%d" , ifile );
+      write_index_file( bfs , filename , ifile , 1 + ifile % 10 );
+      free( filename );
+    }
+    block_fs_close( bfs , false );
+  }
+  test_assert_true( util_file_exists( "test.index" ));
+
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 16 , 10000 , 1.0 , 10 , false , false , false );
+    check_index_file( bfs , "FILE.3" , 3 , 4 );
+    write_index_file( bfs , "FILE.3" , 77 , 100 );
+    block_fs_unlink_file( bfs , "FILE.5" );
+    write_index_file( bfs , "NEW.0" , 99 , 3 );
+    check_index_files( bfs );
+    block_fs_close( bfs , false );
+  }
+
+  /* Mount and close without modifications. */
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 16 , 10000 , 1.0 , 10 , false , false , false );
+    check_index_files( bfs );
+    block_fs_close( bfs , false );
+  }
+
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 16 , 10000 , 1.0 , 10 , false , false , false );
+    vector_type * files = block_fs_alloc_filelist( bfs , NULL , NO_SORT , false );
+    test_assert_int_equal( vector_get_size( files ) , NUM_INDEX_FILES );
+    vector_free( files );
+    check_index_files( bfs );
+    block_fs_close( bfs , false );
+  }
+
+  /* A truncated index file must be ignored, and the index built from the data file. */
+  {
+    size_t index_size = util_file_size( "test.index" );
+    FILE * stream = util_fopen( "test.index" , "r+");
+    test_assert_int_equal( ftruncate( fileno( stream ) , index_size / 2 ) , 0 );
+    fclose( stream );
+  }
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 16 , 10000 , 1.0 , 10 , false , false , false );
+    check_index_files( bfs );
+    block_fs_close( bfs , false );
+  }
+
+  /*
+    An index file with the right size, but garbage in the hash table
+    following the 72 byte header, must also be ignored.
+  */
+  {
+    char garbage[4096];
+    FILE * stream = util_fopen( "test.index" , "r+");
+    memset( garbage , 0x7F , sizeof garbage );
+    fseek( stream , 72 , SEEK_SET );
+    util_fwrite( garbage , 1 , sizeof garbage , stream , __func__ );
+    fclose( stream );
+  }
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 16 , 10000 , 1.0 , 10 , false , false , false );
+    check_index_files( bfs );
+    block_fs_close( bfs , false );
+  }
+  test_work_area_free( work_area );
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+#define NUM_READ_FILES  200
+#define NUM_READERS       4
+
+typedef struct {
+  block_fs_type * bfs;
+  int             offset;
+} read_arg_type;
+
+
+static void fill_buffer( buffer_type * buffer , int ifile , int shift ) {
+  buffer_clear( buffer );
+  for (int j = 0; j <= ifile; j++)
+    buffer_fwrite_int( buffer , ifile * 1000 + j + shift);
+}
+
+
+static void check_file( block_fs_type * bfs , buffer_type * buffer , const char * prefix , int ifile , int shift ) {
+  char * filename = util_alloc_sprintf( "%s.%d" , prefix , ifile );
+  block_fs_fread_realloc_buffer( bfs , filename , buffer );
+  test_assert_int_equal( buffer_get_size( buffer ) , (ifile + 1) * sizeof(int));
+  for (int j = 0; j <= ifile; j++)
+    test_assert_int_equal( buffer_fread_int( buffer ) , ifile * 1000 + j + shift);
+
+  {
+    int * data = util_calloc( ifile + 1 , sizeof * data );
+    block_fs_fread_file( bfs , filename , data );
+    for (int j = 0; j <= ifile; j++)
+      test_assert_int_equal( data[j] , ifile * 1000 + j + shift);
+    free( data );
+  }
+  free( filename );
+}
+
+
+static void * read_files( void * arg ) {
+  read_arg_type * read_arg = arg;
+  buffer_type * buffer = buffer_alloc( 100 );
+  for (int iter = 0; iter < 5; iter++)
+    for (int ifile = read_arg->offset; ifile < NUM_READ_FILES; ifile += NUM_READERS)
+      check_file( read_arg->bfs , buffer , "FILE" , ifile , 0 );
+  buffer_free( buffer );
+  return NULL;
+}
+
+
+/*
+  Writes new files while other threads read; a file must be readable
+  immediately after it has been written.
+*/
+
+static void * write_files( void * arg ) {
+  block_fs_type * bfs = arg;
+  buffer_type * buffer = buffer_alloc( 100 );
+  for (int ifile = 0; ifile < NUM_READ_FILES; ifile++) {
+    char * filename = util_alloc_sprintf( "NEW.%d" , ifile );
+    fill_buffer( buffer , ifile , 7 );
+    block_fs_fwrite_buffer( bfs , filename , buffer );
+    check_file( bfs , buffer , "NEW" , ifile , 7 );
+    free( filename );
+  }
+  buffer_free( buffer );
+  return NULL;
+}
+
+
+void test_concurrent_read( bool async_write ) {
+  test_work_area_type * work_area = test_work_area_alloc("block_fs/concurrent_read");
+  block_fs_type * bfs = block_fs_mount( "test.mnt" , 1000 , 10000 , 0.67 , 10 , true , false , false );
+  block_fs_set_async_write( bfs , async_write );
+  {
+    buffer_type * buffer = buffer_alloc( 100 );
+    for (int ifile = 0; ifile < NUM_READ_FILES; ifile++) {
+      char * filename = util_alloc_sprintf( "FILE.%d" , ifile );
+      fill_buffer( buffer , ifile , 0 );
+      block_fs_fwrite_buffer( bfs , filename , buffer );
+      free( filename );
+    }
+    buffer_free( buffer );
+  }
+
+  {
+    thread_pool_type * tp = thread_pool_alloc( NUM_READERS + 1 , true );
+    read_arg_type args[NUM_READERS];
+
+    for (int t = 0; t < NUM_READERS; t++) {
+      args[t].bfs = bfs;
+      args[t].offset = t;
+      thread_pool_add_job( tp , read_files , &args[t] );
+    }
+    thread_pool_add_job( tp , write_files , bfs );
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+  }
+  block_fs_close( bfs , false );
+  test_work_area_free( work_area );
+}
+
+
+/*
+  With asynchronous writes: the files must be readable immediately
+  after they have been written, the last write of a file must win,
+  and everything must be on disk after block_fs_flush().
+*/
+
+void test_async_write() {
+  test_work_area_type * work_area = test_work_area_alloc("block_fs/async_write");
+  buffer_type * buffer = buffer_alloc( 100 );
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 1000 , 10000 , 0.67 , 10 , true , false , false );
+    block_fs_set_async_write( bfs , true );
+    test_assert_true( block_fs_get_async_write( bfs ));
+
+    for (int ifile = 0; ifile < NUM_READ_FILES; ifile++) {
+      char * filename = util_alloc_sprintf( "FILE.%d" , ifile );
+      fill_buffer( buffer , ifile , 0 );
+      block_fs_fwrite_buffer( bfs , filename , buffer );
+      test_assert_true( block_fs_has_file( bfs , filename ));
+      test_assert_int_equal( block_fs_get_filesize( bfs , filename ) , (ifile + 1) * sizeof(int));
+      check_file( bfs , buffer , "FILE" , ifile , 0 );
+      free( filename );
+    }
+
+    /* Overwrite every other file, the new content of the file must win. */
+    for (int ifile = 0; ifile < NUM_READ_FILES; ifile += 2) {
+      char * filename = util_alloc_sprintf( "FILE.%d" , ifile );
+      fill_buffer( buffer , ifile , 3 );
+      block_fs_fwrite_buffer( bfs , filename , buffer );
+      check_file( bfs , buffer , "FILE" , ifile , 3 );
+      free( filename );
+    }
+
+    block_fs_flush( bfs );
+    for (int ifile = 0; ifile < NUM_READ_FILES; ifile++)
+      check_file( bfs , buffer , "FILE" , ifile , (ifile % 2) ? 0 : 3 );
+
+    block_fs_unlink_file( bfs , "FILE.0" );
+    test_assert_false( block_fs_has_file( bfs , "FILE.0" ));
+    block_fs_close( bfs , false );
+  }
+
+  /* Without the index file the nodes written by the writer thread must be found by scanning the data file. */
+  util_unlink_existing( "test.index" );
+  {
+    block_fs_type * bfs = block_fs_mount( "test.mnt" , 1000 , 10000 , 0.67 , 10 , true , false , false );
+    test_assert_false( block_fs_get_async_write( bfs ));
+    test_assert_false( block_fs_has_file( bfs , "FILE.0" ));
+    for (int ifile = 1; ifile < NUM_READ_FILES; ifile++)
+      check_file( bfs , buffer , "FILE" , ifile , (ifile % 2) ? 0 : 3 );
+    block_fs_close( bfs , false );
+  }
+  buffer_free( buffer );
+  test_work_area_free( work_area );
+}
+
+#endif
+
+
 int main(int argc , char ** argv) {
   test_readonly();
+  test_fwrite_buffers();
+  test_index();
+#ifdef ERT_HAVE_THREAD_POOL
+  test_concurrent_read( false );
+  test_concurrent_read( true );
+  test_async_write();
+#endif
   test_lock_conflict();
   exit(0);
 }
@@ -0,0 +1,91 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_util_cgroup_cpu_quota.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+
+static void write_file( const char * path , const char * filename , const char * content ) {
+  char * full_path = util_alloc_filename( path , filename , NULL );
+  FILE * stream;
+
+  util_make_path( path );
+  stream = util_fopen( full_path , "w" );
+  fprintf( stream , "%s" , content );
+  fclose( stream );
+  free( full_path );
+}
+
+
+/*
+  The process runs in a nested cgroup; the quota of the parent is
+  smaller than the quota of the root, and the cgroup itself has no
+  quota.
+*/
+
+static void test_v2( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "cgroup_v2" );
+
+  write_file( "proc" , "cgroup" , "0::/batch/job1\n" );
+  write_file( "root" , "cpu.max" , "800000 100000\n" );
+  write_file( "root/batch" , "cpu.max" , "250000 100000\n" );
+  write_file( "root/batch/job1" , "cpu.max" , "max 100000\n" );
+  test_assert_int_equal( 3 , util_get_cgroup_cpu_quota( "proc/cgroup" , "root" ));
+
+  write_file( "root/batch/job1" , "cpu.max" , "100000 100000\n" );
+  test_assert_int_equal( 1 , util_get_cgroup_cpu_quota( "proc/cgroup" , "root" ));
+
+  /* Without /proc/self/cgroup only the root is checked. */
+  test_assert_int_equal( 8 , util_get_cgroup_cpu_quota( "proc/missing" , "root" ));
+  test_assert_int_equal( -1 , util_get_cgroup_cpu_quota( "proc/missing" , "no_root" ));
+
+  test_work_area_free( work_area );
+}
+
+
+/*
+  cgroup v1 in a cgroup namespace: the path in the cgroup file does
+  not exist below the mount point, where the root is the cgroup of
+  the container.
+*/
+
+static void test_v1( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "cgroup_v1" );
+
+  write_file( "proc" , "cgroup" , "5:memory:/docker/abc\n4:cpu,cpuacct:/docker/abc\n0::/\n" );
+  write_file( "root/cpu" , "cpu.cfs_quota_us" , "150000\n" );
+  write_file( "root/cpu" , "cpu.cfs_period_us" , "100000\n" );
+  test_assert_int_equal( 2 , util_get_cgroup_cpu_quota( "proc/cgroup" , "root" ));
+
+  write_file( "root/cpu" , "cpu.cfs_quota_us" , "-1\n" );
+  test_assert_int_equal( -1 , util_get_cgroup_cpu_quota( "proc/cgroup" , "root" ));
+
+  test_work_area_free( work_area );
+}
+
+
+int main( int argc , char ** argv ) {
+  test_v2( );
+  test_v1( );
+  test_assert_true( util_get_num_cpu( ) >= 1 );
+  exit(0);
+}
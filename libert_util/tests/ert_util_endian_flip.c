@@ -0,0 +1,79 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ert_util_endian_flip.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+
+/*
+  Byte by byte reference implementation.
+*/
+
+void naive_flip( char * data , int element_size , int elements) {
+  int i,j;
+  for (i=0; i < elements; i++) {
+    char * elm = &data[i * element_size];
+    for (j=0; j < element_size / 2; j++) {
+      char tmp = elm[j];
+      elm[j] = elm[element_size - 1 - j];
+      elm[element_size - 1 - j] = tmp;
+    }
+  }
+}
+
+
+void test_flip( int element_size , int elements ) {
+  int byte_size = element_size * elements;
+  char * data = util_malloc( byte_size + 1 );
+  char * expected = util_malloc( byte_size + 1 );
+  int i;
+
+  for (i=0; i < byte_size; i++)
+    data[i] = (char) (i * 7 + 3);
+
+  memcpy( expected , data , byte_size );
+  naive_flip( expected , element_size , elements );
+  util_endian_flip_vector( data , element_size , elements );
+  test_assert_int_equal( memcmp( data , expected , byte_size ) , 0 );
+
+  /* Unaligned start address. */
+  memmove( &data[1] , expected , byte_size );
+  memcpy( &expected[1] , expected , byte_size );
+  util_endian_flip_vector( &data[1] , element_size , elements );
+  naive_flip( &expected[1] , element_size , elements );
+  test_assert_int_equal( memcmp( &data[1] , &expected[1] , byte_size ) , 0 );
+
+  free( data );
+  free( expected );
+}
+
+
+int main(int argc , char ** argv) {
+  int sizes[] = {0 , 1 , 3 , 4 , 7 , 8 , 9 , 15 , 16 , 17 , 31 , 33 , 1000 , 1001 , 100003};
+  int i;
+
+  for (i=0; i < sizeof sizes / sizeof sizes[0]; i++) {
+    test_flip( 2 , sizes[i] );
+    test_flip( 4 , sizes[i] );
+    test_flip( 8 , sizes[i] );
+  }
+  exit(0);
+}
@@ -0,0 +1,193 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ert_util_matrix_matmul.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/matrix.h>
+#include <ert/util/rng.h>
+
+
+/* The straightforward triple loop used as reference. */
+
+void reference_matmul( matrix_type * A , const matrix_type * B ) {
+  const int rows    = matrix_get_rows( A );
+  const int columns = matrix_get_columns( A );
+  double * tmp = util_calloc( columns , sizeof * tmp );
+
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < columns; j++) {
+      double sum = 0;
+      for (int k = 0; k < columns; k++)
+        sum += matrix_iget( A , i , k ) * matrix_iget( B , k , j );
+      tmp[j] = sum;
+    }
+    for (int j = 0; j < columns; j++)
+      matrix_iset( A , i , j , tmp[j] );
+  }
+  free( tmp );
+}
+
+
+void assert_matrix_close( const matrix_type * m1 , const matrix_type * m2 ) {
+  test_assert_int_equal( matrix_get_rows( m1 ) , matrix_get_rows( m2 ));
+  test_assert_int_equal( matrix_get_columns( m1 ) , matrix_get_columns( m2 ));
+  for (int j = 0; j < matrix_get_columns( m1 ); j++)
+    for (int i = 0; i < matrix_get_rows( m1 ); i++)
+      test_assert_true( fabs( matrix_iget( m1 , i , j ) - matrix_iget( m2 , i , j )) < 1e-10 * (1 + fabs( matrix_iget( m1 , i , j ))));
+}
+
+
+void test_matmul( rng_type * rng , int rows , int columns ) {
+  matrix_type * A = matrix_alloc( rows , columns );
+  matrix_type * B = matrix_alloc( columns , columns );
+  matrix_type * A0;
+
+  matrix_random_init( A , rng );
+  matrix_random_init( B , rng );
+  A0 = matrix_alloc_copy( A );
+
+  matrix_inplace_matmul( A , B );
+  reference_matmul( A0 , B );
+  assert_matrix_close( A0 , A );
+
+  matrix_free( A0 );
+  matrix_free( A );
+  matrix_free( B );
+}
+
+
+/*
+  Multiply a view of some of the rows in a larger matrix; the rows
+  outside the view should not be touched.
+*/
+
+void test_matmul_view( rng_type * rng ) {
+  const int rows = 1000;
+  const int columns = 50;
+  matrix_type * A = matrix_alloc( rows , columns );
+  matrix_type * B = matrix_alloc( columns , columns );
+  matrix_type * A0;
+
+  matrix_random_init( A , rng );
+  matrix_random_init( B , rng );
+  A0 = matrix_alloc_copy( A );
+  {
+    matrix_type * view  = matrix_alloc_shared( A , 100 , 0 , 777 , columns );
+    matrix_type * view0 = matrix_alloc_shared( A0 , 100 , 0 , 777 , columns );
+
+    matrix_inplace_matmul( view , B );
+    reference_matmul( view0 , B );
+    matrix_free( view );
+    matrix_free( view0 );
+  }
+  assert_matrix_close( A0 , A );
+
+  matrix_free( A0 );
+  matrix_free( A );
+  matrix_free( B );
+}
+
+
+/*
+  Single precision multiplication of some of the rows in a float
+  array with a leading dimension larger than the number of rows; the
+  result should agree with the double precision reference to float
+  precision, and the other rows should not be touched.
+*/
+
+void test_matmul_float( rng_type * rng , int rows , int columns ) {
+  const int lda = rows + 17;
+  const int row_offset = 5;
+  const int float_rows = rows - 2 * row_offset;
+  matrix_type * A = matrix_alloc( lda , columns );
+  matrix_type * B = matrix_alloc( columns , columns );
+  float * A_float = util_calloc( lda * columns , sizeof * A_float );
+
+  matrix_random_init( A , rng );
+  matrix_random_init( B , rng );
+  for (int j = 0; j < columns; j++)
+    for (int i = 0; i < lda; i++) {
+      A_float[ i + j * lda ] = matrix_iget( A , i , j );
+      matrix_iset( A , i , j , A_float[ i + j * lda ] );
+    }
+
+  matrix_inplace_matmul_float( &A_float[ row_offset ] , float_rows , lda , B );
+  {
+    matrix_type * view = matrix_alloc_shared( A , row_offset , 0 , float_rows , columns );
+    reference_matmul( view , B );
+    matrix_free( view );
+  }
+
+  for (int j = 0; j < columns; j++)
+    for (int i = 0; i < lda; i++) {
+      if ((i < row_offset) || (i >= row_offset + float_rows))
+        test_assert_true( A_float[ i + j * lda ] == (float) matrix_iget( A , i , j ));
+      else
+        test_assert_true( fabs( A_float[ i + j * lda ] - matrix_iget( A , i , j )) < 1e-6 * columns * (1 + fabs( matrix_iget( A , i , j ))));
+    }
+
+  free( A_float );
+  matrix_free( A );
+  matrix_free( B );
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+void test_matmul_mt( rng_type * rng ) {
+  matrix_type * A = matrix_alloc( 5003 , 40 );
+  matrix_type * B = matrix_alloc( 40 , 40 );
+  matrix_type * A0;
+
+  matrix_random_init( A , rng );
+  matrix_random_init( B , rng );
+  A0 = matrix_alloc_copy( A );
+
+  matrix_inplace_matmul_mt1( A , B , 4 );
+  reference_matmul( A0 , B );
+  assert_matrix_close( A0 , A );
+
+  matrix_free( A0 );
+  matrix_free( A );
+  matrix_free( B );
+}
+
+#endif
+
+
+int main( int argc , char ** argv) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+
+  test_matmul( rng , 1 , 1 );
+  test_matmul( rng , 10 , 10 );
+  test_matmul( rng , 3001 , 100 );
+  test_matmul( rng , 50 , 1001 );
+  test_matmul_view( rng );
+  test_matmul_float( rng , 20 , 1 );
+  test_matmul_float( rng , 3001 , 100 );
+#ifdef ERT_HAVE_THREAD_POOL
+  test_matmul_mt( rng );
+#endif
+
+  rng_free( rng );
+  exit(0);
+}
@@ -208,6 +208,7 @@
 /*****************************************************************/
 
 #define JOB_QUEUE_TYPE_ID 665210
+#define DEFAULT_NUM_WORKER_THREADS 4
 
 struct job_queue_struct {
   UTIL_TYPE_ID_DECLARATION;
@@ -231,6 +232,7 @@ struct job_queue_struct {
   unsigned long              usleep_time;                       /* The sleep time before checking for updates. */
   pthread_mutex_t            run_mutex;                         /* This mutex is used to ensure that ONLY one thread is executing the job_queue_run_jobs(). */
   thread_pool_type         * work_pool;
+  int                        num_worker_threads;                /* The number of threads in the work_pool running the callbacks. */
 };
 
 
@@ -882,8 +884,7 @@ void job_queue_run_jobs(job_queue_type * queue , int num_total_run, bool verbose
       potentially be quite high while running the DONE callback - should therefor not use
       too many threads.
     */
-    const int NUM_WORKER_THREADS = 4;
-    queue->work_pool = thread_pool_alloc( NUM_WORKER_THREADS , true );
+    queue->work_pool = thread_pool_alloc( queue->num_worker_threads , true );
     {
       bool new_jobs         = false;
       bool cont             = true;
@@ -1200,6 +1201,7 @@ job_queue_type * job_queue_alloc(int  max_submit               ,
   queue->running          = false;
   queue->submit_complete  = false;
   queue->work_pool        = NULL;
+  queue->num_worker_threads = DEFAULT_NUM_WORKER_THREADS;
   queue->job_list         = job_list_alloc(  );
   queue->status           = job_queue_status_alloc( );
 
@@ -1209,6 +1211,22 @@ job_queue_type * job_queue_alloc(int  max_submit               ,
 }
 
 
+/**
+   Set the number of threads used to run the callbacks (i.e. loading
+   the results) of completed jobs. Will only take effect the next time
+   job_queue_run_jobs() is called.
+*/
+
+void job_queue_set_num_worker_threads( job_queue_type * queue , int num_worker_threads ) {
+  queue->num_worker_threads = util_int_max( num_worker_threads , 1 );
+}
+
+
+int job_queue_get_num_worker_threads( const job_queue_type * queue ) {
+  return queue->num_worker_threads;
+}
+
+
 /**
    When the job_queue_run_jobs() has been called with @total_num_jobs
    == 0 that means that the total number of jobs to run is not known
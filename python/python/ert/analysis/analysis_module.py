@@ -54,6 +54,7 @@ class AnalysisModule(BaseCClass):
         "CLEAR_LOG": {"type": bool, "description": "Clear Existing Log File"},
         "LAMBDA_RECALCULATE": {"type": bool, "description": "Recalculate Lambda after each Iteration"},
         "ENKF_TRUNCATION": {"type": float, "description": "Singular value truncation"},
+        "RANDOMIZED_SVD": {"type": bool, "description": "Randomized SVD of the leading components"},
         "ENKF_NCOMP": {"type": int, "description": "ENKF_NCOMP"},
         "CV_NFOLDS": {"type": int, "description": "CV_NFOLDS"},
         "FWD_STEP_R2_LIMIT": {"type": float, "description": "FWD_STEP_R2_LIMIT"},
@@ -196,6 +196,13 @@ class EclFile(BaseCClass):
               in cases where a high number of EclFile instances are
               open concurrently.
 
+           ecl.ECL_FILE_MMAP : The file is memory mapped, and keyword
+              data is read directly from the mapped pages.
+
+           ecl.ECL_FILE_INDEX : A keyword index is stored in the
+              sidecar file 'filename.index', and reused on the next
+              open instead of scanning through the whole file.
+
         When the file has been loaded the EclFile instance can be used
         to query for and get reference to the EclKW instances
         constituting the file, like e.g. SWAT from a restart file or
@@ -21,7 +21,9 @@ class EnKFFSType(BaseCEnum):
     INVALID_DRIVER_ID = None
     PLAIN_DRIVER_ID = None
     BLOCK_FS_DRIVER_ID = None
+    BLOCK_FS_FIELD_DRIVER_ID = None
 
 EnKFFSType.addEnum("INVALID_DRIVER_ID", 0)
 EnKFFSType.addEnum("PLAIN_DRIVER_ID", 1005)
 EnKFFSType.addEnum("BLOCK_FS_DRIVER_ID", 3001)
+EnKFFSType.addEnum("BLOCK_FS_FIELD_DRIVER_ID", 3003)
@@ -50,3 +50,6 @@ class StdEnKFTest(ExtendedTestCase):
 
 
     
+
+    def test_randomized_svd_option(self):
+        self.toggleKey( 'RANDOMIZED_SVD' )